@@ -29,6 +29,7 @@
 #include <OpenSim/Tools/AnalyzeTool.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <OpenSim/Analyses/InducedAccelerationsSolver.h>
+#include <OpenSim/Analyses/InducedAccelerations.h>
 
 using namespace OpenSim;
 using namespace SimTK;
@@ -37,6 +38,7 @@ using namespace std;
 // Prototypes
 void testDoublePendulumWithSolver();
 void testDoublePendulum();
+void testDoublePendulumWithThreads();
 Vector calcDoublePendulumUdot(const Model &model, State &s, double Torq1, double Torq2, bool gravity, bool velocity);
 
 int main()
@@ -49,6 +51,9 @@ int main()
         // check that analysis version still works
         testDoublePendulum();
 
+        // contributors solved on several threads match the serial results
+        testDoublePendulumWithThreads();
+
         AnalyzeTool analyze("subject02_Setup_IAA_02_232.xml");
         analyze.run();
         Storage result1("ResultsInducedAccelerations/subject02_running_arms_InducedAccelerations_center_of_mass.sto"), standard1("std_subject02_running_arms_InducedAccelerations_CENTER_OF_MASS.sto");
@@ -217,6 +222,31 @@ void testDoublePendulum()
     cout << "Analysis computed " << nt << " frames in " << 1.e3*(std::clock()-startTime)/CLOCKS_PER_SEC << "ms\n" << endl;
 }
 
+void testDoublePendulumWithThreads()
+{
+    AnalyzeTool analyze("double_pendulum_Setup_IAA.xml");
+    InducedAccelerations& iaa = dynamic_cast<InducedAccelerations&>(
+        analyze.getModel().updAnalysisSet().get("InducedAccelerations"));
+    iaa.setNumThreads(3);
+    analyze.setResultsDir("ResultsInducedAccelerationsThreads");
+    analyze.run();
+
+    const char* coords[] = {"q1", "q2"};
+    for(int k=0; k<2; ++k){
+        string file = string("double_pendulum_InducedAccelerations_")+coords[k]+".sto";
+        Storage serial("ResultsInducedAccelerations/"+file);
+        Storage threaded("ResultsInducedAccelerationsThreads/"+file);
+        ASSERT(serial.getSize() == threaded.getSize());
+        ASSERT(serial.getColumnLabels() == threaded.getColumnLabels());
+        for(int i=0; i<serial.getSize(); ++i){
+            const Array<double>& expected = serial.getStateVector(i)->getData();
+            const Array<double>& actual = threaded.getStateVector(i)->getData();
+            for(int j=0; j<expected.getSize(); ++j)
+                ASSERT_EQUAL(expected[j], actual[j], 1e-10, __FILE__, __LINE__, "Induced Accelerations on threads differ from serial results");
+        }
+    }
+    cout << "Induced Accelerations of double pendulum on 3 threads passed\n" << endl;
+}
 
 Vector calcDoublePendulumUdot(const Model &model, State &s, double Torq1, double Torq2, bool gravity, bool velocity)
 {   
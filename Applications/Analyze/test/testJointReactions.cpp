@@ -42,6 +42,128 @@ int main()
         Storage result2("DoublePendulum3D_JointReaction_ReactionLoads.sto"), standard2("std_DoublePendulum3D_JointReaction_ReactionLoads.sto");
         CHECK_STORAGE_AGAINST_STANDARD(result2, standard2, Array<double>(1e-5, 24), __FILE__, __LINE__, "DoublePendulum3D failed");
         cout << "DoublePendulum3D passed" << endl;
+
+        // Ranges of frames computed on several threads, each with its own
+        // copy of the model or sharing the model, match the serial results.
+        for (int shared = 0; shared < 2; ++shared) {
+            AnalyzeTool analyze3("DoublePendulum3D_Setup_JointReaction.xml");
+            JointReaction& reaction = dynamic_cast<JointReaction&>(
+                analyze3.getModel().updAnalysisSet().get("JointReaction"));
+            reaction.setNumThreads(4);
+            analyze3.getModel().setUseThreadSafeEvaluation(shared == 1);
+            analyze3.setResultsDir("ResultsJointReactionThreads");
+            analyze3.run();
+            Storage result3("ResultsJointReactionThreads/DoublePendulum3D_JointReaction_ReactionLoads.sto");
+            ASSERT(result2.getSize() == result3.getSize());
+            ASSERT(result2.getColumnLabels() == result3.getColumnLabels());
+            for (int i = 0; i < result2.getSize(); ++i) {
+                const Array<double>& expected = result2.getStateVector(i)->getData();
+                const Array<double>& actual = result3.getStateVector(i)->getData();
+                ASSERT_EQUAL(result2.getStateVector(i)->getTime(), result3.getStateVector(i)->getTime(), 1e-12);
+                for (int j = 0; j < expected.getSize(); ++j)
+                    ASSERT_EQUAL(expected[j], actual[j], 1e-10, __FILE__, __LINE__, "DoublePendulum3D on threads differs from serial results");
+            }
+        }
+        cout << "DoublePendulum3D on 4 threads passed" << endl;
+
+        // Discrete variables of the recorded states, here an overridden
+        // actuation, are seen by the threads computing the frames.
+        {
+            Model model("DoublePendulum3D.osim");
+            CoordinateActuator* actuator = new CoordinateActuator("r1_z");
+            actuator->setName("r1_z_actuator");
+            model.addForce(actuator);
+            SimTK::State& s = model.initSystem();
+            actuator->overrideActuation(s, true);
+            actuator->setOverrideActuation(s, 10.0);
+
+            JointReaction serial, threads;
+            threads.setNumThreads(4);
+            JointReaction* reactions[] = { &serial, &threads };
+            for (JointReaction* reaction : reactions) {
+                reaction->setModel(model);
+                for (int i = 0; i <= 20; ++i) {
+                    s.setTime(0.01*i);
+                    for (int j = 0; j < s.getNQ(); ++j)
+                        s.updQ()[j] = 0.05*i*(j + 1);
+                    s.updU() = 0.1;
+                    model.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+                    if (i == 0) reaction->begin(s);
+                    else reaction->step(s, i);
+                }
+                reaction->end(s);
+            }
+            const Storage& expected = *serial.getStorageList().get(0);
+            const Storage& actual = *threads.getStorageList().get(0);
+            ASSERT(expected.getSize() == actual.getSize());
+            for (int i = 0; i < expected.getSize(); ++i) {
+                const Array<double>& e = expected.getStateVector(i)->getData();
+                const Array<double>& a = actual.getStateVector(i)->getData();
+                for (int j = 0; j < e.getSize(); ++j)
+                    ASSERT_EQUAL(e[j], a[j], 1e-10, __FILE__, __LINE__, "Overridden actuation lost on threads");
+            }
+        }
+        cout << "DoublePendulum3D with overridden actuation on 4 threads passed" << endl;
+
+        // Results streamed to a file while only the last rows are kept in
+        // memory match those printed at the end.
+        {
+            AnalyzeTool analyze4("DoublePendulum3D_Setup_JointReaction.xml");
+            JointReaction& reaction = dynamic_cast<JointReaction&>(
+                analyze4.getModel().updAnalysisSet().get("JointReaction"));
+            reaction.setStreamDirectory("ResultsJointReactionStreamed");
+            reaction.setMaxRowsInMemory(10);
+            reaction.setComputeStatistics(true);
+            analyze4.setResultsDir("ResultsJointReactionStreamed");
+            analyze4.run();
+            ASSERT(reaction.getNumStreams() == 1);
+            const StorageStream& stream = reaction.getStream(0);
+            ASSERT(stream.getNumRowsWritten() == result2.getSize());
+            ASSERT(stream.getStorage().getSize() <= 21);
+            Storage result4("ResultsJointReactionStreamed/DoublePendulum3D_JointReaction_Joint_Reaction_Loads.sto");
+            CHECK_STORAGE_AGAINST_STANDARD(result4, result2, Array<double>(1e-5, 24), __FILE__, __LINE__, "DoublePendulum3D streamed failed");
+            const StorageStatistics& stats = stream.getStatistics();
+            for (int j = 0; j < stats.getNumColumns(); ++j) {
+                Array<double> column;
+                result2.getDataColumn(j, column);
+                double max = -SimTK::Infinity;
+                for (int i = 0; i < column.getSize(); ++i)
+                    max = std::max(max, column[i]);
+                ASSERT_EQUAL(max, stats.getMax(j), 1e-5);
+            }
+        }
+
+        // On several threads, the frames are computed and streamed in chunks
+        // of the rows kept in memory.
+        {
+            AnalyzeTool analyze6("DoublePendulum3D_Setup_JointReaction.xml");
+            JointReaction& reaction = dynamic_cast<JointReaction&>(
+                analyze6.getModel().updAnalysisSet().get("JointReaction"));
+            reaction.setNumThreads(4);
+            reaction.setStreamDirectory("ResultsJointReactionStreamedThreads");
+            reaction.setMaxRowsInMemory(10);
+            analyze6.setResultsDir("ResultsJointReactionStreamedThreads");
+            analyze6.run();
+            const StorageStream& stream = reaction.getStream(0);
+            ASSERT(stream.getNumRowsWritten() == result2.getSize());
+            ASSERT(stream.getStorage().getSize() <= 21);
+            Storage result6("ResultsJointReactionStreamedThreads/DoublePendulum3D_JointReaction_Joint_Reaction_Loads.sto");
+            CHECK_STORAGE_AGAINST_STANDARD(result6, result2, Array<double>(1e-5, 24), __FILE__, __LINE__, "DoublePendulum3D streamed on threads failed");
+        }
+
+        // Rows dropped from memory without a directory or callback to write
+        // them to would be lost, so the run refuses to start.
+        {
+            AnalyzeTool analyze5("DoublePendulum3D_Setup_JointReaction.xml");
+            analyze5.getModel().updAnalysisSet().get("JointReaction")
+                .setMaxRowsInMemory(10);
+            analyze5.setResultsDir("ResultsJointReactionStreamed");
+            bool threw = false;
+            try { analyze5.run(); }
+            catch (const Exception&) { threw = true; }
+            ASSERT(threw);
+        }
+        cout << "DoublePendulum3D streamed passed" << endl;
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -31,6 +31,7 @@ using namespace OpenSim;
 using namespace std;
 
 void testArm26();
+void testArm26Linearized();
 
 int main() {
 
@@ -40,6 +41,10 @@ int main() {
     catch (const std::exception& e)
         {  cout << e.what() <<endl; failures.push_back("testArm26"); }
 
+    try {testArm26Linearized();}
+    catch (const std::exception& e)
+        {  cout << e.what() <<endl; failures.push_back("testArm26Linearized"); }
+
     // redo with the Millard2012EquilibriumMuscle 
     Object::renameType("Thelen2003Muscle", "Millard2012EquilibriumMuscle");
     
@@ -86,3 +91,26 @@ void testArm26() {
     
     cout << "\n" << base <<" passed\n" << endl;
 }
+
+// Same problem solved with the linearized (exact Jacobian) optimization target
+// must track the same standard.
+void testArm26Linearized() {
+    cout<<"\n******************************************************************" << endl;
+    cout << "*                       testArm26Linearized                      *" << endl;
+    cout << "******************************************************************\n" << endl;
+    CMCTool cmc("arm26_Setup_CMC.xml");
+    cmc.setUseLinearizedTarget(true);
+    cmc.setResultsDir("Results_Arm26_Linearized");
+    cmc.run();
+
+    Storage results("Results_Arm26_Linearized/arm26_states.sto"), temp("std_arm26_states.sto");
+    Storage *standard = new Storage();
+    cmc.getModel().formStateStorage(temp, *standard);
+
+    Array<double> rms_tols(0.02, 2*2+2*6); // activations within 2%, angles within .6 degrees
+
+    CHECK_STORAGE_AGAINST_STANDARD(results, *standard, rms_tols, __FILE__, __LINE__,
+        "testArm26Linearized failed");
+
+    cout << "\ntestArm26Linearized passed\n" << endl;
+}
@@ -29,11 +29,14 @@
 #include <OpenSim/Tools/ForwardTool.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include "SimTKmath.h"
+#include <cstdio>
+#include <fstream>
 
 using namespace OpenSim;
 using namespace std;
 
 void testPendulum();    // test manager/integration process
+void testPendulumCheckpoint(); // test resuming an integration from a checkpoint
 void testPendulumExternalLoad(); // test application of external loads point in pendulum
 void testPendulumExternalLoadWithPointInGround(); // test application of external loads point in ground
 void testArm26();       // now add computation of controls and generation of muscle forces
@@ -50,6 +53,11 @@ int main() {
     catch (const std::exception& e)
         { cout << e.what() <<endl; failures.push_back("testPendulum"); }
     
+    // test resuming an integration from a checkpoint
+    try { testPendulumCheckpoint(); cout << "\nPendulum checkpoint test PASSED " << endl; }
+    catch (const std::exception& e)
+        { cout << e.what() <<endl; failures.push_back("testPendulumCheckpoint"); }
+
     // test application of external loads
     try { testPendulumExternalLoad(); 
         cout << "\nPendulum with external load test PASSED " << endl; }
@@ -113,6 +121,57 @@ void testPendulum() {
 }
 
 
+void testPendulumCheckpoint() {
+    ForwardTool uninterrupted("pendulum_Setup_Forward.xml");
+    uninterrupted.setName("pendulum_uninterrupted");
+    uninterrupted.setResultsDir("ResultsCheckpoint");
+    uninterrupted.run();
+    Storage expected("ResultsCheckpoint/pendulum_uninterrupted_states.sto");
+
+    // Stop halfway, with a checkpoint after every step. The results are not
+    // printed, so the tool must create the directory for the checkpoint.
+    const string checkpointFile =
+        "ResultsCheckpointResumed/pendulum_resumed_checkpoint.bin";
+    std::remove(checkpointFile.c_str());
+    ForwardTool interrupted("pendulum_Setup_Forward.xml");
+    interrupted.setName("pendulum_resumed");
+    interrupted.setResultsDir("ResultsCheckpointResumed");
+    interrupted.setFinalTime(0.5);
+    interrupted.setCheckpointInterval(1e-9);
+    interrupted.setPrintResultFiles(false);
+    interrupted.run();
+    ASSERT(ifstream(checkpointFile.c_str(), ios::binary).good());
+
+    ForwardTool resumed("pendulum_Setup_Forward.xml");
+    resumed.setName("pendulum_resumed");
+    resumed.setResultsDir("ResultsCheckpointResumed");
+    resumed.setResumeFromCheckpoint(true);
+    resumed.run();
+    Storage actual("ResultsCheckpointResumed/pendulum_resumed_states.sto");
+
+    // The resumed run starts at the last step of the interrupted one and
+    // ends where the uninterrupted run does, in the same state.
+    ASSERT(actual.getFirstTime() > 0.0 && actual.getFirstTime() <= 0.5);
+    ASSERT(actual.getLastTime() == 1.0);
+    ASSERT(actual.getColumnLabels() == expected.getColumnLabels());
+    const Array<double>& last = actual.getLastStateVector()->getData();
+    const Array<double>& lastExpected =
+        expected.getLastStateVector()->getData();
+    ASSERT(last.getSize() == lastExpected.getSize());
+    for (int j = 0; j < last.getSize(); ++j)
+        ASSERT_EQUAL(lastExpected[j], last[j], 1e-4, __FILE__, __LINE__,
+            "Resumed run differs from uninterrupted run in state " +
+            expected.getColumnLabels()[j+1]);
+
+    Array<double> data(0.0, last.getSize());
+    for (int i = 0; i < actual.getSize(); ++i) {
+        const StateVector& row = *actual.getStateVector(i);
+        expected.getDataAtTime(row.getTime(), last.getSize(), data);
+        for (int j = 0; j < last.getSize(); ++j)
+            ASSERT_EQUAL(data[j], row.getData()[j], 1e-3);
+    }
+}
+
 void testPendulumExternalLoad() {
     ForwardTool forward("pendulum_ext_gravity_Setup_Forward.xml");
     forward.run();
@@ -0,0 +1,230 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  testPipeline.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ExternalLoads.h>
+#include <OpenSim/Analyses/ForceReporter.h>
+#include <OpenSim/Tools/AnalyzeTool.h>
+#include <OpenSim/Tools/InverseDynamicsTool.h>
+#include <OpenSim/Tools/InverseKinematicsTool.h>
+#include <OpenSim/Tools/ScaleTool.h>
+#include <OpenSim/Tools/PipelineTool.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void testScaleAndAnalyzeInMemory();
+void testSubjectInMemory();
+void testPipelineTool();
+
+int main()
+{
+    try {
+        testScaleAndAnalyzeInMemory();
+        testSubjectInMemory();
+        testPipelineTool();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+// Scaling, inverse kinematics and an analysis with external loads, with the
+// scaled model and the motion passed in memory, give the results of the same
+// setups run one after the other on files. The external loads name the IK
+// motion as their kinematics, which the analysis takes from memory and
+// filters as it would filter the file.
+void testScaleAndAnalyzeInMemory()
+{
+    const string motionFile = "subject01_walk1_ik_test.mot";
+    remove(motionFile.c_str());
+
+    {
+        Model model("subject01_simbody.osim");
+        ExternalLoads loads(model, "subject01_walk1_grf.xml");
+        loads.setExternalLoadsModelKinematicsFileName(motionFile);
+        ASSERT(loads.getLowpassCutoffFrequencyForLoadKinematics() > 0);
+        loads.print("subject01_pipeline_grf.xml");
+    }
+    AnalyzeTool analyzeSetup;
+    analyzeSetup.setName("subject01_pipeline");
+    analyzeSetup.setInitialTime(0.5);
+    analyzeSetup.setFinalTime(1.5);
+    analyzeSetup.setExternalLoadsFileName("subject01_pipeline_grf.xml");
+    analyzeSetup.setCoordinatesFileName(motionFile);
+    analyzeSetup.setResultsDir("ResultsPipelineInMemory");
+    analyzeSetup.getAnalysisSet().adoptAndAppend(new ForceReporter());
+    analyzeSetup.print("subject01_pipeline_Setup_Analyze.xml");
+
+    SubjectPipeline subject;
+    subject.setName("subject01");
+    subject.set_scale_setup_file("subject01_Setup_Scale.xml");
+    subject.set_inverse_kinematics_setup_file(
+        "subject01_Setup_InverseKinematics.xml");
+    subject.set_analyze_setup_file("subject01_pipeline_Setup_Analyze.xml");
+    subject.run();
+    // Nothing went through the motion file.
+    ASSERT(!ifstream(motionFile.c_str()).good());
+
+    // The same setups, run on files.
+    ScaleTool scaleTool("subject01_Setup_Scale.xml");
+    scaleTool.setPrintResultFiles(false);
+    Model* scaled = scaleTool.createModel();
+    ASSERT(scaled != NULL);
+    ASSERT(scaleTool.getModelScaler().processModel(scaled,
+        scaleTool.getPathToSubject(), scaleTool.getSubjectMass()));
+    ASSERT(scaleTool.getMarkerPlacer().processModel(scaled,
+        scaleTool.getPathToSubject()));
+    scaled->print("subject01_pipeline_scaled.osim");
+    delete scaled;
+
+    Model ikModel("subject01_pipeline_scaled.osim");
+    InverseKinematicsTool ikTool("subject01_Setup_InverseKinematics.xml",
+                                 false);
+    ikTool.setModel(ikModel);
+    ikTool.run();
+    ASSERT(ifstream(motionFile.c_str()).good());
+
+    Model analyzeModel("subject01_pipeline_scaled.osim");
+    AnalyzeTool analyzeTool("subject01_pipeline_Setup_Analyze.xml", false);
+    analyzeTool.setResultsDir("ResultsPipelineOnFiles");
+    analyzeTool.setModel(analyzeModel);
+    analyzeTool.setLoadModelAndInput(true);
+    analyzeTool.run();
+
+    const string forcesFile = "/subject01_pipeline_ForceReporter_forces.sto";
+    Storage inMemory("ResultsPipelineInMemory" + forcesFile);
+    Storage onFiles("ResultsPipelineOnFiles" + forcesFile);
+    ASSERT(inMemory.getSize() == onFiles.getSize());
+    CHECK_STORAGE_AGAINST_STANDARD(inMemory, onFiles,
+        Array<double>(1e-4, inMemory.getColumnLabels().getSize()),
+        __FILE__, __LINE__, "SubjectPipeline analysis with external loads failed");
+    cout << "testScaleAndAnalyzeInMemory passed" << endl;
+}
+
+// Inverse kinematics followed by inverse dynamics, with the motion passed in
+// memory, gives the results of the same tools run one after the other on
+// files.
+void testSubjectInMemory()
+{
+    SubjectPipeline subject;
+    subject.setName("subject01");
+    subject.set_model_file("subject01_simbody.osim");
+    subject.set_inverse_kinematics_setup_file(
+        "subject01_Setup_InverseKinematics.xml");
+    subject.set_inverse_dynamics_setup_file(
+        "subject01_Setup_InverseDynamics.xml");
+    subject.set_write_intermediate_files(true);
+    subject.run();
+
+    Storage standard("std_subject01_walk1_ik.mot");
+    Storage motion(subject.getMotion());
+    CHECK_STORAGE_AGAINST_STANDARD(motion, standard, Array<double>(0.2, 24),
+        __FILE__, __LINE__, "SubjectPipeline inverse kinematics failed");
+
+    // Inverse dynamics of the motion the pipeline wrote.
+    Model model("subject01_simbody.osim");
+    InverseDynamicsTool reference("subject01_Setup_InverseDynamics.xml", false);
+    reference.setModel(model);
+    reference.setCoordinatesFileName("subject01_walk1_ik_test.mot");
+    reference.setOutputGenForceFileName("subject01_reference_InverseDynamics.sto");
+    reference.run();
+
+    Storage result("Results/subject01_InverseDynamics.sto");
+    Storage expected("Results/subject01_reference_InverseDynamics.sto");
+    CHECK_STORAGE_AGAINST_STANDARD(result, expected, Array<double>(0.5, 23),
+        __FILE__, __LINE__, "SubjectPipeline inverse dynamics failed");
+    cout << "testSubjectInMemory passed" << endl;
+}
+
+// Two subjects run concurrently from a setup file.
+void testPipelineTool()
+{
+    PipelineTool setup;
+    setup.setName("testPipeline");
+    setup.set_max_threads(2);
+
+    SubjectPipeline arm26;
+    arm26.setName("arm26");
+    arm26.set_model_file("arm26.osim");
+    arm26.set_inverse_dynamics_setup_file("arm26_Setup_InverseDynamics.xml");
+    arm26.set_analyze_setup_file("arm26_Setup_StaticOptimization.xml");
+    setup.append_subjects(arm26);
+
+    SubjectPipeline subject01;
+    subject01.setName("subject01");
+    subject01.set_model_file("subject01_simbody.osim");
+    subject01.set_inverse_kinematics_setup_file(
+        "subject01_Setup_InverseKinematics.xml");
+    subject01.set_inverse_dynamics_setup_file(
+        "subject01_Setup_InverseDynamics.xml");
+    setup.append_subjects(subject01);
+
+    SubjectPipeline missing;
+    missing.setName("missing");
+    missing.set_model_file("missing.osim");
+    setup.append_subjects(missing);
+    setup.print("testPipeline_Setup.xml");
+
+    PipelineTool pipeline("testPipeline_Setup.xml");
+    ASSERT(!pipeline.run());
+    ASSERT(pipeline.getFailure(0) == "");
+    ASSERT(pipeline.getFailure(1) == "");
+    ASSERT(pipeline.getFailure(2) != "");
+
+    // The arm26 model of the static optimization standards is not that of
+    // the inverse dynamics standard, so inverse dynamics is checked against
+    // the InverseDynamicsTool run on its own.
+    Model model("arm26.osim");
+    InverseDynamicsTool reference("arm26_Setup_InverseDynamics.xml", false);
+    reference.setModel(model);
+    reference.setOutputGenForceFileName("arm26_reference_InverseDynamics.sto");
+    reference.run();
+
+    Storage inverseDynamics("Results/arm26_InverseDynamics.sto");
+    Storage expected("Results/arm26_reference_InverseDynamics.sto");
+    CHECK_STORAGE_AGAINST_STANDARD(inverseDynamics, expected,
+        Array<double>(1e-6, 23), __FILE__, __LINE__,
+        "PipelineTool arm26 inverse dynamics failed");
+
+    Storage activations("Results/arm26_StaticOptimization_activation.sto");
+    Storage stdActivations("std_arm26_StaticOptimization_activation.sto");
+    CHECK_STORAGE_AGAINST_STANDARD(activations, stdActivations,
+        Array<double>(0.005, 6), __FILE__, __LINE__,
+        "PipelineTool arm26 activations failed");
+
+    Storage forces("Results/arm26_StaticOptimization_force.sto");
+    Storage stdForces("std_arm26_StaticOptimization_force.sto");
+    CHECK_STORAGE_AGAINST_STANDARD(forces, stdForces,
+        Array<double>(0.5, 6), __FILE__, __LINE__,
+        "PipelineTool arm26 forces failed");
+    cout << "testPipelineTool passed" << endl;
+}
@@ -109,12 +109,12 @@ void ClutchedPathSpring::setInitialStretch(double stretch0)
     Super::extendAddToSystem(system);
     // The spring force is dependent of stretch so only invalidate dynamics
     // if the stretch state changes
-    addStateVariable("stretch");
+    _stretchSV = addStateVariable("stretch");
 }
 
  void ClutchedPathSpring::extendInitStateFromProperties(SimTK::State& state) const
  {
-     setStateVariableValue(state, "stretch", get_initial_stretch());
+     setStateVariableValue(state, _stretchSV, get_initial_stretch());
  }
 
  void ClutchedPathSpring::extendSetPropertiesFromState(const SimTK::State& state)
@@ -134,7 +134,7 @@ void ClutchedPathSpring::setInitialStretch(double stretch0)
 
 double ClutchedPathSpring::getStretch(const SimTK::State& s) const
 {
-    return getStateVariableValue(s, "stretch");
+    return getStateVariableValue(s, _stretchSV);
 }
 
 
@@ -170,7 +170,7 @@ void ClutchedPathSpring::
                     getLengtheningSpeed(s) : // clutch is engaged
                     -getStretch(s)/get_relaxation_time_constant();
 
-    setStateVariableDerivativeValue(s, "stretch", zdot);
+    setStateVariableDerivativeValue(s, _stretchSV, zdot);
 }
 
 SimTK::Vec3 ClutchedPathSpring::computePathColor(const SimTK::State& state) const 
@@ -144,6 +144,9 @@ private:
     void setNull();
     void constructProperties();
 
+    // Handle to the stretch state variable, assigned in extendAddToSystem().
+    mutable StateVariableHandle _stretchSV;
+
 //=============================================================================
 };  // END of class ClutchedPathSpring
 
@@ -79,7 +79,8 @@ void FirstOrderMuscleActivationDynamics::
 extendAddToSystem(SimTK::MultibodySystem& system) const
 {
     Super::extendAddToSystem(system);
-    addStateVariable(STATE_NAME_ACTIVATION, SimTK::Stage::Dynamics);
+    _activationSV =
+        addStateVariable(STATE_NAME_ACTIVATION, SimTK::Stage::Dynamics);
 }
 
 void FirstOrderMuscleActivationDynamics::
@@ -102,7 +103,7 @@ computeStateVariableDerivatives(const SimTK::State& s) const
      double adot = 
          calcActivationDerivative(getExcitation(s), getActivation(s));
 
-     setStateVariableDerivativeValue(s, STATE_NAME_ACTIVATION, adot);
+     setStateVariableDerivativeValue(s, _activationSV, adot);
 }
 
 //==============================================================================
@@ -111,13 +112,13 @@ computeStateVariableDerivatives(const SimTK::State& s) const
 double FirstOrderMuscleActivationDynamics::
 getActivation(const SimTK::State& s) const
 {
-    return clampToValidInterval(getStateVariableValue(s, STATE_NAME_ACTIVATION));
+    return clampToValidInterval(getStateVariableValue(s, _activationSV));
 }
 
 void FirstOrderMuscleActivationDynamics::setActivation(SimTK::State& s,
                                                        double activation) const
 {
-    setStateVariableValue(s, STATE_NAME_ACTIVATION,
+    setStateVariableValue(s, _activationSV,
                      clampToValidInterval(activation));
 }
 
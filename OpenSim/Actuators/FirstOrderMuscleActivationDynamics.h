@@ -172,6 +172,8 @@ private:
     double calcActivationDerivative(double excitation, double activation) const;
 
     static const std::string STATE_NAME_ACTIVATION;
+    // Handle to the activation state variable, assigned in extendAddToSystem().
+    mutable StateVariableHandle _activationSV;
 
 }; // end of class FirstOrderMuscleActivationDynamics
 }  // end of namespace OpenSim
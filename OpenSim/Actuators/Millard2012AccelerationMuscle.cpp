@@ -27,6 +27,7 @@
 #include <OpenSim/Common/SimmMacros.h>
 #include <OpenSim/Common/DebugUtilities.h>
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/ComponentProfiler.h>
 #include <Simbody.h>
 #include <iostream>
 
@@ -267,9 +268,18 @@ Millard2012AccelerationMuscle(const std::string &aName,  double aMaxIsometricFor
         "Millard2012AccelerationMuscle: Muscle is not"
         " to date with properties");
 
-    addStateVariable(STATE_ACTIVATION_NAME);
-    addStateVariable(STATE_FIBER_LENGTH_NAME);
-    addStateVariable(STATE_FIBER_VELOCITY_NAME);
+    _activationSV = addStateVariable(STATE_ACTIVATION_NAME);
+    _fiberLengthSV = addStateVariable(STATE_FIBER_LENGTH_NAME);
+    _fiberVelocitySV = addStateVariable(STATE_FIBER_VELOCITY_NAME);
+
+    // The integrals of the curves, for the potential energy, are otherwise
+    // built the first time they are used, possibly on several threads.
+    if(getModel().getUseThreadSafeEvaluation()) {
+        get_FiberForceLengthCurve().calcIntegral(1.0);
+        get_TendonForceLengthCurve().calcIntegral(1.0);
+        get_FiberCompressiveForceLengthCurve().calcIntegral(1.0);
+        get_FiberCompressiveForceCosPennationCurve().calcIntegral(1.0);
+    }
  }
 
 void Millard2012AccelerationMuscle::extendInitStateFromProperties(SimTK::State& s) const
@@ -286,9 +296,9 @@ void Millard2012AccelerationMuscle::
 {
     Super::extendSetPropertiesFromState(s);
 
-    setDefaultActivation(getStateVariableValue(s,STATE_ACTIVATION_NAME));
-    setDefaultFiberLength(getStateVariableValue(s,STATE_FIBER_LENGTH_NAME));
-    setDefaultFiberVelocity(getStateVariableValue(s,STATE_FIBER_VELOCITY_NAME));
+    setDefaultActivation(getStateVariableValue(s, _activationSV));
+    setDefaultFiberLength(getStateVariableValue(s, _fiberLengthSV));
+    setDefaultFiberVelocity(getStateVariableValue(s, _fiberVelocitySV));
 }
 
 void Millard2012AccelerationMuscle::
@@ -302,9 +312,9 @@ void Millard2012AccelerationMuscle::
         vdot = getFiberAcceleration(s);
     }
 
-    setStateVariableDerivativeValue(s, STATE_ACTIVATION_NAME, adot);
-    setStateVariableDerivativeValue(s, STATE_FIBER_LENGTH_NAME, ldot);
-    setStateVariableDerivativeValue(s, STATE_FIBER_VELOCITY_NAME, vdot);
+    setStateVariableDerivativeValue(s, _activationSV, adot);
+    setStateVariableDerivativeValue(s, _fiberLengthSV, ldot);
+    setStateVariableDerivativeValue(s, _fiberVelocitySV, vdot);
 }
 
 //=============================================================================
@@ -375,27 +385,27 @@ void Millard2012AccelerationMuscle::
 void Millard2012AccelerationMuscle::
     setActivation(SimTK::State& s, double activation) const
 {
-    setStateVariableValue(s, STATE_ACTIVATION_NAME, activation);    
-    markCacheVariableInvalid(s,"dynamicsInfo");
+    setStateVariableValue(s, _activationSV, activation);    
+    markCacheVariableInvalid(s, _dynamicsInfoCV);
     
 }
 
 void Millard2012AccelerationMuscle::
     setFiberLength(SimTK::State& s, double fiberLength) const
 {
-    setStateVariableValue(s, STATE_FIBER_LENGTH_NAME, fiberLength);
-    markCacheVariableInvalid(s,"lengthInfo");
-    markCacheVariableInvalid(s,"velInfo");
-    markCacheVariableInvalid(s,"dynamicsInfo");
+    setStateVariableValue(s, _fiberLengthSV, fiberLength);
+    markCacheVariableInvalid(s, _lengthInfoCV);
+    markCacheVariableInvalid(s, _velInfoCV);
+    markCacheVariableInvalid(s, _dynamicsInfoCV);
     
 }
 
 void Millard2012AccelerationMuscle::
     setFiberVelocity(SimTK::State& s, double fiberVelocity) const
 {
-    setStateVariableValue(s, STATE_FIBER_VELOCITY_NAME, fiberVelocity);
-    markCacheVariableInvalid(s,"velInfo");
-    markCacheVariableInvalid(s,"dynamicsInfo");
+    setStateVariableValue(s, _fiberVelocitySV, fiberVelocity);
+    markCacheVariableInvalid(s, _velInfoCV);
+    markCacheVariableInvalid(s, _dynamicsInfoCV);
     
 }
 
@@ -735,6 +745,7 @@ void Millard2012AccelerationMuscle::
         int flag_status    = (int)soln[0];
         double solnErr        = soln[1];
         int iterations     = (int)soln[2];
+        OPENSIM_PROFILE_COUNT(*this, "equilibrium iterations", iterations);
         double fiberLength    = soln[3];
         double fiberVelocity  = soln[4];
         double passiveForce   = soln[5];
@@ -864,7 +875,7 @@ void Millard2012AccelerationMuscle::
             = get_FiberCompressiveForceCosPennationCurve(); 
 
         //Populate the output struct
-        mli.fiberLength       = getStateVariableValue(s, STATE_FIBER_LENGTH_NAME); 
+        mli.fiberLength       = getStateVariableValue(s, _fiberLengthSV); 
 
         mli.normFiberLength   = mli.fiberLength/optFiberLength;
         mli.pennationAngle    = m_penMdl.calcPennationAngle(mli.fiberLength);
@@ -990,7 +1001,7 @@ void Millard2012AccelerationMuscle::
         //=========================================================================
 
         //1. Get MuscleLengthInfo & available State information
-        double dlce   = getStateVariableValue(s, STATE_FIBER_VELOCITY_NAME);
+        double dlce   = getStateVariableValue(s, _fiberVelocitySV);
         double dlceN1  = dlce/(getMaxContractionVelocity()*optFiberLen);
         double lce    = mli.fiberLength;
         double phi    = mli.pennationAngle;
@@ -1062,7 +1073,7 @@ void Millard2012AccelerationMuscle::
         const FiberVelocityInfo &mvi = getFiberVelocityInfo(s);        
         
     //Get the state of this muscle
-        double a   = getStateVariableValue(s, STATE_ACTIVATION_NAME); 
+        double a   = getStateVariableValue(s, _activationSV); 
 
     //Get the properties of this muscle
         double mcl            = getLength(s);
@@ -24,6 +24,7 @@
 #include <OpenSim/Common/SimmMacros.h>
 #include <OpenSim/Common/DebugUtilities.h>
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/ComponentProfiler.h>
 #include <iostream>
 #include <OpenSim/Common/Exception.h>
 #include <SimTKcommon/internal/ExceptionMacros.h>
@@ -126,23 +127,42 @@ void Millard2012EquilibriumMuscle::buildMuscle()
 
         } else { //singularity-free model
             set_minimum_activation(clamp(0, get_minimum_activation(), 1));
-            falCurve.setMinValue(0.0);
-            fvCurve.setCurveShape(0.0, conSlopeNearVmax, isometricSlope,
-                                  0.0, eccSlopeNearVmax, eccForceMax);
+            // Setting a curve's properties rebuilds its splines, so leave
+            // those of a copied muscle, which already hold these values,
+            // and the splines it shares with the original, alone.
+            if(falCurve.getMinValue() != 0.0) {
+                falCurve.setMinValue(0.0);
+            }
+            if(conSlopeAtVmax != 0.0 || eccSlopeAtVmax != 0.0) {
+                fvCurve.setCurveShape(0.0, conSlopeNearVmax, isometricSlope,
+                                      0.0, eccSlopeNearVmax, eccForceMax);
+            }
         }
 
         if(conSlopeAtVmax < 0.1 || eccSlopeAtVmax < 0.1) {
             conSlopeAtVmax = 0.1;
             eccSlopeAtVmax = 0.1;
         }
-        fvInvCurve = ForceVelocityInverseCurve(conSlopeAtVmax,
-                                               conSlopeNearVmax,
-                                               isometricSlope,
-                                               eccSlopeAtVmax,
-                                               eccSlopeNearVmax,
-                                               eccForceMax,
-                                               conCurviness,
-                                               eccCurviness);
+        // Likewise, the inverse curve is rebuilt only if its shape changed.
+        if(fvInvCurve.getConcentricSlopeAtVmax() != conSlopeAtVmax
+            || fvInvCurve.getConcentricSlopeNearVmax() != conSlopeNearVmax
+            || fvInvCurve.getIsometricSlope() != isometricSlope
+            || fvInvCurve.getEccentricSlopeAtVmax() != eccSlopeAtVmax
+            || fvInvCurve.getEccentricSlopeNearVmax() != eccSlopeNearVmax
+            || fvInvCurve.getMaxEccentricVelocityForceMultiplier()
+                != eccForceMax
+            || fvInvCurve.getConcentricCurviness() != conCurviness
+            || fvInvCurve.getEccentricCurviness() != eccCurviness)
+        {
+            fvInvCurve = ForceVelocityInverseCurve(conSlopeAtVmax,
+                                                   conSlopeNearVmax,
+                                                   isometricSlope,
+                                                   eccSlopeAtVmax,
+                                                   eccSlopeNearVmax,
+                                                   eccForceMax,
+                                                   conCurviness,
+                                                   eccCurviness);
+        }
 
         // Ensure all sub-objects are up-to-date
         // TODO: Remove this once MuscleFixedWidthPennationModel has been made
@@ -317,10 +337,10 @@ setActivation(SimTK::State& s, double activation) const
         setControls(SimTK::Vector(1, activation), controls);
         _model->setControls(s, controls);
     } else {
-        setStateVariableValue(s, STATE_ACTIVATION_NAME, clampActivation(activation));
+        setStateVariableValue(s, _activationSV, clampActivation(activation));
     }
-    markCacheVariableInvalid(s,"velInfo");
-    markCacheVariableInvalid(s,"dynamicsInfo");
+    markCacheVariableInvalid(s, _velInfoCV);
+    markCacheVariableInvalid(s, _dynamicsInfoCV);
 }
 
 void Millard2012EquilibriumMuscle::setDefaultFiberLength(double fiberLength)
@@ -374,11 +394,11 @@ void Millard2012EquilibriumMuscle::
 setFiberLength(SimTK::State& s, double fiberLength) const
 {
     if(!get_ignore_tendon_compliance()) {
-        setStateVariableValue(s, STATE_FIBER_LENGTH_NAME,
+        setStateVariableValue(s, _fiberLengthSV,
                          clampFiberLength(fiberLength));
-        markCacheVariableInvalid(s,"lengthInfo");
-        markCacheVariableInvalid(s,"velInfo");
-        markCacheVariableInvalid(s,"dynamicsInfo");
+        markCacheVariableInvalid(s, _lengthInfoCV);
+        markCacheVariableInvalid(s, _velInfoCV);
+        markCacheVariableInvalid(s, _dynamicsInfoCV);
     }
 }
 
@@ -438,6 +458,7 @@ computeInitialFiberEquilibrium(SimTK::State& s) const
         flag_status   = (int)soln[0];
         solnErr       = soln[1];
         iterations    = (int)soln[2];
+        OPENSIM_PROFILE_COUNT(*this, "equilibrium iterations", iterations);
         fiberLength   = soln[3];
         fiberVelocity = soln[4];
         tendonForce   = soln[5];
@@ -551,6 +572,7 @@ computeFiberEquilibriumAtZeroVelocity(SimTK::State& s) const
         flag_status   = (int)soln[0];
         solnErr       = soln[1];
         iterations    = (int)soln[2];
+        OPENSIM_PROFILE_COUNT(*this, "equilibrium iterations", iterations);
         fiberLength   = soln[3];
         fiberVelocity = soln[4];
         tendonForce   = soln[5];
@@ -692,7 +714,7 @@ void Millard2012EquilibriumMuscle::calcMuscleLengthInfo(const SimTK::State& s,
                                 tendonSlackLen));
         } else {                                            // elastic tendon
             mli.fiberLength = clampFiberLength(
-                                getStateVariableValue(s, STATE_FIBER_LENGTH_NAME));
+                                getStateVariableValue(s, _fiberLengthSV));
         }
 
         mli.normFiberLength   = mli.fiberLength / optFiberLength;
@@ -822,7 +844,7 @@ calcFiberVelocityInfo(const SimTK::State& s, FiberVelocityInfo& fvi) const
 
             double a = SimTK::NaN;
             if(!get_ignore_activation_dynamics()) {
-                a = clampActivation(getStateVariableValue(s, STATE_ACTIVATION_NAME));
+                a = clampActivation(getStateVariableValue(s, _activationSV));
             } else {
                 a = clampActivation(getControl(s));
             }
@@ -856,7 +878,7 @@ calcFiberVelocityInfo(const SimTK::State& s, FiberVelocityInfo& fvi) const
 
             double a = SimTK::NaN;
             if(!get_ignore_activation_dynamics()) {
-                a = clampActivation(getStateVariableValue(s, STATE_ACTIVATION_NAME));
+                a = clampActivation(getStateVariableValue(s, _activationSV));
             } else {
                 a = clampActivation(getControl(s));
             }
@@ -964,7 +986,7 @@ calcMuscleDynamicsInfo(const SimTK::State& s, MuscleDynamicsInfo& mdi) const
         // Compute dynamic quantities.
         double a = SimTK::NaN;
         if(!get_ignore_activation_dynamics()) {
-            a = clampActivation(getStateVariableValue(s, STATE_ACTIVATION_NAME));
+            a = clampActivation(getStateVariableValue(s, _activationSV));
         } else {
             a = clampActivation(getControl(s));
         }
@@ -1104,10 +1126,17 @@ extendAddToSystem(SimTK::MultibodySystem& system) const
 
     double dummyValue = 0.0;
     if(!get_ignore_activation_dynamics()) {
-        addStateVariable(STATE_ACTIVATION_NAME);
+        _activationSV = addStateVariable(STATE_ACTIVATION_NAME);
     }
     if(!get_ignore_tendon_compliance()) {
-        addStateVariable(STATE_FIBER_LENGTH_NAME);
+        _fiberLengthSV = addStateVariable(STATE_FIBER_LENGTH_NAME);
+    }
+
+    // The integrals of the curves, for the potential energy, are otherwise
+    // built the first time they are used, possibly on several threads.
+    if(getModel().getUseThreadSafeEvaluation()) {
+        get_FiberForceLengthCurve().calcIntegral(1.0);
+        get_TendonForceLengthCurve().calcIntegral(1.0);
     }
 }
 
@@ -1130,10 +1159,10 @@ extendSetPropertiesFromState(const SimTK::State& s)
     Super::extendSetPropertiesFromState(s);
 
     if(!get_ignore_activation_dynamics()) {
-        setDefaultActivation(getStateVariableValue(s,STATE_ACTIVATION_NAME));
+        setDefaultActivation(getStateVariableValue(s, _activationSV));
     }
     if(!get_ignore_tendon_compliance()) {
-        setDefaultFiberLength(getStateVariableValue(s,STATE_FIBER_LENGTH_NAME));
+        setDefaultFiberLength(getStateVariableValue(s, _fiberLengthSV));
     }
 }
 
@@ -1147,7 +1176,7 @@ void Millard2012EquilibriumMuscle::
         if (!isDisabled(s) && !isActuationOverriden(s)) {
             adot =getActivationDerivative(s);
         }
-        setStateVariableDerivativeValue(s, STATE_ACTIVATION_NAME, adot);
+        setStateVariableDerivativeValue(s, _activationSV, adot);
     }
 
     // Fiber length is the next state (if it is a state at all)
@@ -1157,7 +1186,7 @@ void Millard2012EquilibriumMuscle::
         if (!isDisabled(s) && !isActuationOverriden(s)) {
             ldot = getFiberVelocity(s);
         }
-        setStateVariableDerivativeValue(s, STATE_FIBER_LENGTH_NAME, ldot);
+        setStateVariableDerivativeValue(s, _fiberLengthSV, ldot);
     }
 }
 
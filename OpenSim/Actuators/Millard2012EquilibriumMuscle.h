@@ -522,6 +522,10 @@ private:
     static const std::string STATE_ACTIVATION_NAME;
     // The name used to access the fiber length state.
     static const std::string STATE_FIBER_LENGTH_NAME;
+    // Handles to the state variables, assigned in extendAddToSystem() if the
+    // muscle has them.
+    mutable StateVariableHandle _activationSV;
+    mutable StateVariableHandle _fiberLengthSV;
 
     // Indicates whether fiber damping is included in the model (false if
     // dampingCoefficient < 0.001).
@@ -25,6 +25,8 @@
 //=============================================================================
 #include <OpenSim/Simulation/Model/Model.h>
 #include "Thelen2003Muscle.h"
+#include "Thelen2003MuscleBatch.h"
+#include <OpenSim/Common/ComponentProfiler.h>
 
 //=============================================================================
 // STATICS
@@ -378,6 +380,7 @@ void Thelen2003Muscle::computeInitialFiberEquilibrium(SimTK::State& s) const
         int flag_status    = (int)soln[0];
         double solnErr        = soln[1];
         int iterations     = (int)soln[2];
+        OPENSIM_PROFILE_COUNT(*this, "equilibrium iterations", iterations);
         double fiberLength    = soln[3];
         double passiveForce   = soln[4];
         double tendonForce    = soln[5];
@@ -492,7 +495,7 @@ void Thelen2003Muscle::calcMuscleLengthInfo(const SimTK::State& s,
 
         //Clamp the minimum fiber length to its minimum physical value.
         mli.fiberLength  = get_MuscleFixedWidthPennationModel().clampFiberLength(
-                                getStateVariableValue(s, STATE_FIBER_LENGTH_NAME));
+                                getStateVariableValue(s, _fiberLengthSV));
 
         mli.normFiberLength = mli.fiberLength/optFiberLength;       
         mli.pennationAngle  = get_MuscleFixedWidthPennationModel()
@@ -581,7 +584,7 @@ void Thelen2003Muscle::calcFiberVelocityInfo(const SimTK::State& s,
 
         //clamp activation to a legal range
         double a = get_MuscleFirstOrderActivationDynamicModel()
-            .clampActivation(getStateVariableValue(s, STATE_ACTIVATION_NAME));
+            .clampActivation(getStateVariableValue(s, _activationSV));
    
 
         double lce  = mli.fiberLength;   
@@ -725,7 +728,7 @@ void Thelen2003Muscle::calcMuscleDynamicsInfo(const SimTK::State& s,
 
         //1. Get fiber/tendon kinematic information
         double a = get_MuscleFirstOrderActivationDynamicModel()
-            .clampActivation(getStateVariableValue(s, STATE_ACTIVATION_NAME));
+            .clampActivation(getStateVariableValue(s, _activationSV));
 
         double lce      = mli.fiberLength;
         double fiberStateClamped = mvi.userDefinedVelocityExtras[1];
@@ -866,7 +869,7 @@ bool Thelen2003Muscle::
 
     //Is the fiber length  clamped and it is shortening, then the fiber length
     //not valid
-    if( (getStateVariableValue(s, STATE_FIBER_LENGTH_NAME) 
+    if( (getStateVariableValue(s, _fiberLengthSV) 
             <= getMinimumFiberLength())
         && dlceN <= 0){
         clamped = true;
@@ -894,6 +897,14 @@ double Thelen2003Muscle::calcActivationRate(const SimTK::State& s) const
 
 
 
+MuscleBatch* Thelen2003Muscle::
+    createMuscleBatch(const std::vector<const Muscle*>& muscles) const
+{
+    if (getConcreteClassName() != "Thelen2003Muscle")
+        return nullptr;
+    return new Thelen2003MuscleBatch(muscles);
+}
+
 //==============================================================================
 // Numerical Guts: Initialization
 //==============================================================================
@@ -268,6 +268,12 @@ protected:
     /** Calculate activation rate */
     double calcActivationRate(const SimTK::State& s) const override; 
 
+    /** Return a Thelen2003MuscleBatch of the muscles. Classes derived from
+    Thelen2003Muscle get none, since they may compute their info
+    differently. */
+    MuscleBatch* createMuscleBatch(
+        const std::vector<const Muscle*>& muscles) const override;
+
     /** Component interface. */
     void extendFinalizeFromProperties() override;
 
@@ -352,6 +358,8 @@ private:
     void printMatrixToFile(SimTK::Matrix& data, SimTK::Array_<std::string>& colNames,
     const std::string& path, const std::string& filename) const;
 
+    friend class Thelen2003MuscleBatch;
+
 };    
 } // end of namespace OpenSim
 
@@ -0,0 +1,494 @@
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  Thelen2003MuscleBatch.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "Thelen2003MuscleBatch.h"
+#include "Thelen2003Muscle.h"
+
+using namespace std;
+using namespace OpenSim;
+using namespace SimTK;
+
+//=============================================================================
+// CURVES
+//=============================================================================
+// The curves of Thelen2003Muscle, with the constants that do not depend on
+// the state computed once per muscle. Each is written as in
+// Thelen2003Muscle.cpp, so that it gives the same result to the last bit.
+namespace {
+
+inline double calcfal(double lceN, double kShapeActive)
+{
+    double x=(lceN-1.)*(lceN-1.);
+    return exp(-x/kShapeActive);
+}
+
+inline double calcDfalDlceN(double lceN, double kShapeActive)
+{
+    double t1 = lceN - 0.10e1;
+    double t2 = 0.1e1 / kShapeActive;
+    double t4 = t1 * t1;
+    double t6 = exp(-t4 * t2);
+    return -0.2e1 * t1 * t2 * t6;
+}
+
+inline double calcfpe(double lceN, double kpe, double e0, double expKpeMinus1)
+{
+    if(lceN > 1.0){
+        double t5 = exp(kpe * (lceN - 0.10e1) / e0);
+        return (t5 - 0.10e1) / expKpeMinus1;
+    }
+    return 0;
+}
+
+inline double calcDfpeDlceN(double lceN, double kpe, double e0,
+                            double expKpeMinus1)
+{
+    if(lceN > 1.0){
+        double t1 = 0.1e1 / e0;
+        double t6 = exp(kpe * (lceN - 0.10e1) * t1);
+        return kpe * t1 * t6 / expKpeMinus1;
+    }
+    return 0;
+}
+
+inline double calcfse(double tlN, double eToe, double klin)
+{
+    double x = tlN-1;
+    double kToe = 3.0;
+    double Ftoe = 33.0/100.0;
+    if (x > eToe){
+        return klin*(x-eToe)+Ftoe;
+    }else if (x>0.0){
+        return (Ftoe/(exp(kToe)-1.0))*(exp(kToe*x/eToe)-1.0);
+    }
+    return 0.;
+}
+
+inline double calcDfseDtlN(double tlN, double eToe, double klin)
+{
+    double x = tlN-1;
+    double kToe = 3.0;
+    double Ftoe = 33.0/100.0;
+    if (x > eToe){
+        return klin;
+    }else if (x>0.0){
+        return (Ftoe/(exp(kToe)-1.0)) * (kToe/eToe) * (exp(kToe*x/eToe));
+    }
+    return 0.;
+}
+
+// Thelen2003Muscle::calcdlceN(): the normalized fiber velocity, from
+// Thelen 2003 Eqns 6 & 7, extrapolated linearly beyond the asymptotes.
+inline double calcdlceN(double a, double fal, double Fm, double af,
+                        double flen, double asyE_thresh)
+{
+    double afl  = a*fal;
+    double b = 0;
+    double db= 0;
+    double Fm_asyC = 0;
+    double Fm_asyE = afl*flen;
+
+    if (Fm > Fm_asyC && Fm < Fm_asyE*asyE_thresh){
+        if( Fm <= afl ){
+            b = afl + Fm/af;
+        }else{
+            b = ((2+2/af)*(afl*flen-Fm))/(flen-1);
+        }
+        return (0.25 + 0.75*a)*(Fm-afl)/b;
+    }
+
+    double Fm0 = 0.0;
+    if(Fm <= Fm_asyC){
+        Fm0 = Fm_asyC;
+        b = afl + Fm0/af;
+        db= 1/af;
+    }else{
+        Fm0 = asyE_thresh*Fm_asyE;
+        b = ((2+2/af)*(afl*flen-Fm0))/(flen-1);
+        db= ((2+2/af)*(-1))/(flen-1);
+    }
+    double dlce0 = (0.25 + 0.75*a)*(Fm0-afl)/b;
+    double dlcedFm = (0.25 + 0.75*a)*(1)/b
+                   - ((0.25 + 0.75*a)*(Fm0-afl)/(b*b))*db;
+    return dlce0 + dlcedFm*(Fm-Fm0);
+}
+
+// The indices of the muscles being computed and their inputs and outputs,
+// one column per quantity. Each thread, and each kind of info, has its own,
+// so a batch can be used from several threads and the velocity info can ask
+// for the length info while gathering.
+struct Workspace {
+    std::vector<int> muscles;
+    std::vector<double> data;
+
+    double* resize(int numColumns) {
+        data.resize(numColumns*muscles.size());
+        return data.empty() ? NULL : &data[0];
+    }
+};
+
+enum { LengthWorkspace, VelocityWorkspace, DynamicsWorkspace };
+
+Workspace& getWorkspace(int which)
+{
+    thread_local Workspace workspaces[3];
+    return workspaces[which];
+}
+
+} // anonymous namespace
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+Thelen2003MuscleBatch::
+Thelen2003MuscleBatch(const std::vector<const Muscle*>& muscles)
+{
+    for (size_t i = 0; i < muscles.size(); ++i) {
+        const Thelen2003Muscle& m =
+            dynamic_cast<const Thelen2003Muscle&>(*muscles[i]);
+        _muscles.push_back(&m);
+
+        _maxIsometricForce.push_back(m.getMaxIsometricForce());
+        _optimalFiberLength.push_back(m.getOptimalFiberLength());
+        _tendonSlackLength.push_back(m.getTendonSlackLength());
+        _maxContractionVelocity.push_back(m.getMaxContractionVelocity());
+        _minimumActivation.push_back(m.get_MuscleFirstOrderActivationDynamicModel()
+                                     .get_minimum_activation());
+
+        const MuscleFixedWidthPennationModel& penMdl =
+            m.get_MuscleFixedWidthPennationModel();
+        _pennated.push_back(penMdl.get_pennation_angle_at_optimal() > Eps);
+        _minimumFiberLength.push_back(penMdl.getMinimumFiberLength());
+        _parallelogramHeight.push_back(penMdl.getParallelogramHeight());
+        _maximumSinPennation.push_back(
+            sin(penMdl.get_maximum_pennation_angle()));
+        _maximumPennationAngle.push_back(penMdl.get_maximum_pennation_angle());
+
+        _kShapeActive.push_back(m.get_KshapeActive());
+        _kShapePassive.push_back(m.get_KshapePassive());
+        _fmaxMuscleStrain.push_back(m.get_FmaxMuscleStrain());
+        _expKShapePassiveMinusOne.push_back(exp(m.get_KshapePassive())
+                                            - 0.10e1);
+
+        // As in Thelen2003Muscle::calcfse()
+        double e0 = m.get_FmaxTendonStrain();
+        double t1   = exp(0.3e1);
+        double eToe = (0.99e2*e0*t1) / (0.166e3*t1 - 0.67e2);
+        t1 = exp(0.3e1);
+        double klin = (0.67e2/0.100e3)
+                    * 1.0/(e0 - (0.99e2*e0*t1) / (0.166e3*t1 - 0.67e2));
+        _eToe.push_back(eToe);
+        _kLin.push_back(klin);
+
+        _af.push_back(m.get_Af());
+        _flen.push_back(m.get_Flen());
+        _fvLinearExtrapThreshold.push_back(m.get_fv_linear_extrap_threshold());
+    }
+}
+
+//=============================================================================
+// COMPUTATIONS
+//=============================================================================
+// Thelen2003Muscle::calcMuscleLengthInfo()
+void Thelen2003MuscleBatch::
+computeMuscleLengthInfo(const SimTK::State& s) const
+{
+    Workspace& ws = getWorkspace(LengthWorkspace);
+    ws.muscles.clear();
+    for (int i = 0; i < getNumMuscles(); ++i)
+        if (!isMuscleLengthInfoValid(*_muscles[i], s))
+            ws.muscles.push_back(i);
+    const int n = (int)ws.muscles.size();
+    if (n == 0) return;
+
+    // Gather
+    double* col = ws.resize(13);
+    double* mclLength = col;         double* fiberLengthState = col + n;
+    double* lce     = col + 2*n;     double* lceN   = col + 3*n;
+    double* phi     = col + 4*n;     double* cosphi = col + 5*n;
+    double* sinphi  = col + 6*n;     double* lceAT  = col + 7*n;
+    double* tl      = col + 8*n;     double* tlN    = col + 9*n;
+    double* strain  = col + 10*n;    double* fpe    = col + 11*n;
+    double* fal     = col + 12*n;
+    for (int k = 0; k < n; ++k) {
+        const Thelen2003Muscle& m = *_muscles[ws.muscles[k]];
+        mclLength[k] = m.getLength(s);
+        fiberLengthState[k] = m.getStateVariableValue(s, m._fiberLengthSV);
+    }
+
+    // Compute
+    for (int k = 0; k < n; ++k) {
+        const int i = ws.muscles[k];
+        lce[k] = max(_minimumFiberLength[i], fiberLengthState[k]);
+        lceN[k] = lce[k]/_optimalFiberLength[i];
+        double p = 0;
+        if (_pennated[i]) {
+            if (lce[k] > _minimumFiberLength[i]) {
+                double sin_phi = _parallelogramHeight[i]/lce[k];
+                p = (sin_phi < _maximumSinPennation[i]) ?
+                    asin(sin_phi) : _maximumPennationAngle[i];
+            } else {
+                p = _maximumPennationAngle[i];
+            }
+        }
+        phi[k] = p;
+        cosphi[k] = cos(p);
+        sinphi[k] = sin(p);
+        lceAT[k] = lce[k]*cosphi[k];
+        tl[k] = mclLength[k] - lce[k]*cosphi[k];
+        tlN[k] = tl[k] / _tendonSlackLength[i];
+        strain[k] = tlN[k] - 1.0;
+        fpe[k] = calcfpe(lceN[k], _kShapePassive[i], _fmaxMuscleStrain[i],
+                         _expKShapePassiveMinusOne[i]);
+        fal[k] = calcfal(lceN[k], _kShapeActive[i]);
+    }
+
+    // Scatter
+    for (int k = 0; k < n; ++k) {
+        const Thelen2003Muscle& m = *_muscles[ws.muscles[k]];
+        Muscle::MuscleLengthInfo& mli = updMuscleLengthInfo(m, s);
+        mli.fiberLength = lce[k];
+        mli.normFiberLength = lceN[k];
+        mli.pennationAngle = phi[k];
+        mli.cosPennationAngle = cosphi[k];
+        mli.sinPennationAngle = sinphi[k];
+        mli.fiberLengthAlongTendon = lceAT[k];
+        mli.tendonLength = tl[k];
+        mli.normTendonLength = tlN[k];
+        mli.tendonStrain = strain[k];
+        mli.fiberPassiveForceLengthMultiplier = fpe[k];
+        mli.fiberActiveForceLengthMultiplier = fal[k];
+        markMuscleLengthInfoValid(m, s);
+    }
+}
+
+// Thelen2003Muscle::calcFiberVelocityInfo()
+void Thelen2003MuscleBatch::
+computeFiberVelocityInfo(const SimTK::State& s) const
+{
+    Workspace& ws = getWorkspace(VelocityWorkspace);
+    ws.muscles.clear();
+    for (int i = 0; i < getNumMuscles(); ++i)
+        if (!isFiberVelocityInfoValid(*_muscles[i], s))
+            ws.muscles.push_back(i);
+    const int n = (int)ws.muscles.size();
+    if (n == 0) return;
+
+    // Gather
+    double* col = ws.resize(18);
+    double* a      = col;            double* lce    = col + n;
+    double* phi    = col + 2*n;      double* cosphi = col + 3*n;
+    double* sinphi = col + 4*n;      double* tl     = col + 5*n;
+    double* fal    = col + 6*n;      double* fpe    = col + 7*n;
+    double* dmcldt = col + 8*n;      double* fiberLengthState = col + 9*n;
+    double* fse    = col + 10*n;     double* fv     = col + 11*n;
+    double* dlceN  = col + 12*n;     double* dlce   = col + 13*n;
+    double* dphidt = col + 14*n;     double* dlceAT = col + 15*n;
+    double* dtl    = col + 16*n;     double* clamped = col + 17*n;
+    for (int k = 0; k < n; ++k) {
+        const int i = ws.muscles[k];
+        const Thelen2003Muscle& m = *_muscles[i];
+        const Muscle::MuscleLengthInfo& mli = m.getMuscleLengthInfo(s);
+        a[k] = SimTK::clamp(_minimumActivation[i],
+                            m.getStateVariableValue(s, m._activationSV), 1.0);
+        lce[k] = mli.fiberLength;
+        phi[k] = mli.pennationAngle;
+        cosphi[k] = mli.cosPennationAngle;
+        sinphi[k] = mli.sinPennationAngle;
+        tl[k] = mli.tendonLength;
+        fal[k] = mli.fiberActiveForceLengthMultiplier;
+        fpe[k] = mli.fiberPassiveForceLengthMultiplier;
+        dmcldt[k] = m.getLengtheningSpeed(s);
+        fiberLengthState[k] = m.getStateVariableValue(s, m._fiberLengthSV);
+    }
+
+    // Compute
+    for (int k = 0; k < n; ++k) {
+        const int i = ws.muscles[k];
+        fse[k] = calcfse(tl[k]/_tendonSlackLength[i], _eToe[i], _kLin[i]);
+        double afalfv = ((fse[k]/cosphi[k])-fpe[k]);
+        fv[k] = afalfv/(a[k]*fal[k]);
+        dlceN[k] = calcdlceN(a[k], fal[k], afalfv, _af[i], _flen[i],
+                             _fvLinearExtrapThreshold[i]);
+        dlce[k] = dlceN[k]*_maxContractionVelocity[i]*_optimalFiberLength[i];
+        double tanPhi = tan(phi[k]);
+        dphidt[k] = 0;
+        if (_pennated[i]) {
+            if (!(lce[k] > 0))
+                throw Exception("Thelen2003MuscleBatch: fiber length of "
+                    + _muscles[i]->getName() + " cannot be zero.",
+                    __FILE__, __LINE__);
+            dphidt[k] = -(dlce[k]/lce[k]) * tanPhi;
+        }
+        dlceAT[k] = dlce[k]*cosphi[k] - lce[k]*sinphi[k]*dphidt[k];
+        dtl[k] = dmcldt[k] - dlce[k]*cosphi[k]
+               + lce[k]*sinphi[k]*dphidt[k];
+        clamped[k] = 0.0;
+        // The fiber length is clamped and the fiber is shortening.
+        if (fiberLengthState[k] <= _minimumFiberLength[i] && dlceN[k] <= 0) {
+            dlce[k] = 0;
+            dlceAT[k] = 0;
+            dlceN[k] = 0;
+            dphidt[k] = 0;
+            dtl[k] = dmcldt[k];
+            fv[k] = 1.0;
+            clamped[k] = 1.0;
+        }
+    }
+
+    // Scatter
+    for (int k = 0; k < n; ++k) {
+        const int i = ws.muscles[k];
+        const Thelen2003Muscle& m = *_muscles[i];
+        Muscle::FiberVelocityInfo& fvi = updFiberVelocityInfo(m, s);
+        fvi.fiberVelocity = dlce[k];
+        fvi.fiberVelocityAlongTendon = dlceAT[k];
+        fvi.normFiberVelocity = dlceN[k];
+        fvi.pennationAngularVelocity = dphidt[k];
+        fvi.tendonVelocity = dtl[k];
+        fvi.normTendonVelocity = dtl[k]/_tendonSlackLength[i];
+        fvi.fiberForceVelocityMultiplier = fv[k];
+        fvi.userDefinedVelocityExtras.resize(2);
+        fvi.userDefinedVelocityExtras[0] = fse[k];
+        fvi.userDefinedVelocityExtras[1] = clamped[k];
+        markFiberVelocityInfoValid(m, s);
+    }
+}
+
+// Thelen2003Muscle::calcMuscleDynamicsInfo()
+void Thelen2003MuscleBatch::
+computeMuscleDynamicsInfo(const SimTK::State& s) const
+{
+    Workspace& ws = getWorkspace(DynamicsWorkspace);
+    ws.muscles.clear();
+    for (int i = 0; i < getNumMuscles(); ++i)
+        if (!isMuscleDynamicsInfoValid(*_muscles[i], s))
+            ws.muscles.push_back(i);
+    const int n = (int)ws.muscles.size();
+    if (n == 0) return;
+
+    // Gather
+    double* col = ws.resize(23);
+    double* a      = col;            double* lce    = col + n;
+    double* cosphi = col + 2*n;      double* clamped = col + 3*n;
+    double* dlce   = col + 4*n;      double* tl     = col + 5*n;
+    double* dtl    = col + 6*n;      double* fal    = col + 7*n;
+    double* fpe    = col + 8*n;      double* fv     = col + 9*n;
+    double* fse    = col + 10*n;     double* dmcldt = col + 11*n;
+    double* aFm    = col + 12*n;     double* Fm     = col + 13*n;
+    double* dFm_dlce = col + 14*n;   double* dFmAT_dlceAT = col + 15*n;
+    double* dFt_dtl = col + 16*n;    double* Ke     = col + 17*n;
+    double* dFibPEdt = col + 18*n;   double* dTdnPEdt = col + 19*n;
+    double* dFibWdt = col + 20*n;    double* dBoundaryWdt = col + 21*n;
+    double* ddt_KEPEmW = col + 22*n;
+    for (int k = 0; k < n; ++k) {
+        const int i = ws.muscles[k];
+        const Thelen2003Muscle& m = *_muscles[i];
+        const Muscle::MuscleLengthInfo& mli = m.getMuscleLengthInfo(s);
+        const Muscle::FiberVelocityInfo& mvi = m.getFiberVelocityInfo(s);
+        a[k] = SimTK::clamp(_minimumActivation[i],
+                            m.getStateVariableValue(s, m._activationSV), 1.0);
+        lce[k] = mli.fiberLength;
+        cosphi[k] = mli.cosPennationAngle;
+        clamped[k] = mvi.userDefinedVelocityExtras[1];
+        dlce[k] = mvi.fiberVelocity;
+        tl[k] = mli.tendonLength;
+        dtl[k] = mvi.tendonVelocity;
+        fal[k] = mli.fiberActiveForceLengthMultiplier;
+        fpe[k] = mli.fiberPassiveForceLengthMultiplier;
+        fv[k] = mvi.fiberForceVelocityMultiplier;
+        fse[k] = mvi.userDefinedVelocityExtras[0];
+        dmcldt[k] = m.getLengtheningSpeed(s);
+    }
+
+    // Compute
+    for (int k = 0; k < n; ++k) {
+        const int i = ws.muscles[k];
+        const double fiso = _maxIsometricForce[i];
+        const double ofl = _optimalFiberLength[i];
+        const double tsl = _tendonSlackLength[i];
+        aFm[k] = 0;
+        Fm[k] = 0;
+        dFm_dlce[k] = 0;
+        dFmAT_dlceAT[k] = 0;
+        dFt_dtl[k] = 0;
+        Ke[k] = 0;
+        if (clamped[k] < 0.5) {
+            aFm[k] = (a[k]*fal[k]*fv[k])*fiso;
+            Fm[k] = (a[k]*fal[k]*fv[k] + fpe[k])*fiso;
+
+            double lceN = lce[k]/ofl;
+            double dfal_d_lceN = calcDfalDlceN(lceN, _kShapeActive[i]);
+            double dfpe_d_lceN = calcDfpeDlceN(lceN, _kShapePassive[i],
+                _fmaxMuscleStrain[i], _expKShapePassiveMinusOne[i]);
+            dFm_dlce[k] = ((a[k]*fv[k])*dfal_d_lceN + dfpe_d_lceN)*fiso
+                          *(1/ofl);
+
+            double tmp1 = _parallelogramHeight[i]*_parallelogramHeight[i];
+            double tmp2 = lce[k]*lce[k];
+            double tmp3 = tmp2*lce[k];
+            double dcosphi_d_lce = (tmp1 /(tmp3*pow((1-(tmp1/tmp2)),0.5) ));
+            double dFmAT_dlce = dFm_dlce[k]*cosphi[k] + Fm[k]*dcosphi_d_lce;
+            dFmAT_dlceAT[k] = dFmAT_dlce*cosphi[k];
+
+            dFt_dtl[k] = calcDfseDtlN(tl[k]/tsl, _eToe[i], _kLin[i])
+                         *(fiso/tsl);
+            Ke[k] = (dFmAT_dlceAT[k]*dFt_dtl[k])
+                    /(dFmAT_dlceAT[k]+dFt_dtl[k]);
+        }
+        dFibPEdt[k] = fpe[k]*fiso*dlce[k];
+        dTdnPEdt[k] = fse[k]*fiso*dtl[k];
+        dFibWdt[k] = -aFm[k]*dlce[k];
+        dBoundaryWdt[k] = (fse[k]*fiso) * dmcldt[k];
+        ddt_KEPEmW[k] = dFibPEdt[k]+dTdnPEdt[k]-dFibWdt[k]-dBoundaryWdt[k];
+    }
+
+    // Scatter
+    for (int k = 0; k < n; ++k) {
+        const int i = ws.muscles[k];
+        const Thelen2003Muscle& m = *_muscles[i];
+        const double fiso = _maxIsometricForce[i];
+        Muscle::MuscleDynamicsInfo& mdi = updMuscleDynamicsInfo(m, s);
+        mdi.activation = a[k];
+        mdi.fiberForce = Fm[k];
+        mdi.fiberForceAlongTendon = Fm[k]*cosphi[k];
+        mdi.normFiberForce = Fm[k]/fiso;
+        mdi.activeFiberForce = aFm[k];
+        mdi.passiveFiberForce = fpe[k]*fiso;
+        mdi.tendonForce = fse[k]*fiso;
+        mdi.normTendonForce = fse[k];
+        mdi.fiberStiffness = dFm_dlce[k];
+        mdi.fiberStiffnessAlongTendon = dFmAT_dlceAT[k];
+        mdi.tendonStiffness = dFt_dtl[k];
+        mdi.muscleStiffness = Ke[k];
+        mdi.userDefinedDynamicsExtras.resize(1);
+        mdi.userDefinedDynamicsExtras[0] = ddt_KEPEmW[k];
+        mdi.fiberActivePower = dFibWdt[k];
+        mdi.fiberPassivePower = -dFibPEdt[k];
+        mdi.tendonPower = -dTdnPEdt[k];
+        mdi.musclePower = -dBoundaryWdt[k];
+        markMuscleDynamicsInfoValid(m, s);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef OPENSIM_THELEN_2003_MUSCLE_BATCH_H_
+#define OPENSIM_THELEN_2003_MUSCLE_BATCH_H_
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  Thelen2003MuscleBatch.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Actuators/osimActuatorsDLL.h>
+#include <OpenSim/Simulation/Model/MuscleBatch.h>
+#include <vector>
+
+namespace OpenSim {
+
+class Thelen2003Muscle;
+
+//=============================================================================
+//=============================================================================
+/**
+ * Computes the length, velocity and dynamics info of many Thelen2003Muscles
+ * together (see MuscleBatch). The parameters of the muscles are held in one
+ * array per parameter. The path lengths, speeds and states of the muscles
+ * whose info is needed are gathered into arrays, their curves evaluated in
+ * one loop over the arrays, and the results scattered back into the cache of
+ * each muscle. The expressions are those of Thelen2003Muscle, evaluated in
+ * the same order, so the results are identical.
+ *
+ * Created by Thelen2003Muscle::createMuscleBatch().
+ *
+ * @author Ajay Seth
+ */
+class OSIMACTUATORS_API Thelen2003MuscleBatch : public MuscleBatch {
+public:
+    explicit Thelen2003MuscleBatch(const std::vector<const Muscle*>& muscles);
+
+    void computeMuscleLengthInfo(const SimTK::State& s) const override;
+    void computeFiberVelocityInfo(const SimTK::State& s) const override;
+    void computeMuscleDynamicsInfo(const SimTK::State& s) const override;
+
+    int getNumMuscles() const { return (int)_muscles.size(); }
+
+private:
+    std::vector<const Thelen2003Muscle*> _muscles;
+
+    // The parameters of the muscles, in the order of _muscles.
+    std::vector<double> _maxIsometricForce;
+    std::vector<double> _optimalFiberLength;
+    std::vector<double> _tendonSlackLength;
+    std::vector<double> _maxContractionVelocity;
+    std::vector<double> _minimumActivation;
+    // Of the pennation model.
+    std::vector<char>   _pennated;
+    std::vector<double> _minimumFiberLength;
+    std::vector<double> _parallelogramHeight;
+    std::vector<double> _maximumSinPennation;
+    std::vector<double> _maximumPennationAngle;
+    // Of the curves.
+    std::vector<double> _kShapeActive;
+    std::vector<double> _kShapePassive;
+    std::vector<double> _fmaxMuscleStrain;
+    std::vector<double> _expKShapePassiveMinusOne;
+    std::vector<double> _eToe;
+    std::vector<double> _kLin;
+    std::vector<double> _af;
+    std::vector<double> _flen;
+    std::vector<double> _fvLinearExtrapThreshold;
+
+//=============================================================================
+};  // END of class Thelen2003MuscleBatch
+//=============================================================================
+//=============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_THELEN_2003_MUSCLE_BATCH_H_
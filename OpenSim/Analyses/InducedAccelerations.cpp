@@ -24,8 +24,14 @@
 //=============================================================================
 // INCLUDES
 //=============================================================================
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <OpenSim/Common/IO.h>
 #include <OpenSim/Common/FunctionSet.h>
 #include <OpenSim/Simulation/Model/Model.h>
@@ -75,6 +81,7 @@ InducedAccelerations::InducedAccelerations(Model *aModel) :
     _forceThreshold(_forceThresholdProp.getValueDbl()),
     _computePotentialsOnly(_computePotentialsOnlyProp.getValueBool()),
     _reportConstraintReactions(_reportConstraintReactionsProp.getValueBool()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _bodySet(*new BodySet()),
     _coordSet(*new CoordinateSet())
 {
@@ -103,6 +110,7 @@ InducedAccelerations::InducedAccelerations(const std::string &aFileName):
     _forceThreshold(_forceThresholdProp.getValueDbl()),
     _computePotentialsOnly(_computePotentialsOnlyProp.getValueBool()),
     _reportConstraintReactions(_reportConstraintReactionsProp.getValueBool()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _bodySet(*new BodySet()),
     _coordSet(*new CoordinateSet())
 {
@@ -127,6 +135,7 @@ InducedAccelerations::InducedAccelerations(const InducedAccelerations &aInducedA
     _forceThreshold(_forceThresholdProp.getValueDbl()),
     _computePotentialsOnly(_computePotentialsOnlyProp.getValueBool()),
     _reportConstraintReactions(_reportConstraintReactionsProp.getValueBool()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _bodySet(*new BodySet()),
     _coordSet(*new CoordinateSet())
 {
@@ -160,6 +169,7 @@ operator=(const InducedAccelerations &aInducedAccelerations)
     _forceThreshold = aInducedAccelerations._forceThreshold;
     _computePotentialsOnly = aInducedAccelerations._computePotentialsOnly;
     _reportConstraintReactions = aInducedAccelerations._reportConstraintReactions;
+    _numThreads = aInducedAccelerations._numThreads;
     _includeCOM = aInducedAccelerations._includeCOM;
     return(*this);
 }
@@ -179,6 +189,7 @@ void InducedAccelerations::setNull()
     _bodyNames[0] = CENTER_OF_MASS_NAME;
     _computePotentialsOnly = false;
     _reportConstraintReactions = false;
+    _numThreads = 1;
     // Analysis does not own contents of these sets
     _coordSet.setMemoryOwner(false);
     _bodySet.setMemoryOwner(false);
@@ -221,6 +232,11 @@ void InducedAccelerations::setupProperties()
     _reportConstraintReactionsProp.setName("report_constraint_reactions");
     _reportConstraintReactionsProp.setComment("Report individual contributions to constraint reactions in addition to accelerations.");
     _propertySet.append(&_reportConstraintReactionsProp);
+
+    _numThreadsProp.setName("number_of_threads");
+    _numThreadsProp.setComment("Number of threads used to solve for the contributors concurrently. "
+        "Only used when no contact constraints are applied; each thread uses its own copy of the model.");
+    _propertySet.append(&_numThreadsProp);
 }
 
 //=============================================================================
@@ -490,6 +506,37 @@ void InducedAccelerations::setModel(Model &aModel)
 }
 
 
+//_____________________________________________________________________________
+/**
+ * Set up the workers that solve for the contributors: the first uses the
+ * analysis' own model and default state; with more than one thread and no
+ * contact constraints, each of the others uses a copy of the model.
+ */
+void InducedAccelerations::setupWorkers()
+{
+    _workers.clear();
+    int numWorkers = _constraintSet.getSize() > 0 ? 1 :
+        std::max(1, std::min(_numThreads, _contributors.getSize()));
+
+    for(int w=0; w<numWorkers; w++){
+        std::unique_ptr<Worker> worker(new Worker());
+        if(w == 0){
+            worker->model = _model;
+            worker->state = _model->getWorkingState();
+        }
+        else{
+            worker->ownedModel.reset(_model->clone());
+            worker->model = worker->ownedModel.get();
+            worker->state = worker->model->initSystem();
+        }
+        for(int i=0;i<_coordSet.getSize();i++)
+            worker->coordinates.push_back(&worker->model->getCoordinateSet().get(_coordSet.get(i).getName()));
+        for(int i=0;i<_bodySet.getSize();i++)
+            worker->bodies.push_back(&worker->model->getBodySet().get(_bodySet.get(i).getName()));
+        _workers.push_back(std::move(worker));
+    }
+}
+
 //=============================================================================
 // ANALYSIS
 //=============================================================================
@@ -507,7 +554,6 @@ void InducedAccelerations::setModel(Model &aModel)
  */
 int InducedAccelerations::record(const SimTK::State& s)
 {
-    int nu = _model->getNumSpeeds();
     double aT = s.getTime();
     cout << "time = " << aT << endl;
 
@@ -527,273 +573,351 @@ int InducedAccelerations::record(const SimTK::State& s)
     _comIndAccs.setSize(0);
     _constraintReactions.setSize(0);
 
-    SimTK::State s_analysis = _model->getWorkingState();
-
-    _model->initStateWithoutRecreatingSystem(s_analysis);
-    // Just need to set current time and position to determine state of constraints
-    s_analysis.setTime(aT);
-    s_analysis.setQ(Q);
-
-    // Check the external forces and determine if contact constraints should be applied at this time
-    // and turn constraint on if it should be.
-    Array<bool> constraintOn = applyContactConstraintAccordingToExternalForces(s_analysis);
-
-    // Hang on to a state that has the right flags for contact constraints turned on/off
-    _model->setPropertiesFromState(s_analysis);
-    // Use this state for the remainder of this step (record)
-    s_analysis = _model->getMultibodySystem().realizeTopology();
-    // DO NOT recreate the system, will lose location of constraint
-    _model->initStateWithoutRecreatingSystem(s_analysis);
-
-    // Cycle through the force contributors to the system acceleration
-    for(int c=0; c< _contributors.getSize(); c++){          
-        //cout << "Solving for contributor: " << _contributors[c] << endl;
-        // Need to be at the dynamics stage to disable a force
-        _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Dynamics);
-        
-        if(_contributors[c] == "total"){
-            // Set gravity ON
-            _model->getGravityForce().enable(s_analysis);
-
-            //Use same conditions on constraints
-            s_analysis.setTime(aT);
-            // Set the configuration (gen. coords and speeds) of the model.
-            s_analysis.setQ(Q);
-            s_analysis.setU(s.getU());
-            s_analysis.setZ(s.getZ());
-
-            //Make sure all the actuators are on!
-            for(int f=0; f<_model->getActuators().getSize(); f++){
-                _model->updActuators().get(f).setDisabled(s_analysis, false);
+    // Accelerations induced by each contributor, in the order of the
+    // coordinates, bodies (6 each), center of mass and constraint reactions
+    int nContributors = _contributors.getSize();
+    std::vector<Array<double> > induced(nContributors);
+    Array<bool> constraintOn(false, 0);
+
+    if(_constraintSet.getSize() > 0){
+        SimTK::State s_analysis = _model->getWorkingState();
+
+        _model->initStateWithoutRecreatingSystem(s_analysis);
+        // Just need to set current time and position to determine state of constraints
+        s_analysis.setTime(aT);
+        s_analysis.setQ(Q);
+
+        // Check the external forces and determine if contact constraints should be applied at this time
+        // and turn constraint on if it should be.
+        constraintOn = applyContactConstraintAccordingToExternalForces(s_analysis);
+
+        // Hang on to a state that has the right flags for contact constraints turned on/off
+        _model->setPropertiesFromState(s_analysis);
+        // Use this state for the remainder of this step (record)
+        s_analysis = _model->getMultibodySystem().realizeTopology();
+        // DO NOT recreate the system, will lose location of constraint
+        _model->initStateWithoutRecreatingSystem(s_analysis);
+
+        // Cycle through the force contributors to the system acceleration
+        for(int c=0; c<nContributors; c++)
+            solveForContributor(*_workers[0], s_analysis, s, _contributors[c], constraintOn, induced[c]);
+    }
+    else if(_workers.size() == 1){
+        // Without contact constraints the topology does not change, so start
+        // from the default state rather than realizing the topology again
+        SimTK::State s_analysis = _workers[0]->state;
+        s_analysis.setTime(aT);
+        s_analysis.setQ(Q);
+
+        for(int c=0; c<nContributors; c++)
+            solveForContributor(*_workers[0], s_analysis, s, _contributors[c], constraintOn, induced[c]);
+    }
+    else{
+        // Each thread takes the next contributor until there are none left,
+        // starting from its model's default state. The first exception thrown
+        // is rethrown on this thread once all are done.
+        std::atomic<int> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        auto solve = [&](Worker& worker) {
+            for (int c = next++; c < nContributors; c = next++) {
+                try {
+                    SimTK::State s_analysis = worker.state;
+                    s_analysis.setTime(aT);
+                    s_analysis.setQ(Q);
+                    solveForContributor(worker, s_analysis, s, _contributors[c], constraintOn, induced[c]);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) error = std::current_exception();
+                    next = nContributors;
+                }
             }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned t=1; t < _workers.size(); ++t)
+            threads.push_back(std::thread(solve, std::ref(*_workers[t])));
+        solve(*_workers[0]);
+        for (unsigned t=0; t < threads.size(); ++t)
+            threads[t].join();
+        if (error) std::rethrow_exception(error);
+    }
 
-            // Get to  the point where we can evaluate unilateral constraint conditions
-             _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Acceleration);
+    // Gather the accelerations of each contributor in contributor order
+    int nc = _coordSet.getSize();
+    int nb = _bodySet.getSize();
+    for(int c=0; c<nContributors; c++){
+        const Array<double>& acc = induced[c];
+        int k = 0;
+        for(int i=0; i<nc; i++, k++)
+            _coordIndAccs[i]->append(acc[k]);
+        for(int i=0; i<nb; i++, k+=6)
+            _bodyIndAccs[i]->append(6, &acc[k]);
+        if(_includeCOM){
+            _comIndAccs.append(3, &acc[k]);
+            k += 3;
+        }
+        if(_reportConstraintReactions && k < acc.getSize())
+            _constraintReactions.append(acc.getSize()-k, &acc[k]);
+    }
 
-            /* *********************************** ERROR CHECKING *******************************
-            SimTK::Vec3 pcom =_model->getMultibodySystem().getMatterSubsystem().calcSystemMassCenterLocationInGround(s_analysis);
-            SimTK::Vec3 vcom =_model->getMultibodySystem().getMatterSubsystem().calcSystemMassCenterVelocityInGround(s_analysis);
-            SimTK::Vec3 acom =_model->getMultibodySystem().getMatterSubsystem().calcSystemMassCenterAccelerationInGround(s_analysis);
+    // Set the accelerations of coordinates into their storages
+    for(int i=0; i<nc; i++) {
+        _storeInducedAccelerations[i]->append(aT, _coordIndAccs[i]->getSize(),&(_coordIndAccs[i]->get(0)));
+    }
 
-            SimTK::Matrix M;
-            _model->getMultibodySystem().getMatterSubsystem().calcM(s_analysis, M);
-            cout << "mass matrix: " << M << endl;
+    // Set the accelerations of bodies into their storages
+    for(int i=0; i<nb; i++) {
+        _storeInducedAccelerations[nc+i]->append(aT, _bodyIndAccs[i]->getSize(),&(_bodyIndAccs[i]->get(0)));
+    }
 
-            SimTK::Inertia sysInertia = _model->getMultibodySystem().getMatterSubsystem().calcSystemCentralInertiaInGround(s_analysis);
-            cout << "system inertia: " << sysInertia << endl;
+    // Set the accelerations of system center of mass into a storage
+    if(_includeCOM){
+        _storeInducedAccelerations[nc+nb]->append(aT, _comIndAccs.getSize(), &_comIndAccs[0]);
+    }
+    if(_reportConstraintReactions){
+        _storeConstraintReactions->append(aT, _constraintReactions.getSize(), &_constraintReactions[0]);
+    }
 
-            SimTK::SpatialVec sysMomentum =_model->getMultibodySystem().getMatterSubsystem().calcSystemMomentumAboutGroundOrigin(s_analysis);
-            cout << "system momentum: " << sysMomentum << endl;
+    return(0);
+}
 
-            const SimTK::Vector &appliedMobilityForces = _model->getMultibodySystem().getMobilityForces(s_analysis, SimTK::Stage::Dynamics);
-            appliedMobilityForces.dump("All Applied Mobility Forces");
-        
-            // Get all applied body forces like those from conact
-            const SimTK::Vector_<SimTK::SpatialVec>& appliedBodyForces = _model->getMultibodySystem().getRigidBodyForces(s_analysis, SimTK::Stage::Dynamics);
-            appliedBodyForces.dump("All Applied Body Forces");
-
-            SimTK::Vector ucUdot;
-            SimTK::Vector_<SimTK::SpatialVec> ucA_GB;
-            _model->getMultibodySystem().getMatterSubsystem().calcAccelerationIgnoringConstraints(s_analysis, appliedMobilityForces, appliedBodyForces, ucUdot, ucA_GB) ;
-            ucUdot.dump("Udots Ignoring Constraints");
-            ucA_GB.dump("Body Accelerations");
-
-            SimTK::Vector_<SimTK::SpatialVec> constraintBodyForces(_constraintSet.getSize(), SimTK::SpatialVec(SimTK::Vec3(0)));
-            SimTK::Vector constraintMobilityForces(0);
-
-            int nc = _model->getMultibodySystem().getMatterSubsystem().getNumConstraints();
-            for (SimTK::ConstraintIndex cx(0); cx < nc; ++cx) {
-                if (!_model->getMultibodySystem().getMatterSubsystem().isConstraintDisabled(s_analysis, cx)){
-                    cout << "Constraint " << cx << " enabled!" << endl;
-                }
-            }
-            //int nMults = _model->getMultibodySystem().getMatterSubsystem().getTotalMultAlloc();
+//_____________________________________________________________________________
+/**
+ * Solve for the accelerations induced by one contributor, starting from
+ * s_analysis at the time and configuration of s, and append them to
+ * accelerations.
+ */
+void InducedAccelerations::solveForContributor(Worker& worker,
+    SimTK::State& s_analysis, const SimTK::State& s, const string& contributor,
+    const Array<bool>& constraintOn, Array<double>& accelerations)
+{
+    Model& model = *worker.model;
+    int nu = model.getNumSpeeds();
+    double aT = s.getTime();
+    const SimTK::Vector& Q = s.getQ();
 
-            for(int i=0; i<constraintOn.getSize(); i++) {
-                if(constraintOn[i])
-                    _constraintSet[i].calcConstraintForces(s_analysis, constraintBodyForces, constraintMobilityForces);
-            }
-            constraintBodyForces.dump("Constraint Body Forces");
-            constraintMobilityForces.dump("Constraint Mobility Forces");
-            // ******************************* end ERROR CHECKING *******************************/
+
+    //cout << "Solving for contributor: " << contributor << endl;
+    // Need to be at the dynamics stage to disable a force
+    model.getMultibodySystem().realize(s_analysis, SimTK::Stage::Dynamics);
     
-            for(int i=0; i<constraintOn.getSize(); i++) {
-                _constraintSet.get(i).setDisabled(s_analysis, !constraintOn[i]);
-                // Make sure we stay at Dynamics so each constraint can evaluate its conditions
-                _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Acceleration);
-            }
+    if(contributor == "total"){
+        // Set gravity ON
+        model.getGravityForce().enable(s_analysis);
+
+        //Use same conditions on constraints
+        s_analysis.setTime(aT);
+        // Set the configuration (gen. coords and speeds) of the model.
+        s_analysis.setQ(Q);
+        s_analysis.setU(s.getU());
+        s_analysis.setZ(s.getZ());
+
+        //Make sure all the actuators are on!
+        for(int f=0; f<model.getActuators().getSize(); f++){
+            model.updActuators().get(f).setDisabled(s_analysis, false);
+        }
 
-            // This should also push changes to defaults for unilateral conditions
-            _model->setPropertiesFromState(s_analysis);
+        // Get to  the point where we can evaluate unilateral constraint conditions
+         model.getMultibodySystem().realize(s_analysis, SimTK::Stage::Acceleration);
 
-        }
-        else if(_contributors[c] == "gravity"){
-            // Set gravity ON
-            _model->updForceSubsystem().setForceIsDisabled(s_analysis, _model->getGravityForce().getForceIndex(), false);
+        /* *********************************** ERROR CHECKING *******************************
+        SimTK::Vec3 pcom =model.getMultibodySystem().getMatterSubsystem().calcSystemMassCenterLocationInGround(s_analysis);
+        SimTK::Vec3 vcom =model.getMultibodySystem().getMatterSubsystem().calcSystemMassCenterVelocityInGround(s_analysis);
+        SimTK::Vec3 acom =model.getMultibodySystem().getMatterSubsystem().calcSystemMassCenterAccelerationInGround(s_analysis);
+
+        SimTK::Matrix M;
+        model.getMultibodySystem().getMatterSubsystem().calcM(s_analysis, M);
+        cout << "mass matrix: " << M << endl;
 
-            //s_analysis = _model->initSystem();
-            s_analysis.setTime(aT);
-            s_analysis.setQ(Q);
+        SimTK::Inertia sysInertia = model.getMultibodySystem().getMatterSubsystem().calcSystemCentralInertiaInGround(s_analysis);
+        cout << "system inertia: " << sysInertia << endl;
 
-            // zero velocity
-            s_analysis.setU(SimTK::Vector(nu,0.0));
-            s_analysis.setZ(s.getZ());
+        SimTK::SpatialVec sysMomentum =model.getMultibodySystem().getMatterSubsystem().calcSystemMomentumAboutGroundOrigin(s_analysis);
+        cout << "system momentum: " << sysMomentum << endl;
 
-            // disable actuator forces
-            for(int f=0; f<_model->getActuators().getSize(); f++){
-                _model->updActuators().get(f).setDisabled(s_analysis, true);
+        const SimTK::Vector &appliedMobilityForces = model.getMultibodySystem().getMobilityForces(s_analysis, SimTK::Stage::Dynamics);
+        appliedMobilityForces.dump("All Applied Mobility Forces");
+    
+        // Get all applied body forces like those from conact
+        const SimTK::Vector_<SimTK::SpatialVec>& appliedBodyForces = model.getMultibodySystem().getRigidBodyForces(s_analysis, SimTK::Stage::Dynamics);
+        appliedBodyForces.dump("All Applied Body Forces");
+
+        SimTK::Vector ucUdot;
+        SimTK::Vector_<SimTK::SpatialVec> ucA_GB;
+        model.getMultibodySystem().getMatterSubsystem().calcAccelerationIgnoringConstraints(s_analysis, appliedMobilityForces, appliedBodyForces, ucUdot, ucA_GB) ;
+        ucUdot.dump("Udots Ignoring Constraints");
+        ucA_GB.dump("Body Accelerations");
+
+        SimTK::Vector_<SimTK::SpatialVec> constraintBodyForces(_constraintSet.getSize(), SimTK::SpatialVec(SimTK::Vec3(0)));
+        SimTK::Vector constraintMobilityForces(0);
+
+        int nc = model.getMultibodySystem().getMatterSubsystem().getNumConstraints();
+        for (SimTK::ConstraintIndex cx(0); cx < nc; ++cx) {
+            if (!model.getMultibodySystem().getMatterSubsystem().isConstraintDisabled(s_analysis, cx)){
+                cout << "Constraint " << cx << " enabled!" << endl;
             }
         }
-        else if(_contributors[c] == "velocity"){        
-            // Set gravity off
-            _model->updForceSubsystem().setForceIsDisabled(s_analysis, _model->getGravityForce().getForceIndex(), true);
-
-            s_analysis.setTime(aT);
-            s_analysis.setQ(Q);
-
-            // non-zero velocity
-            s_analysis.setU(s.getU());
-            s_analysis.setZ(s.getZ());
-            
-            // zero actuator forces
-            for(int f=0; f<_model->getActuators().getSize(); f++){
-                _model->updActuators().get(f).setDisabled(s_analysis, true);
-            }
-            // Set the configuration (gen. coords and speeds) of the model.
-            _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Velocity);
+        //int nMults = model.getMultibodySystem().getMatterSubsystem().getTotalMultAlloc();
+
+        for(int i=0; i<constraintOn.getSize(); i++) {
+            if(constraintOn[i])
+                _constraintSet[i].calcConstraintForces(s_analysis, constraintBodyForces, constraintMobilityForces);
         }
-        else{ //The rest are actuators      
-            // Set gravity OFF
-            _model->updForceSubsystem().setForceIsDisabled(s_analysis, _model->getGravityForce().getForceIndex(), true);
+        constraintBodyForces.dump("Constraint Body Forces");
+        constraintMobilityForces.dump("Constraint Mobility Forces");
+        // ******************************* end ERROR CHECKING *******************************/
 
-            // zero actuator forces
-            for(int f=0; f<_model->getActuators().getSize(); f++){
-                _model->updActuators().get(f).setDisabled(s_analysis, true);
-            }
+        for(int i=0; i<constraintOn.getSize(); i++) {
+            _constraintSet.get(i).setDisabled(s_analysis, !constraintOn[i]);
+            // Make sure we stay at Dynamics so each constraint can evaluate its conditions
+            model.getMultibodySystem().realize(s_analysis, SimTK::Stage::Acceleration);
+        }
 
-            //s_analysis = _model->initSystem();
-            s_analysis.setTime(aT);
-            s_analysis.setQ(Q);
-
-            // zero velocity
-            SimTK::Vector U(nu,0.0);
-            s_analysis.setU(U);
-            s_analysis.setZ(s.getZ());
-            // light up the one actuator who's contribution we are looking for
-            int ai = _model->getActuators().getIndex(_contributors[c]);
-            if(ai<0)
-                throw Exception("InducedAcceleration: ERR- Could not find actuator '"+_contributors[c],__FILE__,__LINE__);
-            
-            Actuator &actuator = _model->getActuators().get(ai);
-            ScalarActuator* act = dynamic_cast<ScalarActuator*>(&actuator);
-            act->setDisabled(s_analysis, false);
-            act->overrideActuation(s_analysis, false);
-            Muscle *muscle = dynamic_cast<Muscle *>(&actuator);
-            if(muscle){
-                if(_computePotentialsOnly){
-                    muscle->overrideActuation(s_analysis, true);
-                    muscle->setOverrideActuation(s_analysis, 1.0);
-                }
-            }
+        // This should also push changes to defaults for unilateral conditions
+        model.setPropertiesFromState(s_analysis);
 
-            // Set the configuration (gen. coords and speeds) of the model.
-            _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Model);
-            _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Velocity);
+    }
+    else if(contributor == "gravity"){
+        // Set gravity ON
+        model.updForceSubsystem().setForceIsDisabled(s_analysis, model.getGravityForce().getForceIndex(), false);
 
-        }// End of if to select contributor 
+        //s_analysis = model.initSystem();
+        s_analysis.setTime(aT);
+        s_analysis.setQ(Q);
 
-        // cout << "Constraint 0 is of "<< _constraintSet[0].getConcreteClassName() << " and should be " << constraintOn[0] << " and is actually " <<  (_constraintSet[0].isDisabled(s_analysis) ? "off" : "on") << endl;
-        // cout << "Constraint 1 is of "<< _constraintSet[1].getConcreteClassName() << " and should be " << constraintOn[1] << " and is actually " <<  (_constraintSet[1].isDisabled(s_analysis) ? "off" : "on") << endl;
+        // zero velocity
+        s_analysis.setU(SimTK::Vector(nu,0.0));
+        s_analysis.setZ(s.getZ());
 
-        // After setting the state of the model and applying forces
-        // Compute the derivative of the multibody system (speeds and accelerations)
-        _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Acceleration);
+        // disable actuator forces
+        for(int f=0; f<model.getActuators().getSize(); f++){
+            model.updActuators().get(f).setDisabled(s_analysis, true);
+        }
+    }
+    else if(contributor == "velocity"){        
+        // Set gravity off
+        model.updForceSubsystem().setForceIsDisabled(s_analysis, model.getGravityForce().getForceIndex(), true);
 
-        // Sanity check that constraints hasn't totally changed the configuration of the model
-        double error = (Q-s_analysis.getQ()).norm();
+        s_analysis.setTime(aT);
+        s_analysis.setQ(Q);
 
-        // Report reaction forces for debugging
-        /*
-        SimTK::Vector_<SimTK::SpatialVec> constraintBodyForces(_constraintSet.getSize());
-        SimTK::Vector mobilityForces(0);
+        // non-zero velocity
+        s_analysis.setU(s.getU());
+        s_analysis.setZ(s.getZ());
+        
+        // zero actuator forces
+        for(int f=0; f<model.getActuators().getSize(); f++){
+            model.updActuators().get(f).setDisabled(s_analysis, true);
+        }
+        // Set the configuration (gen. coords and speeds) of the model.
+        model.getMultibodySystem().realize(s_analysis, SimTK::Stage::Velocity);
+    }
+    else{ //The rest are actuators      
+        // Set gravity OFF
+        model.updForceSubsystem().setForceIsDisabled(s_analysis, model.getGravityForce().getForceIndex(), true);
 
-        for(int i=0; i<constraintOn.getSize(); i++) {
-            if(constraintOn[i])
-                _constraintSet.get(i).calcConstraintForces(s_analysis, constraintBodyForces, mobilityForces);
-        }*/
+        // zero actuator forces
+        for(int f=0; f<model.getActuators().getSize(); f++){
+            model.updActuators().get(f).setDisabled(s_analysis, true);
+        }
 
-        // VARIABLES
-        SimTK::Vec3 vec,angVec;
+        //s_analysis = model.initSystem();
+        s_analysis.setTime(aT);
+        s_analysis.setQ(Q);
+
+        // zero velocity
+        SimTK::Vector U(nu,0.0);
+        s_analysis.setU(U);
+        s_analysis.setZ(s.getZ());
+        // light up the one actuator who's contribution we are looking for
+        int ai = model.getActuators().getIndex(contributor);
+        if(ai<0)
+            throw Exception("InducedAcceleration: ERR- Could not find actuator '"+contributor,__FILE__,__LINE__);
+        
+        Actuator &actuator = model.getActuators().get(ai);
+        ScalarActuator* act = dynamic_cast<ScalarActuator*>(&actuator);
+        act->setDisabled(s_analysis, false);
+        act->overrideActuation(s_analysis, false);
+        Muscle *muscle = dynamic_cast<Muscle *>(&actuator);
+        if(muscle){
+            if(_computePotentialsOnly){
+                muscle->overrideActuation(s_analysis, true);
+                muscle->setOverrideActuation(s_analysis, 1.0);
+            }
+        }
 
-        // Get Accelerations for kinematics of bodies
-        for(int i=0;i<_coordSet.getSize();i++) {
-            double acc = _coordSet.get(i).getAccelerationValue(s_analysis);
+        // Set the configuration (gen. coords and speeds) of the model.
+        model.getMultibodySystem().realize(s_analysis, SimTK::Stage::Model);
+        model.getMultibodySystem().realize(s_analysis, SimTK::Stage::Velocity);
 
-            if(getInDegrees()) 
-                acc *= SimTK_RADIAN_TO_DEGREE;  
-            _coordIndAccs[i]->append(1, &acc);
-        }
+    }// End of if to select contributor 
 
-        // cout << "Input Body Names: "<< _bodyNames << endl;
-
-        // Get Accelerations for kinematics of bodies
-        for(int i=0;i<_bodySet.getSize();i++) {
-            Body &body = _bodySet.get(i);
-            // cout << "Body Name: "<< body->getName() << endl;
-            const SimTK::Vec3& com = body.get_mass_center();
-            
-            // Get the body acceleration
-            _model->getSimbodyEngine().getAcceleration(s_analysis, body, com, vec);
-            _model->getSimbodyEngine().getAngularAcceleration(s_analysis, body, angVec);    
-
-            // CONVERT TO DEGREES?
-            if(getInDegrees()) 
-                angVec *= SimTK_RADIAN_TO_DEGREE;   
-
-            // FILL KINEMATICS ARRAY
-            _bodyIndAccs[i]->append(3, &vec[0]);
-            _bodyIndAccs[i]->append(3, &angVec[0]);
-        }
+    // cout << "Constraint 0 is of "<< _constraintSet[0].getConcreteClassName() << " and should be " << constraintOn[0] << " and is actually " <<  (_constraintSet[0].isDisabled(s_analysis) ? "off" : "on") << endl;
+    // cout << "Constraint 1 is of "<< _constraintSet[1].getConcreteClassName() << " and should be " << constraintOn[1] << " and is actually " <<  (_constraintSet[1].isDisabled(s_analysis) ? "off" : "on") << endl;
 
-        // Get Accelerations for kinematics of COM
-        if(_includeCOM){
-            // Get the body acceleration in ground
-            vec = _model->getMultibodySystem().getMatterSubsystem().calcSystemMassCenterAccelerationInGround(s_analysis);
+    // After setting the state of the model and applying forces
+    // Compute the derivative of the multibody system (speeds and accelerations)
+    model.getMultibodySystem().realize(s_analysis, SimTK::Stage::Acceleration);
 
-            // FILL KINEMATICS ARRAY
-            _comIndAccs.append(3, &vec[0]);
-        }
+    // Sanity check that constraints hasn't totally changed the configuration of the model
+    double error = (Q-s_analysis.getQ()).norm();
 
-        // Get induced constraint reactions for contributor
-        if(_reportConstraintReactions){
-            for(int j=0; j<_constraintSet.getSize(); j++){
-                _constraintReactions.append(_constraintSet[j].getRecordValues(s_analysis));
-            }
-        }
+    // Report reaction forces for debugging
+    /*
+    SimTK::Vector_<SimTK::SpatialVec> constraintBodyForces(_constraintSet.getSize());
+    SimTK::Vector mobilityForces(0);
 
-    } // End cycling through contributors at this time step
+    for(int i=0; i<constraintOn.getSize(); i++) {
+        if(constraintOn[i])
+            _constraintSet.get(i).calcConstraintForces(s_analysis, constraintBodyForces, mobilityForces);
+    }*/
 
-    // Set the accelerations of coordinates into their storages
-    int nc = _coordSet.getSize();
-    for(int i=0; i<nc; i++) {
-        _storeInducedAccelerations[i]->append(aT, _coordIndAccs[i]->getSize(),&(_coordIndAccs[i]->get(0)));
+    // VARIABLES
+    SimTK::Vec3 vec,angVec;
+
+    // Get Accelerations for kinematics of bodies
+    for(unsigned i=0;i<worker.coordinates.size();i++) {
+        double acc = worker.coordinates[i]->getAccelerationValue(s_analysis);
+
+        if(getInDegrees()) 
+            acc *= SimTK_RADIAN_TO_DEGREE;  
+        accelerations.append(acc);
     }
 
-    // Set the accelerations of bodies into their storages
-    int nb = _bodySet.getSize();
-    for(int i=0; i<nb; i++) {
-        _storeInducedAccelerations[nc+i]->append(aT, _bodyIndAccs[i]->getSize(),&(_bodyIndAccs[i]->get(0)));
+    // Get Accelerations for kinematics of bodies
+    for(unsigned i=0;i<worker.bodies.size();i++) {
+        const Body &body = *worker.bodies[i];
+        const SimTK::Vec3& com = body.get_mass_center();
+        
+        // Get the body acceleration
+        model.getSimbodyEngine().getAcceleration(s_analysis, body, com, vec);
+        model.getSimbodyEngine().getAngularAcceleration(s_analysis, body, angVec);    
+
+        // CONVERT TO DEGREES?
+        if(getInDegrees()) 
+            angVec *= SimTK_RADIAN_TO_DEGREE;   
+
+        // FILL KINEMATICS ARRAY
+        accelerations.append(3, &vec[0]);
+        accelerations.append(3, &angVec[0]);
     }
 
-    // Set the accelerations of system center of mass into a storage
+    // Get Accelerations for kinematics of COM
     if(_includeCOM){
-        _storeInducedAccelerations[nc+nb]->append(aT, _comIndAccs.getSize(), &_comIndAccs[0]);
+        // Get the body acceleration in ground
+        vec = model.getMultibodySystem().getMatterSubsystem().calcSystemMassCenterAccelerationInGround(s_analysis);
+
+        // FILL KINEMATICS ARRAY
+        accelerations.append(3, &vec[0]);
     }
+
+    // Get induced constraint reactions for contributor
     if(_reportConstraintReactions){
-        _storeConstraintReactions->append(aT, _constraintReactions.getSize(), &_constraintReactions[0]);
+        for(int j=0; j<_constraintSet.getSize(); j++){
+            accelerations.append(_constraintSet[j].getRecordValues(s_analysis));
+        }
     }
-
-    return(0);
 }
 
 /**
@@ -833,11 +957,12 @@ void InducedAccelerations::initialize(const SimTK::State& s)
     // Get value for gravity
     _gravity = _model->getGravity();
 
-    SimTK::State &s_analysis =_model->initSystem();
+    _model->initSystem();
 
     // UPDATE VARIABLES IN THIS CLASS
     constructDescription();
     setupStorage();
+    setupWorkers();
 }
 
 //_____________________________________________________________________________
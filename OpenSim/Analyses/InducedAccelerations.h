@@ -30,14 +30,19 @@
 #include <OpenSim/Common/PropertyBool.h>
 #include <OpenSim/Common/PropertyObj.h>
 #include <OpenSim/Common/PropertyDbl.h>
+#include <OpenSim/Common/PropertyInt.h>
 #include <OpenSim/Common/PropertyStrArray.h>
 #include <OpenSim/Simulation/Model/Analysis.h>
 // Header to define analysis (DLL) interface
 #include "osimAnalysesDLL.h"
+#include <memory>
+#include <vector>
 
 namespace OpenSim { 
 
 class Model;
+class Body;
+class Coordinate;
 class BodySet;
 class CoordinateSet;
 class ConstraintSet;
@@ -61,6 +66,12 @@ class ExternalForce;
  * The ConstraintSet supplied must have the same number constraints as
  * external forces AND apply to the same bodies with respect to ground.
  *
+ * Without contact constraints, every time step starts from the same analysis
+ * state rather than rebuilding the System's topology, and the contributors
+ * can be solved for concurrently (see number_of_threads). Each thread then
+ * works on its own copy of the model, since a Model is not safe to realize
+ * from several threads at once.
+ *
  * @author Ajay Seth
  */
 class OSIMANALYSES_API InducedAccelerations : public Analysis {
@@ -104,6 +115,11 @@ protected:
     PropertyBool _reportConstraintReactionsProp;
     bool &_reportConstraintReactions;
 
+    /** Number of threads solving for contributors concurrently. Only used
+        when no contact constraints are applied. */
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
+
     /** Storages for recording induced accelerations for specified coordinates and/or bodies. */
     Array<Storage *> _storeInducedAccelerations;
     Storage* _storeConstraintReactions;
@@ -125,6 +141,20 @@ protected:
     // Hold the actual model gravity since we will be changing it back and forth from 0
     SimTK::Vec3 _gravity;
 
+#ifndef SWIG
+    /* A copy of the model solving for contributors on one thread, with its
+       default state and the coordinates and bodies being analyzed. */
+    struct Worker {
+        Model* model;
+        std::unique_ptr<Model> ownedModel;
+        SimTK::State state;
+        std::vector<const Coordinate*> coordinates;
+        std::vector<const Body*> bodies;
+    };
+    // The first worker uses the analysis' own model
+    std::vector<std::unique_ptr<Worker> > _workers;
+#endif
+
 
 //=============================================================================
 // METHODS
@@ -188,6 +218,11 @@ public:
     //-------------------------------------------------------------------------
     virtual void setModel(Model &aModel);
 
+    /** Set the number of threads used to solve for the contributors. The
+    default is 1. */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
+
     //-------------------------------------------------------------------------
     // INTEGRATION
     //-------------------------------------------------------------------------
@@ -210,6 +245,13 @@ public:
 protected:
     //========================== Internal Methods =============================
     int record(const SimTK::State& s);
+#ifndef SWIG
+    void setupWorkers();
+    void solveForContributor(Worker& worker, SimTK::State& s_analysis,
+                             const SimTK::State& s, const std::string& contributor,
+                             const Array<bool>& constraintOn,
+                             Array<double>& accelerations);
+#endif
     void constructDescription();
     void assembleContributors();
     Array<std::string> constructColumnLabelsForCoordinate();
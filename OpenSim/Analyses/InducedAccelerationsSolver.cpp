@@ -31,6 +31,7 @@
 #include <OpenSim/Simulation/Model/ExternalForce.h>
 #include <OpenSim/Simulation/SimbodyEngine/SimbodyEngine.h>
 #include <OpenSim/Simulation/SimbodyEngine/RollingOnSurfaceConstraint.h>
+#include <OpenSim/Simulation/AccelerationSolver.h>
 #include "InducedAccelerationsSolver.h"
 
 using namespace OpenSim;
@@ -64,7 +65,30 @@ const SimTK::Vector& InducedAccelerationsSolver::solve(const SimTK::State& s,
         SimTK::Vector_<SimTK::SpatialVec>* constraintReactions)
 {
     SimTK::State& s_solver = _modelCopy.updWorkingState();
-    return s_solver.getUDot();
+    s_solver.setTime(s.getTime());
+    s_solver.updQ() = s.getQ();
+    s_solver.updU() = s.getU();
+    _modelCopy.getMultibodySystem().realize(s_solver, SimTK::Stage::Velocity);
+
+    // The induced accelerations are the part of the accelerations that is
+    // linear in the supplied forces
+    AccelerationSolver solver(_modelCopy);
+    solver.factor(s_solver);
+    SimTK::Vector f;
+    solver.calcGeneralizedForces(s_solver, appliedMobilityForces,
+                                 appliedBodyForces, f);
+    SimTK::Matrix F(f.size(), 1), udot, multipliers;
+    F(0) = f;
+    solver.solveLinear(F, udot, &multipliers);
+    _inducedUDot = udot(0);
+
+    if(constraintReactions){
+        SimTK::Vector lambda(multipliers(0));
+        SimTK::Vector mobilityReactions;
+        _modelCopy.getMatterSubsystem().calcConstraintForcesFromMultipliers(
+            s_solver, lambda, *constraintReactions, mobilityReactions);
+    }
+    return _inducedUDot;
 }
 
 /* Solve for the induced accelerations (udot_f) for a Force in the model 
@@ -125,6 +125,8 @@ public:
     /** Solve for the induced (generalized) accelerations (udot) resulting 
         from the suppied force. An supplied force is expressed as any 
         combination of mobility (generalized) forces and/or body forces.
+        The enabled constraints of the model are imposed, and the equations
+        of motion are factored with an AccelerationSolver.
         
         @param[in]  state                   current State of the model
         @param[in]  appliedMobilityForces   Vector of applied mobility forces
@@ -193,6 +195,7 @@ private:
     Set<Force> _forcesToReplace;
     Set<Constraint> _replacementConstraints; 
     Model _modelCopy;
+    SimTK::Vector _inducedUDot;
 
 //=============================================================================
 }; // END of class InducedAccelerationsSolver
@@ -26,7 +26,9 @@
 // INCLUDES
 //=============================================================================
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/Actuator.h>
 #include <OpenSim/Simulation/Model/BodySet.h>
@@ -68,7 +70,8 @@ JointReaction::JointReaction(Model *aModel) :
     _forcesFileName(_forcesFileNameProp.getValueStr()),
     _jointNames(_jointNamesProp.getValueStrArray()),
     _onBody(_onBodyProp.getValueStrArray()),
-    _inFrame(_inFrameProp.getValueStrArray())
+    _inFrame(_inFrameProp.getValueStrArray()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
 }
@@ -86,7 +89,8 @@ JointReaction::JointReaction(const std::string &aFileName):
     _forcesFileName(_forcesFileNameProp.getValueStr()),
     _jointNames(_jointNamesProp.getValueStrArray()),
     _onBody(_onBodyProp.getValueStrArray()),
-    _inFrame(_inFrameProp.getValueStrArray())
+    _inFrame(_inFrameProp.getValueStrArray()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
 
@@ -115,7 +119,8 @@ JointReaction::JointReaction(const JointReaction &aJointReaction):
     _forcesFileName(_forcesFileNameProp.getValueStr()),
     _jointNames(_jointNamesProp.getValueStrArray()),
     _onBody(_onBodyProp.getValueStrArray()),
-    _inFrame(_inFrameProp.getValueStrArray())
+    _inFrame(_inFrameProp.getValueStrArray()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
     // COPY TYPE AND NAME
@@ -145,6 +150,7 @@ operator=(const JointReaction &aJointReaction)
     _jointNames = aJointReaction._jointNames;
     _onBody = aJointReaction._onBody;
     _inFrame = aJointReaction._inFrame;
+    _numThreads = aJointReaction._numThreads;
     _useForceStorage = aJointReaction._useForceStorage;
     _storeActuation = NULL;
     return(*this);
@@ -170,6 +176,7 @@ setNull()
     _onBody[0]= "child";
     _inFrame.setSize(1);
     _inFrame[0] = "ground";
+    _numThreads = 1;
 
     _storeActuation = NULL;
 
@@ -212,6 +219,16 @@ setupProperties()
         "reactions are expressed.  ground body is default.  If the array has one entry only, "
         "that selection is applied to all chosen joints.");
     _propertySet.append(&_inFrameProp);
+
+    _numThreadsProp.setName("number_of_threads");
+    _numThreadsProp.setComment("Number of threads computing contiguous ranges of frames concurrently. "
+        "With more than one, the frames are computed when the analysis ends, each thread using "
+        "its own copy of the model unless the model was initialized for thread-safe evaluation. "
+        "The whole state of each frame, including overridden actuation, disabled forces and "
+        "locked coordinates, is kept in memory until then. When streaming with max_rows_in_memory "
+        "set, the frames are instead computed in chunks of that many (at least one per thread) "
+        "as they are recorded; otherwise the streamed rows are only written when the analysis ends.");
+    _propertySet.append(&_numThreadsProp);
 }
 
 //=============================================================================
@@ -413,6 +430,7 @@ void JointReaction::loadForcesFromFile()
         // check if actuator set and forces file have the same actuators
         bool _containsAllActuators = true;
         int actuatorSetSize = _model->getActuators().getSize();
+        _actuatorColumns.assign(actuatorSetSize, -1);
         if(actuatorSetSize > storeSize){
             cout << "The forces file does not contain enough actuators." << endl;
             _containsAllActuators = false;
@@ -422,6 +440,7 @@ void JointReaction::loadForcesFromFile()
             {
                 std::string actuatorName = _model->getActuators().get(actuatorIndex).getName();
                 int storageIndex = _storeActuation->getStateIndex(actuatorName,0);
+                _actuatorColumns[actuatorIndex] = storageIndex;
                 if(storageIndex == -1) {
                     cout << "\nThe actuator " << actuatorName << " was not found in the forces file." << endl;
                     _containsAllActuators = false;
@@ -463,6 +482,8 @@ setupStorage()
     _storeReactionLoads.setName("Joint Reaction Loads");
     _storeReactionLoads.setDescription(getDescription());
     _storeReactionLoads.setColumnLabels(getColumnLabels());
+    _storageList.setSize(0);
+    _storageList.append(&_storeReactionLoads);
 
     // Actuator forces - if a forces file is specified, load the forces storage data to _storeActuation
     if(!(_forcesFileName == "")) loadForcesFromFile();
@@ -491,6 +512,7 @@ setModel(Model& aModel)
     Analysis::setModel(aModel);
 
     // UPDATE VARIABLES IN THIS CLASS
+    _workers.clear();
     setupReactionList();
     constructDescription();
     constructColumnLabels();
@@ -507,130 +529,262 @@ setModel(Model& aModel)
 //=============================================================================
 //_____________________________________________________________________________
 /**
- * Compute and record the results.
- *
- * This method computes the reaction loads at all joints in the model, then
- * truncates the results to contain only the loads at the requested joints
- * and finally, if necessary, modifies the loads to be acting on the specified
- * body and expressed in the specified frame
- *
- * @param aT Current time in the simulation.
- * @param aX Current values of the controls.
- * @param aY Current values of the states.
+ * Set up the workers that compute the reaction loads. The first uses the
+ * analysis' own model and a copy of the given state. With more than one
+ * thread, the others share the model if it was initialized for thread-safe
+ * evaluation and otherwise each uses its own copy of the model.
  */
-int JointReaction::
-record(const SimTK::State& s)
+void JointReaction::setupWorkers(const SimTK::State& s)
 {
-    /** if a forces file is specified replace the computed actuation with the 
-        forces from storage.*/
-    SimTK::State s_analysis = s;
+    _workers.clear();
+    int numWorkers = std::max(1, _numThreads);
+
+    for(int w=0; w<numWorkers; w++){
+        std::unique_ptr<Worker> worker(new Worker());
+        if(w == 0 || _model->getUseThreadSafeEvaluation()){
+            worker->model = _model;
+            worker->state = s;
+        }
+        else{
+            worker->ownedModel.reset(_model->clone());
+            worker->model = worker->ownedModel.get();
+            worker->state = worker->model->initSystem();
+        }
 
-    _model->updMultibodySystem().realize(s_analysis, s.getSystemStage());
-    if(_useForceStorage){
+        // The joints and frames of this worker's model used by each key
+        const JointSet& jointSet = worker->model->getJointSet();
+        for(int i=0; i<_reactionList.getSize(); i++){
+            const JointReactionKey& key = _reactionList[i];
+            const Joint& joint = jointSet[key.jointIndex];
+            worker->joints.push_back(&joint);
+            if(key.expressedInFrame == &key.joint->getChildFrame())
+                worker->expressedInFrames.push_back(&joint.getChildFrame());
+            else if(key.expressedInFrame == &key.joint->getParentFrame())
+                worker->expressedInFrames.push_back(&joint.getParentFrame());
+            else
+                worker->expressedInFrames.push_back(&worker->model->getGround());
+        }
 
-        const Set<Actuator> *actuatorSet = &_model->getActuators();
-        int nA = actuatorSet->getSize();
-        Array<double> forces(0,nA);
-        _storeActuation->getDataAtTime(s.getTime(),nA,forces);
-        int storageIndex = -1;
-        for(int actuatorIndex=0;actuatorIndex<nA;actuatorIndex++)
-        {
-            //Actuator* act = dynamic_cast<Actuator*>(&_forceSet->get(actuatorIndex));
-            std::string actuatorName = actuatorSet->get(actuatorIndex).getName();
-            storageIndex = _storeActuation->getStateIndex(actuatorName, 0);
-            if(storageIndex == -1){
-                cout << "The actuator, " << actuatorName << ", was not found in the forces file." << endl;
-                break;
-            }
-            const ScalarActuator* act = dynamic_cast<const ScalarActuator*>(&actuatorSet[actuatorIndex]);
-            if (act){
-                act->overrideActuation(s_analysis, true);
-                act->setOverrideActuation(s_analysis, forces[storageIndex]);
-            }
+        const Set<Actuator>& actuatorSet = worker->model->getActuators();
+        for(int i=0; i<actuatorSet.getSize(); i++)
+            worker->actuators.push_back(
+                dynamic_cast<const ScalarActuator*>(&actuatorSet[i]));
+        if(_storeActuation)
+            worker->forces.setSize(_storeActuation->getColumnLabels().getSize()-1);
+
+        _workers.push_back(std::move(worker));
+    }
+}
+
+//_____________________________________________________________________________
+/**
+ * Override the actuation of the actuators of the worker's model in the given
+ * state with the forces from the forces storage at the time of the state.
+ */
+void JointReaction::applyForcesFromStorage(Worker& worker, SimTK::State& s) const
+{
+    Array<double>& forces = worker.forces;
+    _storeActuation->getDataAtTime(s.getTime(), forces.getSize(), forces);
+    for(unsigned i=0; i<worker.actuators.size(); i++){
+        const ScalarActuator* act = worker.actuators[i];
+        if(act && _actuatorColumns[i] >= 0){
+            act->overrideActuation(s, true);
+            act->setOverrideActuation(s, forces[_actuatorColumns[i]]);
         }
     }
-    // VARIABLES
-    const Ground& ground = _model->getGround();
-    int numJoints = _model->getNumJoints();
-
-    /** define 2 variable length vectors of Vec3 vectors to contain calculated  
-    *   forces and moments for all the bodies in the model */
-    Vector_<Vec3> allForcesVec(numJoints);
-    Vector_<Vec3> allMomentsVec(numJoints);
-
-    /* Calculate All joint reaction forces and moments.
-    *  Applied to child bodies, expressed in ground frame.  
-    *  computeReactions realizes to the acceleration stage internally
-    *  so you don't have to call realize in this analysis.*/ 
-    _model->getSimbodyEngine().computeReactions(s_analysis, allForcesVec, allMomentsVec);
-
-    /* retrieved desired joint reactions, convert to desired bodies, and convert
-    *  to desired reference frames*/
+}
+
+//_____________________________________________________________________________
+/**
+ * Compute the reaction loads at the joints in the reaction list, acting on
+ * the specified bodies and expressed in the specified frames.
+ *
+ * The reaction forces of all mobilizers are computed in one pass, and only
+ * those of the requested joints are read. The loads of all joints are first
+ * found in the ground frame and then re-expressed together, using the body
+ * transform of each frame that Simbody keeps in the state.
+ *
+ * @param worker The worker whose model and buffers are used.
+ * @param s State of the worker's model, which is realized to the
+ * acceleration stage.
+ * @param loads The force, moment and point of application of each joint,
+ * 9 values per joint.
+ */
+void JointReaction::computeLoads(Worker& worker, const SimTK::State& s,
+                                 double* loads) const
+{
+    const Model& model = *worker.model;
+
+    /* Calculate the reaction loads of all mobilizers, applied to the child
+    *  bodies and expressed in the ground frame.*/
+    model.getMultibodySystem().realize(s, Stage::Acceleration);
+    model.getMatterSubsystem().calcMobilizerReactionForces(s,
+        worker.reactionForces);
+
+    /* retrieve the desired joint reactions and convert them to the desired
+    *  bodies, still expressed in ground*/
     int numOutputJoints = _reactionList.getSize();
-    Vector_<Vec3> forcesVec(numOutputJoints), momentsVec(numOutputJoints), pointsVec(numOutputJoints);
     for(int i=0; i<numOutputJoints; i++) {
-        JointReactionKey currentKey = _reactionList[i];
-        const Joint& joint = *currentKey.joint;
-        Vec3 force = allForcesVec[currentKey.jointIndex];
-        Vec3 moment = allMomentsVec[currentKey.jointIndex];
-        const PhysicalFrame& expressedInBody = *currentKey.expressedInFrame;
-        
+        const Joint& joint = *worker.joints[i];
+        // SpatialVec = Vec2<Vec3 torque, Vec3 force>
+        const SpatialVec& reaction = worker.reactionForces[
+            joint.getChildFrame().getMobilizedBodyIndex()];
+        Vec3 moment = reaction[0];
+        Vec3 force = reaction[1];
+
         // find the point of application of the joint load on the child
-        const Vec3& childLocation = joint.getLocationInChild();
-        // and find it's current location in the ground reference frame
-        Vec3 childLocationInGlobal = joint.getChildFrame().getGroundTransform(s_analysis)*childLocation;
-        // set the point of application to the joint location in the child body
-        Vec3 pointOfApplication(0,0,0);
-        
-        // check if the load on the child needs to be converted to an equivalent
-        // load on the parent body.
-        if(!currentKey.isAppliedOnChild){
+        // in the ground reference frame
+        Vec3 childLocationInGlobal = joint.getChildFrame()
+            .getGroundTransform(s)*joint.getLocationInChild();
+        Vec3 pointOfApplication = childLocationInGlobal;
+
+        // check if the load on the child needs to be converted to an
+        // equivalent load on the parent body.
+        if(!_reactionList[i].isAppliedOnChild){
             /*Take reaction load from child and apply on parent*/
             force = -force;
             moment = -moment;
-            const Vec3& parentLocation = joint.getLocationInParent();
             Vec3 parentLocationInGlobal = joint.getParentFrame()
-                .getGroundTransform(s_analysis)*parentLocation;
+                .getGroundTransform(s)*joint.getLocationInParent();
 
-            // define vector from the mobilizer location on the child to the location on the parent
+            // find equivalent moment if the load is shifted from the location
+            // on the child to the location on the parent
             Vec3 translation = parentLocationInGlobal - childLocationInGlobal;
-            // find equivalent moment if the load is shifted to the parent loaction
             moment -= translation % force;
 
-            // reset the point of application to the joint location in the parent expressed in ground
             pointOfApplication = parentLocationInGlobal;
         }
-        else{
-            // set the point of application to the joint laction in the child expressed in ground
-            pointOfApplication = childLocationInGlobal;
-        }
-        /* express loads in the desired reference frame*/
-        _model->getSimbodyEngine()
-            .transform(s_analysis, ground, force, expressedInBody, force);
-        _model->getSimbodyEngine().transform(s_analysis,ground,moment,expressedInBody,moment);
-        _model->getSimbodyEngine().transformPosition(s_analysis,ground,pointOfApplication,expressedInBody,pointOfApplication);
-
-        /* place results in the truncated loads vectors*/
-        forcesVec[i] = force;
-        momentsVec[i] = moment;
-        pointsVec[i] = pointOfApplication;
+
+        Vec3::updAs(&loads[9*i]) = force;
+        Vec3::updAs(&loads[9*i+3]) = moment;
+        Vec3::updAs(&loads[9*i+6]) = pointOfApplication;
     }
 
-    /* fill out row construction array*/
-    for(int i=0;i<numOutputJoints;i++) {
-        int I = 9*i;
-        for(int j=0;j<3;j++) {
-            _Loads[I+j] = forcesVec[i][j];
-            _Loads[I+j+3] = momentsVec[i][j];
-            _Loads[I+j+6] = pointsVec[i][j];
-        }
+    /* express the loads in the desired reference frames*/
+    const PhysicalFrame& ground = model.getGround();
+    for(int i=0; i<numOutputJoints; i++) {
+        const PhysicalFrame& frame = *worker.expressedInFrames[i];
+        if(&frame == &ground) continue;
+        const Transform& X_GB = frame.getMobilizedBody().getBodyTransform(s);
+        Vec3& force = Vec3::updAs(&loads[9*i]);
+        Vec3& moment = Vec3::updAs(&loads[9*i+3]);
+        Vec3& point = Vec3::updAs(&loads[9*i+6]);
+        force = ~X_GB.R()*force;
+        moment = ~X_GB.R()*moment;
+        point = ~X_GB*point;
     }
+}
+
+//_____________________________________________________________________________
+/**
+ * Compute and record the results.
+ *
+ * This method computes the reaction loads at the requested joints, acting
+ * on the specified bodies and expressed in the specified frames. When
+ * running on several threads, the frame is saved instead and computed by
+ * recordFrames(), when the analysis ends or, if only max_rows_in_memory rows
+ * are kept while streaming, once that many frames are saved.
+ *
+ * @param s Current state of the model.
+ */
+int JointReaction::
+record(const SimTK::State& s)
+{
+    if(_workers.empty()) setupWorkers(s);
+
+    if(_workers.size() > 1) {
+        _frameStates.push_back(s);
+        // Compute the frames in chunks while keeping only the most recent
+        // rows in memory, so that they are streamed as they are recorded
+        int maxRows = getMaxRowsInMemory();
+        if(isStreaming() && maxRows >= 0 &&
+                _frameStates.size() >= std::max((size_t)maxRows, _workers.size()))
+            recordFrames();
+        return 0;
+    }
+
+    Worker& worker = *_workers[0];
+    if(_useForceStorage){
+        /** replace the computed actuation with the forces from storage, in a
+            copy of the state so that other analyses see the model's forces*/
+        SimTK::State s_analysis = s;
+        _model->getMultibodySystem().realize(s_analysis, s.getSystemStage());
+        applyForcesFromStorage(worker, s_analysis);
+        computeLoads(worker, s_analysis, &_Loads[0]);
+    }
+    else {
+        /** the state is only realized further, which the analyses that
+            follow can use without realizing it again*/
+        computeLoads(worker, s, &_Loads[0]);
+    }
+
     /* Write the reaction data to storage*/
     _storeReactionLoads.append(s.getTime(),_Loads.getSize(),&_Loads[0]);
 
     return 0;
 }
 //_____________________________________________________________________________
+/**
+ * Compute the frames saved by record() on several threads and record the
+ * results in the order of the frames.
+ *
+ * Each worker computes a contiguous range of frames, so that its model sees
+ * the frames in the same order as when they are computed one at a time
+ * (wrapping, for example, starts from the result of the previous frame).
+ * The time, state variables and discrete variables of each frame are copied
+ * into the worker's state, which may belong to a copy of the model.
+ * The first exception thrown is rethrown once all workers are done.
+ */
+void JointReaction::recordFrames()
+{
+    int numFrames = (int)_frameStates.size();
+    if(numFrames == 0) return;
+    int numLoads = _Loads.getSize();
+    int numWorkers = std::min((int)_workers.size(), numFrames);
+    std::vector<double> loads(numFrames*numLoads);
+
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto compute = [&](int w) {
+        Worker& worker = *_workers[w];
+        int first = w*numFrames/numWorkers;
+        int last = (w+1)*numFrames/numWorkers;
+        try {
+            for(int f=first; f<last; f++) {
+                const SimTK::State& frame = _frameStates[f];
+                SimTK::State& s = worker.state;
+                s.setTime(frame.getTime());
+                s.setY(frame.getY());
+                for(SubsystemIndex i(0); i<frame.getNumSubsystems(); ++i)
+                    for(DiscreteVariableIndex d(0);
+                            d<frame.getNDiscreteVariables(i); ++d)
+                        s.updDiscreteVariable(i, d) =
+                            frame.getDiscreteVariable(i, d);
+                if(_useForceStorage) applyForcesFromStorage(worker, s);
+                computeLoads(worker, s, loads.data() + f*numLoads);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(int w=1; w < numWorkers; ++w)
+        threads.push_back(std::thread(compute, w));
+    compute(0);
+    for(unsigned t=0; t < threads.size(); ++t)
+        threads[t].join();
+
+    std::vector<double> times(numFrames);
+    for(int f=0; f<numFrames; f++) times[f] = _frameStates[f].getTime();
+    _frameStates.clear();
+    if(error) std::rethrow_exception(error);
+
+    for(int f=0; f<numFrames; f++)
+        _storeReactionLoads.append(times[f], numLoads, loads.data() + f*numLoads);
+}
+//_____________________________________________________________________________
 /**
  * This method is called at the beginning of an analysis so that any
  * necessary initializations may be performed.
@@ -650,6 +804,8 @@ begin(SimTK::State& s)
 
     // RESET STORAGE
     _storeReactionLoads.reset(s.getTime());
+    _frameStates.clear();
+    setupWorkers(s);
 
     // RECORD
     int status = 0;
@@ -682,7 +838,8 @@ step( const SimTK::State& s, int stepNumber)
 //_____________________________________________________________________________
 /**
  * This method is called at the end of an analysis so that any
- * necessary finalizations may be performed.
+ * necessary finalizations may be performed. Frames saved to be computed on
+ * several threads are computed now.
  *
  * @param s reference to the current state
  *
@@ -694,6 +851,7 @@ end(SimTK::State& s)
     if(!proceed()) return(0);
 
     record(s);
+    recordFrames();
 
     return(0);
 }
@@ -723,6 +881,10 @@ int JointReaction::
 printResults(const string &aBaseName,const string &aDir,double aDT,
                  const string &aExtension)
 {
+    // Frames saved to be computed on several threads, if the analysis did
+    // not end with a call to end()
+    recordFrames();
+
     // Reaction Loads
     Storage::printResult(&_storeReactionLoads,aBaseName+"_"+getName()+"_ReactionLoads",aDir,aDT,aExtension);
 
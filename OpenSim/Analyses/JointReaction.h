@@ -38,6 +38,8 @@
 #include <OpenSim/Common/PropertyStrArray.h>
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include "osimAnalysesDLL.h"
+#include <memory>
+#include <vector>
 
 
 //=============================================================================
@@ -46,6 +48,7 @@ namespace OpenSim {
 
 class Model;
 class Joint;
+class ScalarActuator;
 
 
 /**
@@ -57,6 +60,18 @@ class Joint;
  * the child, parent or ground frames. The default behavior is the the force
  * on the child expressed in the ground frame.
  *
+ * The reactions of all joints are computed with a single pass of
+ * SimTK::SimbodyMatterSubsystem::calcMobilizerReactionForces() per frame.
+ * When the analysis is run by the AnalyzeTool, the frames can be divided into
+ * contiguous ranges that are computed concurrently (see number_of_threads).
+ * The frames are then computed when the analysis ends, each thread working
+ * on the model itself if it was initialized for thread-safe evaluation
+ * (Model::setUseThreadSafeEvaluation()), or on its own copy of the model
+ * otherwise. The whole State of each frame is kept until then, including
+ * its discrete variables (e.g., overridden actuation, disabled forces and
+ * locked coordinates), which are copied into the State of the thread's
+ * model.
+ *
  * @author Matt DeMers, Ajay Seth
  * @version 1.0
  */
@@ -111,6 +126,10 @@ protected:
     PropertyStrArray _inFrameProp;
     Array<std::string> &_inFrame;
 
+    /** Number of threads computing ranges of frames concurrently. */
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
+
     //-----------------------------------------------------------------------
     // STORAGE
     //-----------------------------------------------------------------------
@@ -143,6 +162,32 @@ protected:
 
     bool _useForceStorage;
 
+    /** Column of _storeActuation holding the force of each actuator of the
+    *   model, or -1 if there is none.*/
+    std::vector<int> _actuatorColumns;
+
+#ifndef SWIG
+    /* A model computing reaction loads on one thread, with the joints,
+       frames and actuators of the model used by each JointReactionKey and
+       the buffers it works in. */
+    struct Worker {
+        Model* model;
+        std::unique_ptr<Model> ownedModel;
+        SimTK::State state;
+        std::vector<const Joint*> joints;
+        std::vector<const PhysicalFrame*> expressedInFrames;
+        std::vector<const ScalarActuator*> actuators;
+        SimTK::Vector_<SimTK::SpatialVec> reactionForces;
+        Array<double> forces;
+    };
+    // The first worker uses the analysis' own model
+    std::vector<std::unique_ptr<Worker> > _workers;
+
+    /* States of the frames yet to be computed when running on several
+       threads. */
+    std::vector<SimTK::State> _frameStates;
+#endif
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -186,6 +231,14 @@ public:
      /** Public accessors for the inFrame property */
     const Array<std::string>& getInFrame() const { return _inFrame; }
     void setInFrame( Array<std::string>& inFrame) { _inFrame = inFrame; }
+    /** Set the number of threads computing ranges of frames concurrently.
+    The default is 1, which computes each frame as it is recorded. With more
+    than one, a copy of the State of every frame is kept until the analysis
+    ends, or, when streaming with max_rows_in_memory set, until that many
+    frames (at least one per thread) are recorded, which are then computed
+    and streamed together. */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
 
     //-------------------------------------------------------------------------
     // INTEGRATION
@@ -214,6 +267,13 @@ protected:
     void constructColumnLabels();
     void setupStorage();
     void loadForcesFromFile();
+#ifndef SWIG
+    void setupWorkers(const SimTK::State& s);
+    void applyForcesFromStorage(Worker& worker, SimTK::State& s) const;
+    void computeLoads(Worker& worker, const SimTK::State& s,
+                      double* loads) const;
+    void recordFrames();
+#endif
 
 //=============================================================================
 }; // END of class JointReaction
@@ -0,0 +1,272 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  OutputReporter.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include <OpenSim/Simulation/Model/Model.h>
+#include "OutputReporter.h"
+
+using namespace OpenSim;
+using namespace std;
+
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Destructor.
+ */
+OutputReporter::~OutputReporter()
+{
+}
+//_____________________________________________________________________________
+/**
+ * Construct an OutputReporter for recording Outputs of the model during a
+ * simulation.
+ *
+ * @param aModel Model whose Outputs are to be recorded.
+ */
+OutputReporter::OutputReporter(Model *aModel) :
+    Analysis(aModel),
+    _outputStore(1000,"Outputs")
+{
+    setNull();
+    constructDescription();
+    setupStorage();
+}
+//_____________________________________________________________________________
+/**
+ * Construct an object from file.
+ *
+ * @param aFileName File name of the document.
+ */
+OutputReporter::OutputReporter(const std::string &aFileName):
+    Analysis(aFileName, false),
+    _outputStore(1000,"Outputs")
+{
+    setNull();
+
+    // Serialize from XML
+    updateFromXMLDocument();
+
+    constructDescription();
+    setupStorage();
+}
+//_____________________________________________________________________________
+/**
+ * Copy constructor.
+ */
+OutputReporter::OutputReporter(const OutputReporter &aReporter):
+    Analysis(aReporter),
+    _outputStore(aReporter._outputStore)
+{
+    setNull();
+    *this = aReporter;
+}
+
+//=============================================================================
+// CONSTRUCTION METHODS
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Set NULL values for all member variables.
+ */
+void OutputReporter::
+setNull()
+{
+    constructProperties();
+    setName("OutputReporter");
+}
+//_____________________________________________________________________________
+/**
+ * Construct the properties.
+ */
+void OutputReporter::
+constructProperties()
+{
+    constructProperty_output_paths();
+}
+//--------------------------------------------------------------------------
+// OPERATORS
+//--------------------------------------------------------------------------
+OutputReporter& OutputReporter::operator=(const OutputReporter &aReporter)
+{
+    // BASE CLASS
+    Analysis::operator=(aReporter);
+
+    // The row refers to the Outputs of the other reporter's model; it is
+    // rebuilt in begin().
+    _row.clear();
+    setupStorage();
+
+    return (*this);
+}
+//_____________________________________________________________________________
+/**
+ * Set up the storage of the Output values.
+ */
+void OutputReporter::
+setupStorage()
+{
+    _outputStore.setDescription(getDescription());
+    // Keep references to all storages in a list for uniform access from GUI
+    _storageList.setSize(0);
+    _storageList.append(&_outputStore);
+    _storageList.setMemoryOwner(false);
+}
+//_____________________________________________________________________________
+/**
+ * Construct the description for the OutputReporter files.
+ */
+void OutputReporter::
+constructDescription()
+{
+    setDescription("\nThis file contains the values of Outputs of the "
+        "components of a model during a simulation.\n"
+        "\nUnits are S.I. units (second, meters, Newtons, ...)\n\n");
+}
+//_____________________________________________________________________________
+/**
+ * Find the Outputs of the model, size the row of values and label the
+ * columns of the storage.
+ */
+void OutputReporter::
+setupRow(const SimTK::State& s)
+{
+    _row.clear();
+    for (int i = 0; i < getProperty_output_paths().size(); ++i)
+        _row.addOutput(_model->getOutput(get_output_paths(i)),
+                       get_output_paths(i));
+
+    _model->getMultibodySystem().realize(s, _row.getDependsOnStage());
+    _row.prepare(s);
+    _outputStore.setColumnLabels(_row.getColumnLabels());
+}
+
+//=============================================================================
+// ANALYSIS
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Record the values of the Outputs.
+ */
+int OutputReporter::
+record(const SimTK::State& s)
+{
+    if(_model==NULL) return(-1);
+
+    _model->getMultibodySystem().realize(s, _row.getDependsOnStage());
+
+    _outputStore.append(s.getTime(), _row.gather(s));
+
+    return(0);
+}
+//_____________________________________________________________________________
+/**
+ * Find the Outputs and record their initial values.
+ *
+ * @param s system State
+ *
+ * @return -1 on error, 0 otherwise.
+ */
+int OutputReporter::
+begin(SimTK::State& s)
+{
+    if(!proceed()) return(0);
+    if(_model==NULL) return(-1);
+
+    setupRow(s);
+    // RESET STORAGE
+    _outputStore.reset(s.getTime());
+
+    // RECORD
+    int status = 0;
+    if(_outputStore.getSize()<=0) {
+        status = record(s);
+    }
+
+    return(status);
+}
+//_____________________________________________________________________________
+/**
+ * Record the values of the Outputs at a step of the integration.
+ *
+ * @param s System state
+ *
+ * @return -1 on error, 0 otherwise.
+ */
+int OutputReporter::
+step(const SimTK::State& s, int stepNumber)
+{
+    if(!proceed(stepNumber)) return(0);
+
+    record(s);
+
+    return(0);
+}
+//_____________________________________________________________________________
+/**
+ * Record the values of the Outputs at the end of the integration.
+ *
+ * @param s System state
+ *
+ * @return -1 on error, 0 otherwise.
+ */
+int OutputReporter::
+end(SimTK::State& s)
+{
+    if (!proceed()) return 0;
+
+    record(s);
+
+    return(0);
+}
+
+//=============================================================================
+// IO
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Print results.
+ *
+ * The file name is constructed as
+ * aDir + "/" + aBaseName + "_" + ComponentName + "_outputs" + aExtension
+ *
+ * @return 0 on success, -1 on error.
+ */
+int OutputReporter::
+printResults(const string &aBaseName,const string &aDir,double aDT,
+                 const string &aExtension)
+{
+    if(!getOn()) {
+        printf("OutputReporter.printResults: Off- not printing.\n");
+        return(0);
+    }
+
+    std::string prefix=aBaseName+"_"+getName()+"_";
+    Storage::printResult(&_outputStore, prefix+"outputs", aDir, aDT, aExtension);
+
+    return(0);
+}
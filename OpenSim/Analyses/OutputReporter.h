@@ -0,0 +1,137 @@
+#ifndef OPENSIM_OUTPUT_REPORTER_H_
+#define OPENSIM_OUTPUT_REPORTER_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  OutputReporter.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/OutputRow.h>
+#include <OpenSim/Simulation/Model/Analysis.h>
+#include "osimAnalysesDLL.h"
+
+#ifdef SWIG
+    #ifdef OSIMANALYSES_API
+        #undef OSIMANALYSES_API
+        #define OSIMANALYSES_API
+    #endif
+#endif
+//=============================================================================
+//=============================================================================
+namespace OpenSim { 
+
+/**
+ * A class for recording the values of a list of Outputs of the components of
+ * a model during a simulation.
+ *
+ * Each Output is named by its path from the model, e.g., "com_position" for
+ * an Output of the model itself or "TRIlong/actuation" for an Output of a
+ * component. At each step, the values of all Outputs are gathered into one
+ * preallocated row (see OutputRow) and appended to the storage, so hundreds
+ * of Outputs can be reported with little overhead per step. Outputs with
+ * several elements (e.g., a Vec3) are reported in one column per element.
+ */
+class OSIMANALYSES_API OutputReporter : public Analysis {
+OpenSim_DECLARE_CONCRETE_OBJECT(OutputReporter, Analysis);
+public:
+//=============================================================================
+// PROPERTIES
+//=============================================================================
+    OpenSim_DECLARE_LIST_PROPERTY(output_paths, std::string,
+        "Paths (from the model) of the Outputs to record, e.g., "
+        "com_position or TRIlong/actuation.");
+
+//=============================================================================
+// DATA
+//=============================================================================
+protected:
+    /** Output values storage. */
+    Storage _outputStore;
+
+private:
+    OutputRow _row;
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+    OutputReporter(Model *aModel=0);
+    OutputReporter(const std::string &aFileName);
+    OutputReporter(const OutputReporter &aObject);
+    virtual ~OutputReporter();
+
+private:
+    void setNull();
+    void constructProperties();
+    void constructDescription();
+    void setupStorage();
+    void setupRow(const SimTK::State& s);
+
+public:
+    //--------------------------------------------------------------------------
+    // OPERATORS
+    //--------------------------------------------------------------------------
+#ifndef SWIG
+    OutputReporter& operator=(const OutputReporter &aReporter);
+#endif
+    //--------------------------------------------------------------------------
+    // GET AND SET
+    //--------------------------------------------------------------------------
+    /** Add the Output with this path to those recorded. */
+    void addOutputPath(const std::string& path) { append_output_paths(path); }
+
+    // STORAGE
+    const Storage& getOutputStorage() const
+    {
+        return _outputStore;
+    };
+    Storage& updOutputStorage()
+    {
+        return _outputStore;
+    }
+    //--------------------------------------------------------------------------
+    // ANALYSIS
+    //--------------------------------------------------------------------------
+    int begin(SimTK::State& s) override;
+    int step(const SimTK::State& s, int setNumber) override;
+    int end(SimTK::State& s) override;
+protected:
+    virtual int
+        record(const SimTK::State& s );
+    //--------------------------------------------------------------------------
+    // IO
+    //--------------------------------------------------------------------------
+public:
+    int printResults(const std::string &aBaseName,const std::string &aDir="",
+        double aDT=-1.0,const std::string &aExtension=".sto") override;
+
+//=============================================================================
+};  // END of class OutputReporter
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+
+#endif // #ifndef OPENSIM_OUTPUT_REPORTER_H_
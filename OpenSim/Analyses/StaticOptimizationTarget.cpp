@@ -35,6 +35,7 @@
 #include <OpenSim/Simulation/Model/ActivationFiberLengthMuscle.h>
 #include <OpenSim/Simulation/Model/ForceSet.h>
 #include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
+#include <OpenSim/Simulation/AccelerationSolver.h>
 #include "StaticOptimizationTarget.h"
 #include <iostream>
 
@@ -130,18 +131,35 @@ prepareToOptimize(SimTK::State& s, double *x)
     _constraintMatrix.resize(nc,np);
     _constraintVector.resize(nc);
 
-    Vector pVector(np), cVector(nc);
+    Vector pVector(np);
 
-    // Build linear constraint matrix and constant constraint vector
+    // Build constant constraint vector with all actuations at zero
     pVector = 0;
     computeConstraintVector(s, pVector,_constraintVector);
 
-    for(int p=0; p<np; p++) {
-        pVector[p] = 1;
-        computeConstraintVector(s, pVector, cVector);
-        for(int c=0; c<nc; c++) _constraintMatrix(c,p) = (cVector[c] - _constraintVector[c]);
-        pVector[p] = 0;
+    // Build linear constraint matrix from the accelerations caused by the
+    // generalized force of each actuator at unit parameter value, solved
+    // together with the equations of motion factored once
+    const ForceSet& fs = _model->getForceSet();
+    Matrix forceDirections(s.getNU(), np, 0.0);
+    SimTK::Vector_<SimTK::SpatialVec> bodyForces;
+    Vector mobilityForces, generalizedForces;
+    AccelerationSolver solver(*_model);
+    for(int p=0; p<np && p<fs.getSize(); p++) {
+        ScalarActuator *act = dynamic_cast<ScalarActuator*>(&fs.get(p));
+        if(!act) continue;
+        act->setOverrideActuation(s, _optimalForce[p]);
+        act->calcForceContribution(s, bodyForces, mobilityForces);
+        act->setOverrideActuation(s, 0.0);
+        solver.calcGeneralizedForces(s, mobilityForces, bodyForces, generalizedForces);
+        forceDirections(p) = generalizedForces;
     }
+    solver.factor(s);
+    Matrix udot;
+    solver.solveLinear(forceDirections, udot);
+
+    for(int p=0; p<np; p++)
+        for(int c=0; c<nc; c++) _constraintMatrix(c,p) = -udot(_accelerationIndices[c], p);
 #endif
 
     // return false to indicate that we still need to proceed with optimization
@@ -0,0 +1,190 @@
+#ifndef OPENSIM_AUXILIARY_BENCHMARK_FUNCTIONS_H_
+#define OPENSIM_AUXILIARY_BENCHMARK_FUNCTIONS_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  benchmarkFunctions.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Common/Exception.h>
+#include "SimTKcommon.h"
+#include "getRSS.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Times a number of workloads and writes the results to the console and to a
+ * JSON file, in the layout used by Google Benchmark so that the same tools
+ * can compare the results of two builds.
+ *
+ * Each workload is a function that runs one iteration and returns the number
+ * of items (frames, evaluations, ...) it processed. It is called repeatedly
+ * until it has run for at least the minimum time, and the mean, minimum and
+ * standard deviation of the time per iteration are reported, along with the
+ * items processed per second and the peak resident memory of the process.
+ *
+ * The command line options are those of Google Benchmark:
+ *   --benchmark_out=<file>         JSON output file (default <suite>.json)
+ *   --benchmark_filter=<text>      run only workloads whose name contains text
+ *   --benchmark_min_time=<seconds> minimum time for each workload
+ */
+class BenchmarkSuite {
+public:
+    BenchmarkSuite(const std::string& name, int argc, char** argv,
+                   double minTime = 0.5) :
+        _name(name), _outFile(name + ".json"), _minTime(minTime)
+    {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg(argv[i]);
+            if (arg.find("--benchmark_out=") == 0)
+                _outFile = arg.substr(16);
+            else if (arg.find("--benchmark_filter=") == 0)
+                _filter = arg.substr(19);
+            else if (arg.find("--benchmark_min_time=") == 0)
+                _minTime = std::atof(arg.substr(21).c_str());
+        }
+        std::cout << std::left << std::setw(44) << "Benchmark"
+                  << std::right << std::setw(14) << "Time (ms)"
+                  << std::setw(14) << "Min (ms)" << std::setw(12)
+                  << "Iterations" << std::setw(16) << "Items/s" << std::endl;
+    }
+
+    /** Time iteration(), which returns the number of items it processed.
+    Nothing is timed if the name does not pass the filter. */
+    void run(const std::string& name, const std::function<double()>& iteration)
+    {
+        if (!_filter.empty() && name.find(_filter) == std::string::npos)
+            return;
+
+        Result result;
+        result.name = name;
+        std::vector<double> times;
+        double items = 0, total = 0, cpuTotal = 0;
+        while (total < _minTime || times.empty()) {
+            std::clock_t cpuStart = std::clock();
+            double start = SimTK::realTime();
+            items += iteration();
+            double elapsed = SimTK::realTime() - start;
+            cpuTotal += double(std::clock() - cpuStart)/CLOCKS_PER_SEC;
+            times.push_back(elapsed);
+            total += elapsed;
+        }
+
+        const int n = (int)times.size();
+        result.iterations = n;
+        result.realTime = total/n;
+        result.cpuTime = cpuTotal/n;
+        result.minTime = *std::min_element(times.begin(), times.end());
+        double variance = 0;
+        for (int i = 0; i < n; ++i)
+            variance += (times[i]-result.realTime)*(times[i]-result.realTime);
+        result.stddev = n > 1 ? std::sqrt(variance/(n-1)) : 0;
+        result.itemsPerSecond = items/total;
+        result.peakMemory = (double)getPeakRSS();
+        _results.push_back(result);
+
+        std::cout << std::left << std::setw(44) << name << std::right
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(14) << 1e3*result.realTime
+                  << std::setw(14) << 1e3*result.minTime
+                  << std::setw(12) << n << std::setprecision(1)
+                  << std::setw(16) << result.itemsPerSecond << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    /** Write the results of all workloads run to the JSON file. */
+    void writeResults() const
+    {
+        std::ofstream out(_outFile.c_str());
+        if (!out)
+            throw OpenSim::Exception("BenchmarkSuite: ERROR- could not open "
+                                     + _outFile + ".", __FILE__, __LINE__);
+
+        char date[64];
+        std::time_t now = std::time(NULL);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S",
+                      std::localtime(&now));
+
+        out << std::setprecision(9);
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"executable\": \"" << escape(_name) << "\",\n"
+            << "    \"num_cpus\": " << std::thread::hardware_concurrency()
+            << ",\n"
+#ifdef NDEBUG
+            << "    \"library_build_type\": \"release\"\n"
+#else
+            << "    \"library_build_type\": \"debug\"\n"
+#endif
+            << "  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < _results.size(); ++i) {
+            const Result& r = _results[i];
+            out << (i == 0 ? "\n" : ",\n")
+                << "    {\n"
+                << "      \"name\": \"" << escape(r.name) << "\",\n"
+                << "      \"iterations\": " << r.iterations << ",\n"
+                << "      \"real_time\": " << 1e3*r.realTime << ",\n"
+                << "      \"cpu_time\": " << 1e3*r.cpuTime << ",\n"
+                << "      \"min_time\": " << 1e3*r.minTime << ",\n"
+                << "      \"stddev_time\": " << 1e3*r.stddev << ",\n"
+                << "      \"time_unit\": \"ms\",\n"
+                << "      \"items_per_second\": " << r.itemsPerSecond << ",\n"
+                << "      \"peak_memory_bytes\": " << r.peakMemory << "\n"
+                << "    }";
+        }
+        out << "\n  ]\n}\n";
+        std::cout << "Wrote " << _results.size() << " results to "
+                  << _outFile << "." << std::endl;
+    }
+
+private:
+    struct Result {
+        std::string name;
+        int iterations;
+        double realTime, cpuTime, minTime, stddev;
+        double itemsPerSecond, peakMemory;
+    };
+
+    static std::string escape(const std::string& text)
+    {
+        std::string escaped;
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] == '"' || text[i] == '\\') escaped += '\\';
+            escaped += text[i];
+        }
+        return escaped;
+    }
+
+    std::string _name;
+    std::string _outFile;
+    std::string _filter;
+    double _minTime;
+    std::vector<Result> _results;
+};
+
+#endif // OPENSIM_AUXILIARY_BENCHMARK_FUNCTIONS_H_
@@ -24,6 +24,7 @@
 
 // INCLUDES
 #include "OpenSim/Common/Component.h"
+#include "OpenSim/Common/ComponentProfiler.h"
 //#include "OpenSim/Common/ComponentOutput.h"
 
 using namespace SimTK;
@@ -335,9 +336,10 @@ addModelingOption(const std::string& optionName, int maxFlagValue) const
     _namedModelingOptionInfo[optionName] = ModelingOptionInfo(maxFlagValue);
 }
 
-void Component::addStateVariable(const std::string&  stateVariableName,
-                                 const SimTK::Stage& invalidatesStage,
-                                 bool isHidden) const
+Component::StateVariableHandle
+Component::addStateVariable(const std::string&  stateVariableName,
+                            const SimTK::Stage& invalidatesStage,
+                            bool isHidden) const
 {
     if( (invalidatesStage < Stage::Position) ||
         (invalidatesStage > Stage::Dynamics)) {
@@ -348,11 +350,12 @@ void Component::addStateVariable(const std::string&  stateVariableName,
     AddedStateVariable* asv =
         new AddedStateVariable(stateVariableName, *this, invalidatesStage, isHidden);
     // Add it to the Component and let it take ownership
-    addStateVariable(asv);
+    return addStateVariable(asv);
 }
 
 
-void Component::addStateVariable(Component::StateVariable*  stateVariable) const
+Component::StateVariableHandle
+Component::addStateVariable(Component::StateVariable*  stateVariable) const
 {
     const std::string& stateVariableName = stateVariable->getName();
     // don't add state if there is another state variable with the same name 
@@ -372,20 +375,23 @@ void Component::addStateVariable(Component::StateVariable*  stateVariable) const
     _namedStateVariableInfo[stateVariableName] =
         StateVariableInfo(stateVariable, order);
 
-    const AddedStateVariable* asv =
-        dynamic_cast<const Component::AddedStateVariable *>(stateVariable);
+    AddedStateVariable* asv =
+        dynamic_cast<Component::AddedStateVariable *>(stateVariable);
     // Now automatically add a cache variable to hold the derivative
     // to enable a similar interface for setting and getting the derivatives
     // based on the creator specified state name
     if(asv){
-        addCacheVariable(stateVariableName+"_deriv", 0.0, Stage::Dynamics);
+        asv->derivative =
+            addCacheVariable(stateVariableName+"_deriv", 0.0, Stage::Dynamics);
     }
 
+    return StateVariableHandle(*this, *stateVariable);
 }
 
 
-void Component::addDiscreteVariable(const std::string&  discreteVariableName, 
-                                    SimTK::Stage        invalidatesStage) const
+Component::DiscreteVariable
+Component::addDiscreteVariable(const std::string&  discreteVariableName, 
+                               SimTK::Stage        invalidatesStage) const
 {
     // don't add discrete var if there is another discrete variable with the 
     // same name for this component
@@ -398,8 +404,26 @@ void Component::addDiscreteVariable(const std::string&  discreteVariableName,
     // assign "slots" for the the discrete variables by name
     // discrete variable indices will be invalid by default
     // upon allocation during realizeTopology the indices will be set
-    _namedDiscreteVariableInfo[discreteVariableName] = 
-        DiscreteVariableInfo(invalidatesStage);
+    DiscreteVariableInfo& info = _namedDiscreteVariableInfo[discreteVariableName];
+    info = DiscreteVariableInfo(invalidatesStage);
+    return DiscreteVariable(*this, info.index);
+}
+
+void Component::throwInvalidVariableHandle(const VariableHandle& handle,
+                                           const char* caller) const
+{
+    std::stringstream msg;
+    msg << "Component::" << caller << ": ERR- ";
+    if (handle.isEmpty())
+        msg << "the variable handle is empty.\n ";
+    else if (handle._owner != this)
+        msg << "the variable handle belongs to another component.\n ";
+    else
+        msg << "the variable handle is from an earlier allocation of the "
+               "component's variables.\n ";
+    msg << "for component '" << getName() << "' of type "
+        << getConcreteClassName();
+    throw Exception(msg.str(),__FILE__,__LINE__);
 }
 
 // Get the value of a ModelingOption flag for this Component.
@@ -624,6 +648,26 @@ Array<std::string> Component::getStateVariableNames() const
     return names;
 }
 
+Array<std::string> Component::getDiscreteVariableNames() const
+{
+    Array<std::string> names;
+    std::map<std::string, DiscreteVariableInfo>::const_iterator it;
+    for(it = _namedDiscreteVariableInfo.begin();
+        it != _namedDiscreteVariableInfo.end(); ++it)
+        names.append(it->first);
+    return names;
+}
+
+Array<std::string> Component::getModelingOptionNames() const
+{
+    Array<std::string> names;
+    std::map<std::string, ModelingOptionInfo>::const_iterator it;
+    for(it = _namedModelingOptionInfo.begin();
+        it != _namedModelingOptionInfo.end(); ++it)
+        names.append(it->first);
+    return names;
+}
+
 // Get the value of a state variable allocated by this Component.
 double Component::
     getStateVariableValue(const SimTK::State& s, const std::string& name) const
@@ -878,6 +922,13 @@ getDiscreteVariableIndex(const std::string& name) const
     return it->second.index;
 }
 
+void Component::setOutputCaching(const std::string& name, bool cache)
+{
+    // The Output belongs to this Component or one of its subcomponents, which
+    // are as writable as this one is.
+    const_cast<AbstractOutput&>(getOutput(name)).setCached(cache);
+}
+
 const SimTK::CacheEntryIndex Component::
 getCacheVariableIndex(const std::string& name) const
 {
@@ -974,6 +1025,10 @@ void Component::extendRealizeTopology(SimTK::State& s) const
                (s, ci.dependsOnStage, ci.prototype->clone());
         }
     }
+
+    // Allocate cache entries for the Outputs to be cached
+    for (OutputsIterator it = getOutputsBegin(); it != getOutputsEnd(); ++it)
+        it->second->allocateCacheEntry(s, subSys);
 }
 
 
@@ -989,7 +1044,10 @@ void Component::extendRealizeAcceleration(const SimTK::State& s) const
         const SimTK::Subsystem& subSys = getDefaultSubsystem();
 
         // evaluate and set component state derivative values (in cache) 
-        computeStateVariableDerivatives(s);
+        {
+            OPENSIM_PROFILE_SCOPE(*this, "computeStateVariableDerivatives");
+            computeStateVariableDerivatives(s);
+        }
     
         std::map<std::string, StateVariableInfo>::const_iterator it;
 
@@ -1071,13 +1129,13 @@ void Component::AddedStateVariable::setValue(SimTK::State& state, double value)
 double Component::AddedStateVariable::
     getDerivative(const SimTK::State& state) const
 {
-    return getOwner().getCacheVariableValue<double>(state, getName()+"_deriv");
+    return getOwner().getCacheVariableValue(state, derivative);
 }
 
 void Component::AddedStateVariable::
     setDerivative(const SimTK::State& state, double deriv) const
 {
-    return getOwner().setCacheVariableValue<double>(state, getName()+"_deriv", deriv);
+    getOwner().setCacheVariableValue(state, derivative, deriv);
 }
 
 
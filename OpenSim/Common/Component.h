@@ -373,6 +373,19 @@ public:
      */
     Array<std::string> getStateVariableNames() const;
 
+    /**
+     * Get the names of the discrete variables allocated by this Component
+     * itself, not including those of its subcomponents, as accepted by
+     * getDiscreteVariableValue()
+     */
+    Array<std::string> getDiscreteVariableNames() const;
+
+    /**
+     * Get the names of the modeling options of this Component itself, not
+     * including those of its subcomponents, as accepted by getModelingOption()
+     */
+    Array<std::string> getModelingOptionNames() const;
+
 
     /** @name Component Connector Access methods
         Access Connectors of this component in a generic way and also by name.
@@ -561,6 +574,18 @@ public:
         return _outputsTable.end();
     }
 
+    /**
+    * Cache the value of the named Output in the State, so that it is computed
+    * once per realization of its dependsOnStage no matter how many consumers
+    * read it. Like getOutput(), name may be the path of an Output of a
+    * subcomponent. This takes effect when the System is next created (e.g.,
+    * by Model::initSystem()).
+    *
+    * @param name   the name of the Output
+    * @param cache  whether to cache its value
+    */
+    void setOutputCaching(const std::string& name, bool cache);
+
     //@} end of Component Inputs and Outputs Access methods
 
 
@@ -892,6 +917,72 @@ class StateVariable;
 // Give the ComponentMeasure access to the realize() methods.
 template <class T> friend class ComponentMeasure;
 
+    /** Base of the handles returned by addCacheVariable(),
+    addDiscreteVariable() and addStateVariable(). A handle refers to its
+    variable by the variable's index in the State, so accessing the variable
+    through it does not look up the variable's name. A handle is valid only
+    for the Component that returned it, and only until that Component's
+    variables are allocated again (e.g., by the next Model::initSystem());
+    keep the handle returned by the most recent allocation, typically in a
+    mutable member assigned in extendAddToSystem(). Using a handle of another
+    Component, such as the one a Component was copied from, or of an earlier
+    allocation, throws an Exception. */
+    class VariableHandle {
+    public:
+        /** Whether this handle was default constructed rather than returned
+        by a Component. */
+        bool isEmpty() const { return _owner == nullptr; }
+    protected:
+        VariableHandle() : _owner(nullptr), _allocation(-1) {}
+        explicit VariableHandle(const Component& owner)
+        :   _owner(&owner), _allocation(owner._allocationCount) {}
+    private:
+        friend class Component;
+        const Component* _owner;
+        int _allocation;
+    };
+
+    /** Handle to a cache variable of type T, returned by addCacheVariable().
+    @see VariableHandle */
+    template <class T> class CacheVariable : public VariableHandle {
+    public:
+        CacheVariable() : _index(nullptr) {}
+    private:
+        friend class Component;
+        CacheVariable(const Component& owner,
+                      const SimTK::CacheEntryIndex& index)
+        :   VariableHandle(owner), _index(&index) {}
+        // Points into the Component's table of cache variables, whose index
+        // is assigned when the System's topology is realized.
+        const SimTK::CacheEntryIndex* _index;
+    };
+
+    /** Handle to a discrete variable, returned by addDiscreteVariable().
+    @see VariableHandle */
+    class DiscreteVariable : public VariableHandle {
+    public:
+        DiscreteVariable() : _index(nullptr) {}
+    private:
+        friend class Component;
+        DiscreteVariable(const Component& owner,
+                         const SimTK::DiscreteVariableIndex& index)
+        :   VariableHandle(owner), _index(&index) {}
+        const SimTK::DiscreteVariableIndex* _index;
+    };
+
+    /** Handle to a state variable, returned by addStateVariable().
+    @see VariableHandle */
+    class StateVariableHandle : public VariableHandle {
+    public:
+        StateVariableHandle() : _variable(nullptr) {}
+    private:
+        friend class Component;
+        StateVariableHandle(const Component& owner,
+                            const StateVariable& variable)
+        :   VariableHandle(owner), _variable(&variable) {}
+        const StateVariable* _variable;
+    };
+
   /** Single call to construct the underlying infrastructure of a Component, which
      include: 1) its properties, 2) its structural connectors (to other components),
      3) its Inputs (slots) for expected Output(s) of other components and, 4) its 
@@ -1169,9 +1260,18 @@ template <class T> friend class ComponentMeasure;
      * @param name   the name of the state variable
      * @param deriv  the derivative value to set
      */
-    void setStateVariableDerivativeValue(const SimTK::State& state, 
+    void setStateVariableDerivativeValue(const SimTK::State& state,
                             const std::string& name, double deriv) const;
 
+    /** Set the derivative of a state variable added by this Component through
+    the handle addStateVariable() returned. */
+    void setStateVariableDerivativeValue(const SimTK::State& state,
+                            const StateVariableHandle& sv, double deriv) const
+    {
+        checkVariableHandle(sv, "setStateVariableDerivativeValue");
+        sv._variable->setDerivative(state, deriv);
+    }
+
 
     // End of Component Extension Interface (protected virtuals).
     ///@} 
@@ -1400,7 +1500,7 @@ template <class T> friend class ComponentMeasure;
                                      variable from being accessed outside this
                                      component as an Output
     */
-    void addStateVariable(const std::string&  stateVariableName,
+    StateVariableHandle addStateVariable(const std::string& stateVariableName,
          const SimTK::Stage& invalidatesStage=SimTK::Stage::Dynamics,
          bool isHidden = false) const;
 
@@ -1418,13 +1518,14 @@ template <class T> friend class ComponentMeasure;
 
     @see constructOutputForStateVariable()
     */
-    void addStateVariable(Component::StateVariable*  stateVariable) const;
+    StateVariableHandle
+    addStateVariable(Component::StateVariable*  stateVariable) const;
 
     /** Add a system discrete variable belonging to this Component, give
     it a name by which it can be referenced, and declare the lowest Stage that
     should be invalidated if this variable's value is changed. **/
-    void addDiscreteVariable(const std::string& discreteVariableName,
-                             SimTK::Stage       invalidatesStage) const;
+    DiscreteVariable addDiscreteVariable(const std::string& discreteVariableName,
+                                         SimTK::Stage invalidatesStage) const;
 
     /** Add a state cache entry belonging to this Component to hold
     calculated values that must be automatically invalidated when certain 
@@ -1457,18 +1558,108 @@ template <class T> friend class ComponentMeasure;
     @param[in]      dependsOnStage      
         This is the highest computational stage on which this cache entry's
         value computation depends. State changes at this level or lower will
-        invalidate the cache entry. **/ 
-    template <class T> void 
+        invalidate the cache entry.
+    @return a handle through which to access the cache entry without looking
+        up its name. **/ 
+    template <class T> CacheVariable<T> 
     addCacheVariable(const std::string&     cacheVariableName,
                      const T&               variablePrototype, 
                      SimTK::Stage           dependsOnStage) const
     {
         // Note, cache index is invalid until the actual allocation occurs 
         // during realizeTopology.
-        _namedCacheVariableInfo[cacheVariableName] = 
-            CacheInfo(new SimTK::Value<T>(variablePrototype), dependsOnStage);
+        CacheInfo& info = _namedCacheVariableInfo[cacheVariableName];
+        info = CacheInfo(new SimTK::Value<T>(variablePrototype), dependsOnStage);
+        return CacheVariable<T>(*this, info.index);
     }
 
+    /** @name  Access to variables through their handles
+    These do the same as the accessors that take the name of the variable,
+    using the handle that addCacheVariable(), addDiscreteVariable() or
+    addStateVariable() returned instead of looking up the name. They are meant
+    for the evaluation methods of Components, which may be called many times
+    for each step of a simulation. */
+    //@{
+    template<typename T> const T&
+    getCacheVariableValue(const SimTK::State& state,
+                          const CacheVariable<T>& cv) const
+    {
+        checkVariableHandle(cv, "getCacheVariableValue");
+        return SimTK::Value<T>::downcast(
+            getDefaultSubsystem().getCacheEntry(state, *cv._index)).get();
+    }
+    template<typename T> T&
+    updCacheVariableValue(const SimTK::State& state,
+                          const CacheVariable<T>& cv) const
+    {
+        checkVariableHandle(cv, "updCacheVariableValue");
+        return SimTK::Value<T>::downcast(
+            getDefaultSubsystem().updCacheEntry(state, *cv._index)).upd();
+    }
+    template<typename T> void
+    setCacheVariableValue(const SimTK::State& state, const CacheVariable<T>& cv,
+                          const T& value) const
+    {
+        checkVariableHandle(cv, "setCacheVariableValue");
+        SimTK::Value<T>::downcast(
+            getDefaultSubsystem().updCacheEntry(state, *cv._index)).upd()
+            = value;
+        getDefaultSubsystem().markCacheValueRealized(state, *cv._index);
+    }
+    template<typename T> void
+    markCacheVariableValid(const SimTK::State& state,
+                           const CacheVariable<T>& cv) const
+    {
+        checkVariableHandle(cv, "markCacheVariableValid");
+        getDefaultSubsystem().markCacheValueRealized(state, *cv._index);
+    }
+    template<typename T> void
+    markCacheVariableInvalid(const SimTK::State& state,
+                             const CacheVariable<T>& cv) const
+    {
+        checkVariableHandle(cv, "markCacheVariableInvalid");
+        getDefaultSubsystem().markCacheValueNotRealized(state, *cv._index);
+    }
+    template<typename T> bool
+    isCacheVariableValid(const SimTK::State& state,
+                         const CacheVariable<T>& cv) const
+    {
+        checkVariableHandle(cv, "isCacheVariableValid");
+        return getDefaultSubsystem().isCacheValueRealized(state, *cv._index);
+    }
+
+    double getDiscreteVariableValue(const SimTK::State& state,
+                                    const DiscreteVariable& dv) const
+    {
+        checkVariableHandle(dv, "getDiscreteVariableValue");
+        return SimTK::Value<double>::downcast(
+            getDefaultSubsystem().getDiscreteVariable(state, *dv._index)).get();
+    }
+    void setDiscreteVariableValue(SimTK::State& state,
+                                  const DiscreteVariable& dv,
+                                  double value) const
+    {
+        checkVariableHandle(dv, "setDiscreteVariableValue");
+        SimTK::Value<double>::downcast(
+            getDefaultSubsystem().updDiscreteVariable(state, *dv._index)).upd()
+            = value;
+    }
+
+    double getStateVariableValue(const SimTK::State& state,
+                                 const StateVariableHandle& sv) const
+    {
+        checkVariableHandle(sv, "getStateVariableValue");
+        return sv._variable->getValue(state);
+    }
+    void setStateVariableValue(SimTK::State& state,
+                               const StateVariableHandle& sv,
+                               double value) const
+    {
+        checkVariableHandle(sv, "setStateVariableValue");
+        sv._variable->setValue(state, value);
+    }
+    //@}
+
     
     /**
      * Get writeable reference to the MultibodySystem that this component is
@@ -1595,8 +1786,20 @@ private:
         _namedStateVariableInfo.clear();
         _namedDiscreteVariableInfo.clear();
         _namedCacheVariableInfo.clear();    
+        // Handles to the variables cleared above are no longer valid.
+        ++_allocationCount;
     }
 
+    // Throw if handle was not returned by this Component since its variables
+    // were last cleared.
+    void checkVariableHandle(const VariableHandle& handle,
+                             const char* caller) const {
+        if (handle._owner != this || handle._allocation != _allocationCount)
+            throwInvalidVariableHandle(handle, caller);
+    }
+    void throwInvalidVariableHandle(const VariableHandle& handle,
+                                    const char* caller) const;
+
     // Reset by clearing underlying system indices, disconnecting connectors and
     // creating a fresh connectorsTable.
     void reset() {
@@ -1637,7 +1840,8 @@ protected:
     //AddedStateVariable implements the interface and automatically handles state
     //variable access.
     class StateVariable {
-        friend void Component::addStateVariable(StateVariable* sv) const;
+        friend StateVariableHandle
+            Component::addStateVariable(StateVariable* sv) const;
     public:
         StateVariable() : name(""), owner(nullptr),
             subsysIndex(SimTK::InvalidIndex), varIndex(SimTK::InvalidIndex),
@@ -1776,6 +1980,10 @@ private:
         double getDerivative(const SimTK::State& state) const override;
         void setDerivative(const SimTK::State& state, double deriv) const override;
 
+        // The cache variable that holds the derivative, which
+        // Component::addStateVariable() adds along with this state variable.
+        CacheVariable<double> derivative;
+
         private: // DATA
         // Changes in state variables trigger recalculation of appropriate cache 
         // variables by automatically invalidating the realization stage specified
@@ -1857,6 +2065,9 @@ private:
     // Map names of cache entries of the Component to their individual 
     // cache information.
     mutable std::map<std::string, CacheInfo>            _namedCacheVariableInfo;
+    // Number of times the maps above were cleared, which identifies the
+    // VariableHandles returned since. Not copied with the Component.
+    int _allocationCount = 0;
 //==============================================================================
 };  // END of class Component
 //==============================================================================
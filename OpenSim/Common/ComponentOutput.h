@@ -60,13 +60,27 @@ namespace OpenSim {
  * the overhead is a single redirect to the corresponding member function
  * for the value.
  *
+ * An Output that is read by several consumers (reporters, probes, controllers)
+ * at the same state can instead be cached (see Component::setOutputCaching()).
+ * Its value is then kept in a lazy cache entry of the State that depends on
+ * the Output's dependsOnStage: it is computed by the first call to getValue()
+ * and returned directly by later calls, until the State changes at or below
+ * that stage. Only cache Outputs whose dependsOnStage is accurate.
+ *
+ * The values of Outputs of the common numeric types (double, SimTK::Vec, 
+ * SimTK::Vector and their compositions, such as SimTK::SpatialVec) can also 
+ * be written as a sequence of doubles, which OutputRow uses to gather many
+ * Outputs into one row.
+ *
  * @author  Ajay Seth
  */
 class OSIMCOMMON_API AbstractOutput {
 public:
-    AbstractOutput() : numSigFigs(8), dependsOnStage(SimTK::Stage::Infinity) {}
+    AbstractOutput() : numSigFigs(8), dependsOnStage(SimTK::Stage::Infinity),
+        cached(false) {}
     AbstractOutput(const std::string& name, SimTK::Stage dependsOnStage) : 
-        name(name), dependsOnStage(dependsOnStage), numSigFigs(8) {}
+        name(name), dependsOnStage(dependsOnStage), numSigFigs(8),
+        cached(false) {}
     virtual ~AbstractOutput() { }
 
     /** Output's name */
@@ -77,6 +91,14 @@ public:
     /** Output Interface */
     virtual std::string     getTypeName() const = 0;
     virtual std::string     getValueAsString(const SimTK::State& state) const = 0;
+    /** The number of doubles getValueAsDoubles() writes for the value at this
+    state, or -1 if values of this Output's type cannot be written as doubles. */
+    virtual int getNumberOfDoubles(const SimTK::State& state) const = 0;
+    /** Write the value at this state as a sequence of doubles, in the order of
+    its elements, to values, which has room for maxValues doubles. Returns the
+    number of doubles written; throws if there is not enough room. */
+    virtual int getValueAsDoubles(const SimTK::State& state,
+                                  double* values, int maxValues) const = 0;
     virtual bool        isCompatible(const AbstractOutput&) const = 0;
     virtual void compatibleAssign(const AbstractOutput&) = 0;
 
@@ -90,13 +112,75 @@ public:
     void         setNumberOfSignificantDigits(unsigned int numSigFigs) 
     { numSigFigs = numSigFigs; }
 
+    /** Whether the value is cached in the State. Set this with
+    Component::setOutputCaching() before the System is created. */
+    bool isCached() const { return cached; }
+    void setCached(bool cache) { cached = cache; }
+
+    /** Allocate the cache entry of a cached Output in the given Subsystem.
+    The owning Component calls this when the System's topology is realized. */
+    virtual void allocateCacheEntry(SimTK::State& state,
+                                    const SimTK::Subsystem& subsystem) const = 0;
+
 private:
     unsigned int numSigFigs;
     SimTK::Stage dependsOnStage;
     std::string name;
+    bool cached;
 //=============================================================================
 };  // END class AbstractOutput
 
+/** @cond **/ // hide from Doxygen
+// How values of type T are written as a sequence of doubles. Types that are
+// not specialized here cannot be.
+template <class T>
+struct OutputValueDoubles {
+    static const bool isSupported = false;
+    static int size(const T&) { return -1; }
+    static int copy(const T&, double*) { return 0; }
+};
+
+template <>
+struct OutputValueDoubles<double> {
+    static const bool isSupported = true;
+    static int size(const double&) { return 1; }
+    static int copy(const double& value, double* values)
+    {   values[0] = value; return 1; }
+};
+
+template <int M, class E, int S>
+struct OutputValueDoubles<SimTK::Vec<M, E, S> > {
+    static const bool isSupported = OutputValueDoubles<E>::isSupported;
+    static int size(const SimTK::Vec<M, E, S>& value)
+    {   return isSupported ? M*OutputValueDoubles<E>::size(value[0]) : -1; }
+    static int copy(const SimTK::Vec<M, E, S>& value, double* values)
+    {
+        int n = 0;
+        for (int i = 0; i < M; ++i)
+            n += OutputValueDoubles<E>::copy(value[i], values+n);
+        return n;
+    }
+};
+
+template <class E>
+struct OutputValueDoubles<SimTK::Vector_<E> > {
+    static const bool isSupported = OutputValueDoubles<E>::isSupported;
+    static int size(const SimTK::Vector_<E>& value)
+    {
+        if (!isSupported) return -1;
+        return value.size() == 0 ? 0 :
+               value.size()*OutputValueDoubles<E>::size(value[0]);
+    }
+    static int copy(const SimTK::Vector_<E>& value, double* values)
+    {
+        int n = 0;
+        for (int i = 0; i < value.size(); ++i)
+            n += OutputValueDoubles<E>::copy(value[i], values+n);
+        return n;
+    }
+};
+/** @endcond **/
+
 template<class T>
 class Output : public AbstractOutput {
 public:
@@ -131,13 +215,25 @@ public:
         to a stage at or beyond the dependsOnStage, otherwise expect an
         Exception. */
     const T& getValue(const SimTK::State& state) const {
-        _result = SimTK::NaN;
+        if (_cacheIndex.isValid() &&
+                state.isCacheValueRealized(_subsystemIndex, _cacheIndex)) {
+            return SimTK::Value<T>::downcast(
+                state.getCacheEntry(_subsystemIndex, _cacheIndex)).get();
+        }
         if (state.getSystemStage() < getDependsOnStage())
         {
             throw SimTK::Exception::StageTooLow(__FILE__, __LINE__,
                     state.getSystemStage(), getDependsOnStage(),
                     "Output::getValue(state)");
         }
+        if (_cacheIndex.isValid()) {
+            T& value = SimTK::Value<T>::updDowncast(
+                state.updCacheEntry(_subsystemIndex, _cacheIndex)).upd();
+            value = _outputFcn(state);
+            state.markCacheValueRealized(_subsystemIndex, _cacheIndex);
+            return value;
+        }
+        _result = SimTK::NaN;
         _result = _outputFcn(state); 
         return _result;
     }
@@ -154,12 +250,48 @@ public:
         return s.str();
     }
 
+    int getNumberOfDoubles(const SimTK::State& state) const override
+    {   return OutputValueDoubles<T>::size(getValue(state)); }
+
+    int getValueAsDoubles(const SimTK::State& state,
+                          double* values, int maxValues) const override
+    {
+        if (!OutputValueDoubles<T>::isSupported) {
+            SimTK_THROW2(SimTK::Exception::IncompatibleValues, 
+                         getTypeName(), "double");
+        }
+        const T& value = getValue(state);
+        const int size = OutputValueDoubles<T>::size(value);
+        if (size > maxValues) {
+            std::stringstream msg;
+            msg << "Output::getValueAsDoubles: ERR- the value of output '"
+                << getName() << "' has " << size << " elements but there is "
+                << "room for only " << maxValues << ".";
+            throw Exception(msg.str(), __FILE__, __LINE__);
+        }
+        return OutputValueDoubles<T>::copy(value, values);
+    }
+
+    void allocateCacheEntry(SimTK::State& state,
+                            const SimTK::Subsystem& subsystem) const override
+    {
+        _cacheIndex.invalidate();
+        if (!isCached() || getDependsOnStage() == SimTK::Stage::Infinity)
+            return;
+        _subsystemIndex = subsystem.getMySubsystemIndex();
+        _cacheIndex = subsystem.allocateLazyCacheEntry(state,
+            getDependsOnStage(), new SimTK::Value<T>());
+    }
+
     AbstractOutput* clone() const override { return new Output(*this); }
     SimTK_DOWNCAST(Output, AbstractOutput);
 
 private:
     mutable T _result;
     std::function<T(const SimTK::State&)> _outputFcn;
+    // The cache entry of a cached Output, allocated in the current System.
+    mutable SimTK::SubsystemIndex _subsystemIndex;
+    mutable SimTK::CacheEntryIndex _cacheIndex;
 
 //=============================================================================
 };  // END class Output
@@ -0,0 +1,249 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  ComponentProfiler.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "ComponentProfiler.h"
+#include "Object.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace OpenSim;
+using namespace std;
+
+std::atomic<bool> ComponentProfiler::_enabled(false);
+
+//=============================================================================
+// PER-THREAD TABLES
+//=============================================================================
+namespace {
+
+struct Entry {
+    Entry() : calls(0), seconds(0) {}
+    std::string label;
+    std::string section;
+    long long calls;
+    double seconds;
+};
+
+struct KeyHash {
+    size_t operator()(const std::pair<const void*, const char*>& key) const
+    {   return std::hash<const void*>()(key.first) ^
+               (std::hash<const void*>()(key.second) << 1); }
+};
+
+// The results of one thread. Only that thread writes to it; the mutex is
+// taken by the owner and by report(), so it is never contended in practice.
+struct ThreadTable {
+    std::mutex mutex;
+    std::unordered_map<std::pair<const void*, const char*>, Entry, KeyHash>
+        entries;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadTable> > tables;
+    std::string reportFileName;
+};
+
+Registry& registry()
+{
+    static Registry reg;
+    return reg;
+}
+
+ThreadTable& threadTable()
+{
+    thread_local std::shared_ptr<ThreadTable> table;
+    if (!table) {
+        table = std::make_shared<ThreadTable>();
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.tables.push_back(table);
+    }
+    return *table;
+}
+
+// The results of all threads, with the sections of each instance merged and
+// sorted by total time.
+std::vector<Entry> mergeTables()
+{
+    std::map<std::pair<const void*, std::string>, Entry> merged;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (size_t i = 0; i < reg.tables.size(); ++i) {
+        ThreadTable& table = *reg.tables[i];
+        std::lock_guard<std::mutex> tableLock(table.mutex);
+        for (auto it = table.entries.begin(); it != table.entries.end(); ++it) {
+            Entry& entry = merged[std::make_pair(it->first.first,
+                                                 it->second.section)];
+            if (entry.label.empty()) {
+                entry.label = it->second.label;
+                entry.section = it->second.section;
+            }
+            entry.calls += it->second.calls;
+            entry.seconds += it->second.seconds;
+        }
+    }
+    std::vector<Entry> entries;
+    for (auto it = merged.begin(); it != merged.end(); ++it)
+        entries.push_back(it->second);
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b) { return a.seconds > b.seconds; });
+    return entries;
+}
+
+std::string escape(const std::string& text)
+{
+    std::string escaped;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '"' || text[i] == '\\') escaped += '\\';
+        escaped += text[i];
+    }
+    return escaped;
+}
+
+} // anonymous namespace
+
+//=============================================================================
+// RECORDING
+//=============================================================================
+void ComponentProfiler::setEnabled(bool enabled)
+{
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void ComponentProfiler::reset()
+{
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (size_t i = 0; i < reg.tables.size(); ++i) {
+        std::lock_guard<std::mutex> tableLock(reg.tables[i]->mutex);
+        reg.tables[i]->entries.clear();
+    }
+}
+
+void ComponentProfiler::record(const Object& instance, const char* section,
+                               long long calls, double seconds)
+{
+    ThreadTable& table = threadTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    Entry& entry = table.entries[std::make_pair(
+        static_cast<const void*>(&instance), section)];
+    if (entry.label.empty()) {
+        entry.label = instance.getConcreteClassName() + " " +
+                      instance.getName();
+        entry.section = section;
+    }
+    entry.calls += calls;
+    entry.seconds += seconds;
+}
+
+//=============================================================================
+// REPORTING
+//=============================================================================
+void ComponentProfiler::setReportFileName(const std::string& fileName)
+{
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.reportFileName = fileName;
+}
+
+std::string ComponentProfiler::getReportFileName()
+{
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.reportFileName;
+}
+
+void ComponentProfiler::report(const std::string& title)
+{
+    if (!isEnabled()) return;
+
+    cout << "\nComponent profile (" << title << "):\n";
+    printTable(cout);
+
+    std::string fileName = getReportFileName();
+    if (!fileName.empty()) {
+        std::ofstream out(fileName.c_str());
+        if (out) {
+            printJSON(out, title);
+            cout << "Wrote component profile to " << fileName << "." << endl;
+        }
+        else
+            cout << "ComponentProfiler: could not open " << fileName
+                 << "." << endl;
+    }
+}
+
+void ComponentProfiler::printTable(std::ostream& out)
+{
+    std::vector<Entry> entries = mergeTables();
+    size_t width = 9;
+    for (size_t i = 0; i < entries.size(); ++i)
+        width = std::max(width, entries[i].label.size());
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::left << std::setw(width+2) << "Component"
+        << std::setw(24) << "Section" << std::right << std::setw(12)
+        << "Calls" << std::setw(14) << "Total ms" << std::setw(12)
+        << "Mean us" << "\n" << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Entry& e = entries[i];
+        out << std::left << std::setw(width+2) << e.label
+            << std::setw(24) << e.section << std::right
+            << std::setw(12) << e.calls << std::setw(14) << 1e3*e.seconds;
+        if (e.seconds > 0)
+            out << std::setw(12) << 1e6*e.seconds/e.calls;
+        out << "\n";
+    }
+    out << std::flush;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void ComponentProfiler::printJSON(std::ostream& out, const std::string& title)
+{
+    std::vector<Entry> entries = mergeTables();
+    std::streamsize precision = out.precision();
+    out << std::setprecision(9)
+        << "{\n  \"title\": \"" << escape(title) << "\",\n  \"entries\": [";
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Entry& e = entries[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    { \"component\": \"" << escape(e.label)
+            << "\", \"section\": \"" << escape(e.section)
+            << "\", \"calls\": " << e.calls
+            << ", \"total_seconds\": " << e.seconds << " }";
+    }
+    out << "\n  ]\n}\n";
+    out.precision(precision);
+}
@@ -0,0 +1,137 @@
+#ifndef OPENSIM_COMPONENT_PROFILER_H_
+#define OPENSIM_COMPONENT_PROFILER_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  ComponentProfiler.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+
+namespace OpenSim {
+
+class Object;
+
+//=============================================================================
+//=============================================================================
+/**
+ * Opt-in counters and timers of the hot paths of individual components, to
+ * find which Force, Muscle, wrap object or Analysis makes a simulation slow.
+ *
+ * When enabled, the model records the number of calls and the time spent in
+ * each instance's computeForce(), computeStateVariableDerivatives(),
+ * GeometryPath::computePath() and applyWrapObjects(),
+ * WrapObject::wrapPathSegment(), muscle equilibrium (and its iterations) and
+ * Analysis::step(). Each thread records into its own table, so threads do not
+ * contend for a lock. When disabled, which is the default, each instrumented
+ * call costs one test of a flag. Building with
+ * OPENSIM_DISABLE_COMPONENT_PROFILING defined (the CMake option
+ * OPENSIM_COMPONENT_PROFILING=OFF) removes the instrumentation entirely.
+ *
+ * At the end of the run() of each Tool, report() prints the table of results,
+ * and writes them as JSON if a file was given. Code that integrates with a
+ * Manager directly calls report() itself.
+ *
+ * @code
+ * ComponentProfiler::setEnabled(true);
+ * ComponentProfiler::setReportFileName("profile.json");
+ * ForwardTool("setup.xml").run();
+ * @endcode
+ *
+ * Instances are identified by their address, so call reset() between runs
+ * if components are deleted and others created in their place.
+ */
+class OSIMCOMMON_API ComponentProfiler {
+public:
+    /** Turn recording on or off, for all threads. */
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+    /** Discard everything recorded so far. */
+    static void reset();
+
+    /** The file report() writes JSON to. Empty, the default, for none. */
+    static void setReportFileName(const std::string& fileName);
+    static std::string getReportFileName();
+
+    /** If recording is enabled, print the results under the given title to
+    the console and write them to the report file, if one was set. */
+    static void report(const std::string& title);
+
+    /** Print the results as a table, sorted by total time. */
+    static void printTable(std::ostream& out);
+    /** Print the results as a JSON document. */
+    static void printJSON(std::ostream& out, const std::string& title = "");
+
+    /** Add n to the number of calls of section for instance, without timing
+    it (e.g., the iterations of a solver). */
+    static void count(const Object& instance, const char* section,
+                      long long n = 1)
+    {   if (isEnabled()) record(instance, section, n, 0); }
+
+    /** Times one call of section for instance, from construction to
+    destruction. section must be a string literal. */
+    class Scope {
+    public:
+        Scope(const Object& instance, const char* section) :
+            _instance(isEnabled() ? &instance : 0), _section(section)
+        {   if (_instance) _start = std::chrono::steady_clock::now(); }
+        ~Scope()
+        {
+            if (_instance) {
+                std::chrono::duration<double> elapsed =
+                    std::chrono::steady_clock::now() - _start;
+                record(*_instance, _section, 1, elapsed.count());
+            }
+        }
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        const Object* _instance;
+        const char* _section;
+        std::chrono::steady_clock::time_point _start;
+    };
+
+private:
+    static void record(const Object& instance, const char* section,
+                       long long calls, double seconds);
+
+    static std::atomic<bool> _enabled;
+};
+
+} // end of namespace OpenSim
+
+#ifndef OPENSIM_DISABLE_COMPONENT_PROFILING
+/** Time the rest of the enclosing block as a call of section for instance. */
+#define OPENSIM_PROFILE_SCOPE(instance, section) \
+    OpenSim::ComponentProfiler::Scope opensimProfilerScope((instance), (section))
+/** Add n to the calls of section for instance. */
+#define OPENSIM_PROFILE_COUNT(instance, section, n) \
+    OpenSim::ComponentProfiler::count((instance), (section), (n))
+#else
+#define OPENSIM_PROFILE_SCOPE(instance, section)
+#define OPENSIM_PROFILE_COUNT(instance, section, n)
+#endif
+
+#endif // OPENSIM_COMPONENT_PROFILER_H_
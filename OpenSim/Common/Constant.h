@@ -90,6 +90,10 @@ public:
     {
         return _value;
     }
+    virtual double evaluate(int derivOrder, double xUnused) const
+    {
+        return derivOrder == 0 ? _value : 0;
+    }
     const double getValue() const { return _value; }
     SimTK::Function* createSimTKFunction() const;
 //=============================================================================
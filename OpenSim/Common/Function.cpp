@@ -50,8 +50,7 @@ using SimTK::Vector;
  */
 Function::~Function()
 {
-    if (_function != NULL)
-        delete _function;
+    delete _function.load();
 }
 //_____________________________________________________________________________
 /**
@@ -129,18 +128,14 @@ Function* Function::makeFunctionOfType(Function* aFunction, const string& aNewTy
 //=============================================================================
 // EVALUATE
 //=============================================================================
-/*
-double Function::evaluate(int aDerivOrder,double aX,double aY,double aZ) const
+double Function::evaluate(int derivOrder, double x) const
 {
-    SimTK::Vector workX(getArgumentSize(), aX);
-    if (aDerivOrder == 0)
+    SimTK::Vector workX(1, x);
+    if (derivOrder == 0)
         return calcValue(workX);
-    std::vector<int> workDeriv(aDerivOrder);
-    for (int i = 0; i < aDerivOrder; ++i)
-        workDeriv[i] = 0;
+    std::vector<int> workDeriv(derivOrder, 0);
     return calcDerivative(workDeriv, workX);
 }
-*/
 
 /**
  * Evaluates total first derivative using the chain rule.
@@ -162,35 +157,40 @@ evaluateTotalSecondDerivative(double aX,double aDxdt,double aD2xdt2)
 */
 double Function::calcValue(const Vector& x) const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->calcValue(x);
+    return getFunction().calcValue(x);
 }
 
 double Function::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->calcDerivative(derivComponents, x);
+    return getFunction().calcDerivative(derivComponents, x);
 }
 
 int Function::getArgumentSize() const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->getArgumentSize();
+    return getFunction().getArgumentSize();
 }
 
 int Function::getMaxDerivativeOrder() const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->getMaxDerivativeOrder();
+    return getFunction().getMaxDerivativeOrder();
+}
+
+const SimTK::Function& Function::getFunction() const
+{
+    SimTK::Function* function = _function;
+    if (function == NULL) {
+        // Several threads may get here at once; keep the first function
+        // created, and discard the others.
+        SimTK::Function* created = createSimTKFunction();
+        if (_function.compare_exchange_strong(function, created))
+            function = created;
+        else
+            delete created;
+    }
+    return *function;
 }
 
 void Function::resetFunction()
 {
-    if (_function != NULL)
-        delete _function;
-    _function = NULL;
+    delete _function.exchange(nullptr);
 }
@@ -37,6 +37,7 @@
 #include "PropertyDbl.h"
 #include "Property.h"
 #include "SimTKmath.h"
+#include <atomic>
 
 
 //=============================================================================
@@ -64,8 +65,9 @@ OpenSim_DECLARE_ABSTRACT_OBJECT(Function, Object);
 // DATA
 //=============================================================================
 protected:
-    // The SimTK::Function object implementing this function.
-    mutable SimTK::Function* _function;
+    // The SimTK::Function object implementing this function, created the
+    // first time the function is evaluated (by any thread).
+    mutable std::atomic<SimTK::Function*> _function;
 
 //=============================================================================
 // METHODS
@@ -120,6 +122,14 @@ public:
      * @param x                the Vector of input arguments.  Its size must equal the value returned by getArgumentSize().
      */
     virtual double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const;
+    /**
+     * Calculate the value (derivOrder 0) or a derivative of a function of one
+     * argument at x. This is the same as calcValue() or calcDerivative() with
+     * derivComponents all 0, without the Vector and std::vector arguments.
+     * Functions of one argument override it to evaluate without allocating;
+     * FunctionAdapter uses it whenever it is given a single argument.
+     */
+    virtual double evaluate(int derivOrder, double x) const;
     /**
      * Get the number of components expected in the input vector.
      */
@@ -141,6 +151,10 @@ protected:
      */
     void resetFunction();
 
+private:
+    // Get _function, creating it if this is the first evaluation.
+    const SimTK::Function& getFunction() const;
+
 //=============================================================================
 };  // END class Function
 
@@ -44,14 +44,23 @@ FunctionAdapter::FunctionAdapter(const OpenSim::Function& aFunction) : _function
 //=============================================================================
 // SimTK::Function METHODS
 //=============================================================================
+// A function of a single argument, like those of the TransformAxes of a
+// CustomJoint, is evaluated through Function::evaluate(), which takes the
+// argument and the derivative order by value and does not allocate.
 double FunctionAdapter::calcValue(const Vector& x) const {
+    if (x.size() == 1)
+        return _function.evaluate(0, x[0]);
     return _function.calcValue(x);
 }
 double FunctionAdapter::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const {
+    if (x.size() == 1)
+        return _function.evaluate((int)derivComponents.size(), x[0]);
     return _function.calcDerivative(derivComponents, x);
 }
 
 double FunctionAdapter::calcDerivative(const SimTK::Array_<int>& derivComponents, const SimTK::Vector& x) const{
+    if (x.size() == 1)
+        return _function.evaluate((int)derivComponents.size(), x[0]);
     std::vector<int> dcs(derivComponents.begin(), derivComponents.end());
     return _function.calcDerivative(dcs, x);
 }
@@ -32,6 +32,7 @@
 #include <math.h>
 #include <string>
 #include <climits>
+#include <cctype>
 
 #include "IO.h"
 #if defined(__linux__) || defined(__APPLE__)
@@ -533,6 +534,21 @@ getParentDirectory(const string& fileName)
     return result;
 }
 
+//_____________________________________________________________________________
+/**
+ * Whether fileName is an absolute path, i.e., starts with a directory
+ * separator or, on Windows, a drive letter.
+ * 
+*/
+bool IO::
+isAbsolutePath(const string& fileName)
+{
+    if (fileName.empty()) return false;
+    if (fileName[0] == '/' || fileName[0] == '\\') return true;
+    return fileName.size() > 1 && fileName[1] == ':' &&
+           isalpha((unsigned char)fileName[0]);
+}
+
 //_____________________________________________________________________________
 /**
  * Get filename part of a passed in URI (also works if a dos/unix path is passed in)
@@ -169,6 +169,17 @@ LinearFunction& LinearFunction::operator=(const LinearFunction &aLinearFunction)
 //=============================================================================
 // UTILITY
 //=============================================================================
+/* Evaluate slope*x + intercept the way SimTK::Function::Linear does, for
+ * a function of one argument. */
+double LinearFunction::evaluate(int derivOrder, double x) const
+{
+    if (_coefficients.getSize() != 2)
+        return Function::evaluate(derivOrder, x);
+    if (derivOrder == 0)
+        return _coefficients[0]*x + _coefficients[1];
+    return derivOrder == 1 ? _coefficients[0] : 0;
+}
+
 SimTK::Function* LinearFunction::createSimTKFunction() const 
 {
     SimTK::Vector coeffs(_coefficients.getSize(), &_coefficients[0]);
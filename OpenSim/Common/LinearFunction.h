@@ -103,6 +103,7 @@ public:
     //--------------------------------------------------------------------------
     // EVALUATION
     //--------------------------------------------------------------------------
+    virtual double evaluate(int derivOrder, double x) const;
     virtual SimTK::Function* createSimTKFunction() const;
 
 //=============================================================================
@@ -26,8 +26,20 @@
 //=============================================================================
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <math.h>
 #include <float.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 #include "MarkerData.h"
 #include "SimmIO.h"
 #include "SimmMacros.h"
@@ -40,6 +52,158 @@ using namespace std;
 using namespace OpenSim;
 using SimTK::Vec3;
 
+namespace {
+    // The contents of a file, mapped into memory where the platform supports
+    // it and read into a buffer otherwise.
+    class FileContents {
+    public:
+        explicit FileContents(const string& aFileName) :
+            _data(NULL), _size(0), _mapped(NULL)
+        {
+#ifndef _WIN32
+            int fd = ::open(aFileName.c_str(), O_RDONLY);
+            struct stat info;
+            if (fd >= 0 && ::fstat(fd, &info) == 0 && info.st_size > 0) {
+                void* mapped = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    _mapped = mapped;
+                    _data = static_cast<const char*>(mapped);
+                    _size = info.st_size;
+                }
+            }
+            if (fd >= 0) ::close(fd);
+            if (_mapped) return;
+#endif
+            ifstream in(aFileName.c_str(), ios::binary);
+            if (!in.good())
+                throw Exception("Unable to open marker file " + aFileName);
+            ostringstream contents;
+            contents << in.rdbuf();
+            _buffer = contents.str();
+            _data = _buffer.data();
+            _size = _buffer.size();
+        }
+        ~FileContents()
+        {
+#ifndef _WIN32
+            if (_mapped) ::munmap(_mapped, _size);
+#endif
+        }
+        const char* begin() const { return _data; }
+        const char* end() const { return _data + _size; }
+    private:
+        FileContents(const FileContents&);
+        FileContents& operator=(const FileContents&);
+
+        const char* _data;
+        size_t _size;
+        void* _mapped;
+        string _buffer;
+    };
+
+    // Read a number from the characters [aBegin, aEnd), which hold one field
+    // of a TRC row. An empty field or "NaN" is a missing coordinate. Numbers
+    // with at most 15 significant digits and a decimal exponent of at most 22
+    // are converted exactly by one multiplication or division; anything else
+    // is left to strtod(), so the result is always the same as atof().
+    double parseTRCField(const char* aBegin, const char* aEnd)
+    {
+        static const double powersOf10[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+            1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+            1e22 };
+
+        while (aBegin < aEnd && isspace((unsigned char)*aBegin)) aBegin++;
+        while (aEnd > aBegin && isspace((unsigned char)aEnd[-1])) aEnd--;
+        if (aBegin == aEnd)
+            return SimTK::NaN;
+
+        const char* p = aBegin;
+        bool negative = (*p == '-');
+        if (*p == '-' || *p == '+') p++;
+        if (aEnd - p >= 3 && toupper(p[0]) == 'N' && toupper(p[1]) == 'A' &&
+            toupper(p[2]) == 'N')
+            return SimTK::NaN;
+
+        unsigned long long mantissa = 0;
+        int numDigits = 0, exponent = 0;
+        bool fast = (p < aEnd);
+        for (; p < aEnd && isdigit((unsigned char)*p); p++) {
+            if (mantissa > 0 || *p != '0') numDigits++;
+            mantissa = 10*mantissa + (*p - '0');
+        }
+        if (p < aEnd && *p == '.') {
+            for (p++; p < aEnd && isdigit((unsigned char)*p); p++) {
+                if (mantissa > 0 || *p != '0') numDigits++;
+                mantissa = 10*mantissa + (*p - '0');
+                exponent--;
+            }
+        }
+        if (p < aEnd && (*p == 'e' || *p == 'E')) {
+            p++;
+            bool negativeExponent = (p < aEnd && *p == '-');
+            if (p < aEnd && (*p == '-' || *p == '+')) p++;
+            fast = fast && p < aEnd;
+            int e = 0;
+            for (; p < aEnd && isdigit((unsigned char)*p); p++)
+                if (e < 10000) e = 10*e + (*p - '0');
+            exponent += negativeExponent ? -e : e;
+        }
+        fast = fast && p == aEnd && numDigits <= 15;
+
+        if (fast && mantissa == 0)
+            return negative ? -0.0 : 0.0;
+        if (fast && exponent >= -22 && exponent <= 22) {
+            double value = (double)mantissa;
+            value = exponent < 0 ? value/powersOf10[-exponent]
+                                 : value*powersOf10[exponent];
+            return negative ? -value : value;
+        }
+
+        string field(aBegin, aEnd);
+        return strtod(field.c_str(), NULL);
+    }
+
+    // Parse one row of a TRC file into its frame number, time and marker
+    // coordinates. Fields are separated by tabs; coordinates that are
+    // missing, including those of markers past the end of the row, are NaN.
+    void parseTRCLine(const char* aBegin, const char* aEnd, int aNumMarkers,
+                      int& rFrameNumber, double& rTime, Vec3* rMarkers)
+    {
+        for (int i = 0; i < aNumMarkers; i++)
+            rMarkers[i] = Vec3(SimTK::NaN);
+
+        rFrameNumber = 0;
+        rTime = SimTK::NaN;
+        if (!memchr(aBegin, '\t', aEnd - aBegin)) {
+            // Rows without tabs are read as before, separated by spaces.
+            string line(aBegin, aEnd);
+            readIntegerFromString(line, &rFrameNumber);
+            readDoubleFromString(line, &rTime);
+            Vec3 coords;
+            for (int i = 0; i < aNumMarkers &&
+                 readCoordinatesFromString(line, &coords[0], true); i++)
+                rMarkers[i] = coords;
+            return;
+        }
+
+        const int numFields = 2 + 3*aNumMarkers;
+        const char* field = aBegin;
+        for (int f = 0; f < numFields && field <= aEnd; f++) {
+            const char* next = static_cast<const char*>(
+                memchr(field, '\t', aEnd - field));
+            if (!next) next = aEnd;
+            if (f == 0)
+                rFrameNumber = atoi(string(field, next).c_str());
+            else if (f == 1)
+                rTime = parseTRCField(field, next);
+            else
+                rMarkers[(f-2)/3][(f-2)%3] = parseTRCField(field, next);
+            field = next + 1;
+        }
+    }
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -91,6 +255,17 @@ MarkerData::MarkerData(const string& aFileName) :
     cout << "Loaded marker file " << _fileName << " (" << _numMarkers << " markers, " << _numFrames << " frames)" << endl;
 }
 
+//_____________________________________________________________________________
+/**
+ * Copy constructor. The frames of the copy refer to its own copy of the
+ * marker coordinates.
+ */
+MarkerData::MarkerData(const MarkerData& aMarkerData) :
+    Object(aMarkerData)
+{
+    copyData(aMarkerData);
+}
+
 //_____________________________________________________________________________
 /**
  * Destructor.
@@ -99,6 +274,77 @@ MarkerData::~MarkerData()
 {
 }
 
+//_____________________________________________________________________________
+/**
+ * Assignment operator.
+ */
+MarkerData& MarkerData::operator=(const MarkerData& aMarkerData)
+{
+    if (this != &aMarkerData)
+    {
+        Object::operator=(aMarkerData);
+        copyData(aMarkerData);
+    }
+    return *this;
+}
+
+//_____________________________________________________________________________
+/**
+ * Copy the data members of aMarkerData, making the frames refer to the copy
+ * of its marker coordinates.
+ */
+void MarkerData::copyData(const MarkerData& aMarkerData)
+{
+    _numFrames = aMarkerData._numFrames;
+    _numMarkers = aMarkerData._numMarkers;
+    _firstFrameNumber = aMarkerData._firstFrameNumber;
+    _dataRate = aMarkerData._dataRate;
+    _cameraRate = aMarkerData._cameraRate;
+    _originalDataRate = aMarkerData._originalDataRate;
+    _originalStartFrame = aMarkerData._originalStartFrame;
+    _originalNumFrames = aMarkerData._originalNumFrames;
+    _fileName = aMarkerData._fileName;
+    _units = aMarkerData._units;
+    _markerNames = aMarkerData._markerNames;
+    _markerPositions = aMarkerData._markerPositions;
+
+    _frames.clearAndDestroy();
+    for (int i = 0; i < aMarkerData._frames.getSize(); i++)
+    {
+        const MarkerFrame& frame = *aMarkerData._frames[i];
+        _frames.append(new MarkerFrame(_numMarkers, frame.getFrameNumber(),
+            frame.getFrameTime(), _units, _markerPositions.data() + i*_numMarkers));
+    }
+}
+
+//_____________________________________________________________________________
+/**
+ * Move the marker coordinates of all frames into the contiguous array and
+ * make the frames refer to it. This is needed after frames that hold their
+ * own coordinates have been added.
+ */
+void MarkerData::packFrames()
+{
+    const int numFrames = _frames.getSize();
+    vector<Vec3> positions(numFrames*_numMarkers, Vec3(SimTK::NaN));
+    vector<MarkerFrame*> frames(numFrames);
+    for (int i = 0; i < numFrames; i++)
+    {
+        const SimTK::Array_<Vec3>& markers = _frames[i]->getMarkers();
+        int numMarkers = std::min((int)markers.size(), _numMarkers);
+        std::copy(markers.begin(), markers.begin() + numMarkers,
+                  positions.begin() + i*_numMarkers);
+        frames[i] = new MarkerFrame(_numMarkers, _frames[i]->getFrameNumber(),
+            _frames[i]->getFrameTime(), _units, positions.data() + i*_numMarkers);
+    }
+
+    // Swapping the vectors keeps the addresses the new frames refer to.
+    _frames.clearAndDestroy();
+    _markerPositions.swap(positions);
+    for (int i = 0; i < numFrames; i++)
+        _frames.append(frames[i]);
+}
+
 //=============================================================================
 // I/O
 //=============================================================================
@@ -111,145 +357,101 @@ MarkerData::~MarkerData()
  */
 void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
 {
-   ifstream in;
-   string line, buffer;
-   int frameNum, coordsRead;
-   double time;
-    SimTK::Vec3 coords;
-
     if (aFileName.empty())
         throw Exception("MarkerData.readTRCFile: ERROR- Marker file name is empty",__FILE__,__LINE__);
 
-   in.open(aFileName.c_str());
+    FileContents file(aFileName);
+    const char* end = file.end();
 
-    if (!in.good())
+    /* The header is the first 5 lines. Carriage returns are dropped so that
+     * files written on Windows give the same marker names.
+     */
+    const char* data = file.begin();
+    for (int i = 0; i < 5 && data < end; i++)
     {
-        string errorMessage;
-        errorMessage = "Unable to open marker file " + aFileName;
-        throw Exception(errorMessage);
+        const char* eol = static_cast<const char*>(memchr(data, '\n', end - data));
+        data = eol ? eol + 1 : end;
     }
-
-   readTRCFileHeader(in, aFileName, aSMD);
-
-   /* read frame data */
-   while (getline(in, line))
-   {
-      /* skip over any blank lines */
-      if (findFirstNonWhiteSpace(line) == -1)
-         continue;
-
-        if (aSMD._frames.getSize() == aSMD._numFrames)
+    string header;
+    header.reserve(data - file.begin());
+    for (const char* c = file.begin(); c < data; c++)
+        if (*c != '\r') header += *c;
+    istringstream headerStream(header);
+    readTRCFileHeader(headerStream, aFileName, aSMD);
+
+    /* Find the frame lines, skipping blank ones. Extra lines beyond the
+     * number of frames declared in the header are ignored.
+     */
+    vector<const char*> lineStarts, lineEnds;
+    lineStarts.reserve(aSMD._numFrames);
+    lineEnds.reserve(aSMD._numFrames);
+    for (const char* line = data; line < end && (int)lineStarts.size() < aSMD._numFrames; )
+    {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!eol) eol = end;
+        const char* last = eol;
+        while (last > line && isspace((unsigned char)last[-1]))
+            last--;
+        if (last > line)
         {
-#if 0
-            if (gUseGlobalMessages)
-            {
-                gErrorBuffer += "Extra data found at end of tracked marker file. ";
-                gErrorBuffer += "Header declared only " + intToString(trc->header.numFrames) + " frames.\n";
-            }
-            rc = smFileWarning;
-#endif
-            break;
+            lineStarts.push_back(line);
+            lineEnds.push_back(last);
         }
+        line = eol + 1;
+    }
+    const int numFrames = (int)lineStarts.size();
+    const int numMarkers = aSMD._numMarkers;
 
-      if (!readIntegerFromString(line, &frameNum))
-      {
-#if 0
-         if (gUseGlobalMessages)
-            gErrorBuffer += "Could not read frame number in tracked marker file.\n";
-         rc = smFileError;
-         goto cleanup;
-#endif
-      }
-
-      if (!readDoubleFromString(line, &time))
-      {
-#if 0
-         if (gUseGlobalMessages)
-            gErrorBuffer += "Could not read time in tracked marker file.\n";
-         rc = smFileError;
-         goto cleanup;
-#endif
-      }
-
-        MarkerFrame *frame = new MarkerFrame(aSMD._numMarkers, frameNum, time, aSMD._units);
-
-      /* keep reading sets of coordinates until the end of the line is
-       * reached. If more coordinates were read than there are markers,
-       * return an error.
-       */
-      coordsRead = 0;
-      bool allowNaNs = true;
-      while (readCoordinatesFromString(line, &coords[0], allowNaNs))
-      {
-         if (coordsRead >= aSMD._numMarkers)
-         {
-            break;
-
-#if 0  // Don't return an error because many TRC files have extra data at the ends of rows
-            if (gUseGlobalMessages)
-               gErrorBuffer += "Extra data found in frame number " + intToString(frameNum) +
-                               " in tracked marker file.\n";
-            rc = smFileError;
-            // delete the current markerCoordList because framesRead has not been incremented yet.
-            delete [] f->markerCoordList;
-            goto cleanup;
-#endif
-         }
-         if (coordsRead < aSMD._numMarkers)
-                frame->addMarker(coords);
-         coordsRead++;
-      }
-
-      if (coordsRead < aSMD._numMarkers)
-      {
-#if 0
-         if (gUseGlobalMessages)
-            gErrorBuffer += " Missing data in frame number " + intToString(frameNum) +
-                            " in tracked marker file.\n";
-         rc = smFileError;
-         // delete the current markerCoordList because framesRead has not been incremented yet.
-         delete [] f->markerCoordList;
-         goto cleanup;
-#endif
-      }
-        aSMD._frames.append(frame);
-   }
+    /* Parse the frames into the contiguous array, in blocks of lines shared
+     * among threads. Every line is independent of the others.
+     */
+    vector<SimTK::Vec3> positions(numFrames*numMarkers);
+    vector<int> frameNumbers(numFrames);
+    vector<double> times(numFrames);
+    auto parseFrames = [&](int aFirst, int aLast) {
+        for (int i = aFirst; i < aLast; i++)
+            parseTRCLine(lineStarts[i], lineEnds[i], numMarkers,
+                         frameNumbers[i], times[i], positions.data() + i*numMarkers);
+    };
+
+    // Give each thread enough lines that starting it is worthwhile.
+    const int MinFramesPerThread = 256;
+    int numThreads = std::min((int)std::thread::hardware_concurrency(),
+                              numFrames/MinFramesPerThread);
+    if (numThreads <= 1)
+        parseFrames(0, numFrames);
+    else
+    {
+        vector<std::thread> threads;
+        for (int t = 1; t < numThreads; t++)
+            threads.push_back(std::thread(parseFrames,
+                (int)((long long)numFrames*t/numThreads),
+                (int)((long long)numFrames*(t+1)/numThreads)));
+        parseFrames(0, numFrames/numThreads);
+        for (unsigned t = 0; t < threads.size(); t++)
+            threads[t].join();
+    }
 
-   if (aSMD._frames.getSize() < aSMD._numFrames)
-   {
-#if 0
-      if (gUseGlobalMessages)
-         gErrorBuffer += "Missing data in tracked marker file. Only " + intToString(framesRead) + " of " +
-                         intToString(trc->header.numFrames) + " frames found.\n";
-      rc = smFileError;
-      goto cleanup;
-#endif
-        aSMD._numFrames = aSMD._frames.getSize();
-   }
+    aSMD._numFrames = numFrames;
+    aSMD._markerPositions.swap(positions);
+    aSMD._frames.clearAndDestroy();
+    aSMD._frames.ensureCapacity(numFrames);
+    for (int i = 0; i < numFrames; i++)
+        aSMD._frames.append(new MarkerFrame(numMarkers, frameNumbers[i], times[i],
+            aSMD._units, aSMD._markerPositions.data() + i*numMarkers));
 
    /* If the user-defined frame numbers are not continguous from the first frame to the
     * last, reset them to a contiguous array. This is necessary because the user-defined
     * numbers are used to index the array of frames.
     */
-    if (aSMD._frames[aSMD._numFrames-1]->getFrameNumber() - aSMD._frames[0]->getFrameNumber() !=
+    if (numFrames > 0 &&
+        aSMD._frames[aSMD._numFrames-1]->getFrameNumber() - aSMD._frames[0]->getFrameNumber() !=
          aSMD._numFrames - 1)
    {
         int firstIndex = aSMD._frames[0]->getFrameNumber();
       for (int i = 1; i < aSMD._numFrames; i++)
             aSMD._frames[i]->setFrameNumber(firstIndex + i);
    }
-
-#if 0
-   if (gUseGlobalMessages)
-   {
-      gMessage += "TRC file " + actualFileName + "\n\t" + intToString(trc->header.numFrames)
-                  + " frames\n\t" + intToString(trc->header.numMarkers) + " markers/frame\n";
-      gMessage += "Read " + intToString(framesRead) + " frames.\n";
-   }
-#endif
-
-//cleanup:
-   in.close();
 }
 
 //_____________________________________________________________________________
@@ -260,7 +462,7 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
  * @param aFileName name of file that stream is from.
  * @param aSMD MarkerData object to hold the file contents
  */
-void MarkerData::readTRCFileHeader(ifstream &aStream, const string& aFileName, MarkerData& aSMD)
+void MarkerData::readTRCFileHeader(istream &aStream, const string& aFileName, MarkerData& aSMD)
 {
    string line, buffer;
    int pathFileType, markersRead;
@@ -527,7 +729,7 @@ void MarkerData::readStoFile(const string& aFileName)
         }
         _frames.append(frame);
    }
-   
+    packFrames();
 }
 /**
  * Helper function to check column labels of passed in Storage for possibly being a MarkerName, and if true
@@ -725,6 +927,7 @@ void MarkerData::averageFrames(double aThreshold, double aStartTime, double aEnd
     _frames.clearAndDestroy();
     _frames.append(averagedFrame);
     _numFrames = 1;
+    packFrames();
     _firstFrameNumber = _frames[0]->getFrameNumber();
 
     if (aThreshold > 0.0)
@@ -27,6 +27,7 @@
 // INCLUDE
 #include <iostream>
 #include <string>
+#include <vector>
 #include "osimCommonDLL.h"
 #include "Object.h"
 #include "Storage.h"
@@ -41,6 +42,11 @@ namespace OpenSim {
 /**
  * A class implementing a sequence of marker frames from a TRC/TRB file.
  *
+ * The coordinates of all markers in all frames are held in one contiguous
+ * array, frame by frame, and each MarkerFrame refers to its row of that
+ * array. TRC files are mapped into memory and their rows are parsed by
+ * several threads.
+ *
  * @author Peter Loan
  * @version 1.0
  */
@@ -63,6 +69,7 @@ private:
     Units _units;
     Array<std::string> _markerNames;
     ArrayPtrs<MarkerFrame> _frames;
+    std::vector<SimTK::Vec3> _markerPositions;
 
 //=============================================================================
 // METHODS
@@ -73,13 +80,26 @@ private:
 public:
     MarkerData();
     explicit MarkerData(const std::string& aFileName) SWIG_DECLARE_EXCEPTION;
+    MarkerData(const MarkerData& aMarkerData);
     virtual ~MarkerData();
 
+#ifndef SWIG
+    MarkerData& operator=(const MarkerData& aMarkerData);
+#endif
+
     void findFrameRange(double aStartTime, double aEndTime, int& rStartFrame, int& rEndFrame) const;
     void averageFrames(double aThreshold = -1.0, double aStartTime = -SimTK::Infinity, double aEndTime = SimTK::Infinity);
     const std::string& getFileName() const { return _fileName; }
     void makeRdStorage(Storage& rStorage);
     const MarkerFrame& getFrame(int aIndex) const;
+    /** Coordinates of all markers in all frames, stored frame by frame:
+    the position of marker j in frame i is at i*getNumMarkers() + j. These
+    are the coordinates that the MarkerFrames returned by getFrame() refer
+    to. */
+    const SimTK::Vec3* getMarkerPositions() const
+    {   return _markerPositions.empty() ? NULL : &_markerPositions[0]; }
+    const SimTK::Vec3& getMarkerPosition(int aFrame, int aMarker) const
+    {   return _markerPositions[aFrame*_numMarkers + aMarker]; }
     int getMarkerIndex(const std::string& aName) const;
     const Units& getUnits() const { return _units; }
     void convertToUnits(const Units& aUnits);
@@ -93,10 +113,12 @@ public:
 
 private:
     void readTRCFile(const std::string& aFileName, MarkerData& aSMD);
-    void readTRCFileHeader(std::ifstream &in, const std::string& aFileName, MarkerData& aSMD);
+    void readTRCFileHeader(std::istream &in, const std::string& aFileName, MarkerData& aSMD);
     void readTRBFile(const std::string& aFileName, MarkerData& aSMD);
     void readStoFile(const std::string& aFileName);
     void buildMarkerMap(const Storage& storageToReadFrom, std::map<int, std::string>& markerNames);
+    void packFrames();
+    void copyData(const MarkerData& aMarkerData);
 
 //=============================================================================
 };  // END of class MarkerData
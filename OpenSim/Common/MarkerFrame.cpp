@@ -65,8 +65,31 @@ MarkerFrame::MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime, Units&
     setNull();
 }
 
+//_____________________________________________________________________________
+/**
+ * Constructor for a frame that refers to marker coordinates owned by someone
+ * else, such as the contiguous storage of MarkerData.
+ *
+ * @param aNumMarkers the number of markers in the frame
+ * @param aFrameNumber the frame number
+ * @param aTime the time of the frame
+ * @param aUnits the units of the XYZ marker coordinates
+ * @param aMarkers the XYZ coordinates of the aNumMarkers markers
+ */
+MarkerFrame::MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime,
+                         const Units& aUnits, SimTK::Vec3* aMarkers) :
+    _numMarkers(aNumMarkers),
+    _frameNumber(aFrameNumber),
+    _frameTime(aTime),
+    _units(aUnits),
+    _markers(aMarkers, aMarkers + aNumMarkers, SimTK::DontCopy())
+{
+    setNull();
+}
+
+//_____________________________________________________________________________
 /**
- * Copy constructor.
+ * Copy constructor. The copy always holds its own marker coordinates.
  */
 MarkerFrame::MarkerFrame(const MarkerFrame& aFrame) :
    Object(aFrame)
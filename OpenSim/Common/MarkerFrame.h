@@ -64,6 +64,11 @@ private:
 public:
     MarkerFrame();
     MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime, Units& aUnits);
+    /** Construct a frame whose marker coordinates are stored elsewhere, as
+    MarkerData does for all of its frames. aMarkers must hold aNumMarkers
+    coordinates and outlive the frame; they are not copied. */
+    MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime,
+                const Units& aUnits, SimTK::Vec3* aMarkers);
     MarkerFrame(const MarkerFrame& aFrame);
     virtual ~MarkerFrame();
 
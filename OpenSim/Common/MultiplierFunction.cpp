@@ -182,6 +182,16 @@ double MultiplierFunction::calcValue(const SimTK::Vector& x) const
     }
 }
 
+double MultiplierFunction::evaluate(int derivOrder, double x) const
+{
+    if (_osFunction)
+        return _osFunction->evaluate(derivOrder, x) * _scale;
+    else {
+        throw Exception("MultiplierFunction::evaluate(): _osFunction is NULL.");
+        return 0.0;
+    }
+}
+
 int MultiplierFunction::getArgumentSize() const
 {
     if (_osFunction)
@@ -103,6 +103,7 @@ public:
     //--------------------------------------------------------------------------
     double calcValue(const SimTK::Vector& x) const;
     double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const;
+    double evaluate(int derivOrder, double x) const;
     int getArgumentSize() const;
     int getMaxDerivativeOrder() const;
     SimTK::Function* createSimTKFunction() const;
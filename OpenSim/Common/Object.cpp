@@ -45,6 +45,10 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 using namespace OpenSim;
 using namespace std;
@@ -62,6 +66,33 @@ std::map<string,string>     Object::_renamedTypesMap;
 bool                        Object::_serializeAllDefaults=false;
 const string                Object::DEFAULT_NAME(ObjectDEFAULT_NAME);
 int                         Object::_debugLevel = 0;
+int                         Object::_numDeserializationThreads = 1;
+
+namespace {
+    // Set while a list of objects is being read by several threads, so that
+    // the lists nested within those objects are read serially.
+    std::atomic<bool> parallelReadInProgress(false);
+
+    // The directory of the XML file being read on this thread, if it is an
+    // absolute path, which the files it includes are relative to. The
+    // readers also change the working directory to it, but another thread
+    // may change that meanwhile.
+    thread_local std::string xmlFileDirectory;
+
+    // Sets xmlFileDirectory while a file is read.
+    class XMLFileDirectoryScope {
+    public:
+        explicit XMLFileDirectoryScope(const std::string& fileName) :
+            _saved(xmlFileDirectory)
+        {
+            const std::string directory = IO::getParentDirectory(fileName);
+            xmlFileDirectory = IO::isAbsolutePath(directory) ? directory : "";
+        }
+        ~XMLFileDirectoryScope() { xmlFileDirectory = _saved; }
+    private:
+        std::string _saved;
+    };
+}
 
 //=============================================================================
 // CONSTRUCTOR(S)
@@ -125,6 +156,7 @@ Object::Object(const string &aFileName, bool aUpdateFromXMLNode)
     // relative to that directory. Make sure we switch back properly in case
     // of an exception.
     if (aUpdateFromXMLNode) {
+        XMLFileDirectoryScope directoryScope(aFileName);
         const string saveWorkingDirectory = IO::getCwd();
         const string directoryOfXMLFile = IO::getParentDirectory(aFileName);
         IO::chDir(directoryOfXMLFile);
@@ -210,6 +242,9 @@ operator=(const Object& source)
         _authors        = source._authors;
         _references     = source._references;
         _propertyTable  = source._propertyTable;
+        // Data derived from the properties is copied along with them by the
+        // derived classes, so it need not be recomputed by the copy.
+        _objectIsUpToDate = source._objectIsUpToDate;
 
         delete _document; _document = NULL;
         _inlined = true; // meaning: not associated to an XML document
@@ -575,7 +610,9 @@ renameType(const std::string& oldTypeName, const std::string& newTypeName)
 
 /*static*/ const Object* Object::
 getDefaultInstanceOfType(const std::string& objectTypeTag) {
-    std::string actualName = objectTypeTag;
+    // Point at the name rather than copying it; this is called for every
+    // object that is deserialized.
+    const std::string* actualName = &objectTypeTag;
     bool wasRenamed = false; // for a better error message
 
     // First apply renames if any.
@@ -585,7 +622,7 @@ getDefaultInstanceOfType(const std::string& objectTypeTag) {
     int renameCount = 0;
     while(true) {
         std::map<std::string,std::string>::const_iterator newNamep =
-            _renamedTypesMap.find(actualName);
+            _renamedTypesMap.find(*actualName);
         if (newNamep == _renamedTypesMap.end())
             break; // actualName has not been renamed
 
@@ -595,13 +632,13 @@ getDefaultInstanceOfType(const std::string& objectTypeTag) {
                 "found when looking for '" + objectTypeTag + "'.");
         }
 
-        actualName = newNamep->second;
+        actualName = &newNamep->second;
         wasRenamed = true;
     }
 
     // Look up the "actualName" default object and return it.
     std::map<std::string,Object*>::const_iterator p = 
-        _mapTypesToDefaultObjects.find(actualName);
+        _mapTypesToDefaultObjects.find(*actualName);
     if (p != _mapTypesToDefaultObjects.end())
         return p->second;
 
@@ -611,7 +648,7 @@ getDefaultInstanceOfType(const std::string& objectTypeTag) {
     if (wasRenamed) {
         throw OpenSim::Exception(
             "Object::getDefaultInstanceOfType(): '" + objectTypeTag
-            + "' was renamed to '" + actualName 
+            + "' was renamed to '" + *actualName 
             + "' which is not the name of a registered object.");
     }
 
@@ -727,12 +764,17 @@ void Object::readObjectFromXMLNodeOrFile
 
     // When including contents from another file it's assumed file path is 
     // relative to the current working directory, which is usually set to be
-    // the directory that contained the top-level XML file.
+    // the directory that contained the top-level XML file. If that file was
+    // named by its absolute path, look there directly.
+    std::string path = file;
+    if (!xmlFileDirectory.empty() && !IO::isAbsolutePath(file))
+        path = xmlFileDirectory + file;
     XMLDocument* newDoc=0;
     try {
         std::cout << "reading object from file [" << file <<"] cwd =" 
                   << IO::getCwd() << std::endl;
-         newDoc = new XMLDocument(file);
+         newDoc = new XMLDocument(path);
+         newDoc->setFileName(file);
         _document = newDoc;
     } catch(const std::exception& ex){
         std::cout << "failure reading object from file [" << file <<"] cwd =" 
@@ -744,6 +786,71 @@ void Object::readObjectFromXMLNodeOrFile
     updateFromXMLNode(e, newDoc->getDocumentVersion());
 }
 
+/*static*/ void Object::
+setNumDeserializationThreads(int numThreads)
+{
+    _numDeserializationThreads = std::max(1, numThreads);
+}
+
+/*static*/ void Object::readObjectsFromXMLNodesOrFiles
+   (const SimTK::Array_<Object*>&          objects,
+    SimTK::Array_<SimTK::Xml::Element>&   elements,
+    int                                   versionNumber)
+{
+    assert(objects.size() == elements.size());
+    const int numObjects = (int)objects.size();
+
+    // Give each thread a few objects at least, since starting a thread costs
+    // about as much as reading a small object.
+    const int MinObjectsPerThread = 4;
+    int numThreads = std::min(_numDeserializationThreads,
+                              numObjects/MinObjectsPerThread);
+
+    // Objects included from other files are found relative to the working
+    // directory, which loading a file may change; read those lists serially.
+    for (int i=0; numThreads > 1 && i < numObjects; ++i)
+        if (elements[i].hasAttribute("file")) numThreads = 1;
+
+    bool expected = false;
+    if (numThreads <= 1 || 
+        !parallelReadInProgress.compare_exchange_strong(expected, true)) {
+        for (int i=0; i < numObjects; ++i)
+            objects[i]->readObjectFromXMLNodeOrFile(elements[i], 
+                                                    versionNumber);
+        return;
+    }
+
+    // Threads take the next unread object until there are none left. The 
+    // first exception thrown is rethrown on this thread once all are done.
+    std::atomic<int> next(0);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    const std::string directory = xmlFileDirectory;
+    auto readObjects = [&]() {
+        xmlFileDirectory = directory;
+        for (int i = next++; i < numObjects; i = next++) {
+            try {
+                objects[i]->readObjectFromXMLNodeOrFile(elements[i], 
+                                                        versionNumber);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+                next = numObjects;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t=1; t < numThreads; ++t)
+        threads.push_back(std::thread(readObjects));
+    readObjects();
+    for (unsigned t=0; t < threads.size(); ++t)
+        threads[t].join();
+
+    parallelReadInProgress = false;
+    if (error) std::rethrow_exception(error);
+}
+
 template<class T> static void 
 UpdateXMLNodeSimpleProperty(const Property_Deprecated*  aProperty, 
                             SimTK::Xml::Element&        dParentNode, 
@@ -956,9 +1063,13 @@ try {
 
             // LOOP THROUGH PROPERTY ELEMENT'S CHILD ELEMENTS
             // Each element is expected to be an Object of some type given
-            // by the element's tag.
+            // by the element's tag. The objects of an array (e.g., the
+            // elements of a Set) are all created first and then read
+            // together, possibly in parallel.
             Object *object =NULL;
             int objectsFound = 0;
+            SimTK::Array_<Object*> objects;
+            SimTK::Array_<SimTK::Xml::Element> elements;
             SimTK::Xml::element_iterator iter = propElementIter->element_begin();
             while(iter != propElementIter->element_end()){
                 // Create an Object of the element tag's type.
@@ -978,12 +1089,17 @@ try {
                     else{
                         property->setValue(object);
                     }
+                    object->updateFromXMLNode(*iter, versionNumber);
                 } else {
                     property->appendValue(object);
+                    objects.push_back(object);
+                    elements.push_back(*iter);
                 }
-                object->updateFromXMLNode(*iter, versionNumber);
                 iter++;
             }
+            if(!objects.empty())
+                readObjectsFromXMLNodesOrFiles(objects, elements,
+                                               versionNumber);
                 
             break; }
 
@@ -1553,6 +1669,7 @@ makeObjectFromFile(const std::string &aFileName)
         Object* newObject = newInstanceOfType(rootName);
         if(!newObject) throw Exception("Unrecognized XML element '"+rootName+"' and root of file '"+aFileName+"'",__FILE__,__LINE__);
         // Here file is deemed legit, chdir to where the file lives here and restore at the end so offline objects are handled properly
+        XMLFileDirectoryScope directoryScope(aFileName);
         const string saveWorkingDirectory = IO::getCwd();
         const string directoryOfXMLFile = IO::getParentDirectory(aFileName);
         IO::chDir(directoryOfXMLFile);
@@ -1593,6 +1710,7 @@ void Object::updateFromXMLDocument()
     SimTK::Xml::Element e = _document->getRootDataElement(); 
     const string saveWorkingDirectory = IO::getCwd();
     string parentFileName = _document->getFileName();
+    XMLFileDirectoryScope directoryScope(parentFileName);
     const string directoryOfXMLFile = IO::getParentDirectory(parentFileName);
     IO::chDir(directoryOfXMLFile);
     updateFromXMLNode(e, _document->getDocumentVersion());
@@ -526,6 +526,10 @@ protected:
     that use of this flag is entirely optional; most %Object classes don't
     have any expensive initialization to worry about.
 
+    The flag is copied along with the properties, so an %Object that uses it
+    must also copy the data it derived from its properties when it is copied
+    (the compiler-generated copy constructor and assignment do).
+
     This flag is cleared automatically but if you want to clear it manually
     for testing or debugging, see clearObjectIsUpToDateWithProperties(). **/
     void setObjectIsUpToDateWithProperties() {
@@ -602,6 +606,30 @@ public:
         return _serializeAllDefaults;
     }
 
+    /** Set the number of threads used to deserialize the objects in a list
+    property, such as the muscles of a ForceSet or the bodies of a BodySet.
+    This applies to the elements of every Set as well as to list properties
+    declared with OpenSim_DECLARE_LIST_PROPERTY. The objects of a list are
+    all created first and then read. The default, 1, reads every object on
+    the calling thread. Only the
+    outermost list being read at a time is divided among threads, and a list
+    that includes objects from other files is always read serially. **/
+    static void setNumDeserializationThreads(int numThreads);
+    /** Report the number of threads used to deserialize lists of objects. **/
+    static int getNumDeserializationThreads()
+    {
+        return _numDeserializationThreads;
+    }
+
+    /** Read each of a list of independent objects from the corresponding
+    XML element, using up to getNumDeserializationThreads() threads. This is
+    used by list properties and by the object arrays that hold the elements
+    of Sets; each object is read as if by readObjectFromXMLNodeOrFile(). **/
+    static void readObjectsFromXMLNodesOrFiles
+       (const SimTK::Array_<Object*>&          objects,
+        SimTK::Array_<SimTK::Xml::Element>&   elements,
+        int                                   versionNumber);
+
     /** Returns true if the passed-in string is "Object"; each %Object-derived
     class defines a method of this name for its own class name. **/
     static bool isKindOf(const char *type) 
@@ -819,6 +847,9 @@ private:
     // a "defaults" section.
     static bool _serializeAllDefaults;
 
+    // Number of threads used to deserialize the objects of a list property.
+    static int _numDeserializationThreads;
+
     // Debug level: 
     //  0: Hides non fatal warnings 
     //  1: Shows illegal tags 
@@ -1201,6 +1232,8 @@ ObjectProperty<T>::readFromXMLElement
     // by the element's tag; that type must be derived from O or we
     // can't store it in this property.
     int objectsFound = 0;
+    SimTK::Array_<Object*> objects;
+    SimTK::Array_<SimTK::Xml::Element> elements;
     SimTK::Xml::element_iterator iter = propertyElement.element_begin();
     for (; iter != propertyElement.element_end(); ++iter) {
         const SimTK::String& objTypeTag = iter->getElementTag();
@@ -1229,12 +1262,24 @@ ObjectProperty<T>::readFromXMLElement
         if (objectsFound > this->getMaxListSize())
             continue; // ignore this one
 
-        // Create an Object of the element tag's type.
-        Object* object = Object::newInstanceOfType(objTypeTag);
-        assert(object); // we just checked above
-        object->readObjectFromXMLNodeOrFile(*iter, versionNumber);
+        // Create an Object of the element tag's type; it is read below.
+        objects.push_back(registeredObj->clone());
+        elements.push_back(*iter);
+    }
+
+    // The objects are independent of each other so they can be read
+    // concurrently.
+    try {
+        Object::readObjectsFromXMLNodesOrFiles(objects, elements, 
+                                               versionNumber);
+    } catch (...) {
+        for (unsigned i=0; i < objects.size(); ++i)
+            delete objects[i];
+        throw;
+    }
 
-        T* objectT = dynamic_cast<T*>(object);
+    for (unsigned i=0; i < objects.size(); ++i) {
+        T* objectT = dynamic_cast<T*>(objects[i]);
         assert(objectT); // should have worked by construction
         adoptAndAppendValueVirtual(objectT); // don't copy
     }
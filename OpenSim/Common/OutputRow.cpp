@@ -0,0 +1,106 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  OutputRow.cpp                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "OutputRow.h"
+#include "Exception.h"
+#include <sstream>
+
+using namespace OpenSim;
+using namespace std;
+
+void OutputRow::addOutput(const AbstractOutput& output, const string& label)
+{
+    _outputs.push_back(SimTK::ReferencePtr<const AbstractOutput>(output));
+    _labels.push_back(label.empty() ? output.getName() : label);
+    _prepared = false;
+}
+
+void OutputRow::clear()
+{
+    _outputs.clear();
+    _labels.clear();
+    _sizes.clear();
+    _columnLabels.setSize(0);
+    _row.resize(0);
+    _prepared = false;
+}
+
+SimTK::Stage OutputRow::getDependsOnStage() const
+{
+    SimTK::Stage stage = SimTK::Stage::Topology;
+    for (size_t i = 0; i < _outputs.size(); ++i)
+        stage = std::max(stage, _outputs[i]->getDependsOnStage());
+    return stage;
+}
+
+void OutputRow::prepare(const SimTK::State& state)
+{
+    _sizes.resize(_outputs.size());
+    _columnLabels.setSize(0);
+    _columnLabels.append("time");
+    int numColumns = 0;
+    for (size_t i = 0; i < _outputs.size(); ++i) {
+        const int size = _outputs[i]->getNumberOfDoubles(state);
+        if (size < 0) {
+            throw Exception("OutputRow: ERR- output '" + _labels[i] +
+                "' of type " + _outputs[i]->getTypeName() +
+                " cannot be reported as doubles.", __FILE__, __LINE__);
+        }
+        _sizes[i] = size;
+        numColumns += size;
+        if (size == 1)
+            _columnLabels.append(_labels[i]);
+        else {
+            for (int j = 0; j < size; ++j) {
+                stringstream label;
+                label << _labels[i] << "_" << j+1;
+                _columnLabels.append(label.str());
+            }
+        }
+    }
+    _row.resize(numColumns);
+    _prepared = true;
+}
+
+const SimTK::Vector& OutputRow::gather(const SimTK::State& state)
+{
+    if (!_prepared) prepare(state);
+
+    double* values = _row.size() > 0 ? &_row[0] : NULL;
+    int column = 0;
+    for (size_t i = 0; i < _outputs.size(); ++i) {
+        const int written = _outputs[i]->getValueAsDoubles(state,
+            values+column, _row.size()-column);
+        if (written != _sizes[i]) {
+            stringstream msg;
+            msg << "OutputRow: ERR- output '" << _labels[i] << "' has "
+                << written << " elements; it had " << _sizes[i]
+                << " when the row was prepared.";
+            throw Exception(msg.str(), __FILE__, __LINE__);
+        }
+        column += written;
+    }
+    return _row;
+}
@@ -0,0 +1,95 @@
+#ifndef OPENSIM_OUTPUT_ROW_H_
+#define OPENSIM_OUTPUT_ROW_H_
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  OutputRow.h                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include "Array.h"
+#include "Component.h"
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Gathers the values of a list of Outputs into one preallocated row of
+ * doubles, for reporters that record many Outputs at every step.
+ *
+ * Add the Outputs to report, then call prepare() once with a realized State to
+ * size the row and label its columns. Each call to gather() then evaluates 
+ * every Output once and writes its value into the row in place, without
+ * allocating. Outputs whose values have several elements (e.g., a 
+ * SimTK::Vec3) occupy one column per element.
+ *
+ * @code
+ * OutputRow row;
+ * row.addOutput(model.getOutput("com_position"), "com");
+ * row.prepare(s);
+ * storage.setColumnLabels(row.getColumnLabels());
+ * ...
+ * const SimTK::Vector& values = row.gather(s);
+ * storage.append(s.getTime(), values.size(), &values[0]);
+ * @endcode
+ */
+class OSIMCOMMON_API OutputRow {
+public:
+    OutputRow() : _prepared(false) {}
+
+    /** Add an Output, whose columns are labeled with label (or the Output's
+    name if label is empty). The Output must outlive this row. */
+    void addOutput(const AbstractOutput& output, const std::string& label = "");
+    /** Remove all Outputs. */
+    void clear();
+    int getNumOutputs() const { return (int)_outputs.size(); }
+
+    /** Size the row and construct its column labels from the values of the
+    Outputs at this State, which must be realized to their dependsOnStage.
+    Throws if an Output's type cannot be written as doubles. */
+    void prepare(const SimTK::State& state);
+
+    /** The highest dependsOnStage of the Outputs: the stage a State must be
+    realized to for gather(). */
+    SimTK::Stage getDependsOnStage() const;
+
+    /** The column labels, with "time" first. Valid after prepare(). */
+    const Array<std::string>& getColumnLabels() const { return _columnLabels; }
+    int getNumColumns() const { return _row.size(); }
+
+    /** Write the values of all Outputs at this State into the row and return
+    it. Throws if an Output's value no longer has the number of elements it
+    had in prepare(). */
+    const SimTK::Vector& gather(const SimTK::State& state);
+
+private:
+    std::vector<SimTK::ReferencePtr<const AbstractOutput> > _outputs;
+    std::vector<std::string> _labels;
+    std::vector<int> _sizes;
+    Array<std::string> _columnLabels;
+    SimTK::Vector _row;
+    bool _prepared;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_OUTPUT_ROW_H_
@@ -512,6 +512,23 @@ int SimmSpline::addPoint(double aX, double aY)
 }
 
 double SimmSpline::calcValue(const Vector& x) const
+{
+    return calcSplineValue(x[0]);
+}
+
+double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
+{
+    return calcSplineDerivative((int)derivComponents.size(), x[0]);
+}
+
+double SimmSpline::evaluate(int derivOrder, double x) const
+{
+    if (derivOrder == 0)
+        return calcSplineValue(x);
+    return calcSplineDerivative(derivOrder, x);
+}
+
+double SimmSpline::calcSplineValue(double aX) const
 {
     // NOT A NUMBER
     if(!_y.getSize()) return(SimTK::NaN);
@@ -523,7 +540,6 @@ double SimmSpline::calcValue(const Vector& x) const
     double dx;
 
     int n = _x.getSize();
-    double aX = x[0];
 
    /* Check if the abscissa is out of range of the function. If it is,
     * then use the slope of the function at the appropriate end point to
@@ -578,7 +594,7 @@ double SimmSpline::calcValue(const Vector& x) const
    return _y[k] + dx*(_b[k] + dx*(_c[k] + dx*_d[k]));
 }
 
-double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
+double SimmSpline::calcSplineDerivative(int aDerivOrder, double aX) const
 {
     // NOT A NUMBER
     if(!_y.getSize()) return(SimTK::NaN);
@@ -590,8 +606,6 @@ double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const
     double dx;
 
     int n = _x.getSize();
-    double aX = x[0];
-    int aDerivOrder = (int)derivComponents.size();
     if (aDerivOrder < 1 || aDerivOrder > 2)
         throw Exception("SimmSpline::calcDerivative(): derivative order must be 1 or 2.");
 
@@ -122,6 +122,7 @@ public:
     //--------------------------------------------------------------------------
     double calcValue(const SimTK::Vector& x) const;
     double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const;
+    double evaluate(int derivOrder, double x) const;
     int getArgumentSize() const;
     int getMaxDerivativeOrder() const;
     SimTK::Function* createSimTKFunction() const;
@@ -130,6 +131,8 @@ public:
 
 private:
     void calcCoefficients();
+    double calcSplineValue(double aX) const;
+    double calcSplineDerivative(int aDerivOrder, double aX) const;
 //=============================================================================
 };  // END class SimmSpline
 
@@ -33,6 +33,7 @@
 #include "IO.h"
 #include "Signal.h"
 #include "Storage.h"
+#include "StorageWriter.h"
 #include "GCVSplineSet.h"
 #include "SimmIO.h"
 #include "SimmMacros.h"
@@ -82,6 +83,7 @@ const int Storage::LatestVersion = 1;
  */
 Storage::~Storage()
 {
+    delete _writer;
 }
 
 //=============================================================================
@@ -313,7 +315,7 @@ setNull()
     setHeaderToken(DEFAULT_HEADER_TOKEN);
     _stepInterval = 1;
     _lastI = 0;
-    _fp = 0;
+    _writer = NULL;
     _inDegrees = false;
 }
 //_____________________________________________________________________________
@@ -1313,6 +1315,20 @@ reset(double aTime)
 
     return( reset(index) );
 }
+//_____________________________________________________________________________
+/**
+ * Remove the first aNumRows rows, keeping the rows after them in order.
+ */
+void Storage::
+removeFirstRows(int aNumRows)
+{
+    int size = _storage.getSize();
+    if(aNumRows<=0) return;
+    if(aNumRows>size) aNumRows = size;
+    for(int i=aNumRows;i<size;i++) _storage[i-aNumRows] = _storage[i];
+    _storage.setSize(size-aNumRows);
+    _lastI = 0;
+}
 
 
 //_____________________________________________________________________________
@@ -1352,14 +1368,20 @@ int Storage::
 append(const StateVector &aStateVector,bool aCheckForDuplicateTime)
 {
     // TODO: use some tolerance when checking for duplicate time?
-    if(aCheckForDuplicateTime && _storage.getSize() && _storage.getLast().getTime()==aStateVector.getTime())
+    bool replace = aCheckForDuplicateTime && _storage.getSize() &&
+                   _storage.getLast().getTime()==aStateVector.getTime();
+    if(replace)
         _storage.updLast() = aStateVector;
     else
         _storage.append(aStateVector);
 
-    if (_fp!=0){
-        aStateVector.print(_fp);
-        fflush(_fp);
+    if (_writer!=NULL){
+        const Array<double>& data = aStateVector.getData();
+        const double *y = data.getSize() ? &data[0] : NULL;
+        if(replace)
+            _writer->replaceLast(aStateVector.getTime(),data.getSize(),y);
+        else
+            _writer->append(aStateVector.getTime(),data.getSize(),y);
     }
     return(_storage.getSize());
 }
@@ -1377,7 +1399,7 @@ int Storage::
 append(const Array<StateVector> &aStorage)
 {
     for(int i=0; i<aStorage.getSize(); i++)
-        _storage.append(aStorage[i]);
+        append(aStorage[i],false);
     return(_storage.getSize());
 }
 //_____________________________________________________________________________
@@ -2432,9 +2454,10 @@ findIndex(int aI,double aT) const
     for(i=aI;i<_storage.getSize();i++) {
         if(aT<getStateVector(i)->getTime()) break;
     }
-    _lastI = i-1;
-    if(_lastI<0) _lastI=0;
-    return(_lastI);
+    int lastI = i-1;
+    if(lastI<0) lastI=0;
+    _lastI = lastI;
+    return(lastI);
 }
 //_____________________________________________________________________________
 /**
@@ -2456,9 +2479,10 @@ findIndex(double aT) const
     for(i=0;i<_storage.getSize();i++) {
         if(aT<getStateVector(i)->getTime()) break;
     }
-    _lastI = i-1;
-    if(_lastI<0) _lastI=0;
-    return(_lastI);
+    int lastI = i-1;
+    if(lastI<0) lastI=0;
+    _lastI = lastI;
+    return(lastI);
 }
 //_____________________________________________________________________________
 /** 
@@ -2599,27 +2623,140 @@ void Storage::interpolateAt(const Array<double> &targetTimes)
 //=============================================================================
 // IO
 //=============================================================================
+// print() formats rows into a buffer and writes it out in pieces of about
+// this many bytes.
+static const size_t PrintBufferSize = 1 << 20;
+
+// Write buffer to fp and clear it. Return the number of characters written,
+// or -1 on failure.
+static int writeBuffer(std::string& buffer, FILE *fp)
+{
+    size_t n = fwrite(buffer.data(),1,buffer.size(),fp);
+    bool ok = n==buffer.size();
+    buffer.clear();
+    return(ok ? (int)n : -1);
+}
 //_____________________________________________________________________________
 /**
  * Set name of output file to be written into.
- * This has the side effect of openning the file for writing. The header will not have the correct
- * number of rows but this may not be an issue for ersion 2 of the Storage class
+ * This has the side effect of opening the file and writing the header and the
+ * rows stored so far. Rows appended afterwards are written as they come, and
+ * the header is rewritten with the final number of rows when the file is
+ * closed.
  */
 void Storage::
-setOutputFileName(const std::string& aFileName)
+setOutputFileName(const std::string& aFileName, bool aWriteInBackground)
 {
-    assert(_fileName=="");
+    assert(_writer==NULL);
     _fileName = aFileName;
 
-    // OPEN THE FILE
-    _fp = IO::OpenFile(aFileName,"w");
-    if(_fp==NULL) throw(Exception("Could not open file "+aFileName));
-    // WRITE THE HEADER
-    int n=0,nTotal=0;
-    n = writeHeader(_fp);
-    n = writeDescription(_fp);
-    // WRITE THE COLUMN LABELS
-    n = writeColumnLabels(_fp);
+    // OPEN THE FILE AND WRITE THE HEADER
+    _writer = new StorageWriter(aFileName,
+        [this](FILE *fp) { return writeFileHeader(fp); }, aWriteInBackground);
+
+    // WRITE THE ROWS SO FAR
+    for(int i=0;i<_storage.getSize();i++) {
+        const Array<double>& data = _storage[i].getData();
+        _writer->append(_storage[i].getTime(), data.getSize(),
+                        data.getSize() ? &data[0] : NULL);
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Finish writing the output file, if there is one.
+ */
+bool Storage::
+closeOutputFile()
+{
+    if(_writer==NULL) return(false);
+    StorageWriter *writer = _writer;
+    _writer = NULL;
+    try {
+        writer->close();
+    } catch(...) {
+        delete writer;
+        throw;
+    }
+    delete writer;
+    return(true);
+}
+//_____________________________________________________________________________
+/**
+ * Write the name, column labels and rows of this storage to a binary stream.
+ * Each row is written as its time, its number of values and the values.
+ */
+void Storage::
+writeBinary(std::ostream& aStream) const
+{
+    auto writeInt = [&aStream](int aValue) {
+        aStream.write(reinterpret_cast<const char*>(&aValue), sizeof(int));
+    };
+    auto writeString = [&](const std::string& aString) {
+        writeInt((int)aString.size());
+        aStream.write(aString.data(), aString.size());
+    };
+
+    writeString(_name);
+    writeInt(_columnLabels.getSize());
+    for(int i=0; i<_columnLabels.getSize(); ++i) writeString(_columnLabels[i]);
+
+    writeInt(_storage.getSize());
+    for(int i=0; i<_storage.getSize(); ++i) {
+        const StateVector& vec = _storage[i];
+        double time = vec.getTime();
+        int n = vec.getSize();
+        aStream.write(reinterpret_cast<const char*>(&time), sizeof(double));
+        writeInt(n);
+        if(n>0) aStream.write(reinterpret_cast<const char*>(&vec.getData()[0]),
+                              n*sizeof(double));
+    }
+    if(!aStream) throw Exception("Storage.writeBinary: ERROR- failed to write "
+                                 "storage '"+_name+"'.", __FILE__, __LINE__);
+}
+//_____________________________________________________________________________
+/**
+ * Replace the contents of this storage with those written by writeBinary().
+ */
+void Storage::
+readBinary(std::istream& aStream)
+{
+    auto fail = [this]() {
+        throw Exception("Storage.readBinary: ERROR- unexpected end of data "
+                        "while reading storage '"+_name+"'.",
+                        __FILE__, __LINE__);
+    };
+    auto readInt = [&]() {
+        int value = 0;
+        if(!aStream.read(reinterpret_cast<char*>(&value), sizeof(int))
+           || value<0) fail();
+        return value;
+    };
+    auto readString = [&]() {
+        std::string str(readInt(), '\0');
+        if(!str.empty() && !aStream.read(&str[0], str.size())) fail();
+        return str;
+    };
+
+    _name = readString();
+    int nLabels = readInt();
+    Array<std::string> labels("", nLabels);
+    for(int i=0; i<nLabels; ++i) labels[i] = readString();
+    setColumnLabels(labels);
+
+    purge();
+    int nRows = readInt();
+    _storage.ensureCapacity(nRows);
+    Array<double> data(0.0);
+    for(int i=0; i<nRows; ++i) {
+        double time;
+        if(!aStream.read(reinterpret_cast<char*>(&time), sizeof(double)))
+            fail();
+        int n = readInt();
+        data.setSize(n);
+        if(n>0 && !aStream.read(reinterpret_cast<char*>(&data[0]),
+                                n*sizeof(double))) fail();
+        _storage.append(StateVector(time, n, n>0 ? &data[0] : NULL));
+    }
 }
 //_____________________________________________________________________________
 /**
@@ -2641,6 +2778,10 @@ setOutputFileName(const std::string& aFileName)
 bool Storage::
 print(const string &aFileName,const string &aMode, const string& aComment) const
 {
+    // FINISH STREAMING TO THE SAME FILE BEFORE REPLACING IT
+    if(_writer!=NULL && _writer->getFileName()==aFileName)
+        const_cast<Storage*>(this)->closeOutputFile();
+
     // OPEN THE FILE
     FILE *fp = IO::OpenFile(aFileName,aMode);
     if(fp==NULL) return(false);
@@ -2684,13 +2825,22 @@ print(const string &aFileName,const string &aMode, const string& aComment) const
 //std::cout << aFileName << endl;
 
     // VECTORS
+    // Formatted into a buffer that is written in large pieces.
+    std::string buffer;
+    const char *format = IO::GetDoubleOutputFormat();
     for(int i=0;i<_storage.getSize();i++) {
-        n = getStateVector(i)->print(fp);
-        if(n<0) {
-            cout << "Storage.print(const string&,const string&): error printing to " << aFileName;
-            return(false);
+        const Array<double>& data = _storage[i].getData();
+        StorageWriter::formatRow(buffer,format,_storage[i].getTime(),
+            data.getSize(),data.getSize() ? &data[0] : NULL);
+        if(buffer.size()>=PrintBufferSize || i==_storage.getSize()-1) {
+            n = writeBuffer(buffer,fp);
+            if(n<0) {
+                cout << "Storage.print(const string&,const string&): error printing to " << aFileName;
+                fclose(fp);
+                return(false);
+            }
+            nTotal += n;
         }
-        nTotal += n;        
     }
 
     // CLOSE
@@ -2718,7 +2868,8 @@ print(const string &aFileName,double aDT,const string &aMode) const
     // CHECK FOR VALID DT
     if(aDT<=0) return(0);
 
-    if (_fp!= NULL) fclose(_fp);
+    if(_writer!=NULL && _writer->getFileName()==aFileName)
+        const_cast<Storage*>(this)->closeOutputFile();
     // OPEN THE FILE
     FILE *fp = IO::OpenFile(aFileName,aMode);
     if(fp==NULL) return(-1);
@@ -2768,20 +2919,25 @@ print(const string &aFileName,double aDT,const string &aMode) const
     // LOOP THROUGH THE DATA
     int i,ny=0;
     double t,*y=NULL;
-    StateVector vec;
+    std::string buffer;
+    const char *format = IO::GetDoubleOutputFormat();
     for(t=ti,i=0;i<nr;i++,t=ti+aDT*(double)i) {
 
         // INTERPOLATE THE STATES
         ny = getDataAtTime(t,ny,&y);
-        vec.setStates(t,ny,y);
 
         // PRINT
-        n = vec.print(fp);
-        if(n<0) {
-            cout << "Storage.print(const string&,const string&): error printing to " << aFileName;
-            return(n);
+        StorageWriter::formatRow(buffer,format,t,ny,y);
+        if(buffer.size()>=PrintBufferSize || i==nr-1) {
+            n = writeBuffer(buffer,fp);
+            if(n<0) {
+                cout << "Storage.print(const string&,const string&): error printing to " << aFileName;
+                fclose(fp);
+                if(y!=NULL) delete[] y;
+                return(n);
+            }
+            nTotal += n;
         }
-        nTotal += n;        
     }
 
     // CLEANUP
@@ -2807,13 +2963,15 @@ printResult(const Storage *aStorage,const std::string &aName,
  * Write the header.
  */
 int Storage::
-writeHeader(FILE *rFP,double aDT) const
+writeHeader(FILE *rFP,double aDT,int aNumRows) const
 {
     if(rFP==NULL) return(-1);
 
     // COMPUTE ATTRIBUTES
     int nr,nc;
-    if(aDT<=0) {
+    if(aNumRows>=0) {
+        nr = aNumRows;
+    } else if(aDT<=0) {
         nr = _storage.getSize();
     } else {
         double ti = getFirstTime();
@@ -2838,7 +2996,8 @@ writeHeader(FILE *rFP,double aDT) const
  * @return SIMM header.
  */
 int Storage::
-writeSIMMHeader(FILE *rFP,double aDT, const char *aComment) const
+writeSIMMHeader(FILE *rFP,double aDT, const char *aComment,
+                int aNumRows) const
 {
     if(rFP==NULL) return(-1);
 
@@ -2858,7 +3017,9 @@ writeSIMMHeader(FILE *rFP,double aDT, const char *aComment) const
 
     // ROWS
     int nRows;
-    if(aDT<=0) {
+    if(aNumRows>=0) {
+        nRows = aNumRows;
+    } else if(aDT<=0) {
         nRows = _storage.getSize();
     } else {
         nRows = IO::ComputeNumberOfSteps(getFirstTime(),getLastTime(),aDT);
@@ -2927,6 +3088,19 @@ writeColumnLabels(FILE *rFP) const
 
     return(0);
 }
+//_____________________________________________________________________________
+/**
+ * Write everything print() writes before the rows: the header, the SIMM
+ * header if requested, the description and the column labels.
+ */
+int Storage::
+writeFileHeader(FILE *rFP,int aNumRows) const
+{
+    if(writeHeader(rFP,-1,aNumRows)<0) return(-1);
+    if(_writeSIMMHeader && writeSIMMHeader(rFP,-1,0,aNumRows)<0) return(-1);
+    if(writeDescription(rFP)<0) return(-1);
+    return(writeColumnLabels(rFP));
+}
 void Storage::addToRdStorage(Storage& rStorage, double aStartTime, double aEndTime)
 {
     bool addedData = false;
@@ -33,12 +33,15 @@
 #include "Units.h"
 #include "SimTKcommon.h"
 #include "StorageInterface.h"
+#include <atomic>
 
 const int Storage_DEFAULT_CAPACITY = 256;
 //=============================================================================
 //=============================================================================
 namespace OpenSim { 
 
+class StorageWriter;
+
 typedef std::map<std::string, std::string, std::less<std::string> > MapKeysToValues;
 
 //static std::string[] simmReservedKeys;
@@ -87,8 +90,9 @@ protected:
     /** Step interval at which states in a simulation are stored. See
     store(). */
     int _stepInterval;
-    /** Last index at which a search was started. */
-    mutable int _lastI;
+    /** Last index at which a search was started. Searches may be made from
+    several threads at once. */
+    mutable std::atomic<int> _lastI;
     /** Flag for whether or not to insert a SIMM style header. */
     bool _writeSIMMHeader;
     /** Units in which the data is represented. */
@@ -97,9 +101,10 @@ protected:
     bool _inDegrees;
     /** Map between keys in file header and values */
     MapKeysToValues _keyValueMap;
-    /** Cache for fileName and file pointer when the file is opened so we can flush and write intermediate files if needed */
+    /** Cache for fileName and the writer that streams rows to it as they are
+    appended, so intermediate results are on disk if needed */
     std::string _fileName;
-    FILE *_fp;
+    StorageWriter *_writer;
     /** Name and Description */
     std::string _name;
     std::string _description;
@@ -298,16 +303,43 @@ public:
     //--------------------------------------------------------------------------
     bool print(const std::string &aFileName,const std::string &aMode="w", const std::string& aComment="") const;
     int print(const std::string &aFileName,double aDT,const std::string &aMode="w") const;
-    void setOutputFileName(const std::string& aFileName) ;
+    /** Write the rows of this storage to aFileName as they are appended,
+    in large buffered writes (in a background thread if aWriteInBackground),
+    instead of all at once by print(). The rows already stored are written
+    first. The file is finished by closeOutputFile(), by printing to the same
+    file or when this storage is destroyed, and is then the same file
+    print(aFileName) writes, provided rows were only added by append() or
+    store() in the meantime. See StorageWriter. */
+    void setOutputFileName(const std::string& aFileName,
+                           bool aWriteInBackground=false);
+    /** Finish the file begun by setOutputFileName(), with a header for all the
+    rows written. Returns false if no file was being written. Throws an
+    Exception if writing failed. */
+    bool closeOutputFile();
+    /** Write the name, column labels and rows of this storage to a binary
+    stream (e.g., a simulation checkpoint). Values are written in their native
+    representation so that they are read back exactly by readBinary(). */
+    void writeBinary(std::ostream& aStream) const;
+    /** Replace the name, column labels and rows of this storage with those
+    written by writeBinary(). Throws an Exception if the stream is corrupt. */
+    void readBinary(std::istream& aStream);
     // convenience function for Analyses and DerivCallbacks
     static void printResult(const Storage *aStorage,const std::string &aName,
         const std::string &aDir,double aDT,const std::string &aExtension);
     void interpolateAt(const Array<double> &targetTimes);
 private:
-    int writeHeader(FILE *rFP,double aDT=-1) const;
-    int writeSIMMHeader(FILE *rFP,double aDT=-1, const char*aComment=0) const;
+    // aNumRows, if not negative, is the number of rows written instead of
+    // the number stored.
+    int writeHeader(FILE *rFP,double aDT=-1,int aNumRows=-1) const;
+    int writeSIMMHeader(FILE *rFP,double aDT=-1, const char*aComment=0,
+                        int aNumRows=-1) const;
     int writeDescription(FILE *rFP) const;
     int writeColumnLabels(FILE *rFP) const;
+    int writeFileHeader(FILE *rFP,int aNumRows=-1) const;
+    void removeFirstRows(int aNumRows);
+
+    // Streams the rows of a storage (see StorageStream.h).
+    friend class StorageStream;
     int integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const;
     int integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const;
 
@@ -0,0 +1,129 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  StorageStatistics.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StorageStatistics.h"
+#include "Exception.h"
+#include "IO.h"
+#include <cmath>
+#include <cstdio>
+#include "SimTKcommon.h"
+
+using namespace OpenSim;
+
+void StorageStatistics::reset()
+{
+    _numRows = 0;
+    _startTime = _endTime = SimTK::NaN;
+    _count.clear();
+    _min.clear();
+    _max.clear();
+    _sum.clear();
+    _sumOfSquares.clear();
+}
+
+void StorageStatistics::add(double time, int n, const double* values)
+{
+    if (_numRows++ == 0) _startTime = time;
+    _endTime = time;
+
+    if (n > (int)_count.size()) {
+        _count.resize(n, 0);
+        _min.resize(n, SimTK::Infinity);
+        _max.resize(n, -SimTK::Infinity);
+        _sum.resize(n, 0);
+        _sumOfSquares.resize(n, 0);
+    }
+    for (int i = 0; i < n; ++i) {
+        const double x = values[i];
+        if (std::isnan(x)) continue;
+        ++_count[i];
+        if (x < _min[i]) _min[i] = x;
+        if (x > _max[i]) _max[i] = x;
+        _sum[i] += x;
+        _sumOfSquares[i] += x*x;
+    }
+}
+
+double StorageStatistics::getMin(int i) const
+{
+    return _count[i] ? _min[i] : SimTK::NaN;
+}
+
+double StorageStatistics::getMax(int i) const
+{
+    return _count[i] ? _max[i] : SimTK::NaN;
+}
+
+double StorageStatistics::getMean(int i) const
+{
+    return _count[i] ? _sum[i]/_count[i] : SimTK::NaN;
+}
+
+double StorageStatistics::getRMS(int i) const
+{
+    return _count[i] ? std::sqrt(_sumOfSquares[i]/_count[i]) : SimTK::NaN;
+}
+
+void StorageStatistics::print(const std::string& fileName,
+                              const std::string& name,
+                              const Array<std::string>& columnLabels) const
+{
+    FILE* fp = IO::OpenFile(fileName, "w");
+    if (fp == NULL)
+        throw Exception("StorageStatistics: ERROR- could not open "
+                        + fileName + ".", __FILE__, __LINE__);
+
+    const int nc = getNumColumns();
+    const char* format = IO::GetDoubleOutputFormat();
+    fprintf(fp, "%s\n", name.c_str());
+    fprintf(fp, "nRows=4\n");
+    fprintf(fp, "nColumns=%d\n", nc+1);
+    fprintf(fp, "numSamples=%d\n", _numRows);
+    fprintf(fp, "startTime=%.16g\n", _startTime);
+    fprintf(fp, "endTime=%.16g\n", _endTime);
+    fprintf(fp, "endheader\n");
+
+    fprintf(fp, "statistic");
+    for (int i = 0; i < nc; ++i) {
+        if (i+1 < columnLabels.getSize())
+            fprintf(fp, "\t%s", columnLabels[i+1].c_str());
+        else
+            fprintf(fp, "\tcolumn%d", i+1);
+    }
+    fprintf(fp, "\n");
+
+    const char* statistics[] = {"min", "max", "mean", "rms"};
+    for (int s = 0; s < 4; ++s) {
+        fprintf(fp, "%s", statistics[s]);
+        for (int i = 0; i < nc; ++i) {
+            double value = s == 0 ? getMin(i) : s == 1 ? getMax(i) :
+                           s == 2 ? getMean(i) : getRMS(i);
+            fprintf(fp, "\t");
+            fprintf(fp, format, value);
+        }
+        fprintf(fp, "\n");
+    }
+
+    if (fclose(fp) != 0)
+        throw Exception("StorageStatistics: ERROR- failed writing "
+                        + fileName + ".", __FILE__, __LINE__);
+}
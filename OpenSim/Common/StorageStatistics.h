@@ -0,0 +1,88 @@
+#ifndef OPENSIM_STORAGE_STATISTICS_H_
+#define OPENSIM_STORAGE_STATISTICS_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  StorageStatistics.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include "Array.h"
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * The minimum, maximum, mean and root mean square of each column of the rows
+ * of a storage, accumulated one row at a time so that the rows themselves
+ * need not be kept.
+ *
+ * Each column has its own count of values, so rows of different lengths are
+ * allowed, and NaN values are skipped.
+ *
+ * StorageStream computes the statistics of a storage as rows are appended.
+ */
+class OSIMCOMMON_API StorageStatistics {
+public:
+    StorageStatistics() { reset(); }
+
+    /** Forget all rows added. */
+    void reset();
+
+    /** Add a row of n values at the given time. */
+    void add(double time, int n, const double* values);
+
+    /** The number of rows added. */
+    int getNumRows() const { return _numRows; }
+    /** The number of columns of the longest row added, not counting time. */
+    int getNumColumns() const { return (int)_count.size(); }
+    /** The time of the first and of the last row added. */
+    double getStartTime() const { return _startTime; }
+    double getEndTime() const { return _endTime; }
+
+    /** The statistics of column i, not counting time, or NaN if it has no
+    values. */
+    double getMin(int i) const;
+    double getMax(int i) const;
+    double getMean(int i) const;
+    double getRMS(int i) const;
+
+    /** Write the statistics to fileName as a tab-delimited table with a row
+    for each statistic and a column for each column of the storage. The
+    labels include time, as the column labels of a Storage do. */
+    void print(const std::string& fileName, const std::string& name,
+               const Array<std::string>& columnLabels) const;
+
+private:
+    int _numRows;
+    double _startTime;
+    double _endTime;
+    std::vector<int> _count;
+    std::vector<double> _min;
+    std::vector<double> _max;
+    std::vector<double> _sum;
+    std::vector<double> _sumOfSquares;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_STORAGE_STATISTICS_H_
@@ -0,0 +1,115 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  StorageStream.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StorageStream.h"
+#include "Exception.h"
+#include "Storage.h"
+#include "StorageWriter.h"
+#include <algorithm>
+
+using namespace OpenSim;
+
+StorageStream::StorageStream(Storage& storage) :
+    _storage(storage), _decimation(1), _maxRowsInMemory(-1),
+    _computeStatistics(false), _closed(false), _destroying(false),
+    _next(0), _numRows(0),
+    _numRowsWritten(0), _numRowsRemoved(0)
+{
+}
+
+StorageStream::~StorageStream()
+{
+    // The writer ignores the failure to rewrite the header.
+    _destroying = true;
+    _writer.reset();
+}
+
+void StorageStream::setFileName(const std::string& fileName,
+                                bool writeInBackground)
+{
+    if (_writer)
+        throw Exception("StorageStream: ERROR- already writing "
+                        + _fileName + ".", __FILE__, __LINE__);
+    _fileName = fileName;
+    // The header counts the rows written, which the storage may no longer
+    // hold when the header is rewritten at the end.
+    _writer.reset(new StorageWriter(fileName,
+        [this](FILE* fp) {
+            if (_destroying) return -1;
+            return _storage.writeFileHeader(fp, _numRowsWritten);
+        }, writeInBackground));
+}
+
+void StorageStream::setDecimation(int everyNth)
+{
+    _decimation = std::max(1, everyNth);
+}
+
+// Pass on the rows from _next up to, but not including, end.
+void StorageStream::passOn(int end)
+{
+    for (; _next < end; ++_next) {
+        const StateVector& row = *_storage.getStateVector(_next);
+        const Array<double>& data = row.getData();
+        const int n = data.getSize();
+        const double* values = n ? &data[0] : NULL;
+        if (_computeStatistics) _statistics.add(row.getTime(), n, values);
+        if (_numRows++ % _decimation != 0) continue;
+        ++_numRowsWritten;
+        if (_writer) _writer->append(row.getTime(), n, values);
+        if (_callback) _callback(_storage, row.getTime(), n, values);
+    }
+}
+
+void StorageStream::update()
+{
+    if (_closed) return;
+    const int size = _storage.getSize();
+    _next = std::min(_next, size);
+
+    // The last row is final only once another follows it.
+    passOn(size - 1);
+
+    // Remove the rows passed on that are not among the most recent, once
+    // there are at least as many of them as rows left, so that each row is
+    // moved a bounded number of times.
+    if (_maxRowsInMemory >= 0) {
+        const int removable = std::min(_next, size - _maxRowsInMemory);
+        if (removable > 0 && removable >= size - removable) {
+            _storage.removeFirstRows(removable);
+            _next -= removable;
+            _numRowsRemoved += removable;
+        }
+    }
+}
+
+void StorageStream::close()
+{
+    if (_closed) return;
+    _closed = true;
+    _next = std::min(_next, _storage.getSize());
+    passOn(_storage.getSize());
+    if (_writer) {
+        std::unique_ptr<StorageWriter> writer(std::move(_writer));
+        writer->close();
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef OPENSIM_STORAGE_STREAM_H_
+#define OPENSIM_STORAGE_STREAM_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  StorageStream.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include "StorageStatistics.h"
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace OpenSim {
+
+class Storage;
+class StorageWriter;
+
+//=============================================================================
+//=============================================================================
+/**
+ * Passes the rows of a Storage, as they are appended, to a file, to a
+ * callback and to column statistics, and keeps only the most recent rows in
+ * memory, so that long runs need not hold all their results.
+ *
+ * Call update() whenever rows may have been appended. A row is passed on once
+ * it is final, that is, once a row is appended after it, since
+ * Storage::append() replaces the last row if the next has the same time.
+ * close() passes on the last row and finishes the file.
+ *
+ * Rows must only be appended to the storage (by append() or store()) while
+ * it is streamed. The rows older than the most recent maximum number are
+ * removed from the storage, a block at a time, once they have been passed on.
+ *
+ * @code
+ * StorageStream stream(storage);
+ * stream.setFileName("results.sto");
+ * stream.setDecimation(10);
+ * stream.setMaxRowsInMemory(100);
+ * for (...) { storage.append(time, n, values); stream.update(); }
+ * stream.close();
+ * @endcode
+ */
+class OSIMCOMMON_API StorageStream {
+public:
+    /** Receives a final row of storage: its time and its n values. */
+    typedef std::function<void(const Storage& storage, double time, int n,
+                               const double* values)> RowCallback;
+
+    /** Stream the rows of storage appended from now on. The rows it has
+    already are passed on by the first update(). */
+    explicit StorageStream(Storage& storage);
+    /** Finishes the file if close() was not called, without passing on the
+    remaining rows or reading the storage, which may already be gone. The
+    file then keeps the header it was begun with. */
+    ~StorageStream();
+
+    const Storage& getStorage() const { return _storage; }
+
+    /** Write the rows to fileName, with the header of the storage, in the
+    background if writeInBackground (see StorageWriter). */
+    void setFileName(const std::string& fileName,
+                     bool writeInBackground = false);
+    const std::string& getFileName() const { return _fileName; }
+
+    /** Call callback with each row written. */
+    void setRowCallback(const RowCallback& callback) { _callback = callback; }
+
+    /** Write and pass to the callback only every everyNth row, starting with
+    the first. The statistics include every row. The default is 1. */
+    void setDecimation(int everyNth);
+    int getDecimation() const { return _decimation; }
+
+    /** Keep at most the most recent maxRows rows in the storage, plus rows
+    not yet passed on. The default, -1, keeps all rows. */
+    void setMaxRowsInMemory(int maxRows) { _maxRowsInMemory = maxRows; }
+    int getMaxRowsInMemory() const { return _maxRowsInMemory; }
+
+    /** Compute the statistics of the columns of the rows. Off by default. */
+    void setComputeStatistics(bool compute) { _computeStatistics = compute; }
+    bool getComputeStatistics() const { return _computeStatistics; }
+    const StorageStatistics& getStatistics() const { return _statistics; }
+
+    /** The number of rows passed on, before decimation. */
+    int getNumRows() const { return _numRows; }
+    /** The number of rows written to the file and the callback. */
+    int getNumRowsWritten() const { return _numRowsWritten; }
+    /** The number of rows removed from the storage. */
+    int getNumRowsRemoved() const { return _numRowsRemoved; }
+
+    /** Pass on the final rows appended since the last call, and remove rows
+    from the storage if there are too many. */
+    void update();
+    /** Pass on all remaining rows and finish the file. Throws an Exception
+    if writing failed. Does nothing if already closed. */
+    void close();
+
+private:
+    StorageStream(const StorageStream&);
+    StorageStream& operator=(const StorageStream&);
+
+    void passOn(int end);
+
+    Storage& _storage;
+    std::string _fileName;
+    std::unique_ptr<StorageWriter> _writer;
+    RowCallback _callback;
+    int _decimation;
+    int _maxRowsInMemory;
+    bool _computeStatistics;
+    StorageStatistics _statistics;
+    bool _closed;
+    bool _destroying;
+
+    // The rows of the storage before this index have been passed on.
+    int _next;
+    int _numRows;
+    int _numRowsWritten;
+    int _numRowsRemoved;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_STORAGE_STREAM_H_
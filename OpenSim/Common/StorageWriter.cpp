@@ -0,0 +1,396 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  StorageWriter.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StorageWriter.h"
+#include "Exception.h"
+#include "IO.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace OpenSim;
+
+namespace {
+// Rows are handed to the writer in blocks of about this many values, and at
+// most this many blocks wait for the background thread.
+const size_t BlockValues = 1 << 16;
+const size_t MaxQueuedBlocks = 4;
+// The formatted text is written in pieces of about this many bytes.
+const size_t BufferBytes = 1 << 20;
+
+// If format is "%<width>.<precision>lf" or "%.<precision>lf" (the fixed-point
+// formats IO constructs), return its width (0 if none) and precision.
+bool parseFixedFormat(const char* format, int& width, int& precision)
+{
+    if (*format++ != '%') return false;
+    width = 0;
+    while (*format >= '0' && *format <= '9')
+        width = 10*width + (*format++ - '0');
+    if (*format++ != '.') return false;
+    if (*format < '0' || *format > '9') return false;
+    precision = 0;
+    while (*format >= '0' && *format <= '9')
+        precision = 10*precision + (*format++ - '0');
+    if (*format == 'l') ++format;
+    return format[0] == 'f' && format[1] == '\0';
+}
+
+#ifdef __SIZEOF_INT128__
+// Append x as printf() formats it with "%<width>.<precision>f": the exact
+// binary value of x rounded to precision decimals, half to even. Return false,
+// appending nothing, if x is not finite or is too large, or precision is too
+// high, for the 128-bit arithmetic.
+bool appendFixed(std::string& out, double x, int width, int precision)
+{
+    if (!std::isfinite(x) || precision > 17) return false;
+    int exponent;
+    const double fraction = std::frexp(std::fabs(x), &exponent);
+    if (exponent > 63) return false;
+
+    typedef unsigned __int128 uint128;
+    // |x| = mantissa*2^-shift exactly.
+    const uint64_t mantissa = (uint64_t)std::ldexp(fraction, 53);
+    const int shift = 53 - exponent;
+    uint128 power = 1;
+    for (int i = 0; i < precision; ++i) power *= 10;
+
+    // |x|*10^precision, rounded to an integer.
+    uint128 scaled;
+    if (shift <= 0)
+        scaled = ((uint128)mantissa << -shift) * power;
+    else {
+        const uint128 product = (uint128)mantissa * power;   // < 2^110
+        if (shift > 111)
+            scaled = 0;
+        else {
+            scaled = product >> shift;
+            const uint128 remainder = product - (scaled << shift);
+            const uint128 half = (uint128)1 << (shift-1);
+            if (remainder > half || (remainder == half && (scaled & 1)))
+                ++scaled;
+        }
+    }
+
+    char digits[48];
+    int numDigits = 0;
+    do {
+        digits[numDigits++] = char('0' + (int)(scaled % 10));
+        scaled /= 10;
+    } while (scaled != 0);
+    while (numDigits < precision+1) digits[numDigits++] = '0';
+
+    char text[64];
+    int length = 0;
+    if (std::signbit(x)) text[length++] = '-';
+    for (int i = numDigits-1; i >= 0; --i) {
+        text[length++] = digits[i];
+        if (i == precision && precision > 0) text[length++] = '.';
+    }
+    if (width > length) out.append(width-length, ' ');
+    out.append(text, length);
+    return true;
+}
+#endif
+
+void appendPrintf(std::string& out, const char* format, double x)
+{
+    char text[64];
+    int n = snprintf(text, sizeof(text), format, x);
+    if (n < 0) return;
+    if (n < (int)sizeof(text)) {
+        out.append(text, n);
+        return;
+    }
+    std::vector<char> large(n+1);
+    snprintf(&large[0], large.size(), format, x);
+    out.append(&large[0], n);
+}
+
+// Append x formatted with format, which parseFixedFormat() found to be fixed
+// with the given width and precision, or not.
+inline void appendValue(std::string& out, const char* format, bool fixed,
+                        int width, int precision, double x)
+{
+#ifdef __SIZEOF_INT128__
+    if (fixed && appendFixed(out, x, width, precision)) return;
+#endif
+    appendPrintf(out, format, x);
+}
+} // anonymous namespace
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+StorageWriter::StorageWriter(const std::string& fileName,
+        const HeaderWriter& writeHeader, bool writeInBackground) :
+    _fileName(fileName), _writeHeader(writeHeader),
+    _format(IO::GetDoubleOutputFormat()), _fp(NULL), _headerLength(0),
+    _numRows(0), _hasPending(false), _pendingTime(0), _failed(false),
+    _writeInBackground(writeInBackground), _closing(false)
+{
+    _fp = IO::OpenFile(_fileName, "w");
+    if (_fp == NULL)
+        throw Exception("StorageWriter: ERROR- could not open " + _fileName
+                        + ".", __FILE__, __LINE__);
+    // Keep the header to compare with the final one. If it cannot be kept,
+    // write it directly; close() then copies the rows after the final one.
+    bool written;
+    if (renderHeader(_header))
+        written = fwrite(_header.data(), 1, _header.size(), _fp)
+                  == _header.size();
+    else {
+        _header.clear();
+        written = _writeHeader(_fp) >= 0;
+    }
+    if (!written) {
+        fclose(_fp);
+        _fp = NULL;
+        throw Exception("StorageWriter: ERROR- could not write the header of "
+                        + _fileName + ".", __FILE__, __LINE__);
+    }
+    _headerLength = ftell(_fp);
+
+    if (_writeInBackground)
+        _thread = std::thread(&StorageWriter::runWriterThread, this);
+}
+
+StorageWriter::~StorageWriter()
+{
+    try {
+        close();
+    } catch (...) {}
+}
+
+//=============================================================================
+// ROWS
+//=============================================================================
+void StorageWriter::append(double time, int n, const double* values)
+{
+    if (_fp == NULL)
+        throw Exception("StorageWriter: ERROR- " + _fileName
+                        + " is closed.", __FILE__, __LINE__);
+    if (_hasPending) {
+        _block.times.push_back(_pendingTime);
+        _block.sizes.push_back((int)_pendingValues.size());
+        _block.values.insert(_block.values.end(),
+                             _pendingValues.begin(), _pendingValues.end());
+        if (_block.values.size() + _block.times.size() >= BlockValues)
+            submit();
+    }
+    _hasPending = true;
+    _pendingTime = time;
+    _pendingValues.assign(values, values+n);
+    ++_numRows;
+}
+
+void StorageWriter::replaceLast(double time, int n, const double* values)
+{
+    if (!_hasPending) {
+        append(time, n, values);
+        return;
+    }
+    _pendingTime = time;
+    _pendingValues.assign(values, values+n);
+}
+
+// Hand the current block to the background thread, or write it now.
+void StorageWriter::submit()
+{
+    if (_block.times.empty()) return;
+    if (!_writeInBackground) {
+        write(_block);
+    } else {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _changed.wait(lock, [this] {
+            return _queue.size() < MaxQueuedBlocks || _error; });
+        // After an error the rows are dropped; close() reports it.
+        if (!_error) {
+            _queue.push_back(Block());
+            _queue.back().times.swap(_block.times);
+            _queue.back().sizes.swap(_block.sizes);
+            _queue.back().values.swap(_block.values);
+            _changed.notify_all();
+        }
+    }
+    _block.times.clear();
+    _block.sizes.clear();
+    _block.values.clear();
+}
+
+void StorageWriter::write(const Block& block)
+{
+    const char* format = _format.c_str();
+    int width = 0, precision = 0;
+    const bool fixed = parseFixedFormat(format, width, precision);
+
+    const double* values = block.values.data();
+    for (size_t r = 0; r < block.times.size(); ++r) {
+        appendValue(_buffer, format, fixed, width, precision, block.times[r]);
+        for (int i = 0; i < block.sizes[r]; ++i) {
+            _buffer += '\t';
+            appendValue(_buffer, format, fixed, width, precision, values[i]);
+        }
+        _buffer += '\n';
+        values += block.sizes[r];
+
+        if (_buffer.size() >= BufferBytes || r+1 == block.times.size()) {
+            if (fwrite(_buffer.data(), 1, _buffer.size(), _fp)
+                    != _buffer.size())
+                _failed = true;
+            _buffer.clear();
+        }
+    }
+}
+
+void StorageWriter::formatRow(std::string& buffer, const char* format,
+                              double time, int n, const double* values)
+{
+    int width = 0, precision = 0;
+    const bool fixed = parseFixedFormat(format, width, precision);
+    appendValue(buffer, format, fixed, width, precision, time);
+    for (int i = 0; i < n; ++i) {
+        buffer += '\t';
+        appendValue(buffer, format, fixed, width, precision, values[i]);
+    }
+    buffer += '\n';
+}
+
+void StorageWriter::runWriterThread()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _changed.wait(lock, [this] { return !_queue.empty() || _closing; });
+        if (_queue.empty()) return;
+        Block block;
+        block.times.swap(_queue.front().times);
+        block.sizes.swap(_queue.front().sizes);
+        block.values.swap(_queue.front().values);
+        lock.unlock();
+        try {
+            write(block);
+        } catch (...) {
+            lock.lock();
+            _error = std::current_exception();
+            _queue.clear();
+            _changed.notify_all();
+            return;
+        }
+        lock.lock();
+        _queue.pop_front();
+        _changed.notify_all();
+    }
+}
+
+//=============================================================================
+// CLOSING
+//=============================================================================
+void StorageWriter::close()
+{
+    if (_fp == NULL) return;
+
+    if (_hasPending) {
+        _block.times.push_back(_pendingTime);
+        _block.sizes.push_back((int)_pendingValues.size());
+        _block.values.insert(_block.values.end(),
+                             _pendingValues.begin(), _pendingValues.end());
+        _hasPending = false;
+    }
+    submit();
+    if (_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _closing = true;
+            _changed.notify_all();
+        }
+        _thread.join();
+    }
+
+    // Overwrite the header in place if the final one has the same length
+    // and lines, so that it occupies the same bytes in the file.
+    std::string header;
+    const bool inPlace = !_header.empty() && !_error && !_failed &&
+        renderHeader(header) && header.size() == _header.size() &&
+        std::count(header.begin(), header.end(), '\n') ==
+        std::count(_header.begin(), _header.end(), '\n');
+    if (inPlace) {
+        if (fseek(_fp, 0, SEEK_SET) != 0 ||
+                fwrite(header.data(), 1, header.size(), _fp) != header.size())
+            _failed = true;
+    }
+    if (fclose(_fp) != 0) _failed = true;
+    _fp = NULL;
+
+    if (_error) std::rethrow_exception(_error);
+    if (_failed)
+        throw Exception("StorageWriter: ERROR- could not write to "
+                        + _fileName + ".", __FILE__, __LINE__);
+    if (!inPlace) rewriteHeader();
+}
+
+// Write the header into a string, through a temporary file since the
+// HeaderWriter writes to a FILE.
+bool StorageWriter::renderHeader(std::string& header) const
+{
+    FILE* fp = std::tmpfile();
+    if (fp == NULL) return false;
+    bool ok = _writeHeader(fp) >= 0;
+    const long length = ok ? ftell(fp) : -1;
+    ok = length >= 0 && fseek(fp, 0, SEEK_SET) == 0;
+    if (ok) {
+        header.resize(length);
+        ok = length == 0 ||
+             fread(&header[0], 1, length, fp) == (size_t)length;
+    }
+    fclose(fp);
+    return ok;
+}
+
+// Copy the file to a new one with the final header, and put it in its place,
+// when the header has changed length. The rows are copied in text mode, as
+// they were written.
+void StorageWriter::rewriteHeader()
+{
+    const std::string tempName = _fileName + ".tmp";
+    FILE* in = IO::OpenFile(_fileName, "r");
+    FILE* out = IO::OpenFile(tempName, "w");
+    bool ok = in != NULL && out != NULL && _writeHeader(out) >= 0 &&
+              fseek(in, _headerLength, SEEK_SET) == 0;
+    if (ok) {
+        std::vector<char> buffer(BufferBytes);
+        size_t n;
+        while ((n = fread(&buffer[0], 1, buffer.size(), in)) > 0)
+            if (fwrite(&buffer[0], 1, n, out) != n) { ok = false; break; }
+        if (ferror(in)) ok = false;
+    }
+    if (in) fclose(in);
+    if (out && fclose(out) != 0) ok = false;
+    if (ok) {
+        std::remove(_fileName.c_str());
+        ok = std::rename(tempName.c_str(), _fileName.c_str()) == 0;
+    }
+    if (!ok) {
+        std::remove(tempName.c_str());
+        throw Exception("StorageWriter: ERROR- could not rewrite the header "
+                        "of " + _fileName + ".", __FILE__, __LINE__);
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef OPENSIM_STORAGE_WRITER_H_
+#define OPENSIM_STORAGE_WRITER_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  StorageWriter.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Writes the rows of a storage file (.sto or .mot) to disk as they are
+ * appended, instead of all at once after a run.
+ *
+ * Rows are collected in blocks, formatted into a large buffer and written
+ * with a single fwrite() per block, either by the caller or, if requested, by
+ * a background thread. Values are formatted exactly as StateVector::print()
+ * formats them with the format of IO::GetDoubleOutputFormat() at the time the
+ * writer is constructed; for the default fixed-point formats this is done
+ * without printf, from the exact binary value of each number.
+ *
+ * The header is written when the file is opened, with the number of rows
+ * known then, and is written again with the final number of rows by close().
+ * If the final header has the length of the first, as it does when the
+ * number of rows has as many digits, close() overwrites it in place;
+ * otherwise it copies the rows to a new file after the new header. The file
+ * closed is therefore identical to one printed at once. The last row
+ * appended may be replaced until the next one is appended, as
+ * Storage::append() does for rows with the same time.
+ *
+ * Storage::setOutputFileName() streams a Storage through a StorageWriter.
+ */
+class OSIMCOMMON_API StorageWriter {
+public:
+    /** Writes a file header and returns a negative number on failure. */
+    typedef std::function<int(FILE*)> HeaderWriter;
+
+    /** Open fileName and write the header. Throws an Exception if the file
+    cannot be opened. */
+    StorageWriter(const std::string& fileName, const HeaderWriter& writeHeader,
+                  bool writeInBackground = false);
+    /** Calls close(), ignoring errors. */
+    ~StorageWriter();
+
+    const std::string& getFileName() const { return _fileName; }
+    /** The number of rows appended, counting a replaced row once. */
+    int getNumRows() const { return _numRows; }
+
+    /** Append a row of n values at the given time. */
+    void append(double time, int n, const double* values);
+    /** Replace the last row appended. */
+    void replaceLast(double time, int n, const double* values);
+
+    /** Write the remaining rows, rewrite the header and close the file.
+    Throws an Exception if writing failed. Does nothing if already closed. */
+    void close();
+
+    /** Append one row to buffer, formatted as StateVector::print() would
+    write it with the given printf format of a double. */
+    static void formatRow(std::string& buffer, const char* format,
+                          double time, int n, const double* values);
+
+private:
+    StorageWriter(const StorageWriter&);
+    StorageWriter& operator=(const StorageWriter&);
+
+    // Rows not yet written: their times, their numbers of values and the
+    // values one after the other.
+    struct Block {
+        std::vector<double> times;
+        std::vector<int> sizes;
+        std::vector<double> values;
+    };
+
+    void submit();
+    void write(const Block& block);
+    void runWriterThread();
+    bool renderHeader(std::string& header) const;
+    void rewriteHeader();
+
+    std::string _fileName;
+    HeaderWriter _writeHeader;
+    std::string _format;
+    FILE* _fp;
+    // The header as written when the file was opened, and its length in
+    // the file.
+    std::string _header;
+    long _headerLength;
+    int _numRows;
+
+    // The last row appended, held back so that it can be replaced.
+    bool _hasPending;
+    double _pendingTime;
+    std::vector<double> _pendingValues;
+
+    Block _block;
+    std::string _buffer;
+    bool _failed;
+
+    bool _writeInBackground;
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _changed;
+    std::deque<Block> _queue;
+    bool _closing;
+    std::exception_ptr _error;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_STORAGE_WRITER_H_
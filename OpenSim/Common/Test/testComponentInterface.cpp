@@ -22,6 +22,7 @@
  * -------------------------------------------------------------------------- */
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <OpenSim/Common/Component.h>
+#include <OpenSim/Common/OutputRow.h>
 
 using namespace OpenSim;
 using namespace std;
@@ -153,6 +154,9 @@ public:
         return SimTK::Vec3(t, t*t, sqrt(t));
     }
 
+    // The number of times an Output's function has been called.
+    int getNumOutputCalls() const { return m_mutableCtr; }
+
     SimTK::SpatialVec calcSpatialAcc(const SimTK::State& state) const {
         const_cast<Foo *>(this)->m_ctr++;
         m_mutableCtr++;
@@ -248,6 +252,26 @@ public:
         return spring.calcPotentialEnergyContribution(state);
     }
 
+    // Access the variables through the handles returned when they were added.
+    double getFiberLength(const SimTK::State& state) const {
+        return getStateVariableValue(state, fiberLengthSV);
+    }
+    void setFiberLength(SimTK::State& state, double length) const {
+        setStateVariableValue(state, fiberLengthSV, length);
+    }
+    double getGain(const SimTK::State& state) const {
+        return getDiscreteVariableValue(state, gainDV);
+    }
+    void setGain(SimTK::State& state, double gain) const {
+        setDiscreteVariableValue(state, gainDV, gain);
+    }
+    double getScaledLength(const SimTK::State& state) const {
+        if (!isCacheVariableValid(state, scaledLengthCV))
+            setCacheVariableValue(state, scaledLengthCV,
+                                  getGain(state)*getFiberLength(state));
+        return getCacheVariableValue(state, scaledLengthCV);
+    }
+
 protected:
     /** Component Interface */
     void extendConnect(Component& root) override{
@@ -283,17 +307,21 @@ protected:
 
         // We use these to test the Output's that are generated when we
         // add a StateVariable.
-        addStateVariable("fiberLength", SimTK::Stage::Velocity);
+        fiberLengthSV = addStateVariable("fiberLength", SimTK::Stage::Velocity);
         addStateVariable("activation", SimTK::Stage::Dynamics);
 
         // Create a hidden state variable, so we can ensure that hidden state
         // variables do not have a corresponding Output.
         bool hidden = true;
         addStateVariable("hiddenStateVar", SimTK::Stage::Dynamics, hidden);
+
+        gainDV = addDiscreteVariable("gain", SimTK::Stage::Dynamics);
+        scaledLengthCV =
+            addCacheVariable("scaledLength", 0.0, SimTK::Stage::Dynamics);
     }
 
     void computeStateVariableDerivatives(const SimTK::State& state) const override {
-        setStateVariableDerivativeValue(state, "fiberLength", 2.0);
+        setStateVariableDerivativeValue(state, fiberLengthSV, 2.0);
         setStateVariableDerivativeValue(state, "activation", 3.0 * state.getTime());
         setStateVariableDerivativeValue(state, "hiddenStateVar", 
                                           exp(-0.5 * state.getTime()));
@@ -317,6 +345,10 @@ private:
     mutable ForceIndex fix;
     ReferencePtr<TheWorld> world;
 
+    mutable StateVariableHandle fiberLengthSV;
+    mutable DiscreteVariable gainDV;
+    mutable CacheVariable<double> scaledLengthCV;
+
 }; // End of class Bar
 
 // Create 2nd level derived class to verify that Component interface
@@ -504,6 +536,24 @@ int main() {
             cout << "foo.input1 = " << foo.getInputValue<double>(s, "input1") << endl;
         }
 
+        // Variables accessed through their handles are the same as those
+        // accessed by name.
+        bar.setFiberLength(s, 0.25);
+        bar.setGain(s, 3.0);
+        ASSERT(bar.getStateVariableValue(s, "fiberLength") == 0.25);
+        ASSERT(bar.getDiscreteVariableValue(s, "gain") == 3.0);
+        system.realize(s, Stage::Dynamics);
+        ASSERT_EQUAL(0.75, bar.getScaledLength(s), 1e-15);
+        ASSERT(bar.getCacheVariableValue<double>(s, "scaledLength") == 0.75);
+        bar.setGain(s, 2.0);
+        system.realize(s, Stage::Dynamics);
+        ASSERT_EQUAL(0.5, bar.getScaledLength(s), 1e-15);
+
+        // A copy does not accept the handles of the original.
+        std::unique_ptr<Bar> barCopy(bar.clone());
+        ASSERT_THROW(OpenSim::Exception, barCopy->getFiberLength(s));
+        ASSERT_THROW(OpenSim::Exception, barCopy->getScaledLength(s));
+
         MultibodySystem system2;
         TheWorld *world2 = new TheWorld(modelFile);
         
@@ -572,6 +622,11 @@ int main() {
         ASSERT_THROW( OpenSim::Exception,
             const AbstractOutput& out = bar.getOutput("hiddenStateVar") );
 
+        // Cache Output2, which depends on Time.
+        foo.setOutputCaching("Output2", true);
+        ASSERT(foo.getOutput("Output2").isCached());
+        ASSERT(!foo.getOutput("Output1").isCached());
+
         s = system3.realizeTopology();
 
         bar.setStateVariableValue(s, "fiberLength", 1.5);
@@ -582,6 +637,51 @@ int main() {
         // realize simbody system to velocity stage
         system3.realize(s, Stage::Velocity);
 
+        // The cached Output is computed once until the time changes; the
+        // uncached one every time it is read.
+        int numCalls = foo.getNumOutputCalls();
+        foo.getOutputValue<SimTK::Vec3>(s, "Output2");
+        foo.getOutputValue<SimTK::Vec3>(s, "Output2");
+        ASSERT(foo.getNumOutputCalls() == numCalls + 1);
+        foo.getOutputValue<double>(s, "Output1");
+        foo.getOutputValue<double>(s, "Output1");
+        ASSERT(foo.getNumOutputCalls() == numCalls + 3);
+
+        s.updTime() = 0.25;
+        ASSERT_THROW(SimTK::Exception::StageTooLow,
+            foo.getOutputValue<SimTK::Vec3>(s, "Output2"));
+        system3.realize(s, Stage::Velocity);
+        ASSERT_EQUAL(Vec3(0.25, 0.0625, 0.5),
+            foo.getOutputValue<SimTK::Vec3>(s, "Output2"), Vec3(1e-15));
+        ASSERT(foo.getNumOutputCalls() == numCalls + 4);
+
+        // Gather several Outputs into one row.
+        system3.realize(s, Stage::Acceleration);
+        OutputRow row;
+        row.addOutput(foo.getOutput("Output1"), "foo_time");
+        row.addOutput(foo.getOutput("Output2"));
+        row.addOutput(foo.getOutput("Qs"));
+        row.addOutput(foo.getOutput("BodyAcc"));
+        ASSERT(row.getDependsOnStage() == Stage::Velocity);
+        row.prepare(s);
+        ASSERT(row.getNumColumns() == 1 + 3 + s.getNQ() + 6);
+        ASSERT(row.getColumnLabels().getSize() == 1 + row.getNumColumns());
+        ASSERT(row.getColumnLabels()[0] == "time");
+        ASSERT(row.getColumnLabels()[1] == "foo_time");
+        ASSERT(row.getColumnLabels()[2] == "Output2_1");
+        const Vector& values = row.gather(s);
+        ASSERT_EQUAL(0.25, values[0], 1e-15);
+        ASSERT_EQUAL(0.5, values[3], 1e-15);
+        for (int i = 0; i < s.getNQ(); ++i)
+            ASSERT_EQUAL(s.getQ()[i], values[4+i], 1e-15);
+        const SpatialVec acc =
+            foo.getOutputValue<SpatialVec>(s, "BodyAcc");
+        for (int i = 0; i < 6; ++i)
+            ASSERT_EQUAL(acc[i/3][i%3], values[4+s.getNQ()+i], 1e-15);
+
+        s.updTime() = 0.0;
+        system3.realize(s, Stage::Velocity);
+
         RungeKuttaFeldbergIntegrator integ(system3);
         integ.setAccuracy(1.0e-3);
 
@@ -21,6 +21,7 @@
  * -------------------------------------------------------------------------- */
 
 #include <fstream>
+#include <iomanip>
 #include <OpenSim/Common/Storage.h>
 #include <OpenSim/Common/MarkerData.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
@@ -28,6 +29,8 @@
 using namespace OpenSim;
 using namespace std;
 
+void testLargeTRCFile();
+
 int main() {
     // Create a storge from a std file "std_storage.sto"
     try {
@@ -81,6 +84,8 @@ int main() {
         const SimTK::Vec3& m31 = markers3[1];    
         SimTK::Vec3 diff3 = (markers3[1]-SimTK::Vec3(expectedData3));
         ASSERT(diff.norm() < 1e-7, __FILE__, __LINE__);
+
+        testLargeTRCFile();
     }
     catch(const Exception& e) {
         e.print(cerr);
@@ -89,3 +94,79 @@ int main() {
     cout << "Done" << endl;
     return 0;
 }
+
+// Write a long TRC file with Windows line endings and missing markers, which
+// is read by several threads, and check every coordinate that is read.
+void testLargeTRCFile()
+{
+    const int numFrames = 4000, numMarkers = 40;
+    const string fileName = "testMarkerData_large.trc";
+    {
+        ofstream out(fileName.c_str(), ios::binary);
+        out << "PathFileType\t4\t(X/Y/Z)\t" << fileName << "\r\n";
+        out << "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\t"
+               "OrigDataRate\tOrigDataStartFrame\tOrigNumFrames\r\n";
+        out << "200\t200\t" << numFrames << "\t" << numMarkers
+            << "\tmm\t200\t1\t" << numFrames << "\r\n";
+        out << "Frame#\tTime";
+        for (int j = 0; j < numMarkers; ++j)
+            out << "\tM" << j << "\t\t";
+        out << "\r\n\t";
+        for (int j = 1; j <= numMarkers; ++j)
+            out << "\tX" << j << "\tY" << j << "\tZ" << j;
+        out << "\r\n\r\n";
+        out << setprecision(10);
+        for (int i = 0; i < numFrames; ++i) {
+            out << i+1 << "\t" << i/200.;
+            for (int j = 0; j < numMarkers; ++j) {
+                // Marker 3 is missing in every 7th frame, and the last
+                // marker is cut off at the end of every 5th row.
+                if ((j == 3 && i % 7 == 0) || (j == numMarkers-1 && i % 5 == 0))
+                    out << "\t\t\t";
+                else
+                    out << "\t" << i + 0.001*j << "\t" << -0.5*j
+                        << "\t" << 1.25e3*(j+1);
+            }
+            out << (i % 5 == 0 ? "" : "\t") << "\r\n";
+        }
+    }
+
+    double start = SimTK::realTime();
+    MarkerData md(fileName);
+    cout << "Read " << numFrames << " frames of " << numMarkers
+         << " markers in " << 1000*(SimTK::realTime()-start) << " ms." << endl;
+
+    ASSERT(md.getNumFrames() == numFrames, __FILE__, __LINE__);
+    ASSERT(md.getNumMarkers() == numMarkers, __FILE__, __LINE__);
+    ASSERT(md.getMarkerNames()[numMarkers-1] == "M39", __FILE__, __LINE__);
+    for (int i = 0; i < numFrames; ++i) {
+        const MarkerFrame& frame = md.getFrame(i);
+        ASSERT(frame.getFrameNumber() == i+1, __FILE__, __LINE__);
+        ASSERT_EQUAL(i/200., frame.getFrameTime(), 1e-10);
+        // The frames refer to the contiguous coordinates.
+        ASSERT(&frame.getMarkers()[0] == &md.getMarkerPosition(i, 0),
+               __FILE__, __LINE__);
+        for (int j = 0; j < numMarkers; ++j) {
+            const SimTK::Vec3& m = md.getMarkerPositions()[i*numMarkers + j];
+            if ((j == 3 && i % 7 == 0) || (j == numMarkers-1 && i % 5 == 0))
+                ASSERT(m.isNaN(), __FILE__, __LINE__);
+            else
+                ASSERT_EQUAL(SimTK::Vec3(i + 0.001*j, -0.5*j, 1.25e3*(j+1)),
+                             m, SimTK::Vec3(1e-9));
+        }
+    }
+
+    // A copy has its own coordinates, and averaging keeps them contiguous.
+    MarkerData copy(md);
+    ASSERT(copy.getMarkerPositions() != md.getMarkerPositions(),
+           __FILE__, __LINE__);
+    ASSERT(&copy.getFrame(1).getMarkers()[0] == &copy.getMarkerPosition(1, 0),
+           __FILE__, __LINE__);
+    copy.averageFrames(-1.0, 0.0, 1.0);
+    ASSERT(copy.getNumFrames() == 1, __FILE__, __LINE__);
+    ASSERT(&copy.getFrame(0).getMarkers()[0] == &copy.getMarkerPosition(0, 0),
+           __FILE__, __LINE__);
+    ASSERT_EQUAL(100 + 0.001*5, copy.getMarkerPosition(0, 5)[0], 1e-9);
+    copy.convertToUnits(Units(Units::Meters));
+    ASSERT_EQUAL(1.25*6, copy.getMarkerPosition(0, 5)[2], 1e-12);
+}
@@ -21,12 +21,175 @@
  * -------------------------------------------------------------------------- */
 
 #include <fstream>
+#include <sstream>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/StorageStream.h>
+#include <OpenSim/Common/IO.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
 using namespace std;
 
+static string readFile(const string& fileName)
+{
+    ifstream in(fileName.c_str());
+    stringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+// Stream rows to a file as they are appended and check that the file is
+// byte-for-byte the one print() writes. In the foreground the storage already
+// has 1000 rows when the file is opened, so that the final header (5000 rows)
+// has the length of the first and is patched in place; in the background the
+// header changes length and the rows are copied after the final one.
+static void testStreamingOutput(bool inBackground)
+{
+    SimTK::Random::Uniform random(-1000, 1000);
+    random.setSeed(inBackground ? 1 : 0);
+    Storage st(16, "streamed");
+    Array<string> labels;
+    labels.append("time");
+    for (int j = 0; j < 40; ++j) labels.append("v" + to_string(j));
+    st.setColumnLabels(labels);
+
+    const string streamedFile = "testStorage_streamed.sto";
+    const int numRowsBefore = inBackground ? 0 : 1000;
+    SimTK::Vector y(40);
+    for (int i = 0; i < 5000; ++i) {
+        if (i == numRowsBefore)
+            st.setOutputFileName(streamedFile, inBackground);
+        for (int j = 0; j < 40; ++j)
+            y[j] = j % 4 == 0 ? random.getValue()*pow(10.0, -j/4) :
+                                random.getValue();
+        st.append(0.001*i, y);
+        // A row with the same time replaces the last one.
+        if (i % 100 == 0) {
+            y[0] = -0.0;
+            st.append(0.001*i, y);
+        }
+    }
+    ASSERT(st.closeOutputFile());
+    ASSERT(!st.closeOutputFile());
+
+    const string printedFile = "testStorage_printed.sto";
+    st.print(printedFile);
+    ASSERT(readFile(streamedFile) == readFile(printedFile));
+    ASSERT(readFile(streamedFile).find("nRows=5000\n") != string::npos);
+}
+
+// Stream every third row of a storage that keeps only its last rows, and
+// check the file, the callback and the statistics against a storage that
+// keeps all of them.
+static void testBoundedStream()
+{
+    SimTK::Random::Uniform random(-10, 10);
+    Storage st(16, "bounded"), all(16, "all");
+    Array<string> labels;
+    labels.append("time");
+    for (int j = 0; j < 5; ++j) labels.append("v" + to_string(j));
+    st.setColumnLabels(labels);
+    all.setColumnLabels(labels);
+
+    const string fileName = "testStorage_bounded.sto";
+    int numCalls = 0;
+    {
+        StorageStream stream(st);
+        stream.setFileName(fileName);
+        stream.setDecimation(3);
+        stream.setMaxRowsInMemory(50);
+        stream.setComputeStatistics(true);
+        stream.setRowCallback([&](const Storage& storage, double time, int n,
+                                  const double* values) {
+            ASSERT(&storage == &st);
+            ASSERT(n == 5);
+            ASSERT(time == all.getStateVector(3*numCalls)->getTime());
+            ASSERT(values[4] ==
+                   all.getStateVector(3*numCalls)->getData()[4]);
+            ++numCalls;
+        });
+
+        SimTK::Vector y(5);
+        for (int i = 0; i < 1000; ++i) {
+            for (int j = 0; j < 5; ++j) y[j] = random.getValue();
+            st.append(0.01*i, y);
+            all.append(0.01*i, y);
+            // A row with the same time replaces the last one.
+            if (i % 7 == 0) {
+                y[0] = 100;
+                st.append(0.01*i, y);
+                all.append(0.01*i, y);
+            }
+            stream.update();
+            ASSERT(st.getSize() <= 101);
+        }
+        stream.close();
+        ASSERT(stream.getNumRows() == 1000);
+        ASSERT(stream.getNumRowsWritten() == 334);
+        ASSERT(stream.getNumRowsRemoved() == 1000 - st.getSize());
+        ASSERT(numCalls == 334);
+
+        // The rows kept are the last ones.
+        for (int i = 0; i < st.getSize(); ++i) {
+            const StateVector& row = *st.getStateVector(i);
+            const StateVector& expected =
+                *all.getStateVector(all.getSize() - st.getSize() + i);
+            ASSERT(row.getTime() == expected.getTime());
+            ASSERT(row.getData()[0] == expected.getData()[0]);
+        }
+
+        const StorageStatistics& stats = stream.getStatistics();
+        ASSERT(stats.getNumRows() == 1000);
+        ASSERT(stats.getNumColumns() == 5);
+        ASSERT(stats.getStartTime() == 0);
+        ASSERT_EQUAL(9.99, stats.getEndTime(), 1e-12);
+        for (int j = 0; j < 5; ++j) {
+            double min = SimTK::Infinity, max = -SimTK::Infinity;
+            double sum = 0, sumSquares = 0;
+            int n = 0;
+            for (int i = 0; i < all.getSize(); ++i) {
+                double value = all.getStateVector(i)->getData()[j];
+                min = std::min(min, value);
+                max = std::max(max, value);
+                sum += value;
+                sumSquares += value*value;
+                ++n;
+            }
+            ASSERT(n == 1000);
+            ASSERT(stats.getMin(j) == min);
+            ASSERT(stats.getMax(j) == max);
+            ASSERT_EQUAL(sum/n, stats.getMean(j), 1e-12);
+            ASSERT_EQUAL(sqrt(sumSquares/n), stats.getRMS(j), 1e-12);
+        }
+        stats.print("testStorage_bounded_statistics.txt", st.getName(),
+                    st.getColumnLabels());
+        const string printed = readFile("testStorage_bounded_statistics.txt");
+        ASSERT(printed.find("nRows=4\nnColumns=6\n") != string::npos);
+        ASSERT(printed.find("\nrms\t") != string::npos);
+    }
+
+    // The file holds every third row, and its header counts them.
+    Storage streamed(fileName);
+    ASSERT(streamed.getSize() == 334);
+    for (int i = 0; i < streamed.getSize(); ++i) {
+        const StateVector& row = *streamed.getStateVector(i);
+        const StateVector& expected = *all.getStateVector(3*i);
+        ASSERT_EQUAL(expected.getTime(), row.getTime(), 1e-6);
+        ASSERT_EQUAL(expected.getData()[1], row.getData()[1], 1e-6);
+    }
+
+    // Missing values are left out of the statistics of their column.
+    StorageStatistics stats;
+    double row[] = {1, SimTK::NaN};
+    stats.add(0, 2, row);
+    row[0] = 3;
+    stats.add(1, 2, row);
+    ASSERT(stats.getNumRows() == 2);
+    ASSERT(stats.getMean(0) == 2);
+    ASSERT(stats.getMin(0) == 1 && stats.getMax(0) == 3);
+    ASSERT(SimTK::isNaN(stats.getMean(1)) && SimTK::isNaN(stats.getRMS(1)));
+}
+
 int main() {
     try {
         // Create a storge from a std file "std_storage.sto"
@@ -71,7 +234,37 @@ int main() {
         diff = st->compareColumn(st2, stdLabels[2], 0.);
         ASSERT(fabs(diff) < 1E-7);
 
+        // Binary round trip, as used by Manager checkpoints.
+        stringstream binary;
+        st->writeBinary(binary);
+        Storage st3;
+        st3.readBinary(binary);
+        ASSERT(st3.getName()==st->getName());
+        ASSERT(st3.getSize()==st->getSize());
+        ASSERT(st3.getColumnLabels().getSize()==lbls.getSize());
+        for(i=0; i<st3.getSize(); i++){
+            ASSERT(st3.getStateVector(i)->getTime()==st->getStateVector(i)->getTime());
+            ASSERT(st3.getStateVector(i)->getData()[1]==st->getStateVector(i)->getData()[1]);
+        }
+
         delete st;
+
+        // Streamed files are the same as printed ones, with the default
+        // format, other precisions and %g.
+        testStreamingOutput(false);
+        testStreamingOutput(true);
+        IO::SetPrecision(16);
+        testStreamingOutput(true);
+        IO::SetDigitsPad(-1);
+        IO::SetPrecision(3);
+        testStreamingOutput(false);
+        IO::SetGFormatForDoubleOutput(true);
+        testStreamingOutput(true);
+        IO::SetGFormatForDoubleOutput(false);
+        IO::SetDigitsPad(8);
+        IO::SetPrecision(8);
+
+        testBoundedStream();
     }
     catch (const Exception& e) {
         e.print(cerr);
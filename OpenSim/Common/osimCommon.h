@@ -46,6 +46,8 @@
 #include "ObjectGroup.h"
 #include "StorageInterface.h"
 #include "LoadOpenSimLibrary.h"
+#include "ComponentProfiler.h"
+#include "OutputRow.h"
 #include "RegisterTypes_osimCommon.h"   // to expose RegisterTypes_osimCommon
 #include "SmoothSegmentedFunctionFactory.h"
 
@@ -312,15 +312,11 @@ getRecordValues(const SimTK::State& state) const
     const PhysicalFrame& frame1 = getConnectee<PhysicalFrame>("frame1");
     const PhysicalFrame& frame2 = getConnectee<PhysicalFrame>("frame2");
 
-    const SimTK::Force::LinearBushing &simtkSpring =
-        (SimTK::Force::LinearBushing &)(_model->getForceSubsystem().getForce(_index));
-
     SimTK::Vector_<SimTK::SpatialVec> bodyForces(0);
-    SimTK::Vector_<SimTK::Vec3> particleForces(0);
     SimTK::Vector mobilityForces(0);
 
     //get the net force added to the system contributed by the bushing
-    simtkSpring.calcForceContribution(state, bodyForces, particleForces, mobilityForces);
+    calcForceContribution(state, bodyForces, mobilityForces);
     SimTK::Vec3 forces = bodyForces[frame1.getMobilizedBodyIndex()][1];
     SimTK::Vec3 torques = bodyForces[frame1.getMobilizedBodyIndex()][0];
     values.append(3, &forces[0]);
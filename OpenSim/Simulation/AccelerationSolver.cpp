@@ -0,0 +1,139 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  AccelerationSolver.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "AccelerationSolver.h"
+#include "Model/Model.h"
+
+using namespace std;
+using namespace SimTK;
+
+namespace OpenSim {
+
+AccelerationSolver::AccelerationSolver(const Model& model) :
+    Solver(model), _factored(false)
+{
+}
+
+void AccelerationSolver::factor(const State& s)
+{
+    const SimbodyMatterSubsystem& matter = getModel().getMatterSubsystem();
+    const int nu = s.getNU();
+
+    Matrix M;
+    matter.calcM(s, M);
+    _massMatrix.factor(M);
+
+    // The residual of M*udot + c - f with udot and f zero is c
+    Vector_<SpatialVec> noBodyForces(matter.getNumBodies(), SpatialVec(Vec3(0)));
+    Vector zero(nu, 0.0);
+    matter.calcResidualForceIgnoringConstraints(s, zero, noBodyForces, zero,
+                                                _velocityForces);
+
+    matter.calcG(s, _G);
+    if (_G.nrow() > 0) {
+        matter.calcBiasForAccelerationConstraints(s, _bias);
+        Matrix Gt = ~_G;
+        _massMatrix.solve(Gt, _MInvGt);
+        Matrix GMInvGt = _G*_MInvGt;
+        _constraintMatrix.factor(GMInvGt);
+    }
+    else {
+        _bias.resize(0);
+        _MInvGt.resize(nu, 0);
+    }
+    _factored = true;
+}
+
+void AccelerationSolver::calcGeneralizedForces(const State& s,
+    const Vector& mobilityForces, const Vector_<SpatialVec>& bodyForces,
+    Vector& generalizedForces) const
+{
+    getModel().getMatterSubsystem().multiplyBySystemJacobianTranspose(s,
+        bodyForces, generalizedForces);
+    if (mobilityForces.size() > 0)
+        generalizedForces += mobilityForces;
+}
+
+void AccelerationSolver::solve(const Vector& f, Vector& udot,
+                               Vector* multipliers) const
+{
+    Matrix F(f.size(), 1), U, L;
+    F(0) = f;
+    solveColumns(F, true, U, multipliers ? &L : nullptr);
+    udot = U(0);
+    if (multipliers) *multipliers = L(0);
+}
+
+void AccelerationSolver::solve(const Matrix& f, Matrix& udot,
+                               Matrix* multipliers) const
+{
+    solveColumns(f, true, udot, multipliers);
+}
+
+void AccelerationSolver::solveLinear(const Matrix& f, Matrix& udot,
+                                     Matrix* multipliers) const
+{
+    solveColumns(f, false, udot, multipliers);
+}
+
+// udot = M^-1*(f - c - ~G*lambda), where
+// (G*M^-1*~G)*lambda = G*M^-1*(f - c) + b
+void AccelerationSolver::solveColumns(const Matrix& f, bool includeBias,
+    Matrix& udot, Matrix* multipliers) const
+{
+    if (!_factored)
+        throw Exception("AccelerationSolver::solve: ERROR- factor() must be "
+                        "called before solving.", __FILE__, __LINE__);
+    if (f.nrow() != _velocityForces.size())
+        throw Exception("AccelerationSolver::solve: ERROR- expected "
+                        "generalized forces of size "
+                        + to_string(_velocityForces.size()) + ".",
+                        __FILE__, __LINE__);
+
+    const int nrhs = f.ncol();
+    if (includeBias) {
+        Matrix rhs = f;
+        for (int j = 0; j < nrhs; ++j)
+            rhs(j) -= _velocityForces;
+        _massMatrix.solve(rhs, udot);
+    }
+    else
+        _massMatrix.solve(f, udot);
+
+    const int nm = _G.nrow();
+    if (nm == 0) {
+        if (multipliers) multipliers->resize(0, nrhs);
+        return;
+    }
+
+    Matrix lambda;
+    Matrix rhs = _G*udot;
+    if (includeBias) {
+        for (int j = 0; j < nrhs; ++j)
+            rhs(j) += _bias;
+    }
+    _constraintMatrix.solve(rhs, lambda);
+    udot -= _MInvGt*lambda;
+    if (multipliers) *multipliers = lambda;
+}
+
+} // namespace
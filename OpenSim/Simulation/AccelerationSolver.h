@@ -0,0 +1,122 @@
+#ifndef OPENSIM_ACCELERATION_SOLVER_H_
+#define OPENSIM_ACCELERATION_SOLVER_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  AccelerationSolver.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "Solver.h"
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Solve for the generalized accelerations (udot) and constraint multipliers
+ * (lambda) of the model for many sets of applied forces at one position and
+ * velocity.
+ *
+ * At a given q and u, the constrained equations of motion
+ *
+ *     [M]*udot + [~G]*lambda = f - c(q,u)
+ *     [G]*udot = -b(q,u)
+ *
+ * are linear in the applied generalized forces f (c are the velocity-
+ * dependent forces and b the bias of the acceleration constraints). factor()
+ * computes and factors the mass matrix M and G*M^-1*~G once; each set of
+ * forces then costs only back-substitutions, and a batch of them is solved
+ * as one multiple right-hand side problem. This is much cheaper than
+ * realizing the System to Stage::Acceleration for each set of forces, as
+ * Static Optimization, CMC and Induced Accelerations need to do.
+ *
+ * Body forces are included by mapping them to generalized forces with
+ * calcGeneralizedForces(). Mobilities with prescribed motion (SimTK::Motion)
+ * are not supported.
+ */
+class OSIMSIMULATION_API AccelerationSolver: public Solver {
+OpenSim_DECLARE_CONCRETE_OBJECT(AccelerationSolver, Solver);
+
+//=============================================================================
+// METHODS
+//=============================================================================
+    //--------------------------------------------------------------------------
+    // CONSTRUCTION
+    //--------------------------------------------------------------------------
+public:
+    explicit AccelerationSolver(const Model& model);
+    virtual ~AccelerationSolver() {}
+
+    /** Factor the equations of motion at the positions and velocities of
+    state, which must be realized to Stage::Velocity. The enabled constraints
+    of state are the ones imposed. */
+    void factor(const SimTK::State& state);
+
+    /** Whether factor() has been called. */
+    bool isFactored() const { return _factored; }
+
+    /** The number of constraint equations, and so of multipliers. */
+    int getNumMultipliers() const { return _G.nrow(); }
+
+    /** Add the mobility forces and body forces (in Ground) together as
+    generalized forces, at the positions of state. */
+    void calcGeneralizedForces(const SimTK::State& state,
+        const SimTK::Vector& mobilityForces,
+        const SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+        SimTK::Vector& generalizedForces) const;
+
+    /** Solve for the accelerations and multipliers when the generalized
+    forces f are applied, along with the velocity-dependent forces and
+    constraint bias. This is what realizing to Stage::Acceleration computes
+    when f are all of the applied forces. */
+    void solve(const SimTK::Vector& f, SimTK::Vector& udot,
+               SimTK::Vector* multipliers = nullptr) const;
+
+    /** Solve for each column of f as in solve(const Vector&, ...). */
+    void solve(const SimTK::Matrix& f, SimTK::Matrix& udot,
+               SimTK::Matrix* multipliers = nullptr) const;
+
+    /** Solve for the accelerations and multipliers caused by each column of
+    f alone, without the velocity-dependent forces and constraint bias. These
+    are linear in f: the accelerations for a weighted sum of the columns are
+    the same weighted sum of the results, added to those of solve() with no
+    applied forces. */
+    void solveLinear(const SimTK::Matrix& f, SimTK::Matrix& udot,
+                     SimTK::Matrix* multipliers = nullptr) const;
+
+private:
+    void solveColumns(const SimTK::Matrix& f, bool includeBias,
+                      SimTK::Matrix& udot, SimTK::Matrix* multipliers) const;
+
+    bool _factored;
+    // Factorization of the mass matrix
+    SimTK::FactorLU _massMatrix;
+    // Constraint Jacobian G, M^-1*~G and factorization of G*M^-1*~G
+    SimTK::Matrix _G;
+    SimTK::Matrix _MInvGt;
+    SimTK::FactorQTZ _constraintMatrix;
+    // Velocity-dependent forces c and acceleration constraint bias b
+    SimTK::Vector _velocityForces;
+    SimTK::Vector _bias;
+//=============================================================================
+};  // END of class AccelerationSolver
+//=============================================================================
+} // namespace
+
+#endif // OPENSIM_ACCELERATION_SOLVER_H_
@@ -423,6 +423,32 @@ setControlValue(ArrayPtrs<ControlLinearNode> &aNodes,double aT,double aValue)
     }
 }
 
+//_____________________________________________________________________________
+/**
+ * Find the node at or before time aT, as ArrayPtrs::searchBinary() does for
+ * a node at aT, but without writing to _searchNode, so that the value of a
+ * control can be found from several threads at once.
+ *
+ * @return Index of the node, or -1 if aT is before the first node.
+ */
+static int findNode(const ArrayPtrs<ControlLinearNode> &aNodes,double aT)
+{
+    int lo = 0, hi = aNodes.getSize() - 1, mid = -1;
+    if(hi<0) return(-1);
+    while(lo <= hi) {
+        mid = (lo + hi) / 2;
+        if(aT < aNodes.get(mid)->getTime()) {
+            hi = mid - 1;
+        } else if(aNodes.get(mid)->getTime() < aT) {
+            lo = mid + 1;
+        } else {
+            break;
+        }
+    }
+    if(aT < aNodes.get(mid)->getTime()) mid--;
+    return(mid);
+}
+//_____________________________________________________________________________
 double ControlLinear::
 getControlValue(ArrayPtrs<ControlLinearNode> &aNodes,double aT)
 {
@@ -432,8 +458,7 @@ getControlValue(ArrayPtrs<ControlLinearNode> &aNodes,double aT)
     if(size<=0) return(SimTK::NaN);
 
     // GET NODE
-    _searchNode.setTime(aT);
-    int i = aNodes.searchBinary(_searchNode);
+    int i = findNode(aNodes,aT);
 
     // BEFORE FIRST
     double value;
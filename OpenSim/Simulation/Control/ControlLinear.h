@@ -85,10 +85,11 @@ protected:
     double &_kv;
 
 
-    /** Utility node for speeding up searches for control values in
-    getControlValue() and elsewhere.  Without this node, a control node would
+    /** Utility node for speeding up searches for control nodes in
+    getParameterList() and filter().  Without this node, a control node would
     need to be contructed, but this is too expensive.  It is better to contruct
-    a node up front, and then just alter the time. */
+    a node up front, and then just alter the time.  getControlValue() does not
+    use it, so that controls can be evaluated from several threads at once. */
     ControlLinearNode _searchNode;
 
 //=============================================================================
@@ -160,24 +160,39 @@ operator=(const ControlSetController &aController)
 void ControlSetController::computeControls(const SimTK::State& s, SimTK::Vector& controls)  const
 {
     SimTK_ASSERT( _controlSet , "ControlSetController::computeControls controlSet is NULL");
-
-    std::string actName = "";
-    int index = -1;
+    SimTK_ASSERT( _controlIndex.getSize() == getActuatorSet().getSize(),
+        "ControlSetController::computeControls controls were not found");
 
     int na = getActuatorSet().getSize();
 
     for(int i=0; i< na; ++i){
-        actName = getActuatorSet()[i].getName();
-        index = _controlSet->getIndex(actName);
-        if(index < 0){
-            actName = actName + ".excitation";
-            index = _controlSet->getIndex(actName);
+        int index = _controlIndex[i];
+        if(index >= 0){
+            addInControl(i, _controlSet->get(index).getControlValue(s.getTime()),
+                         controls);
         }
+    }
+}
 
-        if(index >= 0){
-            SimTK::Vector actControls(1, _controlSet->get(index).getControlValue(s.getTime()));
-            getActuatorSet()[i].addInControls(actControls, controls);
+void ControlSetController::extendConnectToModel(Model& model)
+{
+    Super::extendConnectToModel(model);
+    findControls();
+}
+
+void ControlSetController::findControls()
+{
+    int na = getActuatorSet().getSize();
+    _controlIndex.setSize(na);
+    for(int i=0; i< na; ++i){
+        int index = -1;
+        if(_controlSet){
+            const std::string& actName = getActuatorSet()[i].getName();
+            index = _controlSet->getIndex(actName);
+            if(index < 0)
+                index = _controlSet->getIndex(actName + ".excitation");
         }
+        _controlIndex[i] = index;
     }
 }
 
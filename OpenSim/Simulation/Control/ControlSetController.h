@@ -89,7 +89,10 @@ public:
     const ControlSet *getControlSet() {return _controlSet;} 
     ControlSet *updControlSet() {return _controlSet;}
 
-    void setControlSet(ControlSet *aControlSet) {_controlSet = aControlSet;}
+    void setControlSet(ControlSet *aControlSet) {
+        _controlSet = aControlSet;
+        findControls();
+    }
 
 
     
@@ -99,6 +102,13 @@ private:
 
     void setNull();
 
+    // Find the control in _controlSet of each actuator, by its name.
+    void findControls();
+
+    // Index in _controlSet of the control of each actuator of this
+    // controller, or -1 if the actuator has none.
+    Array<int> _controlIndex;
+
 protected:
 
     /**
@@ -116,6 +126,7 @@ protected:
 
     // for any post XML deserialization intialization
     void extendFinalizeFromProperties() override;
+    void extendConnectToModel(Model& model) override;
 
     //--------------------------------------------------------------------------
     // OPERATORS
@@ -132,6 +132,36 @@ void Controller::extendAddToSystem(SimTK::MultibodySystem& system) const
     Super::extendAddToSystem(system);
 }
 
+void Controller::extendRealizeTopology(SimTK::State& state) const
+{
+    Super::extendRealizeTopology(state);
+
+    // Actuators are assigned their slots in the model controls as they are
+    // added to the System, so resolve them here rather than when connecting.
+    _controlIndices.resize(_actuatorSet.getSize());
+    for (int i = 0; i < _actuatorSet.getSize(); ++i) {
+        const Actuator& actuator = _actuatorSet[i];
+        _controlIndices[i] = actuator.numControls() == 1 ?
+                             actuator.getControlIndex() : -1;
+    }
+}
+
+void Controller::throwControlIndexException(int actuatorIndex) const
+{
+    std::string msg = "Controller::addInControl: ";
+    if (actuatorIndex < 0 || actuatorIndex >= _actuatorSet.getSize())
+        msg += "actuator index " + std::to_string(actuatorIndex) +
+               " is out of range for controller '" + getName() + "'.";
+    else if (actuatorIndex >= (int)_controlIndices.size())
+        msg += "controller '" + getName() + "' does not know where the "
+               "controls of its actuators are until the System's topology "
+               "is realized.";
+    else
+        msg += "actuator '" + _actuatorSet[actuatorIndex].getName() +
+               "' does not have exactly one control.";
+    throw Exception(msg, __FILE__, __LINE__);
+}
+
 // makes a request for which actuators a controller will control
 void Controller::setActuators(const Set<Actuator>& actuators)
 {
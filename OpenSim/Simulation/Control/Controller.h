@@ -111,6 +111,21 @@ public:
 
 protected:
 
+    /** Add control to the control of the actuator at actuatorIndex in
+        getActuatorSet(), which must have exactly one control, directly in the
+        model controls. Unlike Actuator::addInControls() this does not need a
+        Vector of the actuator's controls, so computeControls() can use it
+        without allocating. Throws an Exception if the actuator does not have
+        exactly one control or the System's topology has not been realized. */
+    void addInControl(int actuatorIndex, double control,
+                      SimTK::Vector& controls) const {
+        if (actuatorIndex < 0 ||
+                actuatorIndex >= (int)_controlIndices.size() ||
+                _controlIndices[actuatorIndex] < 0)
+            throwControlIndexException(actuatorIndex);
+        controls[_controlIndices[actuatorIndex]] += control;
+    }
+
     /** Model component interface that permits the controller to be "wired" up
        to its actuators. Subclasses can override to perform additional setup. */
     void extendConnectToModel(Model& model) override;  
@@ -120,6 +135,10 @@ protected:
         measures, etc... required by the controller. */
     void extendAddToSystem(SimTK::MultibodySystem& system) const override;
 
+    /** Look up where the controls of the actuators are in the model controls,
+        which is known once all actuators have been added to the System. */
+    void extendRealizeTopology(SimTK::State& state) const override;
+
     /** Only a Controller can set its number of controls based on its actuators */
     void setNumControls(int numControls) {_numControls = numControls; }
 
@@ -130,6 +149,13 @@ private:
     // the (sub)set of Model actuators that this controller controls */ 
     Set<Actuator> _actuatorSet;
 
+    // index in the model controls of the control of each actuator in
+    // _actuatorSet, or -1 if the actuator does not have exactly one control
+    mutable SimTK::Array_<int> _controlIndices;
+
+    // explain why addInControl() cannot add to the actuator's control
+    void throwControlIndexException(int actuatorIndex) const;
+
     // construct and initialize properties
     void constructProperties();
 
@@ -160,12 +160,11 @@ void PrescribedController::extendConnectToModel(Model& model)
 // compute the control value for an actuator
 void PrescribedController::computeControls(const SimTK::State& s, SimTK::Vector& controls) const
 {
-    SimTK::Vector actControls(1, 0.0);
-    SimTK::Vector time(1, s.getTime());
+    const double time = s.getTime();
 
+    const FunctionSet& controlFuncs = get_ControlFunctions();
     for(int i=0; i<getActuatorSet().getSize(); i++){
-        actControls[0] = get_ControlFunctions()[i].calcValue(time);
-        getActuatorSet()[i].addInControls(actControls, controls);
+        addInControl(i, controlFuncs[i].evaluate(0, time), controls);
     }  
 }
 
@@ -109,15 +109,15 @@ void ToyReflexController::computeControls(const State& s, Vector &controls) cons
     double control = 0;
 
     for(int i=0; i<actuators.getSize(); ++i){
-        const Muscle *musc = dynamic_cast<const Muscle*>(&actuators[i]);
-        speed = musc->getLengtheningSpeed(s);
+        // extendConnectToModel() removed any actuators that are not muscles
+        const Muscle& musc = static_cast<const Muscle&>(actuators[i]);
+        speed = musc.getLengtheningSpeed(s);
         // unnormalize muscle's maximum contraction velocity (fib_lengths/sec) 
-        max_speed = musc->getOptimalFiberLength()*musc->getMaxContractionVelocity();
+        max_speed = musc.getOptimalFiberLength()*musc.getMaxContractionVelocity();
         control = 0.5*get_gain()*(fabs(speed)+speed)/max_speed;
 
-        SimTK::Vector actControls(1,control);
         // add reflex controls to whatever controls are already in place.
-        musc->addInControls(actControls, controls);
+        addInControl(i, control, controls);
     }
 }
 
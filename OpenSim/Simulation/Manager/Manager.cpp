@@ -29,10 +29,17 @@
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/AnalysisSet.h>
 #include <OpenSim/Simulation/Control/ControlSet.h>
+#include <OpenSim/Simulation/Control/ControlLinear.h>
 #include <OpenSim/Simulation/Model/ForceSet.h>
 #include <OpenSim/Simulation/Control/Controller.h>
 #include <OpenSim/Simulation/Model/ControllerSet.h>
+#include <OpenSim/Simulation/Model/CoordinateSet.h>
+#include <OpenSim/Simulation/Model/ConstraintSet.h>
 #include <OpenSim/Common/Array.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
 
 
 
@@ -41,6 +48,164 @@ using namespace OpenSim;
 using namespace std;
 
 #define ASSERT(cond) {if (!(cond)) throw(exception());}
+
+namespace {
+    // Identifies (and versions) the binary checkpoint format.
+    const char CheckpointTag[8] = {'O','S','I','M','C','K','P','2'};
+
+    template <class T>
+    void writeValue(std::ostream& out, const T& value)
+    {   out.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    template <class T>
+    T readValue(std::istream& in)
+    {
+        T value;
+        if(!in.read(reinterpret_cast<char*>(&value), sizeof(T)))
+            throw OpenSim::Exception("Manager: ERROR- checkpoint is truncated.",
+                                     __FILE__, __LINE__);
+        return value;
+    }
+
+    void writeString(std::ostream& out, const std::string& str)
+    {
+        writeValue<int>(out, (int)str.size());
+        out.write(str.data(), str.size());
+    }
+
+    std::string readString(std::istream& in)
+    {
+        std::string str(readValue<int>(in), '\0');
+        if(!str.empty() && !in.read(&str[0], str.size()))
+            throw OpenSim::Exception("Manager: ERROR- checkpoint is truncated.",
+                                     __FILE__, __LINE__);
+        return str;
+    }
+
+    void writeNodes(std::ostream& out,
+                    const OpenSim::ArrayPtrs<OpenSim::ControlLinearNode>& nodes)
+    {
+        writeValue<int>(out, nodes.getSize());
+        for(int i=0; i<nodes.getSize(); ++i) {
+            writeValue<double>(out, nodes.get(i)->getTime());
+            writeValue<double>(out, nodes.get(i)->getValue());
+        }
+    }
+
+    void readNodes(std::istream& in,
+                   OpenSim::ArrayPtrs<OpenSim::ControlLinearNode>& nodes)
+    {
+        nodes.setSize(0);
+        int n = readValue<int>(in);
+        for(int i=0; i<n; ++i) {
+            double t = readValue<double>(in);
+            double value = readValue<double>(in);
+            nodes.append(new OpenSim::ControlLinearNode(t, value));
+        }
+    }
+
+    // The model and its components, in the order of the component tree.
+    std::vector<const OpenSim::Component*>
+    getComponents(const OpenSim::Model& model)
+    {
+        std::vector<const OpenSim::Component*> components(1, &model);
+        for(const OpenSim::Component& component : model.getComponentList())
+            components.push_back(&component);
+        return components;
+    }
+
+    // Write the discrete variables and modeling options of the components,
+    // and the flags Simbody keeps in the state for the forces, constraints
+    // and coordinates: disabled, locked and prescribed.
+    void writeDiscreteState(std::ostream& out, const OpenSim::Model& model,
+                            const SimTK::State& s)
+    {
+        std::vector<const OpenSim::Component*> components =
+            getComponents(model);
+        writeValue<int>(out, (int)components.size());
+        for(size_t i=0; i<components.size(); ++i) {
+            const OpenSim::Component& component = *components[i];
+            writeString(out, component.getName());
+            OpenSim::Array<std::string> names =
+                component.getDiscreteVariableNames();
+            writeValue<int>(out, names.getSize());
+            for(int j=0; j<names.getSize(); ++j) {
+                writeString(out, names[j]);
+                writeValue<double>(out,
+                    component.getDiscreteVariableValue(s, names[j]));
+            }
+            names = component.getModelingOptionNames();
+            writeValue<int>(out, names.getSize());
+            for(int j=0; j<names.getSize(); ++j) {
+                writeString(out, names[j]);
+                writeValue<int>(out, component.getModelingOption(s, names[j]));
+            }
+        }
+
+        const OpenSim::ForceSet& forces = model.getForceSet();
+        writeValue<int>(out, forces.getSize());
+        for(int i=0; i<forces.getSize(); ++i)
+            writeValue<int>(out, forces.get(i).isDisabled(s));
+        const OpenSim::ConstraintSet& constraints = model.getConstraintSet();
+        writeValue<int>(out, constraints.getSize());
+        for(int i=0; i<constraints.getSize(); ++i)
+            writeValue<int>(out, constraints.get(i).isDisabled(s));
+        const OpenSim::CoordinateSet& coordinates = model.getCoordinateSet();
+        writeValue<int>(out, coordinates.getSize());
+        for(int i=0; i<coordinates.getSize(); ++i) {
+            writeValue<int>(out, coordinates.get(i).getLocked(s));
+            writeValue<int>(out, coordinates.get(i).isPrescribed(s));
+        }
+    }
+
+    void readDiscreteState(std::istream& in, OpenSim::Model& model,
+                           SimTK::State& s, const std::string& fileName)
+    {
+        const OpenSim::Exception mismatch("Manager.resumeFromCheckpoint: "
+            "ERROR- " + fileName + " does not match the model's discrete "
+            "variables.", __FILE__, __LINE__);
+
+        std::vector<const OpenSim::Component*> components =
+            getComponents(model);
+        if(readValue<int>(in) != (int)components.size()) throw mismatch;
+        for(size_t i=0; i<components.size(); ++i) {
+            const OpenSim::Component& component = *components[i];
+            if(readString(in) != component.getName()) throw mismatch;
+            int n = readValue<int>(in);
+            for(int j=0; j<n; ++j) {
+                std::string name = readString(in);
+                component.setDiscreteVariableValue(s, name,
+                                                   readValue<double>(in));
+            }
+            n = readValue<int>(in);
+            for(int j=0; j<n; ++j) {
+                std::string name = readString(in);
+                component.setModelingOption(s, name, readValue<int>(in));
+            }
+        }
+
+        const OpenSim::ForceSet& forces = model.getForceSet();
+        if(readValue<int>(in) != forces.getSize()) throw mismatch;
+        for(int i=0; i<forces.getSize(); ++i)
+            forces.get(i).setDisabled(s, readValue<int>(in) != 0);
+        OpenSim::ConstraintSet& constraints = model.updConstraintSet();
+        if(readValue<int>(in) != constraints.getSize()) throw mismatch;
+        for(int i=0; i<constraints.getSize(); ++i)
+            constraints.get(i).setDisabled(s, readValue<int>(in) != 0);
+        // A coordinate is locked at its value in the state, so the state
+        // must be restored first.
+        const OpenSim::CoordinateSet& coordinates = model.getCoordinateSet();
+        if(readValue<int>(in) != coordinates.getSize()) throw mismatch;
+        for(int i=0; i<coordinates.getSize(); ++i) {
+            bool locked = readValue<int>(in) != 0;
+            bool prescribed = readValue<int>(in) != 0;
+            const OpenSim::Coordinate& coordinate = coordinates.get(i);
+            if(!prescribed) coordinate.setIsPrescribed(s, false);
+            coordinate.setLocked(s, locked);
+            if(prescribed) coordinate.setIsPrescribed(s, true);
+        }
+    }
+}
 //=============================================================================
 // STATICS
 //=============================================================================
@@ -138,6 +303,13 @@ setNull()
     _tArray.setSize(0);
     _system = 0;
     _dtArray.setSize(0);
+    _checkpointFileName = "";
+    _checkpointInterval = -1.0;
+    _lastCheckpointTime = 0.0;
+    _checkpointControlSet = NULL;
+    _pendingCheckpoint = "";
+    _resumeStep = 0;
+    _resumeDT = 0.0;
 }
 //_____________________________________________________________________________
 /**
@@ -690,13 +862,14 @@ integrate( SimTK::State& s, double dtFirst )
 {
     
 
-    int step = 0;
+    int step = _pendingCheckpoint.empty() ? 0 : _resumeStep;
 
     s.setTime( _ti );
 
     // INTEGRATE
-    return(doIntegration(s, step, dtFirst));
+    bool status = doIntegration(s, step, dtFirst);
 
+    return(status);
 }
 
 bool Manager::doIntegration(SimTK::State& s, int step, double dtFirst ) {
@@ -705,6 +878,11 @@ bool Manager::doIntegration(SimTK::State& s, int step, double dtFirst ) {
     // Halts must arrive during an integration.
     clearHalt();
 
+    // A checkpoint read by resumeFromCheckpoint() already holds the results
+    // up to and including the initial time.
+    bool resuming = !_pendingCheckpoint.empty();
+    if(resuming && _resumeDT>0.0) dtFirst = _resumeDT;
+
     double dt,dtPrev,tReal;
     double time =_ti;
     dt=dtFirst;
@@ -754,6 +932,7 @@ bool Manager::doIntegration(SimTK::State& s, int step, double dtFirst ) {
         dt = getFixedStepSize(getTimeArrayStep(_ti));
     } else {
         _integ->setReturnEveryInternalStep(true); 
+        if(resuming) _integ->setInitialStepSize(dt);
     }
 
     if( s.getTime()+dt >= _tf ) dt = _tf - s.getTime();
@@ -765,7 +944,38 @@ bool Manager::doIntegration(SimTK::State& s, int step, double dtFirst ) {
         sys.realize(s, SimTK::Stage::Velocity); // this is multibody system 
     initialize(s, dt);  
 
-    if( fixedStep){
+    if(resuming) {
+        std::istringstream in(_pendingCheckpoint);
+        _pendingCheckpoint = "";
+        if(_writeToStorage && _performAnalyses) {
+            if(readValue<int>(in)) getStateStorage().readBinary(in);
+            if(readValue<int>(in)) {
+                Storage controls;
+                controls.readBinary(in);
+                Storage* controlStore = _controllerSet ?
+                    _controllerSet->updControlStorage() : NULL;
+                if(controlStore) *controlStore = controls;
+            }
+            AnalysisSet& analysisSet = _model->updAnalysisSet();
+            int na = readValue<int>(in);
+            for(int i=0; i<na; ++i) {
+                std::string name = readString(in);
+                int ns = readValue<int>(in);
+                int index = analysisSet.getIndex(name);
+                for(int j=0; j<ns; ++j) {
+                    Storage stored;
+                    stored.readBinary(in);
+                    if(index<0) continue;
+                    ArrayPtrs<Storage>& list =
+                        analysisSet.get(index).getStorageList();
+                    if(j<list.getSize()) *list.get(j) = stored;
+                }
+            }
+        }
+    }
+    _lastCheckpointTime = SimTK::realTime();
+
+    if( fixedStep && !resuming ){
         s.updTime() = time;
         sys.realize(s, SimTK::Stage::Acceleration);
 
@@ -811,6 +1021,12 @@ bool Manager::doIntegration(SimTK::State& s, int step, double dtFirst ) {
                     _controllerSet->storeControls(s, step);
             }
             step++;
+
+            if(_checkpointInterval>0.0 && _system==NULL &&
+               SimTK::realTime()-_lastCheckpointTime >= _checkpointInterval) {
+                writeCheckpoint(s, step);
+                _lastCheckpointTime = SimTK::realTime();
+            }
         }
         else
             halt();
@@ -874,6 +1090,7 @@ void Manager::initialize(SimTK::State& s, double dt )
 
         // ANALYSES 
         AnalysisSet& analysisSet = _model->updAnalysisSet();
+        analysisSet.setStreamBaseName(getSessionName());
         analysisSet.begin(s);
     }
 
@@ -895,6 +1112,195 @@ void Manager::finalize(SimTK::State& s )
 
     return;
 }
+//=============================================================================
+// CHECKPOINTING
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Set the name of the file to which checkpoints are written.
+ */
+void Manager::setCheckpointFileName(const std::string& aFileName)
+{
+    _checkpointFileName = aFileName;
+}
+//_____________________________________________________________________________
+/**
+ * Get the name of the file to which checkpoints are written.
+ */
+const std::string& Manager::getCheckpointFileName() const
+{
+    return _checkpointFileName;
+}
+//_____________________________________________________________________________
+/**
+ * Set the minimum wall-clock time in seconds between checkpoints.
+ */
+void Manager::setCheckpointInterval(double aSeconds)
+{
+    _checkpointInterval = aSeconds;
+}
+//_____________________________________________________________________________
+/**
+ * Get the minimum wall-clock time in seconds between checkpoints.
+ */
+double Manager::getCheckpointInterval() const
+{
+    return _checkpointInterval;
+}
+//_____________________________________________________________________________
+/**
+ * Set the control set whose nodes are included in checkpoints.
+ */
+void Manager::setCheckpointControlSet(ControlSet* aControlSet)
+{
+    _checkpointControlSet = aControlSet;
+}
+//_____________________________________________________________________________
+/**
+ * Write a checkpoint. The file is first written under a temporary name and
+ * then renamed, so an interruption while writing leaves the previous
+ * checkpoint intact.
+ *
+ * @param s State reached by the integration.
+ * @param step Number of the next integration step.
+ */
+void Manager::writeCheckpoint(const SimTK::State& s, int step) const
+{
+    if(_checkpointFileName.empty()) {
+        throw Exception("Manager.writeCheckpoint: ERROR- no checkpoint file "
+                        "name was set.", __FILE__, __LINE__);
+    }
+    std::string tmpFileName = _checkpointFileName + ".tmp";
+    std::ofstream out(tmpFileName.c_str(), std::ios::binary);
+    if(!out) {
+        throw Exception("Manager.writeCheckpoint: ERROR- could not open "
+                        + tmpFileName + ".", __FILE__, __LINE__);
+    }
+
+    // INTEGRATION
+    out.write(CheckpointTag, sizeof(CheckpointTag));
+    writeValue<double>(out, s.getTime());
+    writeValue<int>(out, step);
+    writeValue<double>(out, _integ->getPredictedNextStepSize());
+    const SimTK::Vector& y = s.getY();
+    writeValue<int>(out, y.size());
+    for(int i=0; i<y.size(); ++i) writeValue<double>(out, y[i]);
+    writeDiscreteState(out, *_model, s);
+
+    // CONTROLS
+    int nControls = 0;
+    if(_checkpointControlSet) {
+        for(int i=0; i<_checkpointControlSet->getSize(); ++i)
+            if(dynamic_cast<ControlLinear*>(&_checkpointControlSet->get(i)))
+                ++nControls;
+    }
+    writeValue<int>(out, nControls);
+    for(int i=0; nControls>0 && i<_checkpointControlSet->getSize(); ++i) {
+        ControlLinear* control =
+            dynamic_cast<ControlLinear*>(&_checkpointControlSet->get(i));
+        if(!control) continue;
+        writeString(out, control->getName());
+        writeNodes(out, control->getControlValues());
+        writeNodes(out, control->getControlMinValues());
+        writeNodes(out, control->getControlMaxValues());
+    }
+
+    // STORED RESULTS
+    bool storeResults = _writeToStorage && _performAnalyses;
+    writeValue<int>(out, storeResults && hasStateStorage());
+    if(storeResults && hasStateStorage()) getStateStorage().writeBinary(out);
+    const Storage* controlStore =
+        _controllerSet ? _controllerSet->getControlStorage() : NULL;
+    writeValue<int>(out, storeResults && controlStore!=NULL);
+    if(storeResults && controlStore) controlStore->writeBinary(out);
+
+    AnalysisSet& analysisSet = _model->updAnalysisSet();
+    writeValue<int>(out, storeResults ? analysisSet.getSize() : 0);
+    for(int i=0; storeResults && i<analysisSet.getSize(); ++i) {
+        ArrayPtrs<Storage>& list = analysisSet.get(i).getStorageList();
+        writeString(out, analysisSet.get(i).getName());
+        writeValue<int>(out, list.getSize());
+        for(int j=0; j<list.getSize(); ++j) list.get(j)->writeBinary(out);
+    }
+
+    out.close();
+    if(!out) {
+        throw Exception("Manager.writeCheckpoint: ERROR- failed writing "
+                        + tmpFileName + ".", __FILE__, __LINE__);
+    }
+    std::remove(_checkpointFileName.c_str());
+    if(std::rename(tmpFileName.c_str(), _checkpointFileName.c_str()) != 0) {
+        throw Exception("Manager.writeCheckpoint: ERROR- could not rename "
+                        + tmpFileName + ".", __FILE__, __LINE__);
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Restore an integration from the checkpoint file.
+ *
+ * @param s State to be set to the checkpointed state.
+ * @return false if the checkpoint file does not exist.
+ */
+bool Manager::resumeFromCheckpoint(SimTK::State& s)
+{
+    std::ifstream file(_checkpointFileName.c_str(), std::ios::binary);
+    if(!file) return false;
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    std::istringstream in(contents.str());
+
+    char tag[sizeof(CheckpointTag)];
+    if(!in.read(tag, sizeof(tag)) ||
+       !std::equal(tag, tag+sizeof(tag), CheckpointTag)) {
+        throw Exception("Manager.resumeFromCheckpoint: ERROR- "
+            + _checkpointFileName + " is not a checkpoint file.",
+            __FILE__, __LINE__);
+    }
+
+    // INTEGRATION
+    double time = readValue<double>(in);
+    int step = readValue<int>(in);
+    double dt = readValue<double>(in);
+    int ny = readValue<int>(in);
+    if(ny != s.getNY()) {
+        throw Exception("Manager.resumeFromCheckpoint: ERROR- "
+            + _checkpointFileName + " does not match the model's states.",
+            __FILE__, __LINE__);
+    }
+    SimTK::Vector y(ny);
+    for(int i=0; i<ny; ++i) y[i] = readValue<double>(in);
+    s.updTime() = time;
+    s.updY() = y;
+    readDiscreteState(in, *_model, s, _checkpointFileName);
+
+    // CONTROLS
+    int nControls = readValue<int>(in);
+    for(int i=0; i<nControls; ++i) {
+        std::string name = readString(in);
+        ControlLinear* control = NULL;
+        if(_checkpointControlSet) {
+            int index = _checkpointControlSet->getIndex(name);
+            if(index>=0) control =
+                dynamic_cast<ControlLinear*>(&_checkpointControlSet->get(index));
+        }
+        ControlLinear ignored;
+        if(!control) control = &ignored;
+        readNodes(in, control->getControlValues());
+        readNodes(in, control->getControlMinValues());
+        readNodes(in, control->getControlMaxValues());
+    }
+
+    _ti = time;
+    _resumeStep = step;
+    _resumeDT = dt;
+    // The stored results are restored at the start of the integration.
+    _pendingCheckpoint = contents.str().substr((size_t)in.tellg());
+
+    cout << "Manager: resuming " << getSessionName() << " from checkpoint "
+         << _checkpointFileName << " at time " << time << "." << endl;
+    return true;
+}
+
 //=============================================================================
 // INTERRUPT
 //=============================================================================
@@ -39,6 +39,7 @@ namespace OpenSim {
 class Model;
 class Storage;
 class ControllerSet;
+class ControlSet;
 
 //=============================================================================
 //=============================================================================
@@ -112,6 +113,22 @@ private:
     /** system of equations to be integrated */
     const SimTK::System* _system;
 
+    /** Name of the file to which checkpoints are written. */
+    std::string _checkpointFileName;
+    /** Minimum wall-clock time in seconds between checkpoints. Checkpointing
+    is disabled if this is not positive. */
+    double _checkpointInterval;
+    /** Wall-clock time at which the last checkpoint was written. */
+    double _lastCheckpointTime;
+    /** Control set (e.g., the one built by CMC) included in checkpoints. */
+    ControlSet* _checkpointControlSet;
+    /** Stored results read from a checkpoint; restored once the analyses
+    have been initialized at the start of the integration. */
+    std::string _pendingCheckpoint;
+    /** Step number and step size at which to resume from a checkpoint. */
+    int _resumeStep;
+    double _resumeDT;
+
 
 //=============================================================================
 // METHODS
@@ -186,6 +203,41 @@ public:
     void finalize( SimTK::State& s);
     double getFixedStepSize(int tArrayStep) const;
 
+    //--------------------------------------------------------------------------
+    // CHECKPOINTING
+    //--------------------------------------------------------------------------
+    /** Set the file to which integration checkpoints are written. A checkpoint
+    is a compact binary file containing the time, step number, predicted step
+    size and continuous state (Y) of the integration, the discrete variables
+    and modeling options of the model's components, which forces and
+    constraints are disabled and which coordinates are locked or prescribed,
+    the nodes of the checkpoint control set, and the rows stored so far in the
+    state storage, the control storage and the storages of the model's
+    analyses.
+
+    Not saved are the integrator's error and step-size history, other
+    internal state of controllers (e.g., the optimizer's starting guess in
+    CMC) and the rows of analyses that do not register their storages. A
+    resumed integration therefore matches an uninterrupted one to within
+    the integrator's (and CMC's optimizer's) tolerance, not bit for bit. */
+    void setCheckpointFileName(const std::string& aFileName);
+    const std::string& getCheckpointFileName() const;
+    /** Write a checkpoint after an integration step whenever at least
+    aSeconds of wall-clock time have passed since the last one, which bounds
+    the overhead. A value <= 0 (the default) disables checkpointing. */
+    void setCheckpointInterval(double aSeconds);
+    double getCheckpointInterval() const;
+    /** Include the nodes of this ControlSet in checkpoints. This is needed
+    for controllers that build their controls as they go (e.g., CMC). */
+    void setCheckpointControlSet(ControlSet* aControlSet);
+    /** Write a checkpoint for the given state now. */
+    void writeCheckpoint(const SimTK::State& s, int step) const;
+    /** Restore the state, the initial time and the checkpoint control set
+    from the checkpoint file. The stored results are restored when the
+    next integrate() starts, which then continues from the checkpoint with the
+    same step size. Returns false if there is no checkpoint file. */
+    bool resumeFromCheckpoint(SimTK::State& s);
+
     // STATE STORAGE
     bool hasStateStorage() const;
     void setStateStorage(Storage& aStorage);
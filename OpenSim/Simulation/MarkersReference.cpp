@@ -23,6 +23,7 @@
 
 #include "MarkersReference.h"
 #include <OpenSim/Common/Units.h>
+#include <algorithm>
 
 using namespace std;
 using namespace SimTK;
@@ -40,7 +41,10 @@ MarkersReference::MarkersReference() : Reference_<SimTK::Vec3>(),
         _markerWeightSetProp(PropertyObj("", Set<MarkerWeight>())),
         _markerWeightSet((Set<MarkerWeight>&)_markerWeightSetProp.getValueObj()),
         _defaultWeight(_defaultWeightProp.getValueDbl()),
-        _markerData(nullptr)
+        _markerData(nullptr),
+        _uniformlySampled(false),
+        _samplingInterval(0),
+        _interpolate(false)
 {
     setAuthors("Ajay Seth");
 }
@@ -50,7 +54,10 @@ MarkersReference::MarkersReference(const std::string markerFile, Units modelUnit
         _markerWeightSetProp(PropertyObj("", Set<MarkerWeight>())),
         _markerWeightSet((Set<MarkerWeight>&)_markerWeightSetProp.getValueObj()),
         _defaultWeight(_defaultWeightProp.getValueDbl()),
-        _markerData(nullptr)
+        _markerData(nullptr),
+        _uniformlySampled(false),
+        _samplingInterval(0),
+        _interpolate(false)
 {
     setAuthors("Ajay Seth");
     loadMarkersFile(markerFile, modelUnits);
@@ -66,7 +73,10 @@ MarkersReference::MarkersReference(MarkerData& aMarkerData, const Set<MarkerWeig
         _markerWeightSetProp(PropertyObj("", Set<MarkerWeight>())),
         _markerWeightSet((Set<MarkerWeight>&)_markerWeightSetProp.getValueObj()),
         _defaultWeight(_defaultWeightProp.getValueDbl()),
-        _markerData(nullptr)
+        _markerData(nullptr),
+        _uniformlySampled(false),
+        _samplingInterval(0),
+        _interpolate(false)
 {
     if (aMarkerWeightSet!=nullptr) _markerWeightSet= *aMarkerWeightSet;
     populateFromMarkerData(aMarkerData);
@@ -112,6 +122,57 @@ void MarkersReference::populateFromMarkerData(MarkerData& aMarkerData)
 
     if(_markerNames.size() != _weights.size())
         throw Exception("MarkersReference: Mismatch between the number of marker names and weights. Verify that marker names are unique.");
+
+    // Keep the frame times together for lookups, and check whether they are
+    // evenly spaced, as they are for most motion capture data.
+    int nf = aMarkerData.getNumFrames();
+    _frameTimes.resize(nf);
+    for(int i=0; i<nf; i++)
+        _frameTimes[i] = aMarkerData.getFrame(i).getFrameTime();
+
+    _uniformlySampled = false;
+    _samplingInterval = 0;
+    if(nf > 1){
+        _samplingInterval = (_frameTimes[nf-1]-_frameTimes[0])/(nf-1);
+        _uniformlySampled = _samplingInterval > 0;
+        for(int i=1; _uniformlySampled && i<nf; i++){
+            double expected = _frameTimes[0] + i*_samplingInterval;
+            _uniformlySampled = abs(_frameTimes[i]-expected) < 1e-3*_samplingInterval;
+        }
+    }
+}
+
+void MarkersReference::findFrames(double time, int& before, int& after, double& fraction) const
+{
+    int nf = (int)_frameTimes.size();
+    if(nf == 0)
+        throw Exception("MarkersReference: No index corresponding to time of frame.");
+
+    fraction = 0;
+    if(time <= _frameTimes[0]){
+        before = after = 0;
+        return;
+    }
+    if(time >= _frameTimes[nf-1]){
+        before = after = nf-1;
+        return;
+    }
+
+    if(_uniformlySampled){
+        before = (int)((time-_frameTimes[0])/_samplingInterval);
+        before = std::max(0, std::min(before, nf-2));
+        // The frame times are only nearly uniform, so step to the right frame.
+        while(before > 0 && _frameTimes[before] > time)
+            --before;
+        while(before < nf-2 && _frameTimes[before+1] <= time)
+            ++before;
+    }
+    else{
+        before = (int)(std::upper_bound(_frameTimes.begin(), _frameTimes.end(), time)
+                       - _frameTimes.begin()) - 1;
+    }
+    after = before+1;
+    fraction = (time-_frameTimes[before])/(_frameTimes[after]-_frameTimes[before]);
 }
 
 SimTK::Vec2 MarkersReference::getValidTimeRange() const
@@ -142,18 +203,34 @@ const SimTK::Array_<std::string>& MarkersReference::getNames() const
 /** get the values of the MarkersReference */
 void  MarkersReference::getValues(const SimTK::State &s, SimTK::Array_<Vec3> &values) const
 {
-    double time =  s.getTime();
-
     int before=0, after=0;
-    // get index for time 
-    _markerData->findFrameRange(time, time, before, after);
-    if(before > after || after < 0)
-        throw Exception("MarkersReference: No index corresponding to time of frame.");
-    else if(after-before > 0){
-        before = abs(_markerData->getFrame(before).getFrameTime()-time) < abs(_markerData->getFrame(after).getFrameTime()-time) ? before : after;
+    double fraction = 0;
+    findFrames(s.getTime(), before, after, fraction);
+
+    // Read the frames straight from the contiguous coordinates of MarkerData.
+    // values keeps its storage from one call to the next.
+    const int nm = _markerData->getNumMarkers();
+    const Vec3* markersBefore = _markerData->getMarkerPositions() + before*nm;
+    const Vec3* markersAfter = _markerData->getMarkerPositions() + after*nm;
+    const double time = s.getTime();
+    const Vec3* nearest = abs(_frameTimes[before]-time) < abs(_frameTimes[after]-time) ?
+                          markersBefore : markersAfter;
+    values.resize(nm);
+
+    if(!_interpolate || fraction == 0){
+        for(int i=0; i<nm; i++)
+            values[i] = nearest[i];
+        return;
     }
 
-    values = _markerData->getFrame(before).getMarkers();
+    for(int i=0; i<nm; i++){
+        const Vec3& a = markersBefore[i];
+        const Vec3& b = markersAfter[i];
+        if(a.isNaN() || b.isNaN())
+            values[i] = nearest[i];
+        else
+            values[i] = a + fraction*(b-a);
+    }
 }
 
 /** get the speed value of the MarkersReference */
@@ -171,7 +248,7 @@ void MarkersReference::getAccelerationValues(const SimTK::State &s, SimTK::Array
 /** get the weights of the Markers */
 void  MarkersReference::getWeights(const SimTK::State &s, SimTK::Array_<double> &weights) const
 {
-    weights = _weights;
+    weights.assign(_weights.begin(), _weights.end());
 }
 
 void MarkersReference::setMarkerWeightSet(Set<MarkerWeight> &markerWeights)
@@ -113,6 +113,13 @@ private:
     SimTK::Array_<std::string> _markerNames;
     // corresponding list of weights guaranteed to be in the same order as names above
     SimTK::Array_<double> _weights;
+    // times of the frames in the marker data, and whether they are evenly
+    // spaced so that the frame for a time can be computed rather than searched
+    SimTK::Array_<double> _frameTimes;
+    bool _uniformlySampled;
+    double _samplingInterval;
+    // interpolate between frames rather than take the nearest one
+    bool _interpolate;
 
 //=============================================================================
 // METHODS
@@ -167,6 +174,12 @@ public:
     Set<MarkerWeight> &updMarkerWeightSet() {return _markerWeightSet; }
     void setMarkerWeightSet(Set<MarkerWeight> &markerWeights);
     void setDefaultWeight(double weight) {_defaultWeight = weight; }
+    /** Linearly interpolate the marker positions between the two frames
+        around the time of the State passed to getValues(). By default the
+        positions in the nearest frame are returned. A marker that is missing
+        from either frame takes its position in the nearest frame. */
+    void setInterpolateFrames(bool interpolate) {_interpolate = interpolate; }
+    bool getInterpolateFrames() const {return _interpolate; }
 
 private:
     // utility to define object properties including their tags, comments and
@@ -175,6 +188,11 @@ private:
 
     void populateFromMarkerData(MarkerData& aMarkerData);
 
+    // Find the frames before and after time, and the fraction of the way
+    // from one to the other that time lies. The frames are the same, and the
+    // fraction zero, at or beyond the ends of the data.
+    void findFrames(double time, int& before, int& after, double& fraction) const;
+
 //=============================================================================
 };  // END of class MarkersReference
 //=============================================================================
@@ -68,6 +68,8 @@ AbstractTool::AbstractTool():
     _maxDT(_maxDTProp.getValueDbl()),
     _minDT(_minDTProp.getValueDbl()),
     _errorTolerance(_errorToleranceProp.getValueDbl()),
+    _checkpointInterval(_checkpointIntervalProp.getValueDbl()),
+    _resumeFromCheckpoint(_resumeFromCheckpointProp.getValueBool()),
     _analysisSetProp(PropertyObj("Analyses",AnalysisSet())),
     _analysisSet((AnalysisSet&)_analysisSetProp.getValueObj()),
     _controllerSetProp(PropertyObj("Controllers", ControllerSet())),
@@ -100,6 +102,8 @@ AbstractTool::AbstractTool(const string &aFileName, bool aUpdateFromXMLNode):
     _maxDT(_maxDTProp.getValueDbl()),
     _minDT(_minDTProp.getValueDbl()),
     _errorTolerance(_errorToleranceProp.getValueDbl()),
+    _checkpointInterval(_checkpointIntervalProp.getValueDbl()),
+    _resumeFromCheckpoint(_resumeFromCheckpointProp.getValueBool()),
     _analysisSetProp(PropertyObj("Analyses",AnalysisSet())),
     _analysisSet((AnalysisSet&)_analysisSetProp.getValueObj()),
     _controllerSetProp(PropertyObj("Controllers", ControllerSet())),
@@ -162,6 +166,8 @@ AbstractTool::AbstractTool(const AbstractTool &aTool):
     _maxDT(_maxDTProp.getValueDbl()),
     _minDT(_minDTProp.getValueDbl()),
     _errorTolerance(_errorToleranceProp.getValueDbl()),
+    _checkpointInterval(_checkpointIntervalProp.getValueDbl()),
+    _resumeFromCheckpoint(_resumeFromCheckpointProp.getValueBool()),
     _analysisSetProp(PropertyObj("Analyses",AnalysisSet())),
     _analysisSet((AnalysisSet&)_analysisSetProp.getValueObj()),
     _controllerSetProp(PropertyObj("Controllers", ControllerSet())),
@@ -184,6 +190,7 @@ setNull()
     setupProperties();
 
     _model = NULL;
+    _externalLoadsReadMutex = NULL;
     _modelFile = "";
     _replaceForceSet = true;
     _resultsDir = "./";
@@ -195,6 +202,8 @@ setNull()
     _maxDT = 1.0;
     _minDT = 1.0e-8;
     _errorTolerance = 1.0e-5;
+    _checkpointInterval = -1.0;
+    _resumeFromCheckpoint = false;
     _toolOwnsModel=true;
     _externalLoadsFileName = "";
 }
@@ -269,6 +278,22 @@ void AbstractTool::setupProperties()
     _errorToleranceProp.setName("integrator_error_tolerance");
     _propertySet.append( &_errorToleranceProp );
 
+    comment = "Minimum wall-clock time in seconds between checkpoints of the integration, "
+                "written to <name>_checkpoint.bin in the results directory. "
+                "Checkpointing is disabled if the value is not positive. A checkpoint holds the "
+                "states, discrete variables and modeling options of the model, the controls "
+                "computed by CMC and the results stored so far. The integrator's step-size "
+                "history and CMC's optimizer starting guess are not saved, so a resumed run "
+                "matches an uninterrupted one to within the integrator and optimizer tolerances, not bit for bit.";
+    _checkpointIntervalProp.setComment(comment);
+    _checkpointIntervalProp.setName("checkpoint_interval");
+    _propertySet.append( &_checkpointIntervalProp );
+
+    comment = "Resume the integration from the checkpoint file of an earlier run, if one exists.";
+    _resumeFromCheckpointProp.setComment(comment);
+    _resumeFromCheckpointProp.setName("resume_from_checkpoint");
+    _propertySet.append( &_resumeFromCheckpointProp );
+
     comment = "Set of analyses to be run during the investigation.";
     _analysisSetProp.setComment(comment);
     _analysisSetProp.setName("Analyses");
@@ -316,6 +341,8 @@ operator=(const AbstractTool &aTool)
     _maxDT = aTool._maxDT;
     _minDT = aTool._minDT;
     _errorTolerance = aTool._errorTolerance;
+    _checkpointInterval = aTool._checkpointInterval;
+    _resumeFromCheckpoint = aTool._resumeFromCheckpoint;
     _analysisSet = aTool._analysisSet;
     _toolOwnsModel = aTool._toolOwnsModel;
 
@@ -568,6 +595,9 @@ bool AbstractTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
     IO::chDir(IO::getParentDirectory(aExternalLoadsFileName));
     // Create external forces
     try {
+        std::unique_lock<std::mutex> lock;
+        if(_externalLoadsReadMutex)
+            lock = std::unique_lock<std::mutex>(*_externalLoadsReadMutex);
         _externalLoads = ExternalLoads(aModel, aExternalLoadsFileName);
     }
      catch (const Exception &ex) {
@@ -580,35 +610,55 @@ bool AbstractTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
         throw(ex);
     }
     _externalLoads.setMemoryOwner(false);
+
+    // The files the ExternalLoads names are relative to its directory. When
+    // that is known, name them by their full path, so they are found even if
+    // another thread changes the working directory meanwhile.
+    const string loadsDirectory = IO::getParentDirectory(aExternalLoadsFileName);
+    const bool resolveFileNames = IO::isAbsolutePath(loadsDirectory);
+    string dataFileName = _externalLoads.getDataFileName();
+    IO::TrimLeadingWhitespace(dataFileName);
+    if(resolveFileNames && dataFileName != "" && !IO::isAbsolutePath(dataFileName))
+        _externalLoads.setDataFileName(loadsDirectory + dataFileName);
+
     _externalLoads.invokeConnectToModel(aModel);
 
     string loadKinematicsFileName = _externalLoads.getExternalLoadsModelKinematicsFileName();
     
     const Storage *loadKinematicsForPointTransformation = NULL;
+    // The kinematics read or copied here, deleted when done.
+    Storage *temp = NULL;
     
     //If the the Tool is already loading the storage allow it to pass it in for use rather than reloading and processing
     if(loadKinematics && loadKinematics->getName() == loadKinematicsFileName){
-        loadKinematicsForPointTransformation = loadKinematics;
+        // Filter a copy, as the kinematics would be filtered if read from
+        // the file.
+        if(_externalLoads.getLowpassCutoffFrequencyForLoadKinematics() >= 0)
+            temp = new Storage(*loadKinematics);
+        else
+            loadKinematicsForPointTransformation = loadKinematics;
     }
     else{
         IO::TrimLeadingWhitespace(loadKinematicsFileName);
-        Storage *temp = NULL;
         // fine if there are no kinematics as long as it was not assigned
         if(!(loadKinematicsFileName == "") && !(loadKinematicsFileName == "Unassigned")){
+            if(resolveFileNames && !IO::isAbsolutePath(loadKinematicsFileName))
+                loadKinematicsFileName = loadsDirectory + loadKinematicsFileName;
             temp = new Storage(loadKinematicsFileName);
             if(!temp){
                 IO::chDir(savedCwd);
                 throw Exception("DynamicsTool: could not find external loads kinematics file '"+loadKinematicsFileName+"'."); 
             }
         }
-        // if loading the data, do whatever filtering operations are also specified
-        if(temp && _externalLoads.getLowpassCutoffFrequencyForLoadKinematics() >= 0) {
-            cout<<"\n\nLow-pass filtering coordinates data with a cutoff frequency of "<<_externalLoads.getLowpassCutoffFrequencyForLoadKinematics()<<"."<<endl;
-            temp->pad(temp->getSize()/2);
-            temp->lowpassIIR(_externalLoads.getLowpassCutoffFrequencyForLoadKinematics());
-        }
-        loadKinematicsForPointTransformation = temp;
     }
+    // if loading or copying the data, do whatever filtering operations are
+    // also specified
+    if(temp && _externalLoads.getLowpassCutoffFrequencyForLoadKinematics() >= 0) {
+        cout<<"\n\nLow-pass filtering coordinates data with a cutoff frequency of "<<_externalLoads.getLowpassCutoffFrequencyForLoadKinematics()<<"."<<endl;
+        temp->pad(temp->getSize()/2);
+        temp->lowpassIIR(_externalLoads.getLowpassCutoffFrequencyForLoadKinematics());
+    }
+    if(temp) loadKinematicsForPointTransformation = temp;
     
     // if load kinematics for performing re-expressing the point of application is provided
     // then perform the transformations
@@ -635,8 +685,7 @@ bool AbstractTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
         aModel.updForceSet().adoptAndAppend(&_externalLoads[i]);
     }
 
-    if(!loadKinematics)
-        delete loadKinematics;
+    delete temp;
 
     IO::chDir(savedCwd);
     return(true);
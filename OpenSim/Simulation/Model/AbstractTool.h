@@ -35,6 +35,7 @@
 #include "SimTKsimbody.h"
 #include "ForceSet.h"
 #include "ExternalLoads.h"
+#include <mutex>
 
 namespace OpenSim { 
 
@@ -117,6 +118,16 @@ protected:
     integrator step size is decreased. */
     PropertyDbl _errorToleranceProp;
     double &_errorTolerance;
+
+    /** Minimum wall-clock time in seconds between checkpoints of an
+    integration. A non-positive value disables checkpointing. */
+    PropertyDbl _checkpointIntervalProp;
+    double &_checkpointInterval;
+
+    /** Whether to resume an integration from the checkpoint file left in
+    the results directory by an earlier, interrupted run. */
+    PropertyBool _resumeFromCheckpointProp;
+    bool &_resumeFromCheckpoint;
     
     /** Set of analyses to be run during the study. */
     PropertyObj _analysisSetProp;
@@ -135,6 +146,8 @@ protected:
     std::string &_externalLoadsFileName;
     /** Actual external forces being applied. e.g. GRF */
     ExternalLoads   _externalLoads;
+    /** Held while reading the external loads, if not NULL. */
+    std::mutex* _externalLoadsReadMutex;
 
 //=============================================================================
 // METHODS
@@ -262,6 +275,14 @@ public:
     const ExternalLoads& getExternalLoads() const { return _externalLoads; }
     ExternalLoads& updExternalLoads() { return _externalLoads; }
     void setExternalLoads(ExternalLoads& el) { _externalLoads = el; }
+#ifndef SWIG
+    /** Hold aMutex, if not NULL, while reading the external loads file in
+    run(), so that it is not read while another thread holding aMutex reads
+    other XML files (reading XML can update the registered default objects).
+    The tool does not own the mutex. */
+    void setExternalLoadsReadMutex(std::mutex* aMutex)
+    {   _externalLoadsReadMutex = aMutex; }
+#endif
 
     // External loads get/set
     const std::string &getExternalLoadsFileName() const { return _externalLoadsFileName; }
@@ -304,6 +325,17 @@ public:
     double getErrorTolerance() const { return _errorTolerance; }
     void setErrorTolerance(double aErrorTolerance) { _errorTolerance = aErrorTolerance; }
 
+    double getCheckpointInterval() const { return _checkpointInterval; }
+    void setCheckpointInterval(double aSeconds) { _checkpointInterval = aSeconds; }
+
+    bool getResumeFromCheckpoint() const { return _resumeFromCheckpoint; }
+    void setResumeFromCheckpoint(bool aResume) { _resumeFromCheckpoint = aResume; }
+
+    /** Name of the file in the results directory to which integration
+    checkpoints are written. */
+    std::string getCheckpointFileName() const
+    {   return getResultsDir() + "/" + getName() + "_checkpoint.bin"; }
+
     // Model xml file
     const std::string& getModelFilename() const { return _modelFile; }
     void setModelFilename(const std::string& aModelFile) { _modelFile = aModelFile; }
@@ -78,7 +78,7 @@ void ActivationFiberLengthMuscle::constructProperties()
         throw Exception(errMsg);
     }
 
-    addStateVariable(STATE_ACTIVATION_NAME);
+    _activationSV = addStateVariable(STATE_ACTIVATION_NAME);
     // Fiber length should be a position stage state variable.
     // That is setting the fiber length should force position and above
     // dependent cache to be reevaluated. Problem with doing this now
@@ -87,7 +87,7 @@ void ActivationFiberLengthMuscle::constructProperties()
     // multibody position realization which is overkill and would
     // also wipe out the muscle path, which we do not want to 
     // reevaluate over and over.
-    addStateVariable(STATE_FIBER_LENGTH_NAME);//, SimTK::Stage::Velocity);
+    _fiberLengthSV = addStateVariable(STATE_FIBER_LENGTH_NAME);//, SimTK::Stage::Velocity);
  }
 
  void ActivationFiberLengthMuscle::extendInitStateFromProperties( SimTK::State& s) const
@@ -140,8 +140,8 @@ void ActivationFiberLengthMuscle::
         ldot = getFiberVelocity(s);
     }
 
-    setStateVariableDerivativeValue(s, STATE_ACTIVATION_NAME, adot);
-    setStateVariableDerivativeValue(s, STATE_FIBER_LENGTH_NAME, ldot);
+    setStateVariableDerivativeValue(s, _activationSV, adot);
+    setStateVariableDerivativeValue(s, _fiberLengthSV, ldot);
 }
 //==============================================================================
 // GET
@@ -152,19 +152,19 @@ void ActivationFiberLengthMuscle::
 
 void ActivationFiberLengthMuscle::setActivation(SimTK::State& s, double activation) const
 {
-    setStateVariableValue(s, STATE_ACTIVATION_NAME, activation);
+    setStateVariableValue(s, _activationSV, activation);
 }
 
 void ActivationFiberLengthMuscle::setFiberLength(SimTK::State& s, double fiberLength) const
 {
-    setStateVariableValue(s, STATE_FIBER_LENGTH_NAME, fiberLength);
+    setStateVariableValue(s, _fiberLengthSV, fiberLength);
     // NOTE: This is a temporary measure since we were forced to allocate
     // fiber length as a Dynamics stage dependent state variable.
     // In order to force the recalculation of the length cache we have to 
     // invalidate the length info whenever fiber length is set.
-    markCacheVariableInvalid(s,"lengthInfo");
-    markCacheVariableInvalid(s,"velInfo");
-    markCacheVariableInvalid(s,"dynamicsInfo");
+    markCacheVariableInvalid(s, _lengthInfoCV);
+    markCacheVariableInvalid(s, _velInfoCV);
+    markCacheVariableInvalid(s, _dynamicsInfoCV);
 }
 
 double ActivationFiberLengthMuscle::getActivationRate(const SimTK::State& s) const
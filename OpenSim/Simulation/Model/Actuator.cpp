@@ -173,11 +173,14 @@ void ScalarActuator::extendAddToSystem(SimTK::MultibodySystem& system) const
     addModelingOption("override_actuation", 1);
 
     // Cache the computed actuation and speed of the scalar valued actuator
-    addCacheVariable<double>("actuation", 0.0, Stage::Velocity);
-    addCacheVariable<double>("speed", 0.0, Stage::Velocity);
+    _actuationCV = addCacheVariable<double>("actuation", 0.0, Stage::Velocity);
+    _speedCV = addCacheVariable<double>("speed", 0.0, Stage::Velocity);
 
-    // Discrete state variable is the override actuation value if in override mode
-    addDiscreteVariable("override_actuation", Stage::Time);
+    // Discrete state variable is the override actuation value if in override mode.
+    // It is only consumed when forces are computed, so changing it need not
+    // invalidate the positions and velocities (or actuator paths).
+    _overrideActuationDV =
+        addDiscreteVariable("override_actuation", Stage::Dynamics);
 }
 
 double ScalarActuator::getControl(const SimTK::State& s) const
@@ -198,22 +201,22 @@ double ScalarActuator::getOptimalForce() const
 double ScalarActuator::getActuation(const State &s) const
 {
     if (isDisabled(s)) return 0.0;
-    return getCacheVariableValue<double>(s, "actuation");
+    return getCacheVariableValue(s, _actuationCV);
 }
 
 void ScalarActuator::setActuation(const State& s, double aActuation) const
 {
-    setCacheVariableValue<double>(s, "actuation", aActuation);
+    setCacheVariableValue(s, _actuationCV, aActuation);
 }
 
 double ScalarActuator::getSpeed(const State& s) const
 {
-    return getCacheVariableValue<double>(s, "speed");
+    return getCacheVariableValue(s, _speedCV);
 }
 
 void ScalarActuator::setSpeed(const State &s, double speed) const
 {
-    setCacheVariableValue<double>(s, "speed", speed);
+    setCacheVariableValue(s, _speedCV, speed);
 }
 
 void ScalarActuator::overrideActuation(SimTK::State& s, bool flag) const
@@ -228,12 +231,12 @@ bool ScalarActuator::isActuationOverriden(const SimTK::State& s) const
        
 void ScalarActuator::setOverrideActuation(SimTK::State& s, double actuation) const
 {
-    setDiscreteVariableValue(s, "override_actuation", actuation);;
+    setDiscreteVariableValue(s, _overrideActuationDV, actuation);
 }
 
 double ScalarActuator::getOverrideActuation(const SimTK::State& s) const
 {
-    return getDiscreteVariableValue(s, "override_actuation");
+    return getDiscreteVariableValue(s, _overrideActuationDV);
 }
 double ScalarActuator::computeOverrideActuation(const SimTK::State& s) const
 {
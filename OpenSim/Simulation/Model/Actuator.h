@@ -106,6 +106,10 @@ public:
     virtual void setControls(const SimTK::Vector& actuatorControls, SimTK::Vector& modelControls) const;
     /** add actuator controls to the values already occupying the slot in the system-wide model controls */
     virtual void addInControls(const SimTK::Vector& actuatorControls, SimTK::Vector& modelControls) const;
+    /** The index of this actuator's first control in the system-wide model
+        controls. It is assigned when the actuator is added to the System, and
+        is -1 before then. */
+    int getControlIndex() const { return _controlIndex; }
 
     //--------------------------------------------------------------------------
     // COMPUTATIONS
@@ -247,6 +251,11 @@ private:
     void constructProperties() override;
     void constructOutputs() override;
 
+    // Handles to the variables allocated in extendAddToSystem().
+    mutable CacheVariable<double> _actuationCV;
+    mutable CacheVariable<double> _speedCV;
+    mutable DiscreteVariable _overrideActuationDV;
+
 //=============================================================================
 };  // END of class ScalarActuator
 //=============================================================================
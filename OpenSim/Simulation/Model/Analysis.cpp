@@ -31,6 +31,9 @@
 //=============================================================================
 #include "Analysis.h"
 #include "Model.h"
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Storage.h>
+#include <algorithm>
 
 
 
@@ -51,6 +54,10 @@ Analysis::Analysis(Model *aModel):
     _endTime(_endTimeProp.getValueDbl()),
     _stepInterval(_stepIntervalProp.getValueInt()),
     _inDegrees(_inDegreesProp.getValueBool()),
+    _streamDirectory(_streamDirectoryProp.getValueStr()),
+    _streamDecimation(_streamDecimationProp.getValueInt()),
+    _maxRowsInMemory(_maxRowsInMemoryProp.getValueInt()),
+    _computeStatistics(_computeStatisticsProp.getValueBool()),
     _statesStore(NULL)
 {
     
@@ -91,6 +98,10 @@ Analysis::Analysis(const string &aFileName, bool aUpdateFromXMLNode):
     Object(aFileName, false),
     _stepInterval(_stepIntervalProp.getValueInt()),
     _inDegrees(_inDegreesProp.getValueBool()),
+    _streamDirectory(_streamDirectoryProp.getValueStr()),
+    _streamDecimation(_streamDecimationProp.getValueInt()),
+    _maxRowsInMemory(_maxRowsInMemoryProp.getValueInt()),
+    _computeStatistics(_computeStatisticsProp.getValueBool()),
     _on(_onProp.getValueBool()),
     _startTime(_startTimeProp.getValueDbl()),
     _endTime(_endTimeProp.getValueDbl()),
@@ -143,6 +154,10 @@ Analysis::Analysis(const Analysis &aAnalysis):
    _endTime(_endTimeProp.getValueDbl()),
    _stepInterval(_stepIntervalProp.getValueInt()),
    _inDegrees(_inDegreesProp.getValueBool()),
+   _streamDirectory(_streamDirectoryProp.getValueStr()),
+   _streamDecimation(_streamDecimationProp.getValueInt()),
+   _maxRowsInMemory(_maxRowsInMemoryProp.getValueInt()),
+   _computeStatistics(_computeStatisticsProp.getValueBool()),
    _statesStore(NULL)
 {
     setNull();
@@ -163,6 +178,10 @@ setNull()
     _startTime = -SimTK::Infinity;
     _endTime = SimTK::Infinity;
     _inDegrees=true;
+    _streamDirectory = "";
+    _streamDecimation = 1;
+    _maxRowsInMemory = -1;
+    _computeStatistics = false;
     _storageList.setMemoryOwner(false);
     _printResultFiles=true;
 }
@@ -195,6 +214,39 @@ void Analysis::setupProperties()
         "results are in degrees or not.");
     _inDegreesProp.setName("in_degrees");
     _propertySet.append( &_inDegreesProp );
+
+    _streamDirectoryProp.setComment("Directory to which the rows of the "
+        "results are written as they are recorded, rather than only by "
+        "printResults, in files named <run>_<analysis>_<storage>.sto after "
+        "the run, the analysis and the name of each storage, with spaces "
+        "replaced by underscores. These may differ from the names of the "
+        "printed results. JointReaction with number_of_threads greater than 1 "
+        "writes its rows when it computes them, at the end of the run unless "
+        "max_rows_in_memory is set. Empty, the default, for none.");
+    _streamDirectoryProp.setName("stream_directory");
+    _propertySet.append( &_streamDirectoryProp );
+
+    _streamDecimationProp.setComment("Write only every this many rows of the "
+        "results to the stream directory (1 by default). The statistics "
+        "include every row.");
+    _streamDecimationProp.setName("stream_decimation");
+    _propertySet.append( &_streamDecimationProp );
+
+    _maxRowsInMemoryProp.setComment("Number of the most recent rows of each "
+        "result to keep in memory; older rows are dropped once streamed. "
+        "Results are then not printed at the end of the run, so "
+        "stream_directory must be set. -1, the default, keeps all rows. "
+        "JointReaction with number_of_threads greater than 1 computes its "
+        "frames in chunks of this many rows (at least one per thread).");
+    _maxRowsInMemoryProp.setName("max_rows_in_memory");
+    _propertySet.append( &_maxRowsInMemoryProp );
+
+    _computeStatisticsProp.setComment("Flag (true or false) indicating "
+        "whether to compute the minimum, maximum, mean and RMS of each "
+        "column of the results while they are recorded, and print them "
+        "with the results. False by default.");
+    _computeStatisticsProp.setName("compute_statistics");
+    _propertySet.append( &_computeStatisticsProp );
 }
 
 
@@ -222,6 +274,12 @@ operator=(const Analysis &aAnalysis)
 
     _inDegrees = aAnalysis._inDegrees;
     _printResultFiles = aAnalysis._printResultFiles;
+    _streamDirectory = aAnalysis._streamDirectory;
+    _streamDecimation = aAnalysis._streamDecimation;
+    _maxRowsInMemory = aAnalysis._maxRowsInMemory;
+    _computeStatistics = aAnalysis._computeStatistics;
+    _rowCallback = aAnalysis._rowCallback;
+    _streamBaseName = aAnalysis._streamBaseName;
 
     // Class Memebers
     setStepInterval(aAnalysis.getStepInterval());
@@ -352,6 +410,114 @@ ArrayPtrs<Storage>& Analysis::getStorageList()
     return _storageList;
 }
 
+//=============================================================================
+// STREAMING
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Whether the properties ask for the results to be streamed.
+ */
+bool Analysis::
+isStreaming() const
+{
+    return !_streamDirectory.empty() || _rowCallback || _computeStatistics ||
+           _maxRowsInMemory >= 0;
+}
+//_____________________________________________________________________________
+/**
+ * Create a stream for each storage in the storage list, and pass on the rows
+ * the storages already have (e.g., those recorded by begin()).
+ */
+void Analysis::
+beginStreaming()
+{
+    _streams.clear();
+    if(!getOn() || !isStreaming()) return;
+
+    if(_maxRowsInMemory>=0 && _streamDirectory.empty() && !_rowCallback) {
+        string msg = "Analysis::beginStreaming: ERROR- " + getName() +
+            " keeps only " + std::to_string(_maxRowsInMemory) + " rows in "
+            "memory (max_rows_in_memory) but writes them nowhere; set "
+            "stream_directory or a row callback.";
+        throw Exception(msg,__FILE__,__LINE__);
+    }
+
+    if(!_streamDirectory.empty()) IO::makeDir(_streamDirectory);
+
+    ArrayPtrs<Storage>& storages = getStorageList();
+    for(int i=0;i<storages.getSize();i++) {
+        Storage* store = storages.get(i);
+        if(store==NULL) continue;
+        std::unique_ptr<StorageStream> stream(new StorageStream(*store));
+        if(!_streamDirectory.empty()) {
+            string name = getName() + "_" + store->getName();
+            if(!_streamBaseName.empty()) name = _streamBaseName + "_" + name;
+            std::replace(name.begin(), name.end(), ' ', '_');
+            stream->setFileName(_streamDirectory + "/" + name + ".sto");
+        }
+        if(_rowCallback) stream->setRowCallback(_rowCallback);
+        stream->setDecimation(_streamDecimation);
+        stream->setMaxRowsInMemory(_maxRowsInMemory);
+        stream->setComputeStatistics(_computeStatistics);
+        stream->update();
+        _streams.push_back(std::move(stream));
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Pass on the rows recorded since the last call.
+ */
+void Analysis::
+updateStreaming()
+{
+    for(size_t i=0;i<_streams.size();i++) _streams[i]->update();
+}
+//_____________________________________________________________________________
+/**
+ * Pass on the remaining rows and finish the files.
+ */
+void Analysis::
+endStreaming()
+{
+    for(size_t i=0;i<_streams.size();i++) _streams[i]->close();
+}
+//_____________________________________________________________________________
+/**
+ * Get the streams of the last run.
+ */
+int Analysis::
+getNumStreams() const
+{
+    return (int)_streams.size();
+}
+const StorageStream& Analysis::
+getStream(int aIndex) const
+{
+    if(aIndex<0 || aIndex>=(int)_streams.size()) {
+        throw Exception("Analysis.getStream: index out of range.",
+                        __FILE__,__LINE__);
+    }
+    return *_streams[aIndex];
+}
+//_____________________________________________________________________________
+/**
+ * Print the statistics of the streams that computed them.
+ */
+void Analysis::
+printStatistics(const string &aBaseName, const string &aDir) const
+{
+    for(size_t i=0;i<_streams.size();i++) {
+        const StorageStream& stream = *_streams[i];
+        if(!stream.getComputeStatistics()) continue;
+        const Storage& store = stream.getStorage();
+        string name = aBaseName + "_" + getName() + "_" + store.getName();
+        std::replace(name.begin(), name.end(), ' ', '_');
+        string fileName = aDir.empty() ? name : aDir + "/" + name;
+        stream.getStatistics().print(fileName + "_statistics.txt",
+                                     store.getName(), store.getColumnLabels());
+    }
+}
+
 // GET AND SET
 //=============================================================================
 //_____________________________________________________________________________
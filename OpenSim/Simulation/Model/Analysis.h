@@ -37,6 +37,9 @@
 #include <OpenSim/Common/PropertyInt.h>
 #include <OpenSim/Common/ArrayPtrs.h>
 #include <OpenSim/Common/Array.h>
+#include <OpenSim/Common/StorageStream.h>
+#include <memory>
+#include <vector>
 
 namespace OpenSim { 
 
@@ -49,6 +52,13 @@ class Model;
  * An abstract class for specifying the interface for an analysis
  * plugin.
  *
+ * The rows of the results (the storages in getStorageList()) can be streamed
+ * while the analysis runs in an AnalysisSet: written to files in a directory
+ * and passed to a callback as they are recorded, reduced to the minimum,
+ * maximum, mean and RMS of each column, and dropped from memory once they
+ * are written (see StorageStream). Results of which rows are dropped are not
+ * printed by AnalysisSet::printResults().
+ *
  * @author Frank C. Anderson, Ajay Seth
  * @version 1.0
  */
@@ -67,10 +77,35 @@ private:
     PropertyBool _inDegreesProp;
     bool &_inDegrees;
 
+    /** Directory to which rows of the results are written as recorded. */
+    PropertyStr _streamDirectoryProp;
+    std::string &_streamDirectory;
+
+    /** Write only every this many rows to the stream. */
+    PropertyInt _streamDecimationProp;
+    int &_streamDecimation;
+
+    /** Number of most recent rows of each result kept in memory. */
+    PropertyInt _maxRowsInMemoryProp;
+    int &_maxRowsInMemory;
+
+    /** Compute the min, max, mean and RMS of each column of the results. */
+    PropertyBool _computeStatisticsProp;
+    bool &_computeStatistics;
+
     // WORK ARRAYS
     /** Column labels. */
     Array<std::string> _labels;
 
+#ifndef SWIG
+    /** Streams of the storages in the storage list, from beginStreaming()
+    until the next call. */
+    std::vector<std::unique_ptr<StorageStream> > _streams;
+    StorageStream::RowCallback _rowCallback;
+#endif
+    /** Prefix of the names of the streamed files. */
+    std::string _streamBaseName;
+
 
 protected:
 
@@ -213,6 +248,68 @@ public:
     void setPrintResultFiles(bool aToWrite) { _printResultFiles = aToWrite; }
     bool getPrintResultFiles() const { return _printResultFiles; }
 
+    //--------------------------------------------------------------------------
+    // STREAMING
+    //--------------------------------------------------------------------------
+    /** Write the rows of each result to aDirectory as they are recorded, in
+    a file named <base name>_<analysis name>_<storage name>.sto with spaces
+    replaced by underscores (e.g., arm26_Kinematics_Positions.sto). This is
+    not always the name printResults() gives the result, which some analyses
+    choose themselves (e.g., JointReaction's _ReactionLoads). Rows an
+    analysis computes late (e.g., JointReaction with number_of_threads
+    greater than 1) are written when it computes them. Empty, the default,
+    for none. */
+    void setStreamDirectory(const std::string& aDirectory)
+    {   _streamDirectory = aDirectory; }
+    const std::string& getStreamDirectory() const { return _streamDirectory; }
+    /** Write (and pass to the row callback) only every aEveryNth row. The
+    statistics include every row. The default is 1. */
+    void setStreamDecimation(int aEveryNth) { _streamDecimation = aEveryNth; }
+    int getStreamDecimation() const { return _streamDecimation; }
+    /** Keep only the aMaxRows most recent rows of each result in memory. The
+    default, -1, keeps all rows. The rows dropped are lost unless a stream
+    directory or a row callback is set, so beginStreaming() throws an
+    Exception if neither is. JointReaction on several threads computes its
+    frames in chunks of aMaxRows (at least one per thread). */
+    void setMaxRowsInMemory(int aMaxRows) { _maxRowsInMemory = aMaxRows; }
+    int getMaxRowsInMemory() const { return _maxRowsInMemory; }
+    /** Compute the minimum, maximum, mean and RMS of each column of each
+    result, which printStatistics() writes. Off by default. */
+    void setComputeStatistics(bool aTrueFalse)
+    {   _computeStatistics = aTrueFalse; }
+    bool getComputeStatistics() const { return _computeStatistics; }
+#ifndef SWIG
+    /** Pass each row written to aCallback, along with its storage. */
+    void setRowCallback(const StorageStream::RowCallback& aCallback)
+    {   _rowCallback = aCallback; }
+#endif
+    /** The base name with which the streamed files begin, normally the name
+    of the tool or Manager session running the analysis, which sets it
+    before begin(). Empty for none. */
+    void setStreamBaseName(const std::string& aBaseName)
+    {   _streamBaseName = aBaseName; }
+    const std::string& getStreamBaseName() const { return _streamBaseName; }
+    /** Whether any of the above options asks for the results to be
+    streamed. */
+    bool isStreaming() const;
+
+    /** Start streaming the storages in the storage list, if requested. The
+    AnalysisSet calls this after begin(), updateStreaming() after each
+    step() and endStreaming() after end(). */
+    void beginStreaming();
+    void updateStreaming();
+    void endStreaming();
+#ifndef SWIG
+    /** The streams of the last run, one per storage in the storage list. */
+    int getNumStreams() const;
+    const StorageStream& getStream(int aIndex) const;
+#endif
+
+    /** Write the statistics of each result, if computed, to
+    aDir/aBaseName_<analysis>_<storage>_statistics.txt. */
+    void printStatistics(const std::string &aBaseName,
+                         const std::string &aDir="") const;
+
     //--------------------------------------------------------------------------
     // RESULTS
     //--------------------------------------------------------------------------
@@ -31,6 +31,7 @@
 //=============================================================================
 #include "AnalysisSet.h"
 #include "Model.h"
+#include <OpenSim/Common/ComponentProfiler.h>
 
 
 using namespace OpenSim;
@@ -184,6 +185,16 @@ getOn() const
     for(int i=0; i<getSize(); i++) on[i] = get(i).getOn();
     return on;
 }
+//_____________________________________________________________________________
+/**
+ * Set the base name of the files the analyses stream their results to,
+ * normally the name of the run (see Analysis::setStreamBaseName()).
+ */
+void AnalysisSet::
+setStreamBaseName(const std::string &aBaseName)
+{
+    for(int i=0;i<getSize();i++) get(i).setStreamBaseName(aBaseName);
+}
 
 
 //=============================================================================
@@ -203,7 +214,10 @@ begin(SimTK::State& s )
     int i;
     for(i=0;i<getSize();i++) {
         Analysis& analysis = get(i);
-        if (analysis.getOn()) analysis.begin(s);
+        if (analysis.getOn()) {
+            analysis.begin(s);
+            analysis.beginStreaming();
+        }
     }
 }
 //_____________________________________________________________________________
@@ -220,7 +234,11 @@ step( const SimTK::State& s, int stepNumber )
     int i;
     for(i=0;i<getSize();i++) {
         Analysis& analysis = get(i);
-        if (analysis.getOn()) analysis.step(s, stepNumber);
+        if (analysis.getOn()) {
+            OPENSIM_PROFILE_SCOPE(analysis, "step");
+            analysis.step(s, stepNumber);
+            analysis.updateStreaming();
+        }
     }
 }
 //_____________________________________________________________________________
@@ -237,7 +255,10 @@ end(SimTK::State& s)
     int i;
     for(i=0;i<getSize();i++) {
         Analysis& analysis = get(i);
-        if (analysis.getOn()) analysis.end(s);
+        if (analysis.getOn()) {
+            analysis.end(s);
+            analysis.endStreaming();
+        }
     }
 }
 
@@ -261,7 +282,20 @@ printResults(const string &aBaseName,const string &aDir,double aDT,
     int size = getSize();
     for(i=0;i<size;i++) {
         Analysis& analysis = get(i);
-        if(analysis.getOn() && analysis.getPrintResultFiles()) analysis.printResults(aBaseName,aDir,aDT,aExtension);
+        if(!analysis.getOn() || !analysis.getPrintResultFiles()) continue;
+        // Only the last rows of bounded results are left to print; the
+        // rest were streamed.
+        if(analysis.getMaxRowsInMemory()<0) {
+            analysis.printResults(aBaseName,aDir,aDT,aExtension);
+        } else {
+            const string& dir = analysis.getStreamDirectory();
+            cout << "AnalysisSet.printResults: results of " << analysis.getName()
+                 << " were streamed to "
+                 << (dir.empty() ? string("a row callback") : "'" + dir + "'")
+                 << " while kept to " << analysis.getMaxRowsInMemory()
+                 << " rows in memory." << endl;
+        }
+        analysis.printStatistics(aBaseName,aDir);
     }
 }
 //=============================================================================
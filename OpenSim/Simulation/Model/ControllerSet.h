@@ -85,6 +85,9 @@ public:
     void constructStorage();
     void storeControls( const SimTK::State& s, int step );
     void printControlStorage( const std::string& fileName) const;
+    /** Storage of the recorded controls; NULL until constructStorage(). */
+    const Storage* getControlStorage() const { return _controlStore.get(); }
+    Storage* updControlStorage() { return _controlStore.get(); }
     void setActuators(Set<Actuator>& actuators);
 
     void setDesiredStates( Storage* yStore); 
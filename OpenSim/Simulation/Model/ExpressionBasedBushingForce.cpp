@@ -143,12 +143,6 @@ void ExpressionBasedBushingForce::constructProperties()
     constructProperty_Fx_expression( zero );
     constructProperty_Fy_expression( zero );
     constructProperty_Fz_expression( zero );
-    setMxExpression( "0.0" );
-    setMyExpression( "0.0" );
-    setMzExpression( "0.0" );
-    setFxExpression( "0.0" );
-    setFyExpression( "0.0" );
-    setFzExpression( "0.0" );
     
     constructProperty_rotational_damping(Vec3(0));
     constructProperty_translational_damping(Vec3(0));
@@ -169,13 +163,17 @@ void ExpressionBasedBushingForce::extendConnectToModel(Model& aModel)
 {
     Super::extendConnectToModel(aModel); // base class first
 
-    // must initialize the 6 force functions using the user provided expressions
-    setMxExpression(get_Mx_expression());
-    setMyExpression(get_My_expression());
-    setMzExpression(get_Mz_expression());
-    setFxExpression(get_Fx_expression());
-    setFyExpression(get_Fy_expression());
-    setFzExpression(get_Fz_expression());
+    // compile the 6 force functions and their derivatives once, from the
+    // user provided expressions
+    const string* expressions[6] = {
+        &get_Mx_expression(), &get_My_expression(), &get_Mz_expression(),
+        &get_Fx_expression(), &get_Fy_expression(), &get_Fz_expression() };
+    for (int i = 0; i < 6; ++i) {
+        string expression = *expressions[i];
+        expression.erase( remove_if(expression.begin(), expression.end(),
+                                    ::isspace), expression.end() );
+        _deflectionForces.setExpression(i, expression);
+    }
 
     string errorMessage;
     const string& body1Name = get_body_1(); // error if unspecified
@@ -262,59 +260,53 @@ void ExpressionBasedBushingForce::setBody2BushingLocation(const Vec3& location,
     set_orientation_body_2(orientation);
 }
 
-/** Set the expression for the Mx function and create it's lepton program */
+/** Set the expression for the Mx function; it is compiled on connect */
 void ExpressionBasedBushingForce::setMxExpression(std::string expression) 
 {
     expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
                         expression.end() );
     set_Mx_expression(expression);
-    MxProg = Lepton::Parser::parse(expression).optimize().createProgram();
 }
 
-/** Set the expression for the My function and create it's lepton program */
+/** Set the expression for the My function; it is compiled on connect */
 void ExpressionBasedBushingForce::setMyExpression(std::string expression) 
 {
     
     expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
                         expression.end() );
     set_My_expression(expression);
-    MyProg = Lepton::Parser::parse(expression).optimize().createProgram();
 }
 
-/** Set the expression for the Mz function and create it's lepton program */
+/** Set the expression for the Mz function; it is compiled on connect */
 void ExpressionBasedBushingForce::setMzExpression(std::string expression) 
 {
     expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
                         expression.end() );
     set_Mz_expression(expression);
-    MzProg = Lepton::Parser::parse(expression).optimize().createProgram();
 }
 
-/** Set the expression for the Fx function and create it's lepton program */
+/** Set the expression for the Fx function; it is compiled on connect */
 void ExpressionBasedBushingForce::setFxExpression(std::string expression) 
 {
     expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
                         expression.end() );
     set_Fx_expression(expression);
-    FxProg = Lepton::Parser::parse(expression).optimize().createProgram();
 }
 
-/** Set the expression for the Fy function and create it's lepton program */
+/** Set the expression for the Fy function; it is compiled on connect */
 void ExpressionBasedBushingForce::setFyExpression(std::string expression) 
 {
     expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
                         expression.end() );
     set_Fy_expression(expression);
-    FyProg = Lepton::Parser::parse(expression).optimize().createProgram();
 }
 
-/** Set the expression for the Fz function and create it's lepton program */
+/** Set the expression for the Fz function; it is compiled on connect */
 void ExpressionBasedBushingForce::setFzExpression(std::string expression) 
 {
     expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
                         expression.end() );
     set_Fz_expression(expression);
-    FzProg = Lepton::Parser::parse(expression).optimize().createProgram();
 }
 //=============================================================================
 // COMPUTATION
@@ -345,6 +337,21 @@ SimTK::Vec6 ExpressionBasedBushingForce::computeDeflection(const SimTK::State& s
     return dq;
 }
 
+/** Compute the derivatives of the deflection forces with respect to the
+    deflections. */
+SimTK::Mat66 ExpressionBasedBushingForce::computeStiffness(const SimTK::State& s) const
+{
+    Vec6 dq = computeDeflection(s);
+    double dfk[36];
+    _deflectionForces.evaluateDerivatives(&dq[0], dfk);
+
+    Mat66 stiffness;
+    for (int i = 0; i < 6; ++i)
+        for (int j = 0; j < 6; ++j)
+            stiffness(i, j) = dfk[6*i + j];
+    return stiffness;
+}
+
 /** compute the bushing force at the bushing location
 */
 void ExpressionBasedBushingForce::ComputeForcesAtBushing(const SimTK::State& state, 
@@ -367,22 +374,7 @@ void ExpressionBasedBushingForce::ComputeForcesAtBushing(const SimTK::State& sta
     // TO DO: compute the deflection forces from functions
     //------------------------------------------
     Vec6 fk = Vec6(0.0);
-
-    std::map<std::string, double> deflectionVars;
-    deflectionVars["theta_x"] = dq[0];
-    deflectionVars["theta_y"] = dq[1];
-    deflectionVars["theta_z"] = dq[2];
-    deflectionVars["delta_x"] = dq[3];
-    deflectionVars["delta_y"] = dq[4];
-    deflectionVars["delta_z"] = dq[5];
-
-    
-    fk[0] = MxProg.evaluate(deflectionVars);
-    fk[1] = MyProg.evaluate(deflectionVars);
-    fk[2] = MzProg.evaluate(deflectionVars);
-    fk[3] = FxProg.evaluate(deflectionVars);
-    fk[4] = FyProg.evaluate(deflectionVars);
-    fk[5] = FzProg.evaluate(deflectionVars);
+    _deflectionForces.evaluate(&dq[0], &fk[0]);
 
     // Now evaluate velocities.
     const SpatialVec& V_GB1 = _b1->getBodyVelocity(state);
@@ -566,15 +558,11 @@ getRecordValues(const SimTK::State& state) const
 
     OpenSim::Array<double> values(1);
 
-    const SimTK::Force::LinearBushing &simtkSpring = 
-        (SimTK::Force::LinearBushing &)(_model->getForceSubsystem().getForce(_index));
-
     SimTK::Vector_<SimTK::SpatialVec> bodyForces(0);
-    SimTK::Vector_<SimTK::Vec3> particleForces(0);
     SimTK::Vector mobilityForces(0);
 
     //get the net force added to the system contributed by the bushing
-    simtkSpring.calcForceContribution(state, bodyForces, particleForces, mobilityForces);
+    calcForceContribution(state, bodyForces, mobilityForces);
     SimTK::Vec3 forces = bodyForces(_model->getBodySet().get(body1Name).getIndex())[1];
     SimTK::Vec3 torques = bodyForces(_model->getBodySet().get(body1Name).getIndex())[0];
     values.append(3, &forces[0]);
@@ -30,8 +30,8 @@
 #include <OpenSim/Common/PropertyStr.h>
 #include <OpenSim/Common/PropertyDblVec.h>
 #include "Force.h"
+#include "ExpressionEvaluator.h"
 #include <OpenSim/Common/osimCommon.h>
-#include <Vendors/lepton/include/Lepton.h>
 
 
 namespace OpenSim {
@@ -116,8 +116,11 @@ public:
 protected:
     /** how to display the bushing */
 private:
-    // parser programs for efficiently evaluating the expressions
-    Lepton::ExpressionProgram MxProg, MyProg, MzProg, FxProg, FyProg, FzProg; 
+    // Mx, My, Mz, Fx, Fy, Fz expressions of the deflections and their
+    // derivatives, compiled once in extendConnectToModel()
+    ExpressionEvaluator _deflectionForces{
+        {"theta_x", "theta_y", "theta_z", "delta_x", "delta_y", "delta_z"},
+        6, true};
     // underlying SimTK system elements
     // the mobilized bodies involved
     const SimTK::MobilizedBody *_b1;
@@ -224,6 +227,13 @@ public:
       * The force and potential energy are determined by the deflection.  **/
     virtual SimTK::Vec6 computeDeflection(const SimTK::State& s) const;
 
+    /** Compute the stiffness of the bushing at its current deflection: the
+      * partial derivatives of (Mx, My, Mz, Fx, Fy, Fz) with respect to
+      * (theta_x, theta_y, theta_z, delta_x, delta_y, delta_z), from the
+      * analytic derivatives of the expressions. Row i holds the derivatives
+      * of the i-th expression. Damping is not included. **/
+    SimTK::Mat66 computeStiffness(const SimTK::State& s) const;
+
     /** Compute the bushing force contribution to the system and add in to appropriate
       * bodyForce and/or system generalizedForce. 
       */
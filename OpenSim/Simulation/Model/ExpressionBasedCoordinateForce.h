@@ -24,7 +24,7 @@
  * -------------------------------------------------------------------------- */
 // INCLUDE
 #include "Force.h"
-#include <Vendors/lepton/include/Lepton.h>
+#include "ExpressionEvaluator.h"
 
 namespace OpenSim {
 
@@ -126,8 +126,8 @@ private:
     void setNull();
     void constructProperties();
 
-    // parser programs for efficiently evaluating the expressions
-    Lepton::ExpressionProgram _forceProg;
+    // compiled force expression
+    ExpressionEvaluator _forceExpression{{"q", "qdot"}, 1};
 
     // Corresponding generalized coordinate to which the force
     // is applied.
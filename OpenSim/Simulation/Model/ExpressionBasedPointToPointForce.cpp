@@ -129,7 +129,7 @@ void ExpressionBasedPointToPointForce::extendConnectToModel(Model& model)
             remove_if(expression.begin(), expression.end(), ::isspace), 
                       expression.end() );
     
-    _forceProg = Lepton::Parser::parse(expression).optimize().createProgram();
+    _forceExpression.setExpression(0, expression);
 }
 
 //=============================================================================
@@ -179,11 +179,9 @@ void ExpressionBasedPointToPointForce::computeForce(const SimTK::State& s,
     //speed along the line connecting the two bodies
     const double ddot = dot(vRel, r_G)/d;
 
-    std::map<std::string, double> forceVars;
-    forceVars["d"] = d;
-    forceVars["ddot"] = ddot;
-
-    double forceMag = _forceProg.evaluate(forceVars);
+    const double forceVars[2] = {d, ddot};
+    double forceMag;
+    _forceExpression.evaluate(forceVars, &forceMag);
     setCacheVariableValue<double>(s, "force_magnitude", forceMag);
 
     const Vec3 f1_G = (forceMag/d) * r_G;
@@ -234,13 +232,11 @@ getRecordValues(const SimTK::State& state) const
     OpenSim::Array<double> values(1);
 
     SimTK::Vector_<SimTK::SpatialVec> bodyForces(0);
-    SimTK::Vector_<SimTK::Vec3> particleForces(0);
     SimTK::Vector mobilityForces(0);
 
 
     //get the net force added to the system contributed by the Spring
-    _model->getForceSubsystem().getForce(_index)
-        .calcForceContribution(state, bodyForces, particleForces, mobilityForces);
+    calcForceContribution(state, bodyForces, mobilityForces);
     
     SimTK::Vec3 forces = bodyForces(_body1->getMobilizedBodyIndex())[1];
     values.append(3, &forces[0]);
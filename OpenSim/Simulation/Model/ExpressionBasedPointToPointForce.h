@@ -24,7 +24,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "Force.h"
-#include <Vendors/lepton/include/Lepton.h>
+#include "ExpressionEvaluator.h"
 
 //==============================================================================
 //==============================================================================
@@ -165,8 +165,8 @@ private:
     void setNull();
     void constructProperties();
 
-    // parser programs for efficiently evaluating the expressions
-    Lepton::ExpressionProgram _forceProg;
+    // compiled force expression
+    ExpressionEvaluator _forceExpression{{"d", "ddot"}, 1};
 
     // Temporary solution until implemented with Connectors
     SimTK::ReferencePtr<const PhysicalFrame> _body1;
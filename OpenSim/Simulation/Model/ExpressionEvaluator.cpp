@@ -0,0 +1,229 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  ExpressionEvaluator.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "ExpressionEvaluator.h"
+#include <OpenSim/Common/Exception.h>
+#include <algorithm>
+
+using namespace std;
+using namespace OpenSim;
+
+namespace {
+    Lepton::CompiledExpression compileZero()
+    {
+        return Lepton::Parser::parse("0").createCompiledExpression();
+    }
+}
+
+//=============================================================================
+// CONSTRUCTOR(S)
+//=============================================================================
+ExpressionEvaluator::ExpressionEvaluator(const vector<string>& variableNames,
+    int numExpressions, bool withDerivatives) :
+    _variableNames(variableNames),
+    _numExpressions(numExpressions),
+    _withDerivatives(withDerivatives),
+    _generation(0)
+{
+    // Until they are set, all expressions (and so their derivatives) are 0.
+    _values.expressions.assign(_numExpressions, compileZero());
+    if(_withDerivatives) {
+        _derivatives.expressions.assign(_numExpressions*getNumVariables(),
+                                        compileZero());
+    }
+    _values.bind(_variableNames);
+    _derivatives.bind(_variableNames);
+}
+
+ExpressionEvaluator::ExpressionEvaluator(const ExpressionEvaluator& source) :
+    _variableNames(source._variableNames),
+    _numExpressions(source._numExpressions),
+    _withDerivatives(source._withDerivatives),
+    _generation(0)
+{
+    _values.expressions = source._values.expressions;
+    _derivatives.expressions = source._derivatives.expressions;
+    _values.bind(_variableNames);
+    _derivatives.bind(_variableNames);
+}
+
+ExpressionEvaluator&
+ExpressionEvaluator::operator=(const ExpressionEvaluator& source)
+{
+    if(&source != this) {
+        _variableNames = source._variableNames;
+        _numExpressions = source._numExpressions;
+        _withDerivatives = source._withDerivatives;
+        _values.expressions = source._values.expressions;
+        _derivatives.expressions = source._derivatives.expressions;
+        _values.bind(_variableNames);
+        _derivatives.bind(_variableNames);
+        lock_guard<mutex> sparesLock(_sparesMutex);
+        clearSpares();
+    }
+    return *this;
+}
+
+//=============================================================================
+// EXPRESSIONS
+//=============================================================================
+void ExpressionEvaluator::setExpression(int index, const string& expression)
+{
+    if(index < 0 || index >= _numExpressions) {
+        throw Exception("ExpressionEvaluator::setExpression: index "
+            + to_string(index) + " is out of range.", __FILE__, __LINE__);
+    }
+
+    Lepton::ParsedExpression parsed;
+    try {
+        parsed = Lepton::Parser::parse(expression).optimize();
+    }
+    catch(const Lepton::Exception& e) {
+        throw Exception("ExpressionEvaluator: could not parse expression '"
+            + expression + "': " + e.what(), __FILE__, __LINE__);
+    }
+
+    Lepton::CompiledExpression compiled = parsed.createCompiledExpression();
+    for(const string& name : compiled.getVariables()) {
+        if(find(_variableNames.begin(), _variableNames.end(), name)
+           == _variableNames.end()) {
+            throw Exception("ExpressionEvaluator: expression '" + expression
+                + "' uses unknown variable '" + name + "'.",
+                __FILE__, __LINE__);
+        }
+    }
+
+    // Compile the derivatives before taking the lock, too.
+    vector<Lepton::CompiledExpression> derivatives;
+    if(_withDerivatives) {
+        for(const string& name : _variableNames) {
+            derivatives.push_back(parsed.differentiate(name).optimize()
+                                        .createCompiledExpression());
+        }
+    }
+
+    // No spare copy is made while the expressions change.
+    lock_guard<mutex> lock(_mutex);
+    lock_guard<mutex> sparesLock(_sparesMutex);
+    _values.expressions[index] = compiled;
+    _values.bind(_variableNames);
+    if(_withDerivatives) {
+        const int nv = getNumVariables();
+        for(int j = 0; j < nv; ++j)
+            _derivatives.expressions[index*nv + j] = derivatives[j];
+        _derivatives.bind(_variableNames);
+    }
+    clearSpares();
+}
+
+//=============================================================================
+// EVALUATION
+//=============================================================================
+void ExpressionEvaluator::
+evaluate(const double* variableValues, double* results) const
+{
+    evaluateWorkspace(_values, _spareValues, variableValues, results);
+}
+
+void ExpressionEvaluator::
+evaluateDerivatives(const double* variableValues, double* derivatives) const
+{
+    if(!_withDerivatives) {
+        throw Exception("ExpressionEvaluator::evaluateDerivatives: "
+            "derivatives were not requested at construction.",
+            __FILE__, __LINE__);
+    }
+    evaluateWorkspace(_derivatives, _spareDerivatives, variableValues,
+                      derivatives);
+}
+
+void ExpressionEvaluator::evaluateWorkspace(const Workspace& workspace,
+    Spares& spares, const double* variableValues, double* results) const
+{
+    unique_lock<mutex> lock(_mutex, try_to_lock);
+    if(lock.owns_lock()) {
+        workspace.evaluate(variableValues, results);
+        return;
+    }
+
+    // Take a spare copy, or make one if all are in use. Copying only reads
+    // the compiled operations, which are not modified by evaluation, and
+    // setExpression() cannot change them while _sparesMutex is held.
+    unique_ptr<Workspace> spare;
+    {
+        lock_guard<mutex> sparesLock(_sparesMutex);
+        if(!spares.empty()) {
+            spare = std::move(spares.back());
+            spares.pop_back();
+        }
+        else {
+            spare.reset(new Workspace);
+            spare->expressions = workspace.expressions;
+            spare->bind(_variableNames);
+            spare->generation = _generation;
+        }
+    }
+
+    spare->evaluate(variableValues, results);
+
+    // Keep the copy unless the expressions changed meanwhile.
+    lock_guard<mutex> sparesLock(_sparesMutex);
+    if(spare->generation == _generation) spares.push_back(std::move(spare));
+}
+
+void ExpressionEvaluator::clearSpares()
+{
+    _spareValues.clear();
+    _spareDerivatives.clear();
+    ++_generation;
+}
+
+//=============================================================================
+// WORKSPACE
+//=============================================================================
+void ExpressionEvaluator::Workspace::bind(const vector<string>& variableNames)
+{
+    slots.clear();
+    slotVariables.clear();
+    for(Lepton::CompiledExpression& expression : expressions) {
+        const set<string>& used = expression.getVariables();
+        for(int j = 0; j < (int)variableNames.size(); ++j) {
+            if(used.count(variableNames[j])) {
+                slots.push_back(
+                    &expression.getVariableReference(variableNames[j]));
+                slotVariables.push_back(j);
+            }
+        }
+    }
+}
+
+void ExpressionEvaluator::Workspace::
+evaluate(const double* variableValues, double* results) const
+{
+    for(size_t k = 0; k < slots.size(); ++k)
+        *slots[k] = variableValues[slotVariables[k]];
+    for(size_t i = 0; i < expressions.size(); ++i)
+        results[i] = expressions[i].evaluate();
+}
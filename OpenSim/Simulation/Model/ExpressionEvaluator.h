@@ -0,0 +1,143 @@
+#ifndef OPENSIM_EXPRESSION_EVALUATOR_H_
+#define OPENSIM_EXPRESSION_EVALUATOR_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  ExpressionEvaluator.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include <Vendors/lepton/include/Lepton.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Evaluates a fixed number of user-supplied Lepton expressions of the same
+ * named variables, as used by the expression-based forces.
+ *
+ * Each expression is compiled once, when it is set, and the workspace slot of
+ * every variable it uses is bound at that time. Evaluation writes the variable
+ * values directly into those slots and runs the compiled expressions, so it
+ * does not build a map of variable names or allocate memory.
+ *
+ * If requested, the partial derivatives of every expression with respect to
+ * every variable are differentiated analytically and compiled when the
+ * expression is set, and are evaluated the same way.
+ *
+ * A Lepton::CompiledExpression cannot be evaluated by two threads at once. An
+ * ExpressionEvaluator is safe to use from several threads: a thread that
+ * finds the compiled expressions in use evaluates a spare copy of them
+ * instead. Spare copies are kept for reuse, so copies are only made until
+ * there is one for each thread that evaluates concurrently. A copy of an
+ * ExpressionEvaluator has its own compiled expressions.
+ */
+class OSIMSIMULATION_API ExpressionEvaluator {
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+    /** @param variableNames     Names of the variables the expressions may
+                                use, in the order their values are passed to
+                                evaluate().
+        @param numExpressions   Number of expressions.
+        @param withDerivatives  Also compile the partial derivatives of the
+                                expressions for evaluateDerivatives(). */
+    ExpressionEvaluator(const std::vector<std::string>& variableNames,
+                        int numExpressions, bool withDerivatives = false);
+    ExpressionEvaluator(const ExpressionEvaluator& source);
+    ExpressionEvaluator& operator=(const ExpressionEvaluator& source);
+
+    int getNumVariables() const { return (int)_variableNames.size(); }
+    int getNumExpressions() const { return _numExpressions; }
+
+    /** Parse, optimize and compile the expression with the given index.
+    Throws an Exception if the expression cannot be parsed or uses a variable
+    other than those given at construction. */
+    void setExpression(int index, const std::string& expression);
+
+    /** Evaluate all expressions.
+    @param variableValues   getNumVariables() values, in order.
+    @param results          Receives getNumExpressions() values. */
+    void evaluate(const double* variableValues, double* results) const;
+
+    /** Evaluate the partial derivatives of all expressions with respect to
+    all variables. Requires that the evaluator was constructed with
+    withDerivatives.
+    @param variableValues   getNumVariables() values, in order.
+    @param derivatives      Receives getNumExpressions()*getNumVariables()
+                            values; the derivative of expression i with
+                            respect to variable j is at i*getNumVariables()+j.
+    */
+    void evaluateDerivatives(const double* variableValues,
+                             double* derivatives) const;
+
+private:
+    // Compiled expressions and the addresses of the variable slots in them.
+    struct Workspace {
+        std::vector<Lepton::CompiledExpression> expressions;
+        std::vector<double*> slots;
+        std::vector<int> slotVariables;
+        // The expressions a spare copy was made of; see _generation.
+        int generation;
+        Workspace() : generation(0) {}
+        void bind(const std::vector<std::string>& variableNames);
+        void evaluate(const double* variableValues, double* results) const;
+    };
+    typedef std::vector<std::unique_ptr<Workspace> > Spares;
+
+    // Evaluate workspace, or one of its spare copies if another thread is
+    // evaluating it.
+    void evaluateWorkspace(const Workspace& workspace, Spares& spares,
+                           const double* variableValues,
+                           double* results) const;
+    // Discard the spare copies, since the expressions changed. The caller
+    // holds _sparesMutex.
+    void clearSpares();
+
+//=============================================================================
+// DATA
+//=============================================================================
+    std::vector<std::string> _variableNames;
+    int _numExpressions;
+    bool _withDerivatives;
+    Workspace _values;
+    Workspace _derivatives;
+    // Held by the thread evaluating the compiled expressions.
+    mutable std::mutex _mutex;
+    // Spare copies of _values and _derivatives not in use, and the number
+    // of times the expressions changed, guarded by _sparesMutex.
+    mutable Spares _spareValues;
+    mutable Spares _spareDerivatives;
+    mutable int _generation;
+    mutable std::mutex _sparesMutex;
+
+//=============================================================================
+};  // END of class ExpressionEvaluator
+//=============================================================================
+//=============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_EXPRESSION_EVALUATOR_H_
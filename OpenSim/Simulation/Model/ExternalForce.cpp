@@ -30,6 +30,7 @@
 #include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/PiecewiseLinearFunction.h>
 #include <OpenSim/Common/GCVSpline.h>
+#include <algorithm>
 
 #include "ExternalForce.h"
 
@@ -98,6 +99,8 @@ void ExternalForce::setNull()
     _appliedToBody = NULL;
     _forceExpressedInBody = NULL;
     _pointExpressedInBody = NULL; 
+    _resampleInterval = -1.0;
+    _resampleStartTime = 0.0;
 }
 
 
@@ -304,6 +307,19 @@ void ExternalForce::extendConnectToModel(Model& model)
             }
         }
     }
+
+    // Resample the functions on a uniform grid within the data.
+    _resampledLoads.clear();
+    _resampledSlopes.clear();
+    if(_resampleInterval > 0 && nt > 1){
+        _resampleStartTime = time[0];
+        int n = (int)((time[nt-1] - time[0])/_resampleInterval) + 1;
+        _resampledLoads.resize(n);
+        _resampledSlopes.resize(n);
+        for(int k=0; k<n; ++k)
+            calcLoadFunctions(_resampleStartTime + k*_resampleInterval,
+                              _resampledLoads[k], &_resampledSlopes[k]);
+    }
 }
 
 
@@ -317,18 +333,18 @@ void ExternalForce::computeForce(const SimTK::State& state,
                               SimTK::Vector_<SimTK::SpatialVec>& bodyForces, 
                               SimTK::Vector& generalizedForces) const
 {
-    double time = state.getTime();
     const SimbodyEngine& engine = getModel().getSimbodyEngine();
 
     assert(_appliedToBody!=nullptr);
 
+    // Point defaults to the body origin.
+    Vec3 force, point, torque;
+    calcLoadsAtTime(state.getTime(), force, point, torque);
+
     if (_appliesForce) {
-        Vec3 force = getForceAtTime(time);
         engine.transform(state, *_forceExpressedInBody, force, 
                                 getModel().getGround(), force);
-        Vec3 point(0); // Default is body origin.
         if (_specifiesPoint) {
-            point = getPointAtTime(time);
             engine.transformPosition(state, *_pointExpressedInBody, point, 
                                             *_appliedToBody,        point);
         }
@@ -336,7 +352,6 @@ void ExternalForce::computeForce(const SimTK::State& state,
     }
 
     if (_appliesTorque) {
-        Vec3 torque = getTorqueAtTime(time);
         engine.transform(state, *_forceExpressedInBody, torque, 
                                 getModel().getGround(), torque);
         applyTorque(state, *_appliedToBody, torque, bodyForces);
@@ -348,47 +363,86 @@ void ExternalForce::computeForce(const SimTK::State& state,
  */
 Vec3 ExternalForce::getForceAtTime(double aTime) const  
 {
-    SimTK::Vector timeAsVector(1, aTime);
-    const Function* forceX=NULL;
-    const Function* forceY=NULL;
-    const Function* forceZ=NULL;
-    if (_forceFunctions.size()==3){
-        forceX=_forceFunctions[0];  forceY=_forceFunctions[1];  forceZ=_forceFunctions[2];
-    }
-    Vec3 force(forceX?forceX->calcValue(timeAsVector):0.0, 
-        forceY?forceY->calcValue(timeAsVector):0.0, 
-        forceZ?forceZ->calcValue(timeAsVector):0.0);
+    Vec3 force, point, torque;
+    calcLoadsAtTime(aTime, force, point, torque);
     return force;
 }
 
 Vec3 ExternalForce::getPointAtTime(double aTime) const
 {
-    SimTK::Vector timeAsVector(1, aTime);
-    const Function* pointX=NULL;
-    const Function* pointY=NULL;
-    const Function* pointZ=NULL;
-    if (_pointFunctions.size()==3){
-        pointX=_pointFunctions[0];  pointY=_pointFunctions[1];  pointZ=_pointFunctions[2];
-    }
-    Vec3 point(pointX?pointX->calcValue(timeAsVector):0.0, 
-        pointY?pointY->calcValue(timeAsVector):0.0, 
-        pointZ?pointZ->calcValue(timeAsVector):0.0);
+    Vec3 force, point, torque;
+    calcLoadsAtTime(aTime, force, point, torque);
     return point;
 }
 
 Vec3 ExternalForce::getTorqueAtTime(double aTime) const
 {
+    Vec3 force, point, torque;
+    calcLoadsAtTime(aTime, force, point, torque);
+    return torque;
+}
+
+/**
+ * Evaluate the force, point and torque together, from the resampled table
+ * if it covers aTime and from the functions otherwise.
+ */
+void ExternalForce::calcLoadsAtTime(double aTime, Vec3& force, Vec3& point,
+                                    Vec3& torque) const
+{
+    SimTK::Vec<9> loads;
+    if(!interpolateResampledLoads(aTime, loads))
+        calcLoadFunctions(aTime, loads);
+    force = loads.getSubVec<3>(0);
+    point = loads.getSubVec<3>(3);
+    torque = loads.getSubVec<3>(6);
+}
+
+void ExternalForce::calcLoadFunctions(double aTime, SimTK::Vec<9>& loads,
+                                      SimTK::Vec<9>* slopes) const
+{
+    static const std::vector<int> derivComponents(1, 0);
     SimTK::Vector timeAsVector(1, aTime);
-    const Function* torqueX=NULL;
-    const Function* torqueY=NULL;
-    const Function* torqueZ=NULL;
-    if (_torqueFunctions.size()==3){
-        torqueX=_torqueFunctions[0];    torqueY=_torqueFunctions[1];    torqueZ=_torqueFunctions[2];
+    const ArrayPtrs<Function>* functions[3] = 
+        {&_forceFunctions, &_pointFunctions, &_torqueFunctions};
+
+    loads = 0;
+    if(slopes) *slopes = 0;
+    for(int k=0; k<3; ++k){
+        const ArrayPtrs<Function>& f = *functions[k];
+        if(f.size() != 3)
+            continue;
+        for(int i=0; i<3; ++i){
+            loads[3*k+i] = f[i]->calcValue(timeAsVector);
+            if(slopes)
+                (*slopes)[3*k+i] = 
+                    f[i]->calcDerivative(derivComponents, timeAsVector);
+        }
     }
-    Vec3 torque(torqueX?torqueX->calcValue(timeAsVector):0.0, 
-        torqueY?torqueY->calcValue(timeAsVector):0.0, 
-        torqueZ?torqueZ->calcValue(timeAsVector):0.0);
-    return torque;
+}
+
+bool ExternalForce::
+interpolateResampledLoads(double aTime, SimTK::Vec<9>& loads) const
+{
+    const int n = (int)_resampledLoads.size();
+    if(n < 2)
+        return false;
+    const double s = (aTime - _resampleStartTime)/_resampleInterval;
+    if(!(s >= 0 && s <= n-1)) // also rejects NaN
+        return false;
+
+    // One interval lookup and one set of Hermite basis weights for all 9
+    // values.
+    const int k = std::min((int)s, n-2);
+    const double u = s - k;
+    const double u2 = u*u, u3 = u2*u;
+    const double h = _resampleInterval;
+    const double w00 = 2*u3 - 3*u2 + 1;
+    const double w10 = (u3 - 2*u2 + u)*h;
+    const double w01 = -2*u3 + 3*u2;
+    const double w11 = (u3 - u2)*h;
+    loads = w00*_resampledLoads[k]   + w10*_resampledSlopes[k]
+          + w01*_resampledLoads[k+1] + w11*_resampledSlopes[k+1];
+    return true;
 }
 
 
@@ -429,21 +483,21 @@ OpenSim::Array<double> ExternalForce::getRecordValues(const SimTK::State& state)
     OpenSim::Array<double>  values(SimTK::NaN);
     double time = state.getTime();
 
+    Vec3 force, point, torque;
+    calcLoadsAtTime(time, force, point, torque);
+
     if (_appliesForce) {
-        Vec3 force = getForceAtTime(time);
         engine.transform(state, *_forceExpressedInBody, force, getModel().getGround(), force);
         for(int i=0; i<3; ++i)
             values.append(force[i]);
     
         if (_specifiesPoint) {
-            Vec3 point = getPointAtTime(time);
             engine.transformPosition(state, *_pointExpressedInBody, point, *_appliedToBody, point);
             for(int i=0; i<3; ++i)
                 values.append(point[i]);
         }
     }
     if (_appliesTorque){
-        Vec3 torque = getTorqueAtTime(time);
         engine.transform(state, *_forceExpressedInBody, torque, getModel().getGround(), torque);
         for(int i=0; i<3; ++i)
             values.append(torque[i]);
@@ -169,6 +169,25 @@ public:
     SimTK::Vec3 getForceAtTime(double aTime) const;
     SimTK::Vec3 getPointAtTime(double aTime) const;
     SimTK::Vec3 getTorqueAtTime(double aTime) const;
+    /**
+     * Compute the force, point and torque at a given time together. Those
+     * that are not applied by this ExternalForce are zero.
+     */
+    void calcLoadsAtTime(double aTime, SimTK::Vec3& force, SimTK::Vec3& point,
+                         SimTK::Vec3& torque) const;
+
+    /**
+     * Evaluate the force, point and torque from a table of the data
+     * resampled at uniform intervals, which is built when the force is
+     * connected to the model. Between table entries, the values are
+     * interpolated with cubic Hermite polynomials from the values and slopes
+     * of the functions fit to the data, so the interval should be a fraction
+     * of the sampling interval of the data. Times outside the table are
+     * evaluated from the functions. A value <= 0 (the default) disables
+     * resampling.
+     */
+    void setResampleInterval(double interval) { _resampleInterval = interval; }
+    double getResampleInterval() const { return _resampleInterval; }
 
     /**
      * Methods used for reporting.
@@ -224,6 +243,13 @@ private:
     void setNull();
     void constructProperties();
 
+    // Evaluate the force, point and torque functions (and optionally their
+    // slopes) at aTime, as 9 values.
+    void calcLoadFunctions(double aTime, SimTK::Vec<9>& loads,
+                           SimTK::Vec<9>* slopes = nullptr) const;
+    // Interpolate the resampled table; false if aTime is not covered by it.
+    bool interpolateResampledLoads(double aTime, SimTK::Vec<9>& loads) const;
+
 
 //==============================================================================
 // DATA
@@ -253,6 +279,13 @@ private:
     ArrayPtrs<Function> _torqueFunctions;
     ArrayPtrs<Function> _pointFunctions;
 
+    /** force, point and torque resampled at _resampleInterval from
+        _resampleStartTime, and their slopes */
+    double _resampleInterval;
+    double _resampleStartTime;
+    std::vector<SimTK::Vec<9> > _resampledLoads;
+    std::vector<SimTK::Vec<9> > _resampledSlopes;
+
     friend class ExternalLoads;
 //==============================================================================
 };  // END of class ExternalForce
@@ -54,7 +54,8 @@ ExternalLoads::~ExternalLoads()
 ExternalLoads::ExternalLoads():
 _dataFileName(_dataFileNameProp.getValueStr()),
 _externalLoadsModelKinematicsFileName(_externalLoadsModelKinematicsFileNameProp.getValueStr()),
-_lowpassCutoffFrequencyForLoadKinematics(_lowpassCutoffFrequencyForLoadKinematicsProp.getValueDbl())
+_lowpassCutoffFrequencyForLoadKinematics(_lowpassCutoffFrequencyForLoadKinematicsProp.getValueDbl()),
+_resampleInterval(_resampleIntervalProp.getValueDbl())
 {
     setNull();
 }
@@ -63,7 +64,8 @@ ExternalLoads::ExternalLoads(Model& model) :
     ModelComponentSet<ExternalForce>(model),
     _dataFileName(_dataFileNameProp.getValueStr()),
     _externalLoadsModelKinematicsFileName(_externalLoadsModelKinematicsFileNameProp.getValueStr()),
-    _lowpassCutoffFrequencyForLoadKinematics(_lowpassCutoffFrequencyForLoadKinematicsProp.getValueDbl())
+    _lowpassCutoffFrequencyForLoadKinematics(_lowpassCutoffFrequencyForLoadKinematicsProp.getValueDbl()),
+    _resampleInterval(_resampleIntervalProp.getValueDbl())
 {
     setNull();
 }
@@ -78,7 +80,8 @@ ExternalLoads::ExternalLoads(Model& model, const std::string &aFileName, bool aU
     ModelComponentSet<ExternalForce>(model, aFileName, false),
     _dataFileName(_dataFileNameProp.getValueStr()),
     _externalLoadsModelKinematicsFileName(_externalLoadsModelKinematicsFileNameProp.getValueStr()),
-    _lowpassCutoffFrequencyForLoadKinematics(_lowpassCutoffFrequencyForLoadKinematicsProp.getValueDbl())
+    _lowpassCutoffFrequencyForLoadKinematics(_lowpassCutoffFrequencyForLoadKinematicsProp.getValueDbl()),
+    _resampleInterval(_resampleIntervalProp.getValueDbl())
 {
     setNull();
 
@@ -97,7 +100,8 @@ ExternalLoads::ExternalLoads(const ExternalLoads &otherExternalLoads) :
     ModelComponentSet<ExternalForce>(otherExternalLoads),
     _dataFileName(_dataFileNameProp.getValueStr()),
     _externalLoadsModelKinematicsFileName(_externalLoadsModelKinematicsFileNameProp.getValueStr()),
-    _lowpassCutoffFrequencyForLoadKinematics(_lowpassCutoffFrequencyForLoadKinematicsProp.getValueDbl())
+    _lowpassCutoffFrequencyForLoadKinematics(_lowpassCutoffFrequencyForLoadKinematicsProp.getValueDbl()),
+    _resampleInterval(_resampleIntervalProp.getValueDbl())
 {
     setNull();
 
@@ -134,6 +138,7 @@ void ExternalLoads::copyData(const ExternalLoads &aAbsExternalLoads)
     _dataFileName = aAbsExternalLoads._dataFileName;
     _externalLoadsModelKinematicsFileName = aAbsExternalLoads._externalLoadsModelKinematicsFileName;
     _lowpassCutoffFrequencyForLoadKinematics = aAbsExternalLoads._lowpassCutoffFrequencyForLoadKinematics;
+    _resampleInterval = aAbsExternalLoads._resampleInterval;
 }
 
 //_____________________________________________________________________________
@@ -165,6 +170,16 @@ void ExternalLoads::setupSerializedMembers()
     _lowpassCutoffFrequencyForLoadKinematicsProp.setComment(comment);
     _lowpassCutoffFrequencyForLoadKinematicsProp.setName("lowpass_cutoff_frequency_for_load_kinematics");
     _propertySet.append( &_lowpassCutoffFrequencyForLoadKinematicsProp );
+
+    _resampleInterval=-1.0;
+    comment = "Optional interval (s) at which the data of all external forces is resampled, "
+              "when they are connected to the model, into a table that is interpolated during "
+              "the simulation instead of evaluating the splines through the data. It should be "
+              "a fraction of the sampling interval of the data. A value <= 0 results in no "
+              "resampling. The default value is -1.0, so no resampling.";
+    _resampleIntervalProp.setComment(comment);
+    _resampleIntervalProp.setName("resample_interval");
+    _propertySet.append( &_resampleIntervalProp );
 }
 
 
@@ -192,8 +207,12 @@ void ExternalLoads::invokeConnectToModel(Model& aModel)
 {
     Storage *forceData = new Storage(_dataFileName);
 
-    for(int i=0; i<getSize(); ++i)
+    // All forces share the data source, so they are resampled on the same
+    // time grid.
+    for(int i=0; i<getSize(); ++i) {
         get(i).setDataSource(*forceData);
+        get(i).setResampleInterval(_resampleInterval);
+    }
 
     // BASE CLASS
     Super::invokeConnectToModel(aModel);
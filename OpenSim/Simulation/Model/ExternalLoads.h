@@ -79,6 +79,11 @@ protected:
     The default value is -1.0, so no filtering. */
     PropertyDbl _lowpassCutoffFrequencyForLoadKinematicsProp;
     double &_lowpassCutoffFrequencyForLoadKinematics;
+    /** Interval at which the data of the external forces is resampled for
+    evaluation during a simulation (see ExternalForce::setResampleInterval()).
+    The default value is -1.0, so no resampling. */
+    PropertyDbl _resampleIntervalProp;
+    double &_resampleInterval;
 
 private:
     /* If point of applications for external forces must be re-expressed
@@ -115,6 +120,8 @@ public:
     void setExternalLoadsModelKinematicsFileName(const std::string &aFileName) { _externalLoadsModelKinematicsFileName = aFileName; }
     double getLowpassCutoffFrequencyForLoadKinematics() const { return _lowpassCutoffFrequencyForLoadKinematics; }
     void setLowpassCutoffFrequencyForLoadKinematics(double aLowpassCutoffFrequency) { _lowpassCutoffFrequencyForLoadKinematics = aLowpassCutoffFrequency; }
+    double getResampleInterval() const { return _resampleInterval; }
+    void setResampleInterval(double aResampleInterval) { _resampleInterval = aResampleInterval; }
 
     void transformPointsExpressedInGroundToAppliedBodies(const Storage &kinematics, double startTime = -SimTK::Infinity, double endTime = SimTK::Infinity);
     ExternalForce* transformPointExpressedInGroundToAppliedBody(const ExternalForce &exForce, const Storage &kinematics, double startTime, double endTime);
@@ -72,6 +72,8 @@ void Force::copyData(const Force& source)
     // system must be created, at which time the Force will be assigned an index
     // corresponding to a valid system SimTK::Force.
     _index.invalidate();
+    _adapter = NULL;
+    _adapterIndex.invalidate();
 }
 
 //_____________________________________________________________________________
@@ -79,6 +81,7 @@ void Force::copyData(const Force& source)
 void Force::setNull()
 {
     setAuthors("Peter Eastman, Ajay Seth");
+    _adapter = NULL;
 }
 
 //_____________________________________________________________________________
@@ -100,6 +103,8 @@ void Force::extendAddToSystem(SimTK::MultibodySystem& system) const
      // Beyond the const Component get the index so we can access the SimTK::Force later
     Force* mutableThis = const_cast<Force *>(this);
     mutableThis->_index = force.getForceIndex();
+    mutableThis->_adapter = adapter;
+    mutableThis->_adapterIndex = _index;
 }
 
 
@@ -153,6 +158,26 @@ bool Force::isDisabled(const SimTK::State& s) const
     return get_isDisabled();
 }
 
+void Force::calcForceContribution(const SimTK::State& s,
+                                  Vector_<SpatialVec>& bodyForces,
+                                  Vector& generalizedForces) const
+{
+    // A deferred adapter applies nothing, so compute the Force directly.
+    if (_adapter && _adapter->isDeferred() && _index == _adapterIndex) {
+        bodyForces.resize(_model->getMatterSubsystem().getNumBodies());
+        generalizedForces.resize(s.getNU());
+        bodyForces.setToZero();
+        generalizedForces.setToZero();
+        if (!isDisabled(s))
+            computeForce(s, bodyForces, generalizedForces);
+        return;
+    }
+    SimTK::Vector_<SimTK::Vec3> particleForces(0);
+    _model->getForceSubsystem().getForce(_index)
+        .calcForceContribution(s, bodyForces, particleForces,
+                               generalizedForces);
+}
+
 //-----------------------------------------------------------------------------
 // ABSTRACT METHODS
 //-----------------------------------------------------------------------------
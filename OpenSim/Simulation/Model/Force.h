@@ -90,6 +90,16 @@ public:
     /** Set the Force as disabled (true) or not (false). */
     void setDisabled(SimTK::State& s, bool disabled) const;
 
+    /** Compute the body and generalized forces that this Force alone would
+    apply to the system in the given state, without realizing the system to
+    Dynamics (so no other Force is evaluated). The state must be realized to
+    the stage this Force requires, typically Stage::Velocity. The output
+    vectors are resized and zeroed before the contribution is added. A
+    disabled Force contributes nothing. */
+    void calcForceContribution(const SimTK::State& s,
+                               SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                               SimTK::Vector& generalizedForces) const;
+
     /**
      * Methods to query a Force for the value actually applied during 
      * simulation. The names of the quantities (column labels) is returned by 
@@ -230,7 +240,15 @@ private:
     void constructProperties();
     void copyData(const Force &aForce);
 
+    // The ForceAdapter through which Simbody calls computeForce(), and the
+    // index of its SimTK::Force. A subclass that represents the Force with
+    // another SimTK::Force replaces _index, leaving the adapter unused.
+    ForceAdapter*       _adapter;
+    SimTK::ForceIndex   _adapterIndex;
+
     friend class ForceAdapter;
+    friend class ParallelForceAdapter;
+    friend class ForceSet;
 
 //=============================================================================
 };  // END of class Force
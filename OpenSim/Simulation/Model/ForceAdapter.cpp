@@ -25,6 +25,7 @@
 // INCLUDES
 //=============================================================================
 #include "ForceAdapter.h"
+#include <OpenSim/Common/ComponentProfiler.h>
 
 //=============================================================================
 // STATICS
@@ -35,7 +36,8 @@ using SimTK::Vec3;
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
-ForceAdapter::ForceAdapter(const Force& force) : _force(&force)
+ForceAdapter::ForceAdapter(const Force& force) :
+    _force(&force), _deferred(false)
 {
 }
 
@@ -46,6 +48,8 @@ void ForceAdapter::calcForce(const SimTK::State& state,
     SimTK::Vector_<SimTK::SpatialVec>& bodyForces,SimTK::Vector_<SimTK::Vec3>& particleForces,
     SimTK::Vector& mobilityForces) const
 {
+    if (_deferred) return;
+    OPENSIM_PROFILE_SCOPE(*_force, "computeForce");
     _force->computeForce(state, bodyForces, mobilityForces);
 }
 
@@ -46,6 +46,7 @@ class OSIMSIMULATION_API ForceAdapter : public SimTK::Force::Custom::Implementat
 //=============================================================================
 private:
     const Force* _force;
+    bool _deferred;
 
 //=============================================================================
 // METHODS
@@ -54,6 +55,11 @@ public:
     // CONSTRUCTION AND DESTRUCTION
     ForceAdapter(const Force& force);
 
+    /** A deferred adapter does not apply its Force in calcForce(); the
+    ParallelForceAdapter of the ForceSet applies it instead. */
+    void setDeferred(bool deferred) { _deferred = deferred; }
+    bool isDeferred() const { return _deferred; }
+
     // CALC FORCES (Called by Simbody)
     void calcForce(const SimTK::State& state,
         SimTK::Vector_<SimTK::SpatialVec>& bodyForces,SimTK::Vector_<SimTK::Vec3>& particleForces,
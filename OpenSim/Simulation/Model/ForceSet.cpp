@@ -30,6 +30,10 @@
 #include "ForceSet.h"
 #include "Model.h"
 #include "Muscle.h"
+#include "MuscleBatch.h"
+#include "ForceAdapter.h"
+#include "GeometryPath.h"
+#include "ParallelForceAdapter.h"
 #include "SimTKsimbody.h"
 
 using namespace std;
@@ -51,6 +55,7 @@ template class OSIMSIMULATION_API ModelComponentSet<Force>;
  */
 ForceSet::~ForceSet()
 {
+    clearMuscleBatches();
 }
 //_____________________________________________________________________________
 /**
@@ -93,6 +98,9 @@ ForceSet::ForceSet(const ForceSet &aForceSet) :
     ModelComponentSet<Force>(aForceSet)
 {
     setNull();
+    _useBatchedMuscleEvaluation = aForceSet._useBatchedMuscleEvaluation;
+    _useParallelEvaluation = aForceSet._useParallelEvaluation;
+    _numParallelThreads = aForceSet._numParallelThreads;
 
 }
 
@@ -113,6 +121,11 @@ void ForceSet::setNull()
     _actuators.setMemoryOwner(false);
 
     _muscles.setMemoryOwner(false);
+
+    _useBatchedMuscleEvaluation = false;
+    _useParallelEvaluation = false;
+    _numParallelThreads = 0;
+    _numParallelChunks = 0;
 }
 
 //_____________________________________________________________________________
@@ -146,6 +159,10 @@ ForceSet& ForceSet::operator=(const ForceSet &aAbsForceSet)
     // BASE CLASS
     Set<Force>::operator=(aAbsForceSet);
 
+    _useBatchedMuscleEvaluation = aAbsForceSet._useBatchedMuscleEvaluation;
+    _useParallelEvaluation = aAbsForceSet._useParallelEvaluation;
+    _numParallelThreads = aAbsForceSet._numParallelThreads;
+
     return(*this);
 }
 
@@ -353,6 +370,128 @@ void ForceSet::updateMuscles()
     }
 }
 
+//=============================================================================
+// BATCHED MUSCLE EVALUATION
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Create a MuscleBatch for the muscles of each class that provides one, and
+ * point each of those muscles to its batch.
+ */
+void ForceSet::updateMuscleBatches()
+{
+    updateMuscles();
+    for (int i = 0; i < _muscles.getSize(); ++i)
+        _muscles[i]._batch = nullptr;
+    clearMuscleBatches();
+    if (!_useBatchedMuscleEvaluation)
+        return;
+
+    // Group the muscles by class, in the order the classes first appear.
+    std::vector<std::string> classNames;
+    std::vector< std::vector<const Muscle*> > groups;
+    for (int i = 0; i < _muscles.getSize(); ++i) {
+        const std::string& className = _muscles[i].getConcreteClassName();
+        size_t g = std::find(classNames.begin(), classNames.end(), className)
+                   - classNames.begin();
+        if (g == classNames.size()) {
+            classNames.push_back(className);
+            groups.push_back(std::vector<const Muscle*>());
+        }
+        groups[g].push_back(&_muscles[i]);
+    }
+
+    for (size_t g = 0; g < groups.size(); ++g) {
+        MuscleBatch* batch = groups[g][0]->createMuscleBatch(groups[g]);
+        if (batch == NULL) continue;
+        _muscleBatches.push_back(batch);
+        for (size_t i = 0; i < groups[g].size(); ++i)
+            const_cast<Muscle*>(groups[g][i])->_batch = batch;
+    }
+}
+
+void ForceSet::clearMuscleBatches()
+{
+    for (size_t i = 0; i < _muscleBatches.size(); ++i)
+        delete _muscleBatches[i];
+    _muscleBatches.clear();
+}
+
+//=============================================================================
+// PARALLEL EVALUATION
+//=============================================================================
+// Estimated costs of evaluating a Force, in units of about a tenth of a
+// microsecond: a Force costs one unit, plus one per path point and ten per
+// wrap object of its paths, plus a few for a muscle's equilibrium. A chunk
+// must cost enough to pay for handing it to another thread.
+static const double WrapObjectCost = 10;
+static const double MuscleCost = 4;
+static const double MinimumChunkCost = 64;
+static const int MaximumNumChunks = 64;
+
+//_____________________________________________________________________________
+/**
+ * Divide the Forces evaluated through their ForceAdapters into chunks of
+ * about the same cost, and defer their adapters to a ParallelForceAdapter
+ * that evaluates the chunks on several threads.
+ */
+void ForceSet::updateParallelEvaluation(SimTK::GeneralForceSubsystem& forces)
+{
+    _numParallelChunks = 0;
+    if (!_useParallelEvaluation)
+        return;
+
+    std::vector<ParallelForceAdapter::Element> elements;
+    std::vector<double> costs;
+    double totalCost = 0;
+    for (int i = 0; i < getSize(); ++i) {
+        const Force& force = get(i);
+        if (force._adapter == NULL || force._index != force._adapterIndex)
+            continue;
+        ParallelForceAdapter::Element element = { &force, force._index, NULL };
+        double cost = 1;
+        for (const GeometryPath& path : force.getComponentList<GeometryPath>())
+            cost += path.getPathPointSet().getSize()
+                    + WrapObjectCost*path.getWrapSet().getSize();
+        if (const Muscle* muscle = dynamic_cast<const Muscle*>(&force)) {
+            cost += MuscleCost;
+            if (muscle->_batch)
+                element.batchedPath = &muscle->getGeometryPath();
+        }
+        elements.push_back(element);
+        costs.push_back(cost);
+        totalCost += cost;
+    }
+
+    // The chunks depend only on the Forces, not on the number of threads,
+    // so that the sums are the same for any number of threads.
+    const int numChunks = std::min(MaximumNumChunks,
+                                   (int)(totalCost/MinimumChunkCost));
+    if (numChunks < 2)
+        return;
+    std::vector<int> chunkEnds;
+    double cost = 0;
+    for (size_t i = 0; i < elements.size(); ++i) {
+        cost += costs[i];
+        if (cost >= totalCost*(chunkEnds.size()+1)/numChunks)
+            chunkEnds.push_back((int)i+1);
+    }
+    if (chunkEnds.empty() || chunkEnds.back() != (int)elements.size())
+        chunkEnds.push_back((int)elements.size());
+
+    int numThreads = _numParallelThreads;
+    if (numThreads <= 0)
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<const MuscleBatch*> batches(_muscleBatches.begin(),
+                                            _muscleBatches.end());
+    ParallelForceAdapter* adapter = new ParallelForceAdapter(forces, elements,
+                                        chunkEnds, batches, numThreads);
+    SimTK::Force::Custom(forces, adapter);
+    for (size_t i = 0; i < elements.size(); ++i)
+        elements[i].force->_adapter->setDeferred(true);
+    _numParallelChunks = adapter->getNumChunks();
+}
+
 //=============================================================================
 // COMPUTATIONS
 //=============================================================================
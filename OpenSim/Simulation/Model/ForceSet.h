@@ -28,12 +28,14 @@
 #include "Force.h"
 #include "Muscle.h"
 #include "ModelComponentSet.h"
+#include <vector>
 
 namespace OpenSim {
 
 class Model;
 class ScalarActuator;
 class Muscle;
+class MuscleBatch;
 
 //=============================================================================
 //=============================================================================
@@ -60,6 +62,17 @@ protected:
     /** The subset of Forces that are Muscles. */
     Set<Muscle> _muscles;
 
+    /** Whether the muscles of a class are evaluated together, by a
+        MuscleBatch per class, and the batches. */
+    bool _useBatchedMuscleEvaluation;
+    std::vector<MuscleBatch*> _muscleBatches;
+
+    /** Whether the Forces are evaluated on several threads, on how many, and
+        the number of chunks they were divided into. */
+    bool _useParallelEvaluation;
+    int _numParallelThreads;
+    int _numParallelChunks;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -78,6 +91,7 @@ private:
     void setupSerializedMembers();
     void updateActuators();
     void updateMuscles();
+    void clearMuscleBatches();
 
     //--------------------------------------------------------------------------
     // OPERATORS
@@ -112,6 +126,50 @@ public:
     // STATES
     void getStateVariableNames(Array<std::string> &rNames) const;
 
+    // BATCHED MUSCLE EVALUATION
+    /** Compute the length, velocity and dynamics info of all the muscles of
+    a class together, with the MuscleBatch the class provides (see
+    Muscle::createMuscleBatch()), rather than one muscle at a time. Muscles
+    of classes without a batch are evaluated as before. The results are
+    identical either way. It takes effect at the next call to
+    Model::initSystem(). The default is off. */
+    void setUseBatchedMuscleEvaluation(bool batched)
+    {   _useBatchedMuscleEvaluation = batched; }
+    bool getUseBatchedMuscleEvaluation() const
+    {   return _useBatchedMuscleEvaluation; }
+    /** The number of batches created by the last call to Model::initSystem(),
+    one per class of muscle that provides one. */
+    int getNumMuscleBatches() const { return (int)_muscleBatches.size(); }
+    /** Create a batch for the muscles of each class that provides one, or
+    remove the batches if batched evaluation is off. The Model calls this when
+    it builds its System. */
+    void updateMuscleBatches();
+
+    // PARALLEL EVALUATION
+    /** Evaluate the Forces of this set on several threads rather than one
+    after the other. The Forces are divided, in order, into chunks of similar
+    estimated cost; each chunk is summed on its own and the sums are added in
+    order, so the results are the same from run to run and for any number of
+    threads, but can differ from serial evaluation in the last bits. The
+    Forces must be safe to evaluate at once on one State, as the shipped ones
+    are. Forces that a native SimTK::Force represents (e.g.,
+    ElasticFoundationForce, HuntCrossleyForce) are still evaluated by Simbody,
+    and a set whose Forces are too few or too cheap to be worth dividing is
+    evaluated as before. numThreads counts the calling thread; 0 for one per
+    processor. It takes effect at the next call to Model::initSystem(). The
+    default is off. */
+    void setUseParallelEvaluation(bool parallel, int numThreads = 0)
+    {   _useParallelEvaluation = parallel; _numParallelThreads = numThreads; }
+    bool getUseParallelEvaluation() const { return _useParallelEvaluation; }
+    int getNumParallelThreads() const { return _numParallelThreads; }
+    /** The number of chunks the Forces were divided into by the last call to
+    Model::initSystem(), or 0 if they are evaluated one at a time. */
+    int getNumParallelChunks() const { return _numParallelChunks; }
+    /** Hand the evaluation of the Forces to a ParallelForceAdapter added to
+    forces, if parallel evaluation is on and worthwhile. The Model calls this
+    once its Forces have been added to its System. */
+    void updateParallelEvaluation(SimTK::GeneralForceSubsystem& forces);
+
 
     //--------------------------------------------------------------------------
     // CHECK
@@ -38,6 +38,7 @@
 #include "Model.h"
 
 #include "ModelVisualizer.h"
+#include <OpenSim/Common/ComponentProfiler.h>
 //=============================================================================
 // STATICS
 //=============================================================================
@@ -102,26 +103,39 @@ void GeometryPath::extendConnectToModel(Model& aModel)
     // Allocate cache entries to save the current length and speed(=d/dt length)
     // of the path in the cache. Length depends only on q's so will be valid
     // after Position stage, speed requires u's also so valid at Velocity stage.
-    addCacheVariable<double>("length", 0.0, SimTK::Stage::Position);
-    addCacheVariable<double>("speed", 0.0, SimTK::Stage::Velocity);
-    // Cache the set of points currently defining this path.
-    Array<PathPoint *> pathPrototype;
-    addCacheVariable<Array<PathPoint *> >
+    _lengthCV = addCacheVariable<double>("length", 0.0, SimTK::Stage::Position);
+    _speedCV = addCacheVariable<double>("speed", 0.0, SimTK::Stage::Velocity);
+    // Cache the set of points currently defining this path. To evaluate the
+    // Model on several threads, each State gets its own copies of the moving
+    // points and the wrapping, which change with the State.
+    CurrentPath pathPrototype;
+    if (getModel().getUseThreadSafeEvaluation()) {
+        for (int i = 0; i < get_PathPointSet().getSize(); i++) {
+            const PathPoint& point = get_PathPointSet()[i];
+            pathPrototype.pathPoints.push_back(
+                dynamic_cast<const MovingPathPoint*>(&point) ? point.clone()
+                                                             : nullptr);
+        }
+        for (int i = 0; i < get_PathWrapSet().getSize(); i++)
+            pathPrototype.pathWraps.push_back(get_PathWrapSet()[i].clone());
+    }
+    _currentPathCV = addCacheVariable<CurrentPath>
         ("current_path", pathPrototype, SimTK::Stage::Position);
     // When displaying, cache the set of points to be used to draw the path.
-    addCacheVariable<Array<PathPoint *> >
-        ("current_display_path", pathPrototype, SimTK::Stage::Position);
+    Array<PathPoint *> displayPathPrototype;
+    _currentDisplayPathCV = addCacheVariable<Array<PathPoint *> >
+        ("current_display_path", displayPathPrototype, SimTK::Stage::Position);
 
     // We consider this cache entry valid any time after it has been created
     // and first marked valid, and we won't ever invalidate it.
-    addCacheVariable<SimTK::Vec3>("color", get_default_color(), 
-                                  SimTK::Stage::Topology);
+    _colorCV = addCacheVariable<SimTK::Vec3>("color", get_default_color(), 
+                                             SimTK::Stage::Topology);
 }
 
  void GeometryPath::extendInitStateFromProperties(SimTK::State& s) const
 {
     Super::extendInitStateFromProperties(s);
-    markCacheVariableValid(s, "color"); // it is OK at its default value
+    markCacheVariableValid(s, _colorCV); // it is OK at its default value
 }
 
 //------------------------------------------------------------------------------
@@ -228,7 +242,7 @@ const OpenSim::Array <PathPoint*> & GeometryPath::
 getCurrentPath(const SimTK::State& s)  const
 {
     computePath(s);   // compute checks if path needs to be recomputed
-    return getCacheVariableValue< Array<PathPoint*> >(s, "current_path");
+    return getCacheVariableValue(s, _currentPathCV).points;
 }
 
 // get the the path as PointForceDirections directions 
@@ -411,7 +425,7 @@ getCurrentDisplayPath(const SimTK::State& s) const
 {
     // update the geometry to make sure the current display path is up to date.
     // updateGeometry(s);
-    return getCacheVariableValue<Array <PathPoint*> >(s, "current_display_path" );
+    return getCacheVariableValue(s, _currentDisplayPathCV);
 }
 
 //_____________________________________________________________________________
@@ -428,7 +442,7 @@ void GeometryPath::updateGeometry(const SimTK::State& s) const
     computePath(s);
 
     // If display path is current do not need to recompute it.
-    if (isCacheVariableValid(s, "current_display_path"))
+    if (isCacheVariableValid(s, _currentDisplayPathCV))
         return;
    
     // Updating the display path will also validate the current_display_path 
@@ -451,22 +465,22 @@ void GeometryPath::updateGeometry(const SimTK::State& s) const
 double GeometryPath::getLength( const SimTK::State& s) const
 {
     computePath(s);  // compute checks if path needs to be recomputed
-    return( getCacheVariableValue<double>(s, "length") );
+    return( getCacheVariableValue(s, _lengthCV) );
 }
 
 void GeometryPath::setLength( const SimTK::State& s, double length ) const
 {
-    setCacheVariableValue<double>(s, "length", length); 
+    setCacheVariableValue(s, _lengthCV, length); 
 }
 
 void GeometryPath::setColor(const SimTK::State& s, const SimTK::Vec3& color) const
 {
-    setCacheVariableValue<SimTK::Vec3>(s, "color", color);
+    setCacheVariableValue(s, _colorCV, color);
 }
 
 Vec3 GeometryPath::getColor(const SimTK::State& s) const
 {
-    return getCacheVariableValue<SimTK::Vec3>(s, "color");
+    return getCacheVariableValue(s, _colorCV);
 }
 
 //_____________________________________________________________________________
@@ -478,11 +492,11 @@ Vec3 GeometryPath::getColor(const SimTK::State& s) const
 double GeometryPath::getLengtheningSpeed( const SimTK::State& s) const
 {
     computeLengtheningSpeed(s);
-    return getCacheVariableValue<double>(s, "speed");
+    return getCacheVariableValue(s, _speedCV);
 }
 void GeometryPath::setLengtheningSpeed( const SimTK::State& s, double speed ) const
 {
-    setCacheVariableValue<double>(s, "speed", speed);    
+    setCacheVariableValue(s, _speedCV, speed);    
 }
 
 void GeometryPath::setPreScaleLength( const SimTK::State& s, double length ) {
@@ -847,6 +861,66 @@ void GeometryPath::postScale(const SimTK::State& s, const ScaleSet& aScaleSet)
 //=============================================================================
 // PATH, WRAPPING, AND MOMENT ARM
 //=============================================================================
+//_____________________________________________________________________________
+/*
+ * Replace the entries of path that refer to point with replacement.
+ */
+static void redirectPathPoint(Array<PathPoint*>& path, const PathPoint* point,
+                             PathPoint* replacement)
+{
+    for (int i = 0; i < path.getSize(); i++)
+        if (path[i] == point)
+            path[i] = replacement;
+}
+
+GeometryPath::CurrentPath::CurrentPath(const CurrentPath& other)
+{
+    *this = other;
+}
+
+GeometryPath::CurrentPath::~CurrentPath()
+{
+    for (size_t i = 0; i < pathPoints.size(); i++)
+        delete pathPoints[i];
+    for (size_t i = 0; i < pathWraps.size(); i++)
+        delete pathWraps[i];
+}
+
+//_____________________________________________________________________________
+/*
+ * Copy the path, along with the points and wraps it owns. The copied path
+ * refers to the copied points rather than to those of other.
+ */
+GeometryPath::CurrentPath&
+GeometryPath::CurrentPath::operator=(const CurrentPath& other)
+{
+    if (&other == this)
+        return *this;
+
+    for (size_t i = 0; i < pathPoints.size(); i++)
+        delete pathPoints[i];
+    for (size_t i = 0; i < pathWraps.size(); i++)
+        delete pathWraps[i];
+    pathPoints.clear();
+    pathWraps.clear();
+
+    points = other.points;
+    for (size_t i = 0; i < other.pathPoints.size(); i++) {
+        PathPoint* point = other.pathPoints[i];
+        pathPoints.push_back(point ? point->clone() : nullptr);
+        if (point)
+            redirectPathPoint(points, point, pathPoints.back());
+    }
+    for (size_t i = 0; i < other.pathWraps.size(); i++) {
+        PathWrap* wrap = other.pathWraps[i];
+        pathWraps.push_back(wrap->clone());
+        for (int j = 0; j < 2; j++)
+            redirectPathPoint(points, &wrap->getWrapPoint(j),
+                             &pathWraps.back()->getWrapPoint(j));
+    }
+    return *this;
+}
+
 //_____________________________________________________________________________
 /*
  * Calculate the current path.
@@ -855,36 +929,34 @@ void GeometryPath::computePath(const SimTK::State& s) const
 {
     const SimTK::Stage& sg = s.getSystemStage();
     
-    if (isCacheVariableValid(s, "current_path"))  {
+    if (isCacheVariableValid(s, _currentPathCV))  {
         return;
     }
+    // Profile the path under the Force that owns it, if any.
+    OPENSIM_PROFILE_SCOPE(getOwner() ? *getOwner() : *this,
+                          "GeometryPath::computePath");
 
     // Clear the current path.
-    Array<PathPoint*>& currentPath = 
-        updCacheVariableValue<Array<PathPoint*> >(s, "current_path");
-    currentPath.setSize(0);
-
-    // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-    // TODO: This is a bug. Here we are going to modify moving path point
-    // locations *in the property* which means they are out of sync with 
-    // the supplied state. These updates should be done in the state cache.
-    GeometryPath * mutableThis = const_cast<GeometryPath*>(this);
+    CurrentPath& currentPath = updCacheVariableValue(s, _currentPathCV);
+    currentPath.points.setSize(0);
 
-    // Add the active fixed and moving via points to the path.
+    // Add the active fixed and moving via points to the path. Unless the
+    // State has its own copies of the moving points, their locations are
+    // updated in the PathPointSet property, which is then out of sync with
+    // any other State.
     for (int i = 0; i < get_PathPointSet().getSize(); i++) {
-        // If this is a moving path point, update its location *in the
-        // PathPointSet property* (BAD).
-        mutableThis->upd_PathPointSet()[i].update(s);
-        if (get_PathPointSet()[i].isActive(s))
-            currentPath.append(&get_PathPointSet()[i]); // <--- !!!!BAD
+        PathPoint& point = updPathPoint(currentPath, i);
+        point.update(s);
+        if (point.isActive(s))
+            currentPath.points.append(&point);
     }
   
     // Use the current path so far to check for intersection with wrap objects, 
     // which may add additional points to the path.
     applyWrapObjects(s, currentPath);
-    calcLengthAfterPathComputation(s, currentPath);
+    calcLengthAfterPathComputation(s, currentPath.points);
 
-    markCacheVariableValid(s, "current_path");
+    markCacheVariableValid(s, _currentPathCV);
 }
 
 //_____________________________________________________________________________
@@ -893,7 +965,7 @@ void GeometryPath::computePath(const SimTK::State& s) const
  */
 void GeometryPath::computeLengtheningSpeed(const SimTK::State& s) const
 {
-    if (isCacheVariableValid(s, "speed"))
+    if (isCacheVariableValid(s, _speedCV))
         return;
 
     SimTK::Vec3 posRelative, velRelative;
@@ -954,15 +1026,41 @@ void GeometryPath::computeLengtheningSpeed(const SimTK::State& s) const
     setLengtheningSpeed(s, speed);
 }
 
+//_____________________________________________________________________________
+/*
+ * Get the point of the PathPointSet, or its copy in the current path if the
+ * State has its own copies of the moving points.
+ */
+PathPoint& GeometryPath::updPathPoint(CurrentPath& path, int i) const
+{
+    if (i < (int)path.pathPoints.size() && path.pathPoints[i])
+        return *path.pathPoints[i];
+    return get_PathPointSet()[i];
+}
+
+//_____________________________________________________________________________
+/*
+ * Get the PathWrap of the PathWrapSet, or its copy in the current path.
+ */
+PathWrap& GeometryPath::updPathWrap(CurrentPath& path, int i) const
+{
+    if (i < (int)path.pathWraps.size())
+        return *path.pathWraps[i];
+    return get_PathWrapSet()[i];
+}
+
 //_____________________________________________________________________________
 /*
  * Apply the wrap objects to the current path.
  */
 void GeometryPath::
-applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const 
+applyWrapObjects(const SimTK::State& s, CurrentPath& currentPath) const 
 {
     if (get_PathWrapSet().getSize() < 1)
         return;
+    Array<PathPoint*>& path = currentPath.points;
+    OPENSIM_PROFILE_SCOPE(getOwner() ? *getOwner() : *this,
+                          "GeometryPath::applyWrapObjects");
 
     WrapResult best_wrap;
     Array<int> result, order;
@@ -985,7 +1083,7 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
         for (int i = 0; i < get_PathWrapSet().getSize(); i++)
         {
             result[i] = 0;
-            PathWrap& ws = get_PathWrapSet().get(order[i]);
+            PathWrap& ws = updPathWrap(currentPath, order[i]);
             const WrapObject* wo = ws.getWrapObject();
             best_wrap.wrap_pts.setSize(0);
             double min_length_change = SimTK::Infinity;
@@ -1029,7 +1127,7 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                         break;
                 if (jfwd > wrapEnd) // there are no active points in the path
                     return;
-                const PathPoint* const smp = &get_PathPointSet().get(jfwd);
+                const PathPoint* const smp = &updPathPoint(currentPath, jfwd);
 
                 // 3. Scan backwards from wrapEnd in get_PathPointSet() to find 
                 // the last point that is active. Store a pointer to it (emp).
@@ -1039,7 +1137,7 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                         break;
                 if (jrev < wrapStart) // there are no active points in the path
                     return;
-                const PathPoint* const emp = &get_PathPointSet().get(jrev);
+                const PathPoint* const emp = &updPathPoint(currentPath, jrev);
 
                 // 4. Now find the indices of smp and emp in _currentPath.
                 int start=-1, end=-1;
@@ -1073,8 +1171,11 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                         wr.startPoint = pt1;
                         wr.endPoint   = pt2;
 
-                        result[i] = wo->wrapPathSegment(s, *path.get(pt1), 
+                        {
+                            OPENSIM_PROFILE_SCOPE(*wo, "wrapPathSegment");
+                            result[i] = wo->wrapPathSegment(s, *path.get(pt1),
                                                         *path.get(pt2), ws, wr);
+                        }
                         if (result[i] == WrapObject::mandatoryWrap) {
                             // "mandatoryWrap" means the path actually 
                             // intersected the wrap object. In this case, you 
@@ -1170,7 +1271,7 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                 order[1] = 0;
 
                 // remove wrap object 0 from the list of path points
-                PathWrap& ws = get_PathWrapSet().get(0);
+                PathWrap& ws = updPathWrap(currentPath, 0);
                 for (int j = 0; j < path.getSize(); j++) {
                     if (path.get(j) == &ws.getWrapPoint(0)) {
                         path.remove(j); // remove the first wrap point
@@ -1257,6 +1358,11 @@ calcLengthAfterPathComputation(const SimTK::State& s,
 double GeometryPath::
 computeMomentArm(const SimTK::State& s, const Coordinate& aCoord) const
 {
+    // The solver works in a copy of the State, so it cannot be shared by
+    // threads evaluating the Model at once.
+    if (getModel().getUseThreadSafeEvaluation())
+        return MomentArmSolver(*_model).solve(s, aCoord, *this);
+
     if (!_maSolver)
         const_cast<Self*>(this)->_maSolver.reset(new MomentArmSolver(*_model));
 
@@ -1270,7 +1376,7 @@ computeMomentArm(const SimTK::State& s, const Coordinate& aCoord) const
 void GeometryPath::updateDisplayPath(const SimTK::State& s) const
 {
     Array<PathPoint*>& currentDisplayPath = 
-        updCacheVariableValue<Array<PathPoint*> >(s, "current_display_path");
+        updCacheVariableValue(s, _currentDisplayPathCV);
     // Clear the current display path. Delete all path points
     // that have a NULL path pointer. This means that they were
     // created by an earlier call to updateDisplayPath() and are
@@ -1285,7 +1391,7 @@ void GeometryPath::updateDisplayPath(const SimTK::State& s) const
     currentDisplayPath.setSize(0);
 
     const Array<PathPoint*>& currentPath =  
-        getCacheVariableValue<Array<PathPoint*> >(s, "current_path");
+        getCacheVariableValue(s, _currentPathCV).points;
     for (int i=0; i<currentPath.getSize(); i++) {
         PathPoint* mp = currentPath.get(i);
         PathWrapPoint* mwp = dynamic_cast<PathWrapPoint*>(mp);
@@ -1307,5 +1413,5 @@ void GeometryPath::updateDisplayPath(const SimTK::State& s) const
         currentDisplayPath.append(mp);
     }
 
-    markCacheVariableValid(s, "current_display_path");
+    markCacheVariableValid(s, _currentDisplayPathCV);
 }
@@ -31,6 +31,7 @@
 #include "PathPointSet.h"
 #include <OpenSim/Simulation/Wrap/PathWrapSet.h>
 #include <OpenSim/Simulation/MomentArmSolver.h>
+#include <vector>
 
 
 #ifdef SWIG
@@ -78,6 +79,38 @@ private:
     // but we cannot simply use a unique_ptr because we want the pointer to be
     // cleared on copy.
     SimTK::NullOnCopyUniquePtr<MomentArmSolver> _maSolver;
+
+    // The active points of the path in a State. If the Model is evaluated
+    // thread-safely (Model::setUseThreadSafeEvaluation()), the State also owns
+    // copies of the MovingPathPoints and PathWraps, whose locations and
+    // wrapping change with the State, and the path refers to the copies.
+    struct CurrentPath {
+        CurrentPath() {}
+        CurrentPath(const CurrentPath& other);
+        CurrentPath& operator=(const CurrentPath& other);
+        ~CurrentPath();
+
+        Array<PathPoint*> points;
+        // One per point of the PathPointSet: a copy of the MovingPathPoints,
+        // null for the others. Empty if the points are not copied.
+        std::vector<PathPoint*> pathPoints;
+        // A copy of each PathWrap of the PathWrapSet, or empty.
+        std::vector<PathWrap*> pathWraps;
+
+        friend std::ostream& operator<<(std::ostream& o,
+                                        const CurrentPath& path) {
+            o << "GeometryPath::CurrentPath should not be serialized!"
+              << std::endl;
+            return o;
+        }
+    };
+
+    // Handles to the cache variables allocated in extendAddToSystem().
+    mutable CacheVariable<double> _lengthCV;
+    mutable CacheVariable<double> _speedCV;
+    mutable CacheVariable<CurrentPath> _currentPathCV;
+    mutable CacheVariable<Array<PathPoint*> > _currentDisplayPathCV;
+    mutable CacheVariable<SimTK::Vec3> _colorCV;
     
 //=============================================================================
 // METHODS
@@ -206,7 +239,10 @@ private:
 
     void computePath(const SimTK::State& s ) const;
     void computeLengtheningSpeed(const SimTK::State& s) const;
-    void applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path ) const;
+    void applyWrapObjects(const SimTK::State& s, CurrentPath& path) const;
+    // The point or PathWrap of this path, or its copy in the current path.
+    PathPoint& updPathPoint(CurrentPath& path, int i) const;
+    PathWrap& updPathWrap(CurrentPath& path, int i) const;
     double calcPathLengthChange(const SimTK::State& s, const WrapObject& wo, 
                                 const WrapResult& wr, 
                                 const Array<PathPoint*>& path) const; 
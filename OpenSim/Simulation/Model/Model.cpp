@@ -42,6 +42,7 @@
 #include <OpenSim/Simulation/Wrap/WrapEllipsoid.h>
 #include <OpenSim/Simulation/Wrap/WrapSphere.h>
 #include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/ComponentProfiler.h>
 #include <OpenSim/Simulation/AssemblySolver.h>
 #include <OpenSim/Simulation/CoordinateReference.h>
 
@@ -91,6 +92,7 @@ Model::Model() :
     _analysisSet(AnalysisSet()),
     _coordinateSet(CoordinateSet()),
     _useVisualizer(false),
+    _useThreadSafeEvaluation(false),
     _allControllersEnabled(true),
     _system(nullptr),
     _workingState()
@@ -108,6 +110,7 @@ Model::Model(const string &aFileName, const bool finalize) :
     _analysisSet(AnalysisSet()),
     _coordinateSet(CoordinateSet()),
     _useVisualizer(false),
+    _useThreadSafeEvaluation(false),
     _allControllersEnabled(true),
     _system(nullptr),
     _workingState()
@@ -217,6 +220,7 @@ void Model::updateFromXMLNode(SimTK::Xml::Element& aNode, int versionNumber)
 void Model::setNull()
 {
     _useVisualizer = false;
+    _useThreadSafeEvaluation = false;
     _allControllersEnabled = true;
 
     _system = NULL;
@@ -816,6 +820,10 @@ void Model::extendAddToSystem(SimTK::MultibodySystem& system) const
     //Components have been wired-up correctly.
     mutableThis->updAnalysisSet().setModel(*mutableThis);
 
+    // The muscles are connected, so their batches (if the ForceSet batches
+    // muscle evaluation) can gather their parameters.
+    mutableThis->updForceSet().updateMuscleBatches();
+
     // Reset the vector of all controls' defaults
     mutableThis->_defaultControls.resize(0);
 
@@ -828,6 +836,21 @@ void Model::extendAddToSystem(SimTK::MultibodySystem& system) const
         Stage::Velocity, Stage::Acceleration);
 
     mutableThis->_modelControlsIndex = modelControls.getSubsystemMeasureIndex();
+    // Keep a handle to the controls for getControls(); it is not reassigned
+    // during evaluation, so States can be realized on several threads.
+    mutableThis->_controlsCache = modelControls;
+}
+
+void Model::extendAddToSystemAfterSubcomponents(SimTK::MultibodySystem& system)
+                                                                        const
+{
+    Super::extendAddToSystemAfterSubcomponents(system);
+
+    // The Forces have their SimTK::Forces now, so the ForceSet can take over
+    // their evaluation if it evaluates them in parallel.
+    Model *mutableThis = const_cast<Model *>(this);
+    mutableThis->updForceSet().updateParallelEvaluation(
+        mutableThis->updForceSubsystem());
 }
 
 
@@ -1039,6 +1062,7 @@ void Model::equilibrateMuscles(SimTK::State& state)
         Muscle* muscle = dynamic_cast<Muscle*>(&get_ForceSet().get(i));
         if (muscle != NULL && !muscle->isDisabled(state)){
             try{
+                OPENSIM_PROFILE_SCOPE(*muscle, "equilibrate");
                 muscle->equilibrate(state);
             }
             catch (const std::exception& e) {
@@ -1778,14 +1802,7 @@ Vector& Model::updControls(const SimTK::State &s) const
             "Prior call to Model::initSystem() is required.");
     }
 
-    // direct the system shared cache
-    Measure_<Vector>::Result controlsCache =
-        Measure_<Vector>::Result::getAs(_system->updDefaultSubsystem()
-            .getMeasure(_modelControlsIndex));
-    // update the locally stored pointer to the controlsCache
-    const_cast<Model*>(this)->_controlsCache = controlsCache;
-    
-    return controlsCache.updValue(s);
+    return _controlsCache.updValue(s);
 }
 
 void Model::markControlsAsValid(const SimTK::State& s) const
@@ -1795,10 +1812,7 @@ void Model::markControlsAsValid(const SimTK::State& s) const
             "Prior call to Model::initSystem() is required.");
     }
 
-    Measure_<Vector>::Result controlsCache =
-        Measure_<Vector>::Result::getAs(_system->updDefaultSubsystem()
-            .getMeasure(_modelControlsIndex));
-    controlsCache.markAsValid(s);
+    _controlsCache.markAsValid(s);
 }
 
 void Model::setControls(const SimTK::State& s, const SimTK::Vector& controls) const
@@ -1808,11 +1822,7 @@ void Model::setControls(const SimTK::State& s, const SimTK::Vector& controls) co
             "Prior call to Model::initSystem() is required.");
     }
 
-    // direct the system shared cache
-    Measure_<Vector>::Result controlsCache =
-        Measure_<Vector>::Result::getAs(_system->updDefaultSubsystem()
-        .getMeasure(_modelControlsIndex));
-    controlsCache.setValue(s, controls);
+    _controlsCache.setValue(s, controls);
 
     // Make sure to re-realize dynamics to make sure controls can affect forces
     // and not just derivatives
@@ -1828,9 +1838,6 @@ const Vector& Model::getControls(const SimTK::State &s) const
             "Prior call to Model::initSystem() is required.");
     }
 
-    // _controlsCache assumes that the controls cache will not be changed or
-    // invalidated between the realization of Stage::Velocity and
-    // Stage::Dynamics
     return _controlsCache.getValue(s);
 }
 
@@ -2079,21 +2086,18 @@ void Model::realizeReport(const SimTK::State& state) const
 void Model::extendRealizeVelocity(const SimTK::State& state) const
 {
     Super::extendRealizeVelocity(state);
-    Measure_<Vector>::Result controlsCache = Measure_<Vector>::Result::getAs(
-               _system->updDefaultSubsystem().getMeasure(_modelControlsIndex));
 
     //Calculate the controls cache before we realize dynamics and call calcForces (possibly in parallel).
     //Note: If the shared controls cache is calculated inside of calcForces and the force in which it is
     //being calculated is parallel, a data race may occur to mark the controlsCache as valid/invalid.
-    if(!controlsCache.isValid(state)){
+    if(!_controlsCache.isValid(state)){
         // Always reset controls to their default values before computing controls
         // since default behavior is for controllors to "addInControls" so there should be valid
         // values to begin with.
-        controlsCache.updValue(state) = _defaultControls;
-        computeControls(state, controlsCache.updValue(state));
-        controlsCache.markAsValid(state);
+        _controlsCache.updValue(state) = _defaultControls;
+        computeControls(state, _controlsCache.updValue(state));
+        _controlsCache.markAsValid(state);
     }
-    const_cast<Model*>(this)->_controlsCache = controlsCache;
 }
 
 /**
@@ -251,6 +251,22 @@ public:
     take effect at the next call to initSystem() on this %Model. **/
     bool getUseVisualizer() const {return _useVisualizer;}
 
+    /** Allow this %Model, once initialized, to be evaluated from several
+    threads at once, each thread with its own SimTK::State. With this flag,
+    each State holds its own copies of the moving path points and path wraps
+    of the GeometryPaths, whose locations change with the State, and moment
+    arms are computed with a MomentArmSolver made for the call. It takes
+    effect at the next call to initSystem(); edit path points and wrapping
+    before that, since the copies in existing States do not follow later
+    changes. Outputs that are not cached keep their value in the Output
+    itself, so cache those that are read from several threads
+    (Component::setOutputCaching()). The default is off. **/
+    void setUseThreadSafeEvaluation(bool threadSafe)
+    {   _useThreadSafeEvaluation = threadSafe; }
+    /** Return the current setting of the "thread-safe evaluation" flag, which
+    will take effect at the next call to initSystem() on this %Model. **/
+    bool getUseThreadSafeEvaluation() const {return _useThreadSafeEvaluation;}
+
     /** Test whether a ModelVisualizer has been created for this Model. Even
     if visualization has been requested there will be no visualizer present
     until initSystem() has been successfully invoked. Use this method prior
@@ -927,6 +943,8 @@ public:
 
     void extendConnectToModel(Model& model)  override;
     void extendAddToSystem(SimTK::MultibodySystem& system) const override; 
+    void extendAddToSystemAfterSubcomponents(SimTK::MultibodySystem& system)
+                                                        const override;
     void extendInitStateFromProperties(SimTK::State& state) const override;
     /**@}**/
 
@@ -1030,6 +1048,11 @@ private:
     // a ModelVisualizer for display.
     bool _useVisualizer;
 
+    // If this flag is set when initSystem() is called, components keep all
+    // intermediate results in the State so that several threads can evaluate
+    // the Model at once.
+    bool _useThreadSafeEvaluation;
+
     // Global flag used to disable all Controllers.
     bool _allControllersEnabled;
 
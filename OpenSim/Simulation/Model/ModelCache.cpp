@@ -0,0 +1,181 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  ModelCache.cpp                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "ModelCache.h"
+#include "Model.h"
+#include <OpenSim/Common/IO.h>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace OpenSim;
+
+namespace {
+    // Hash of the contents of a file, used to detect that a cached model is
+    // out of date.
+    size_t hashFileContents(const string& aFileName)
+    {
+        ifstream file(aFileName.c_str(), ios::binary);
+        if(!file) {
+            throw Exception("ModelCache: ERROR- could not open model file "
+                            + aFileName + ".", __FILE__, __LINE__);
+        }
+        ostringstream contents;
+        contents << file.rdbuf();
+        return hash<string>()(contents.str());
+    }
+}
+
+std::mutex ModelCache::_loadMutex;
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+ModelCache::ModelCache() :
+    _numHits(0),
+    _numMisses(0)
+{
+}
+
+ModelCache::~ModelCache()
+{
+}
+
+ModelCache& ModelCache::getInstance()
+{
+    static ModelCache cache;
+    return cache;
+}
+
+//=============================================================================
+// ACQUIRE
+//=============================================================================
+std::string ModelCache::getKey(const string& aFileName)
+{
+    string path = IO::isAbsolutePath(aFileName) ? aFileName
+                                                : IO::getCwd() + "/" + aFileName;
+
+    // Split the path into its components and resolve "." and "..".
+    string root;
+    if(path.size() > 1 && path[1] == ':') {
+        root = path.substr(0, 2);
+        path = path.substr(2);
+    }
+    vector<string> parts;
+    string part;
+    for(size_t i = 0; i <= path.size(); ++i) {
+        if(i == path.size() || path[i] == '/' || path[i] == '\\') {
+            if(part == "..") {
+                if(!parts.empty()) parts.pop_back();
+            } else if(!part.empty() && part != ".") {
+                parts.push_back(part);
+            }
+            part.clear();
+        } else {
+            part += path[i];
+        }
+    }
+
+    string key = root;
+    for(size_t i = 0; i < parts.size(); ++i) key += "/" + parts[i];
+    return key;
+}
+
+std::shared_ptr<const Model> ModelCache::
+findTemplate(const string& aKey, size_t contentHash)
+{
+    lock_guard<mutex> lock(_mutex);
+    auto it = _templates.find(aKey);
+    if(it == _templates.end() || it->second.contentHash != contentHash)
+        return nullptr;
+    ++_numHits;
+    return it->second.model;
+}
+
+std::unique_ptr<Model> ModelCache::
+acquire(const string& aFileName, bool initSystem)
+{
+    const string key = getKey(aFileName);
+    size_t contentHash = hashFileContents(aFileName);
+
+    std::shared_ptr<const Model> model = findTemplate(key, contentHash);
+    if(!model) {
+        // Reading a model changes the working directory and may update the
+        // registered default objects, so only one file is read at a time.
+        // Another thread may have loaded this file while we waited.
+        lock_guard<mutex> loadLock(_loadMutex);
+        model = findTemplate(key, contentHash);
+        if(!model) {
+            model.reset(new Model(aFileName));
+            lock_guard<mutex> lock(_mutex);
+            ++_numMisses;
+            Entry& entry = _templates[key];
+            entry.contentHash = contentHash;
+            entry.model = model;
+        }
+    }
+
+    // The template is kept alive by model even if it is erased or replaced
+    // meanwhile.
+    std::unique_ptr<Model> copy(model->clone());
+    if(initSystem) copy->initSystem();
+    return copy;
+}
+
+//=============================================================================
+// MANAGEMENT
+//=============================================================================
+void ModelCache::erase(const string& aFileName)
+{
+    const string key = getKey(aFileName);
+    lock_guard<mutex> lock(_mutex);
+    _templates.erase(key);
+}
+
+void ModelCache::clear()
+{
+    lock_guard<mutex> lock(_mutex);
+    _templates.clear();
+}
+
+int ModelCache::getNumTemplates() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return (int)_templates.size();
+}
+
+int ModelCache::getNumHits() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _numHits;
+}
+
+int ModelCache::getNumMisses() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _numMisses;
+}
@@ -0,0 +1,129 @@
+#ifndef OPENSIM_MODEL_CACHE_H_
+#define OPENSIM_MODEL_CACHE_H_
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  ModelCache.h                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace OpenSim {
+
+class Model;
+
+//=============================================================================
+//=============================================================================
+/**
+ * An in-process cache of Models loaded from .osim files, for applications
+ * that construct the same model many times.
+ *
+ * The first request for a file deserializes it into a template Model. Later
+ * requests return a clone of the template, which avoids reading and parsing
+ * the XML document again. A template is keyed by the absolute, normalized
+ * path of the file (so "arm26.osim" and "./arm26.osim" share one) and a hash
+ * of its contents, so it is reloaded if the file is modified.
+ *
+ * Every Model returned is an independent copy that the caller owns. The
+ * SimTK::System cannot be shared between Models, since each ModelComponent
+ * refers to the subsystem and element indices of the System of its own
+ * Model, so each copy builds its own System in acquire() or initSystem().
+ *
+ * A ModelCache can be used from several threads at once. Files are
+ * deserialized one at a time, by all caches, since reading a model changes
+ * the working directory of the process; clones are made outside of any lock.
+ *
+ * @code
+ * std::unique_ptr<Model> model = ModelCache::getInstance().acquire("arm26.osim");
+ * SimTK::State& s = model->updWorkingState();
+ * @endcode
+ */
+class OSIMSIMULATION_API ModelCache {
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+    ModelCache();
+    ~ModelCache();
+
+    /** The cache shared by the whole process. */
+    static ModelCache& getInstance();
+
+    /** Return a new copy of the model in the file aFileName, loading the
+    file only if it is not cached or its contents changed.
+    @param aFileName    Name of an OpenSim model (.osim) file.
+    @param initSystem   If true, initSystem() is called on the copy, so that
+                        its System and working State are ready for use. */
+    std::unique_ptr<Model> acquire(const std::string& aFileName,
+                                   bool initSystem = true);
+
+    /** The key of the template for aFileName: its absolute path, without
+    "." and ".." components. */
+    static std::string getKey(const std::string& aFileName);
+
+    /** Remove the template for aFileName, if any. */
+    void erase(const std::string& aFileName);
+    /** Remove all templates. */
+    void clear();
+
+    /** Number of cached templates. */
+    int getNumTemplates() const;
+    /** Number of requests served from a cached template. */
+    int getNumHits() const;
+    /** Number of requests that had to load the file. */
+    int getNumMisses() const;
+
+private:
+    ModelCache(const ModelCache&) = delete;
+    ModelCache& operator=(const ModelCache&) = delete;
+
+    struct Entry {
+        std::size_t contentHash;
+        std::shared_ptr<const Model> model;
+    };
+
+    // The template for aKey if it is cached with the given contentHash,
+    // counting a hit if so.
+    std::shared_ptr<const Model> findTemplate(const std::string& aKey,
+                                              std::size_t contentHash);
+
+//=============================================================================
+// DATA
+//=============================================================================
+    /** Guards the templates and the counts; never held while a model is
+    read or cloned. */
+    mutable std::mutex _mutex;
+    /** Held while a model file is deserialized, by all caches. */
+    static std::mutex _loadMutex;
+    std::map<std::string, Entry> _templates;
+    int _numHits;
+    int _numMisses;
+
+//=============================================================================
+};  // END of class ModelCache
+//=============================================================================
+//=============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_MODEL_CACHE_H_
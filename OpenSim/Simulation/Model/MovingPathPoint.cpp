@@ -107,6 +107,11 @@ void MovingPathPoint::copyData(const MovingPathPoint &aPoint)
     _yCoordinateName = aPoint._yCoordinateName;
     _zLocation = (Function*)Object::SafeCopy(aPoint._zLocation);
     _zCoordinateName = aPoint._zCoordinateName;
+    // Like the body of the point, the coordinates are looked up again when
+    // the copy is connected to a model.
+    _xCoordinate = aPoint._xCoordinate;
+    _yCoordinate = aPoint._yCoordinate;
+    _zCoordinate = aPoint._zCoordinate;
 }
 
 //_____________________________________________________________________________
@@ -25,6 +25,7 @@
 // INCLUDES
 //=============================================================================
 #include "Muscle.h"
+#include "MuscleBatch.h"
 
 #include <OpenSim/Simulation/SimbodyEngine/Body.h>
 #include <OpenSim/Simulation/SimbodyEngine/SimbodyEngine.h>
@@ -252,6 +253,8 @@ void Muscle::extendConnectToModel(Model& aModel)
     _optimalFiberLength = getOptimalFiberLength();
     _pennationAngleAtOptimal = getPennationAngleAtOptimalFiberLength();
     _tendonSlackLength = getTendonSlackLength();
+
+    _batch = nullptr;
 }
 
 // Add Muscle's contributions to the underlying system
@@ -268,13 +271,13 @@ void Muscle::extendConnectToModel(Model& aModel)
     //              both the position and velocity of the multibody system and
     //              the muscles path before solving for the fiber length and
     //              velocity in the reduced model.
-    addCacheVariable<Muscle::MuscleLengthInfo>
+    _lengthInfoCV = addCacheVariable<Muscle::MuscleLengthInfo>
        ("lengthInfo", MuscleLengthInfo(), SimTK::Stage::Velocity);
-    addCacheVariable<Muscle::FiberVelocityInfo>
+    _velInfoCV = addCacheVariable<Muscle::FiberVelocityInfo>
        ("velInfo", FiberVelocityInfo(), SimTK::Stage::Velocity);
-    addCacheVariable<Muscle::MuscleDynamicsInfo>
+    _dynamicsInfoCV = addCacheVariable<Muscle::MuscleDynamicsInfo>
        ("dynamicsInfo", MuscleDynamicsInfo(), SimTK::Stage::Dynamics);
-    addCacheVariable<Muscle::MusclePotentialEnergyInfo>
+    _potentialEnergyInfoCV = addCacheVariable<Muscle::MusclePotentialEnergyInfo>
        ("potentialEnergyInfo", MusclePotentialEnergyInfo(), SimTK::Stage::Velocity);
  }
 
@@ -554,79 +557,94 @@ void Muscle::setExcitation(SimTK::State& s, double excitation) const
 /* Access to muscle calculation data structures */
 const Muscle::MuscleLengthInfo& Muscle::getMuscleLengthInfo(const SimTK::State& s) const
 {
-    if(!isCacheVariableValid(s,"lengthInfo")){
+    if(!isCacheVariableValid(s, _lengthInfoCV)){
+        if(_batch){
+            // computes the info of the other muscles of the batch as well
+            _batch->computeMuscleLengthInfo(s);
+            return getCacheVariableValue(s, _lengthInfoCV);
+        }
         MuscleLengthInfo &umli = updMuscleLengthInfo(s);
         calcMuscleLengthInfo(s, umli);
-        markCacheVariableValid(s,"lengthInfo");
+        markCacheVariableValid(s, _lengthInfoCV);
         // don't bother fishing it out of the cache since 
         // we just calculated it and still have a handle on it
         return umli;
     }
-    return getCacheVariableValue<MuscleLengthInfo>(s, "lengthInfo");
+    return getCacheVariableValue(s, _lengthInfoCV);
 }
 
 Muscle::MuscleLengthInfo& Muscle::updMuscleLengthInfo(const SimTK::State& s) const
 {
-    return updCacheVariableValue<MuscleLengthInfo>(s, "lengthInfo");
+    return updCacheVariableValue(s, _lengthInfoCV);
 }
 
 const Muscle::FiberVelocityInfo& Muscle::
 getFiberVelocityInfo(const SimTK::State& s) const
 {
-    if(!isCacheVariableValid(s,"velInfo")){
+    if(!isCacheVariableValid(s, _velInfoCV)){
+        if(_batch){
+            // computes the info of the other muscles of the batch as well
+            _batch->computeFiberVelocityInfo(s);
+            return getCacheVariableValue(s, _velInfoCV);
+        }
         FiberVelocityInfo& ufvi = updFiberVelocityInfo(s);
         calcFiberVelocityInfo(s, ufvi);
-        markCacheVariableValid(s,"velInfo");
+        markCacheVariableValid(s, _velInfoCV);
         // don't bother fishing it out of the cache since 
         // we just calculated it and still have a handle on it
         return ufvi;
     }
-    return getCacheVariableValue<FiberVelocityInfo>(s, "velInfo");
+    return getCacheVariableValue(s, _velInfoCV);
 }
 
 Muscle::FiberVelocityInfo& Muscle::
 updFiberVelocityInfo(const SimTK::State& s) const
 {
-    return updCacheVariableValue<FiberVelocityInfo>(s, "velInfo");
+    return updCacheVariableValue(s, _velInfoCV);
 }
 
 const Muscle::MuscleDynamicsInfo& Muscle::
 getMuscleDynamicsInfo(const SimTK::State& s) const
 {
-    if(!isCacheVariableValid(s,"dynamicsInfo")){
+    if(!isCacheVariableValid(s, _dynamicsInfoCV)){
+        if(_batch){
+            // computes the info of the other muscles of the batch as well
+            _batch->computeMuscleDynamicsInfo(s);
+            return getCacheVariableValue(s, _dynamicsInfoCV);
+        }
         MuscleDynamicsInfo& umdi = updMuscleDynamicsInfo(s);
         calcMuscleDynamicsInfo(s, umdi);
-        markCacheVariableValid(s,"dynamicsInfo");
+        markCacheVariableValid(s, _dynamicsInfoCV);
         // don't bother fishing it out of the cache since 
         // we just calculated it and still have a handle on it
         return umdi;
     }
-    return getCacheVariableValue<MuscleDynamicsInfo>(s, "dynamicsInfo");
+    return getCacheVariableValue(s, _dynamicsInfoCV);
 }
 Muscle::MuscleDynamicsInfo& Muscle::
 updMuscleDynamicsInfo(const SimTK::State& s) const
 {
-    return updCacheVariableValue<MuscleDynamicsInfo>(s, "dynamicsInfo");
+    return updCacheVariableValue(s, _dynamicsInfoCV);
 }
 
 const Muscle::MusclePotentialEnergyInfo& Muscle::
 getMusclePotentialEnergyInfo(const SimTK::State& s) const
 {
-    if(!isCacheVariableValid(s,"potentialEnergyInfo")){
+    if(!isCacheVariableValid(s, _potentialEnergyInfoCV)){
         MusclePotentialEnergyInfo& umpei = updMusclePotentialEnergyInfo(s);
         calcMusclePotentialEnergyInfo(s, umpei);
-        markCacheVariableValid(s,"potentialEnergyInfo");
+        markCacheVariableValid(s, _potentialEnergyInfoCV);
         // don't bother fishing it out of the cache since 
         // we just calculated it and still have a handle on it
         return umpei;
     }
-    return getCacheVariableValue<MusclePotentialEnergyInfo>(s, "potentialEnergyInfo");
+    return getCacheVariableValue(s, _potentialEnergyInfoCV);
 }
 
 Muscle::MusclePotentialEnergyInfo& Muscle::
 updMusclePotentialEnergyInfo(const SimTK::State& s) const
 {
-    return updCacheVariableValue<MusclePotentialEnergyInfo>(s, "potentialEnergyInfo");
+    return updCacheVariableValue(s, _potentialEnergyInfoCV);
 }
 
 
@@ -36,6 +36,8 @@
 
 namespace OpenSim {
 
+class MuscleBatch;
+
 //=============================================================================
 //=============================================================================
 /**
@@ -329,6 +331,14 @@ protected:
         computeInitialFiberEquilibrium(s);
     }
 
+    /** Return a new MuscleBatch that computes the length, velocity and
+    dynamics info of the given muscles together, or null (the default) if
+    this class has none. The muscles are all of this muscle's concrete class,
+    and include this one. The ForceSet calls this when it batches muscle
+    evaluation, and owns the batch. */
+    virtual MuscleBatch* createMuscleBatch(
+        const std::vector<const Muscle*>& muscles) const { return nullptr; }
+
     // End of Muscle's State Related Calculations.
     //@} 
 
@@ -781,6 +791,23 @@ protected:
     double _pennationAngleAtOptimal;
     double _tendonSlackLength;
 
+    /** Handles to the cache variables that hold the structs above, assigned
+        in extendAddToSystem(). Derived muscles use them to invalidate the
+        structs when they set a state variable the structs depend on. */
+    mutable CacheVariable<MuscleLengthInfo> _lengthInfoCV;
+    mutable CacheVariable<FiberVelocityInfo> _velInfoCV;
+    mutable CacheVariable<MuscleDynamicsInfo> _dynamicsInfoCV;
+    mutable CacheVariable<MusclePotentialEnergyInfo> _potentialEnergyInfoCV;
+
+private:
+    /** The batch that computes this muscle's info with that of the other
+        muscles of its class, if the ForceSet batches muscle evaluation.
+        Reset in extendConnectToModel() and assigned by the ForceSet. */
+    const MuscleBatch* _batch = nullptr;
+
+    friend class ForceSet;
+    friend class MuscleBatch;
+
 //=============================================================================
 };  // END of class Muscle
 //=============================================================================
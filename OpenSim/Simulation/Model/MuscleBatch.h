@@ -0,0 +1,106 @@
+#ifndef OPENSIM_MUSCLE_BATCH_H_
+#define OPENSIM_MUSCLE_BATCH_H_
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  MuscleBatch.h                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "Muscle.h"
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * A kernel that computes the MuscleLengthInfo, FiberVelocityInfo and
+ * MuscleDynamicsInfo of many muscles of one concrete type together, used when
+ * the ForceSet batches muscle evaluation
+ * (ForceSet::setUseBatchedMuscleEvaluation()).
+ *
+ * When one of these structs of a batched muscle is not valid,
+ * Muscle::getMuscleLengthInfo() (or getFiberVelocityInfo(),
+ * getMuscleDynamicsInfo()) asks the muscle's batch to compute it. The batch
+ * computes the struct of every one of its muscles whose struct is not valid,
+ * stores each in the muscle's cache and marks it valid, so that the other
+ * muscles find theirs already computed. A batch can then gather the inputs
+ * of its muscles into contiguous arrays and evaluate their curves in one
+ * loop, instead of one muscle at a time through virtual calls.
+ *
+ * A muscle class provides a batch by overriding
+ * Muscle::createMuscleBatch(). The values a batch stores must be identical
+ * to those of the muscle's own calcMuscleLengthInfo(),
+ * calcFiberVelocityInfo() and calcMuscleDynamicsInfo(). A batch may be used
+ * from several threads at once, each with its own State, so it must not
+ * write its members while computing.
+ *
+ * @author Ajay Seth
+ */
+class OSIMSIMULATION_API MuscleBatch {
+public:
+    virtual ~MuscleBatch() {}
+
+    /** Compute, cache and mark valid the MuscleLengthInfo of each muscle of
+    the batch whose MuscleLengthInfo is not valid in s. */
+    virtual void computeMuscleLengthInfo(const SimTK::State& s) const = 0;
+    /** Ditto for the FiberVelocityInfo. */
+    virtual void computeFiberVelocityInfo(const SimTK::State& s) const = 0;
+    /** Ditto for the MuscleDynamicsInfo. */
+    virtual void computeMuscleDynamicsInfo(const SimTK::State& s) const = 0;
+
+protected:
+    /** Access to the cached structs of a muscle, for derived batches. */
+    static bool isMuscleLengthInfoValid(const Muscle& m,
+                                        const SimTK::State& s)
+    {   return m.isCacheVariableValid(s, m._lengthInfoCV); }
+    static Muscle::MuscleLengthInfo& updMuscleLengthInfo(const Muscle& m,
+                                                    const SimTK::State& s)
+    {   return m.updCacheVariableValue(s, m._lengthInfoCV); }
+    static void markMuscleLengthInfoValid(const Muscle& m,
+                                          const SimTK::State& s)
+    {   m.markCacheVariableValid(s, m._lengthInfoCV); }
+
+    static bool isFiberVelocityInfoValid(const Muscle& m,
+                                         const SimTK::State& s)
+    {   return m.isCacheVariableValid(s, m._velInfoCV); }
+    static Muscle::FiberVelocityInfo& updFiberVelocityInfo(const Muscle& m,
+                                                     const SimTK::State& s)
+    {   return m.updCacheVariableValue(s, m._velInfoCV); }
+    static void markFiberVelocityInfoValid(const Muscle& m,
+                                           const SimTK::State& s)
+    {   m.markCacheVariableValid(s, m._velInfoCV); }
+
+    static bool isMuscleDynamicsInfoValid(const Muscle& m,
+                                          const SimTK::State& s)
+    {   return m.isCacheVariableValid(s, m._dynamicsInfoCV); }
+    static Muscle::MuscleDynamicsInfo& updMuscleDynamicsInfo(const Muscle& m,
+                                                       const SimTK::State& s)
+    {   return m.updCacheVariableValue(s, m._dynamicsInfoCV); }
+    static void markMuscleDynamicsInfoValid(const Muscle& m,
+                                            const SimTK::State& s)
+    {   m.markCacheVariableValid(s, m._dynamicsInfoCV); }
+
+//=============================================================================
+};  // END of class MuscleBatch
+//=============================================================================
+//=============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_MUSCLE_BATCH_H_
@@ -0,0 +1,199 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  ParallelForceAdapter.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "ParallelForceAdapter.h"
+#include "Force.h"
+#include "GeometryPath.h"
+#include "MuscleBatch.h"
+#include <OpenSim/Common/ComponentProfiler.h>
+#include <algorithm>
+
+using namespace OpenSim;
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+ParallelForceAdapter::ParallelForceAdapter(
+        const SimTK::GeneralForceSubsystem& forces,
+        const std::vector<Element>& elements,
+        const std::vector<int>& chunkEnds,
+        const std::vector<const MuscleBatch*>& batches,
+        int numThreads) :
+    _forces(forces), _elements(elements), _chunkEnds(chunkEnds),
+    _batches(batches), _hasBatchedPaths(false), _task(NULL),
+    _generation(0), _numBusy(0), _nextChunk(0), _stopping(false)
+{
+    for (size_t i = 0; i < _elements.size(); ++i)
+        if (_elements[i].batchedPath) _hasBatchedPaths = true;
+
+    const int numChunks = getNumChunks();
+    _chunkBodyForces.resize(numChunks);
+    _chunkMobilityForces.resize(numChunks);
+    _chunkErrors.resize(numChunks);
+
+    // The calling thread evaluates chunks too.
+    for (int t = 1; t < std::min(numThreads, numChunks); ++t)
+        _threads.push_back(std::thread(&ParallelForceAdapter::runWorker, this));
+}
+
+ParallelForceAdapter::~ParallelForceAdapter()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _started.notify_all();
+    for (size_t t = 0; t < _threads.size(); ++t)
+        _threads[t].join();
+}
+
+//-----------------------------------------------------------------------------
+// METHODS TO CALCULATE FORCE
+//-----------------------------------------------------------------------------
+void ParallelForceAdapter::calcForce(const SimTK::State& s,
+    SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+    SimTK::Vector_<SimTK::Vec3>& particleForces,
+    SimTK::Vector& mobilityForces) const
+{
+    std::unique_lock<std::mutex> evaluating(_evaluating, std::try_to_lock);
+    if (!evaluating.owns_lock() || _threads.empty()) {
+        // Sum the same chunks one after the other. Batched muscles compute
+        // their batches when first asked, as usual.
+        thread_local SimTK::Vector_<SimTK::SpatialVec> chunkBodyForces;
+        thread_local SimTK::Vector chunkMobilityForces;
+        for (int c = 0; c < getNumChunks(); ++c) {
+            evaluateChunk(s, c, chunkBodyForces, chunkMobilityForces);
+            bodyForces += chunkBodyForces;
+            mobilityForces += chunkMobilityForces;
+        }
+        return;
+    }
+
+    // A batch computes the info of all its muscles at once, so compute the
+    // batches before the muscles ask for them from several threads.
+    if (!_batches.empty()) {
+        if (_hasBatchedPaths)
+            runOnAllThreads([&](int c) { preparePaths(s, c); });
+        for (size_t b = 0; b < _batches.size(); ++b)
+            _batches[b]->computeMuscleDynamicsInfo(s);
+    }
+
+    runOnAllThreads([&](int c) {
+        evaluateChunk(s, c, _chunkBodyForces[c], _chunkMobilityForces[c]);
+    });
+    for (int c = 0; c < getNumChunks(); ++c) {
+        bodyForces += _chunkBodyForces[c];
+        mobilityForces += _chunkMobilityForces[c];
+    }
+}
+
+void ParallelForceAdapter::preparePaths(const SimTK::State& s, int chunk) const
+{
+    const int begin = chunk == 0 ? 0 : _chunkEnds[chunk-1];
+    for (int i = begin; i < _chunkEnds[chunk]; ++i) {
+        const GeometryPath* path = _elements[i].batchedPath;
+        if (path == NULL) continue;
+        path->getLength(s);
+        path->getLengtheningSpeed(s);
+    }
+}
+
+void ParallelForceAdapter::evaluateChunk(const SimTK::State& s, int chunk,
+    SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+    SimTK::Vector& mobilityForces) const
+{
+    bodyForces.resize(_forces.getMultibodySystem().getMatterSubsystem()
+                          .getNumBodies());
+    mobilityForces.resize(s.getNU());
+    bodyForces.setToZero();
+    mobilityForces.setToZero();
+
+    const int begin = chunk == 0 ? 0 : _chunkEnds[chunk-1];
+    for (int i = begin; i < _chunkEnds[chunk]; ++i) {
+        const Element& element = _elements[i];
+        if (_forces.isForceDisabled(s, element.index)) continue;
+        OPENSIM_PROFILE_SCOPE(*element.force, "computeForce");
+        element.force->computeForce(s, bodyForces, mobilityForces);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// THREADS
+//-----------------------------------------------------------------------------
+void ParallelForceAdapter::runOnAllThreads(const ChunkTask& task) const
+{
+    std::fill(_chunkErrors.begin(), _chunkErrors.end(), std::exception_ptr());
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task = &task;
+        _nextChunk = 0;
+        _numBusy = (int)_threads.size();
+        ++_generation;
+    }
+    _started.notify_all();
+    runChunks();
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _finished.wait(lock, [this] { return _numBusy == 0; });
+        _task = NULL;
+    }
+
+    // Rethrow the exception of the first chunk that threw one, so that the
+    // same one is thrown whichever thread got there first.
+    for (size_t c = 0; c < _chunkErrors.size(); ++c)
+        if (_chunkErrors[c]) std::rethrow_exception(_chunkErrors[c]);
+}
+
+void ParallelForceAdapter::runChunks() const
+{
+    const int numChunks = getNumChunks();
+    for (int c = _nextChunk++; c < numChunks; c = _nextChunk++) {
+        try {
+            (*_task)(c);
+        }
+        catch (...) {
+            _chunkErrors[c] = std::current_exception();
+        }
+    }
+}
+
+void ParallelForceAdapter::runWorker()
+{
+    long generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _started.wait(lock, [&] {
+                return _stopping || _generation != generation; });
+            if (_stopping) return;
+            generation = _generation;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_numBusy == 0) _finished.notify_one();
+        }
+    }
+}
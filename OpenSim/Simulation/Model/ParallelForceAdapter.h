@@ -0,0 +1,144 @@
+#ifndef OPENSIM_PARALLEL_FORCE_ADAPTER_H_
+#define OPENSIM_PARALLEL_FORCE_ADAPTER_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  ParallelForceAdapter.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include "OpenSim/Simulation/osimSimulationDLL.h"
+#include <SimTKsimbody.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OpenSim {
+
+class Force;
+class GeometryPath;
+class MuscleBatch;
+
+//=============================================================================
+//=============================================================================
+/**
+ * Evaluates a group of Forces as one SimTK::Force, on several threads. The
+ * ForceSet creates one when it evaluates its Forces in parallel (see
+ * ForceSet::setUseParallelEvaluation()), and the ForceAdapters of the Forces
+ * in the group are deferred to it.
+ *
+ * The Forces are divided, in order, into chunks of about the same estimated
+ * cost. Each chunk is summed on its own, starting from zero, and the sums
+ * are added to the system forces in chunk order. The chunks do not depend on
+ * the number of threads or on which thread evaluates which chunk, so the
+ * results are the same from run to run and for any number of threads; they
+ * can differ from one-at-a-time evaluation in the last bits.
+ *
+ * All the Forces of the group are evaluated at once on one State, so each
+ * must only write its own cache entries. If muscles are batched, the paths of
+ * the batched muscles are computed in parallel first, then the batches, on
+ * the calling thread, and then the Forces.
+ *
+ * If another thread is already evaluating the group (with another State),
+ * the chunks are evaluated one after the other on the calling thread, with
+ * the same results.
+ */
+class OSIMSIMULATION_API ParallelForceAdapter :
+    public SimTK::Force::Custom::Implementation
+{
+public:
+    /** A Force of the group, the SimTK::Force that enables or disables it
+    and, for a batched muscle, its path. */
+    struct Element {
+        const Force* force;
+        SimTK::ForceIndex index;
+        const GeometryPath* batchedPath;
+    };
+
+    /** Evaluate elements in chunks, chunkEnds[c] being one past the last
+    element of chunk c, using up to numThreads threads in all (including the
+    calling thread). */
+    ParallelForceAdapter(const SimTK::GeneralForceSubsystem& forces,
+                         const std::vector<Element>& elements,
+                         const std::vector<int>& chunkEnds,
+                         const std::vector<const MuscleBatch*>& batches,
+                         int numThreads);
+    ~ParallelForceAdapter();
+
+    int getNumChunks() const { return (int)_chunkEnds.size(); }
+    int getNumThreads() const { return (int)_threads.size() + 1; }
+
+    // CALC FORCES (Called by Simbody)
+    void calcForce(const SimTK::State& state,
+        SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+        SimTK::Vector_<SimTK::Vec3>& particleForces,
+        SimTK::Vector& mobilityForces) const override;
+
+    // The potential energy of the Forces is reported by their own adapters.
+    SimTK::Real calcPotentialEnergy(const SimTK::State& state) const override
+    {   return 0; }
+
+private:
+    ParallelForceAdapter(const ParallelForceAdapter&);
+    ParallelForceAdapter& operator=(const ParallelForceAdapter&);
+
+    typedef std::function<void(int)> ChunkTask;
+
+    void preparePaths(const SimTK::State& s, int chunk) const;
+    void evaluateChunk(const SimTK::State& s, int chunk,
+                       SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                       SimTK::Vector& mobilityForces) const;
+    // Run task for every chunk, on the worker threads and this one.
+    void runOnAllThreads(const ChunkTask& task) const;
+    void runChunks() const;
+    void runWorker();
+
+    const SimTK::GeneralForceSubsystem& _forces;
+    std::vector<Element> _elements;
+    std::vector<int> _chunkEnds;
+    std::vector<const MuscleBatch*> _batches;
+    bool _hasBatchedPaths;
+
+    // The sum of each chunk and the exception it threw, if any, for the
+    // thread evaluating in parallel (the one holding _evaluating).
+    mutable std::mutex _evaluating;
+    mutable std::vector< SimTK::Vector_<SimTK::SpatialVec> > _chunkBodyForces;
+    mutable std::vector<SimTK::Vector> _chunkMobilityForces;
+    mutable std::vector<std::exception_ptr> _chunkErrors;
+
+    // The worker threads wait for _generation to change, then take chunks
+    // of *_task until there are none left.
+    std::vector<std::thread> _threads;
+    mutable std::mutex _mutex;
+    mutable std::condition_variable _started;
+    mutable std::condition_variable _finished;
+    mutable const ChunkTask* _task;
+    mutable long _generation;
+    mutable int _numBusy;
+    mutable std::atomic<int> _nextChunk;
+    bool _stopping;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_PARALLEL_FORCE_ADAPTER_H_
@@ -30,6 +30,7 @@
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/LinearFunction.h>
+#include <OpenSim/Common/MultiplierFunction.h>
 
 
 //=============================================================================
@@ -137,6 +138,55 @@ void CustomJoint::extendConnectToModel(Model& aModel)
     upd_CoordinateSet().setMemoryOwner(currentOwnership);
     for (int i=0; i<coords.getSize(); i++)
         upd_CoordinateSet().adoptAndAppend(coords[i]);
+
+    _pinOrSliderAxis = findPinOrSliderAxis();
+}
+
+//_____________________________________________________________________________
+/*
+ * A joint whose only coordinate drives one TransformAxis through the identity
+ * LinearFunction (slope 1 and intercept 0), while the other 5 axes are the
+ * Constant 0 (possibly scaled), is a pin about that axis if it is a rotation
+ * and a slider along it if it is a translation. Return the index of that
+ * axis, or -1 if the joint is anything else.
+ */
+static bool isZeroFunction(const OpenSim::Function& function)
+{
+    const MultiplierFunction* mf =
+        dynamic_cast<const MultiplierFunction*>(&function);
+    if (mf)
+        return mf->getFunction() && isZeroFunction(*mf->getFunction());
+    const Constant* constant = dynamic_cast<const Constant*>(&function);
+    return constant && constant->getValue() == 0;
+}
+
+int CustomJoint::findPinOrSliderAxis() const
+{
+    if (numCoordinates() != 1)
+        return -1;
+
+    int found = -1;
+    for (int i=0; i<6; i++) {
+        const TransformAxis& transform = getSpatialTransform()[i];
+        if (!transform.hasFunction())
+            return -1;
+        const OpenSim::Function& function = transform.getFunction();
+        if (transform.getCoordinateNames().size() == 0) {
+            if (!isZeroFunction(function))
+                return -1;
+            continue;
+        }
+        const LinearFunction* lf = dynamic_cast<const LinearFunction*>(&function);
+        if (found >= 0 || transform.getCoordinateNames().size() != 1 || !lf)
+            return -1;
+        const Array<double> coefficients = lf->getCoefficients();
+        if (coefficients.getSize() != 2 ||
+            coefficients[0] != 1.0 || coefficients[1] != 0.0 ||
+            transform.getAxis().norm() == 0)
+            return -1;
+        found = i;
+    }
+    return found;
 }
 
 
@@ -256,6 +306,30 @@ void CustomJoint::extendAddToSystem(SimTK::MultibodySystem& system) const
         outb = getChildInternalRigidBody();
     }
 
+    SimTK::MobilizedBody::Direction dir =
+        SimTK::MobilizedBody::Direction(get_reverse());
+
+    // A pin rotates about the Z axis of its frames and a slider translates
+    // along the X axis, so express both frames in a frame with that axis
+    // along the joint's axis; the rest of the joint's motion is 0.
+    if (_pinOrSliderAxis >= 0) {
+        const SimTK::UnitVec3 axis(
+            getSpatialTransform()[_pinOrSliderAxis].getAxis());
+        if (_pinOrSliderAxis < 3) {
+            const SimTK::Transform X_FA(SimTK::Rotation(axis, SimTK::ZAxis));
+            SimTK::MobilizedBody::Pin
+                simtkBody(inb, *inbX*X_FA, outb, *outbX*X_FA, dir);
+            assignSystemIndicesToBodyAndCoordinates(simtkBody, mobilized, 1, 0);
+        }
+        else {
+            const SimTK::Transform X_FA(SimTK::Rotation(axis, SimTK::XAxis));
+            SimTK::MobilizedBody::Slider
+                simtkBody(inb, *inbX*X_FA, outb, *outbX*X_FA, dir);
+            assignSystemIndicesToBodyAndCoordinates(simtkBody, mobilized, 1, 0);
+        }
+        return;
+    }
+
     const CoordinateSet& coords = get_CoordinateSet();
     // Some initializations
     int numMobilities = coords.getSize();  // Note- should check that all coordinates are used.
@@ -282,9 +356,6 @@ void CustomJoint::extendAddToSystem(SimTK::MultibodySystem& system) const
         "%s::%s must specify 6 independent axes to span spatial motion.",
         getConcreteClassName().c_str(), getSpatialTransform().getConcreteClassName().c_str());
 
-    SimTK::MobilizedBody::Direction dir =
-        SimTK::MobilizedBody::Direction(get_reverse());
-
     SimTK::MobilizedBody::FunctionBased
         simtkBody(inb, *inbX, 
                   outb, *outbX, 
@@ -47,6 +47,11 @@ The order of the spatial transform is fixed with rotations first followed by
 translations. Subsequently, coupled motion (i.e., describing motion of two
 degrees of freedom as a function of one coordinate) is easily handled.
 
+A custom joint whose single coordinate is the angle about (or the distance
+along) one axis, with every other axis held at 0, is a pin (or a slider); it is
+detected when the joint is connected to its model and built as a
+SimTK::MobilizedBody::Pin (or Slider), which does not evaluate any functions.
+
 @author Ajay Seth, Frank C. Anderson
 */
 
@@ -109,6 +114,7 @@ private:
 
     void constructProperties();
     void constructCoordinates();
+    int findPinOrSliderAxis() const;
 
     template <typename T>
     T createMobilizedBody(SimTK::MobilizedBody& inboard,
@@ -117,6 +123,10 @@ private:
         const SimTK::Transform& outboardTransform,
         int& startingCoorinateIndex) const {};
 
+    // The TransformAxis of a joint that is a pin or a slider, or -1 for a
+    // joint built as a FunctionBased mobilizer.
+    int _pinOrSliderAxis = -1;
+
 //==============================================================================
 };  // END of class CustomJoint
 //==============================================================================
@@ -157,11 +157,38 @@ std::vector<std::vector<int> > SpatialTransform::getCoordinateIndices() const
     
     return coordIndices;
 }
+// Scaling a model wraps the functions of its translations in
+// MultiplierFunctions, which Simbody would evaluate through a FunctionAdapter.
+// A scaled LinearFunction or Constant is itself linear or constant, so give
+// Simbody its native function with the scale factor folded in.
+static SimTK::Function* createFoldedFunction(const OpenSim::Function& function)
+{
+    const MultiplierFunction* mf =
+        dynamic_cast<const MultiplierFunction*>(&function);
+    if (mf && mf->getFunction()) {
+        const double scale = mf->getScale();
+        const Constant* constant =
+            dynamic_cast<const Constant*>(mf->getFunction());
+        if (constant)
+            return new SimTK::Function::Constant(scale*constant->getValue(), 0);
+        const LinearFunction* lf =
+            dynamic_cast<const LinearFunction*>(mf->getFunction());
+        if (lf) {
+            const Array<double> coefficients = lf->getCoefficients();
+            SimTK::Vector coeffs(coefficients.getSize());
+            for (int i = 0; i < coefficients.getSize(); ++i)
+                coeffs[i] = scale*coefficients[i];
+            return new SimTK::Function::Linear(coeffs);
+        }
+    }
+    return function.createSimTKFunction();
+}
+
 std::vector<const SimTK::Function*> SpatialTransform::getFunctions() const
 {
     std::vector<const SimTK::Function*> functions(NumTransformAxes);
     for(int i=0; i < NumTransformAxes; i++){
-        functions[i] = getTransformAxis(i).getFunction().createSimTKFunction();
+        functions[i] = createFoldedFunction(getTransformAxis(i).getFunction());
     }
     return functions;
 }
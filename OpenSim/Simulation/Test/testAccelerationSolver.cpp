@@ -0,0 +1,117 @@
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  testAccelerationSolver.cpp                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//==============================================================================
+// testAccelerationSolver checks that the accelerations and constraint forces
+// of the factored equations of motion match those of realizing the model to
+// Stage::Acceleration, and that a batch of forces solved together matches
+// solving the forces one at a time with Simbody.
+//==============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void testAccelerationSolver(const string& modelFile);
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testAccelerationSolver("arm26.osim");
+        testAccelerationSolver("PushUpToesOnGroundExactConstraints.osim");
+    }
+    catch (const std::exception& e) {
+        cout << "testAccelerationSolver FAILED: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+void assertVectorsEqual(const SimTK::Vector& expected,
+                        const SimTK::Vector& found, double tol)
+{
+    ASSERT(expected.size() == found.size());
+    for (int i = 0; i < expected.size(); ++i)
+        ASSERT_EQUAL(expected[i], found[i],
+                     tol*std::max(1.0, std::abs(expected[i])));
+}
+
+void testAccelerationSolver(const string& modelFile)
+{
+    Model model(modelFile);
+    SimTK::State& s = model.initSystem();
+    const SimTK::MultibodySystem& system = model.getMultibodySystem();
+    const SimTK::SimbodyMatterSubsystem& matter = model.getMatterSubsystem();
+    const int nu = s.getNU();
+
+    for (int i = 0; i < nu; ++i)
+        s.updU()[i] = 0.1*(i+1)*(i % 2 ? -1 : 1);
+    system.realize(s, SimTK::Stage::Acceleration);
+
+    AccelerationSolver solver(model);
+    solver.factor(s);
+
+    // All of the forces applied to the model
+    SimTK::Vector f, udot, lambda;
+    solver.calcGeneralizedForces(s, system.getMobilityForces(s,
+        SimTK::Stage::Dynamics), system.getRigidBodyForces(s,
+        SimTK::Stage::Dynamics), f);
+    solver.solve(f, udot, &lambda);
+    assertVectorsEqual(s.getUDot(), udot, 1e-8);
+
+    // The multipliers need not be unique, but the constraint forces are
+    ASSERT(solver.getNumMultipliers() == s.getMultipliers().size());
+    SimTK::Vector expectedForces, foundForces;
+    matter.multiplyByGTranspose(s, s.getMultipliers(), expectedForces);
+    matter.multiplyByGTranspose(s, lambda, foundForces);
+    assertVectorsEqual(expectedForces, foundForces, 1e-8);
+
+    // A batch of forces, each solved alone and without velocity forces
+    const int nf = 5;
+    SimTK::Matrix F(nu, nf), udots, fullUDots;
+    for (int j = 0; j < nf; ++j)
+        for (int i = 0; i < nu; ++i)
+            F(i, j) = std::sin(1.0 + i + 7.0*j);
+    solver.solveLinear(F, udots);
+    solver.solve(F, fullUDots);
+
+    SimTK::Vector_<SimTK::SpatialVec> noBodyForces(matter.getNumBodies(),
+        SimTK::SpatialVec(SimTK::Vec3(0)));
+    SimTK::Vector_<SimTK::SpatialVec> A_GB;
+    SimTK::Vector udotBias, expected;
+    matter.calcAcceleration(s, SimTK::Vector(nu, 0.0), noBodyForces,
+                            udotBias, A_GB);
+    for (int j = 0; j < nf; ++j) {
+        SimTK::Vector fj(F(j));
+        matter.calcAcceleration(s, fj, noBodyForces, expected, A_GB);
+        SimTK::Vector full(fullUDots(j)), linear(udots(j));
+        assertVectorsEqual(expected, full, 1e-8);
+        expected -= udotBias;
+        assertVectorsEqual(expected, linear, 1e-8);
+    }
+
+    cout << modelFile << ": " << nu << " mobilities, "
+         << solver.getNumMultipliers() << " multipliers passed." << endl;
+}
@@ -0,0 +1,160 @@
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  testComponentProfiler.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ * Author(s): Peter Eastman, Ajay Seth                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <OpenSim/Simulation/Manager/Manager.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/Muscle.h>
+#include <OpenSim/Analyses/ForceReporter.h>
+#include <OpenSim/Common/ComponentProfiler.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testComponentProfiler tests that ComponentProfiler records nothing until it
+// is enabled, and that it then records the hot paths of the components of a
+// simulation and writes them to the report file when asked to, which
+// Manager::integrate() does not do itself. It also tests that counts made on
+// several threads are merged.
+//==============================================================================
+void testSimulationProfile(const string& modelFile);
+void testThreadedCounts();
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testSimulationProfile("arm26.osim");
+        testThreadedCounts();
+    }
+    catch (const Exception& e) {
+        cout << "testComponentProfiler failed: ";
+        e.print(cout);
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testComponentProfiler failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+string profileAsJSON()
+{
+    stringstream json;
+    ComponentProfiler::printJSON(json);
+    return json.str();
+}
+
+void simulate(Model& model, double finalTime)
+{
+    SimTK::State& s = model.initSystem();
+    model.equilibrateMuscles(s);
+    SimTK::RungeKuttaMersonIntegrator integrator(model.getMultibodySystem());
+    Manager manager(model, integrator);
+    manager.setInitialTime(0.0);
+    manager.setFinalTime(finalTime);
+    manager.integrate(s);
+}
+
+void testSimulationProfile(const string& modelFile)
+{
+    Model model(modelFile);
+    model.addAnalysis(new ForceReporter(&model));
+
+    // Disabled, nothing is recorded.
+    ComponentProfiler::reset();
+    ASSERT(!ComponentProfiler::isEnabled());
+    simulate(model, 0.01);
+    ASSERT(profileAsJSON().find("\"component\"") == string::npos);
+
+    const string reportFile = "testComponentProfiler_arm26.json";
+    remove(reportFile.c_str());
+    ComponentProfiler::setEnabled(true);
+    ComponentProfiler::setReportFileName(reportFile);
+    simulate(model, 0.05);
+    ASSERT(!ifstream(reportFile.c_str()).good());
+    ComponentProfiler::report("testSimulationProfile");
+    ComponentProfiler::setEnabled(false);
+    ComponentProfiler::setReportFileName("");
+
+    ifstream in(reportFile.c_str());
+    ASSERT(in.good());
+    stringstream contents;
+    contents << in.rdbuf();
+    const string json = contents.str();
+    ASSERT(json.find("\"title\": \"testSimulationProfile\"") != string::npos);
+
+    // Each muscle's force, path and equilibrium, the wrapping of the triceps
+    // and the analysis are all there.
+    const Set<Muscle>& muscles = model.getMuscles();
+    for (int i = 0; i < muscles.getSize(); ++i) {
+        const string label = "\"component\": \"" +
+            muscles[i].getConcreteClassName() + " " + muscles[i].getName();
+        ASSERT(json.find(label + "\", \"section\": \"computeForce\"")
+               != string::npos);
+        ASSERT(json.find(label + "\", \"section\": \"GeometryPath::computePath\"")
+               != string::npos);
+        ASSERT(json.find(label + "\", \"section\": \"equilibrate\"")
+               != string::npos);
+        ASSERT(json.find(label + "\", \"section\": \"equilibrium iterations\"")
+               != string::npos);
+    }
+    ASSERT(json.find("\"section\": \"GeometryPath::applyWrapObjects\"")
+           != string::npos);
+    ASSERT(json.find("\"section\": \"wrapPathSegment\"") != string::npos);
+    ASSERT(json.find("\"component\": \"ForceReporter ForceReporter\", "
+                     "\"section\": \"step\"") != string::npos);
+
+    ComponentProfiler::reset();
+    ASSERT(profileAsJSON().find("\"component\"") == string::npos);
+}
+
+void testThreadedCounts()
+{
+    Model model;
+    model.setName("counted");
+    const int numThreads = 4, numCounts = 10000;
+
+    ComponentProfiler::reset();
+    ComponentProfiler::setEnabled(true);
+    vector<thread> threads;
+    for (int i = 0; i < numThreads; ++i)
+        threads.push_back(thread([&model]() {
+            for (int j = 0; j < numCounts; ++j)
+                ComponentProfiler::count(model, "counts", 2);
+        }));
+    for (int i = 0; i < numThreads; ++i)
+        threads[i].join();
+    ComponentProfiler::setEnabled(false);
+
+    stringstream expected;
+    expected << "\"component\": \"Model counted\", \"section\": \"counts\", "
+             << "\"calls\": " << 2*numThreads*numCounts << ",";
+    ASSERT(profileAsJSON().find(expected.str()) != string::npos);
+    ComponentProfiler::reset();
+}
@@ -0,0 +1,166 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  testModelCache.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <exception>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ModelCache.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testModelCache tests that models handed out by a ModelCache are equivalent
+// to a model loaded from file, are independent of each other, and that a
+// model is reloaded when its file changes, also when several threads acquire
+// the same file under different names.
+//==============================================================================
+void testCachedModelMatchesFile(const string& modelFile);
+void testCachedModelsAreIndependent(const string& modelFile);
+void testReloadWhenFileChanges(const string& modelFile);
+void testConcurrentAcquire(const string& modelFile);
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testCachedModelMatchesFile("arm26.osim");
+        testCachedModelsAreIndependent("arm26.osim");
+        testReloadWhenFileChanges("arm26.osim");
+        testConcurrentAcquire("arm26.osim");
+    }
+    catch (const Exception& e) {
+        cout << "testModelCache failed: ";
+        e.print(cout);
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testModelCache failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+//==============================================================================
+// Test Cases
+//==============================================================================
+void testCachedModelMatchesFile(const string& modelFile)
+{
+    ModelCache cache;
+    Model model(modelFile);
+    const SimTK::State& s = model.initSystem();
+
+    for (int i = 0; i < 2; ++i) {
+        std::unique_ptr<Model> cached = cache.acquire(modelFile);
+        const SimTK::State& sc = cached->getWorkingState();
+        ASSERT(cached->getNumStateVariables() == model.getNumStateVariables());
+        ASSERT(sc.getNY() == s.getNY());
+        for (int j = 0; j < s.getNY(); ++j)
+            ASSERT_EQUAL(s.getY()[j], sc.getY()[j], 1e-12);
+    }
+    ASSERT(cache.getNumTemplates() == 1);
+    ASSERT(cache.getNumMisses() == 1);
+    ASSERT(cache.getNumHits() == 1);
+}
+
+void testCachedModelsAreIndependent(const string& modelFile)
+{
+    ModelCache cache;
+    std::unique_ptr<Model> first = cache.acquire(modelFile, false);
+    const string coordName = first->getCoordinateSet().get(0).getName();
+    const double defaultValue =
+        first->getCoordinateSet().get(0).getDefaultValue();
+    first->updCoordinateSet().get(0).setDefaultValue(defaultValue + 0.5);
+    first->initSystem();
+
+    std::unique_ptr<Model> second = cache.acquire(modelFile);
+    ASSERT_EQUAL(defaultValue,
+        second->getCoordinateSet().get(coordName).getDefaultValue(), 1e-12);
+    ASSERT_EQUAL(defaultValue + 0.5,
+        first->getCoordinateSet().get(coordName).getDefaultValue(), 1e-12);
+
+    // Each model has its own System and State.
+    ASSERT(&first->getMultibodySystem() != &second->getMultibodySystem());
+    first.reset();
+    second->getMultibodySystem().realize(second->getWorkingState(),
+                                         SimTK::Stage::Acceleration);
+}
+
+void testReloadWhenFileChanges(const string& modelFile)
+{
+    const string copyFile = "testModelCache_copy.osim";
+    Model model(modelFile);
+    model.print(copyFile);
+
+    ModelCache cache;
+    std::unique_ptr<Model> original = cache.acquire(copyFile, false);
+
+    model.setName("testModelCache_renamed");
+    model.print(copyFile);
+    std::unique_ptr<Model> changed = cache.acquire(copyFile, false);
+
+    ASSERT(original->getName() != changed->getName());
+    ASSERT(changed->getName() == "testModelCache_renamed");
+    ASSERT(cache.getNumMisses() == 2);
+    ASSERT(cache.getNumTemplates() == 1);
+}
+
+void testConcurrentAcquire(const string& modelFile)
+{
+    ASSERT(ModelCache::getKey(modelFile) ==
+           ModelCache::getKey("./" + modelFile));
+    ASSERT(ModelCache::getKey(modelFile) ==
+           ModelCache::getKey("unused/../" + modelFile));
+
+    ModelCache cache;
+    const int numThreads = 8;
+    vector<std::unique_ptr<Model> > models(numThreads);
+    vector<std::exception_ptr> errors(numThreads);
+    vector<std::thread> threads;
+    for (int i = 0; i < numThreads; ++i) {
+        threads.push_back(std::thread([&, i]() {
+            try {
+                models[i] = cache.acquire(i % 2 ? "./" + modelFile : modelFile,
+                                          false);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }));
+    }
+    for (int i = 0; i < numThreads; ++i) threads[i].join();
+    for (int i = 0; i < numThreads; ++i)
+        if (errors[i]) std::rethrow_exception(errors[i]);
+
+    // The file was read once, whichever thread got there first.
+    ASSERT(cache.getNumTemplates() == 1);
+    ASSERT(cache.getNumMisses() == 1);
+    ASSERT(cache.getNumHits() == numThreads - 1);
+    for (int i = 1; i < numThreads; ++i) {
+        ASSERT(models[i].get() != models[0].get());
+        ASSERT(models[i]->getNumCoordinates() ==
+               models[0]->getNumCoordinates());
+    }
+}
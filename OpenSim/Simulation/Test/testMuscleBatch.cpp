@@ -0,0 +1,223 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  testMuscleBatch.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ActivationFiberLengthMuscle.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testMuscleBatch checks that the muscles of gait2354 (Thelen2003Muscles)
+// evaluated together by a MuscleBatch, with
+// ForceSet::setUseBatchedMuscleEvaluation(), have exactly the same length,
+// velocity and dynamics info as when each muscle computes its own, over
+// random states that include clamped fibers and inactive muscles. It also
+// times the realization of accelerations both ways.
+//==============================================================================
+void testBatchedMusclesMatch(const string& modelFile, int numStates);
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testBatchedMusclesMatch("gait2354_simbody.osim", 200);
+    }
+    catch (const Exception& e) {
+        cout << "testMuscleBatch failed: ";
+        e.print(cout);
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testMuscleBatch failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+//==============================================================================
+// Test Cases
+//==============================================================================
+void compare(double expected, double found, const string& what)
+{
+    ASSERT(expected == found ||
+           (SimTK::isNaN(expected) && SimTK::isNaN(found)), __FILE__,
+           __LINE__, what + " differs with batched muscle evaluation.");
+}
+
+void compareMuscles(const Model& model, const SimTK::State& s,
+                    const Model& batchedModel, const SimTK::State& bs)
+{
+    const Set<Muscle>& muscles = model.getMuscles();
+    const Set<Muscle>& batched = batchedModel.getMuscles();
+    for (int i = 0; i < muscles.getSize(); ++i) {
+        const string& name = muscles[i].getName();
+        const Muscle::MuscleLengthInfo& a = muscles[i].getMuscleLengthInfo(s);
+        const Muscle::MuscleLengthInfo& b = batched[i].getMuscleLengthInfo(bs);
+        compare(a.fiberLength, b.fiberLength, name + " fiberLength");
+        compare(a.fiberLengthAlongTendon, b.fiberLengthAlongTendon,
+                name + " fiberLengthAlongTendon");
+        compare(a.normFiberLength, b.normFiberLength, name + " normFiberLength");
+        compare(a.tendonLength, b.tendonLength, name + " tendonLength");
+        compare(a.normTendonLength, b.normTendonLength,
+                name + " normTendonLength");
+        compare(a.tendonStrain, b.tendonStrain, name + " tendonStrain");
+        compare(a.pennationAngle, b.pennationAngle, name + " pennationAngle");
+        compare(a.cosPennationAngle, b.cosPennationAngle,
+                name + " cosPennationAngle");
+        compare(a.sinPennationAngle, b.sinPennationAngle,
+                name + " sinPennationAngle");
+        compare(a.fiberPassiveForceLengthMultiplier,
+                b.fiberPassiveForceLengthMultiplier, name + " fpe");
+        compare(a.fiberActiveForceLengthMultiplier,
+                b.fiberActiveForceLengthMultiplier, name + " fal");
+
+        const Muscle::FiberVelocityInfo& c = muscles[i].getFiberVelocityInfo(s);
+        const Muscle::FiberVelocityInfo& d = batched[i].getFiberVelocityInfo(bs);
+        compare(c.fiberVelocity, d.fiberVelocity, name + " fiberVelocity");
+        compare(c.fiberVelocityAlongTendon, d.fiberVelocityAlongTendon,
+                name + " fiberVelocityAlongTendon");
+        compare(c.normFiberVelocity, d.normFiberVelocity,
+                name + " normFiberVelocity");
+        compare(c.pennationAngularVelocity, d.pennationAngularVelocity,
+                name + " pennationAngularVelocity");
+        compare(c.tendonVelocity, d.tendonVelocity, name + " tendonVelocity");
+        compare(c.normTendonVelocity, d.normTendonVelocity,
+                name + " normTendonVelocity");
+        compare(c.fiberForceVelocityMultiplier, d.fiberForceVelocityMultiplier,
+                name + " fv");
+        ASSERT(c.userDefinedVelocityExtras.size() ==
+               d.userDefinedVelocityExtras.size());
+        for (int j = 0; j < c.userDefinedVelocityExtras.size(); ++j)
+            compare(c.userDefinedVelocityExtras[j],
+                    d.userDefinedVelocityExtras[j], name + " velocity extras");
+
+        const Muscle::MuscleDynamicsInfo& e = muscles[i].getMuscleDynamicsInfo(s);
+        const Muscle::MuscleDynamicsInfo& f = batched[i].getMuscleDynamicsInfo(bs);
+        compare(e.activation, f.activation, name + " activation");
+        compare(e.fiberForce, f.fiberForce, name + " fiberForce");
+        compare(e.fiberForceAlongTendon, f.fiberForceAlongTendon,
+                name + " fiberForceAlongTendon");
+        compare(e.normFiberForce, f.normFiberForce, name + " normFiberForce");
+        compare(e.activeFiberForce, f.activeFiberForce,
+                name + " activeFiberForce");
+        compare(e.passiveFiberForce, f.passiveFiberForce,
+                name + " passiveFiberForce");
+        compare(e.tendonForce, f.tendonForce, name + " tendonForce");
+        compare(e.normTendonForce, f.normTendonForce, name + " normTendonForce");
+        compare(e.fiberStiffness, f.fiberStiffness, name + " fiberStiffness");
+        compare(e.fiberStiffnessAlongTendon, f.fiberStiffnessAlongTendon,
+                name + " fiberStiffnessAlongTendon");
+        compare(e.tendonStiffness, f.tendonStiffness, name + " tendonStiffness");
+        compare(e.muscleStiffness, f.muscleStiffness, name + " muscleStiffness");
+        compare(e.fiberActivePower, f.fiberActivePower,
+                name + " fiberActivePower");
+        compare(e.fiberPassivePower, f.fiberPassivePower,
+                name + " fiberPassivePower");
+        compare(e.tendonPower, f.tendonPower, name + " tendonPower");
+        compare(e.musclePower, f.musclePower, name + " musclePower");
+        ASSERT(e.userDefinedDynamicsExtras.size() ==
+               f.userDefinedDynamicsExtras.size());
+        for (int j = 0; j < e.userDefinedDynamicsExtras.size(); ++j)
+            compare(e.userDefinedDynamicsExtras[j],
+                    f.userDefinedDynamicsExtras[j], name + " dynamics extras");
+    }
+
+    ASSERT(s.getNU() == bs.getNU());
+    for (int j = 0; j < s.getNU(); ++j)
+        compare(s.getUDot()[j], bs.getUDot()[j], "udot");
+}
+
+void testBatchedMusclesMatch(const string& modelFile, int numStates)
+{
+    Model model(modelFile);
+    SimTK::State& s = model.initSystem();
+    ASSERT(model.getForceSet().getNumMuscleBatches() == 0);
+
+    Model batchedModel(modelFile);
+    batchedModel.updForceSet().setUseBatchedMuscleEvaluation(true);
+    SimTK::State& bs = batchedModel.initSystem();
+    ASSERT(batchedModel.getForceSet().getNumMuscleBatches() == 1);
+
+    // Random states within the ranges of the coordinates. One in ten muscles
+    // is inactive, and one in ten has its fiber at its minimum length.
+    SimTK::Random::Uniform random(0, 1);
+    random.setSeed(0);
+    const CoordinateSet& coordinates = model.getCoordinateSet();
+    const Set<Muscle>& muscles = model.getMuscles();
+    std::vector<SimTK::State> states;
+    for (int k = 0; k < numStates; ++k) {
+        for (int i = 0; i < coordinates.getSize(); ++i) {
+            const Coordinate& c = coordinates[i];
+            if (c.getLocked(s)) continue;
+            c.setValue(s, c.getRangeMin() + random.getValue()
+                       *(c.getRangeMax()-c.getRangeMin()), false);
+            c.setSpeedValue(s, 4*random.getValue()-2);
+        }
+        for (int i = 0; i < muscles.getSize(); ++i) {
+            const ActivationFiberLengthMuscle& m =
+                dynamic_cast<const ActivationFiberLengthMuscle&>(muscles[i]);
+            double r = random.getValue();
+            m.setActivation(s, r < 0.1 ? 0 : random.getValue());
+            r = random.getValue();
+            m.setFiberLength(s, r < 0.1 ? 0 :
+                (0.5 + random.getValue())*m.getOptimalFiberLength());
+        }
+        states.push_back(s);
+    }
+
+    double time = 0, batchedTime = 0;
+    for (int k = 0; k < numStates; ++k) {
+        s.updY() = states[k].getY();
+        bs.updY() = states[k].getY();
+
+        double start = SimTK::realTime();
+        model.getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+        time += SimTK::realTime() - start;
+
+        start = SimTK::realTime();
+        batchedModel.getMultibodySystem().realize(bs,
+                                                  SimTK::Stage::Acceleration);
+        batchedTime += SimTK::realTime() - start;
+
+        compareMuscles(model, s, batchedModel, bs);
+    }
+
+    // Changing the fiber length of one muscle invalidates only its own info,
+    // so the batch computes that muscle alone.
+    const ActivationFiberLengthMuscle& first =
+        dynamic_cast<const ActivationFiberLengthMuscle&>(muscles[0]);
+    const ActivationFiberLengthMuscle& batchedFirst =
+        dynamic_cast<const ActivationFiberLengthMuscle&>(
+            batchedModel.getMuscles()[0]);
+    first.setFiberLength(s, 1.1*first.getOptimalFiberLength());
+    batchedFirst.setFiberLength(bs, 1.1*first.getOptimalFiberLength());
+    model.getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+    batchedModel.getMultibodySystem().realize(bs, SimTK::Stage::Acceleration);
+    compareMuscles(model, s, batchedModel, bs);
+
+    cout << modelFile << ": " << muscles.getSize() << " muscles, "
+         << 1e6*time/numStates << " us per realization of accelerations, "
+         << 1e6*batchedTime/numStates << " us with batched muscles." << endl;
+}
@@ -0,0 +1,184 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testParallelForces.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ActivationFiberLengthMuscle.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testParallelForces checks that the forces of gait2354 evaluated on several
+// threads, with ForceSet::setUseParallelEvaluation(), give the accelerations
+// of serial evaluation to within roundoff, and exactly the same accelerations
+// from one evaluation to the next, for any number of threads and with or
+// without batched muscles. It also times the realization of accelerations
+// both ways.
+//==============================================================================
+void testParallelForcesMatch(const string& modelFile, int numStates);
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testParallelForcesMatch("gait2354_simbody.osim", 100);
+    }
+    catch (const Exception& e) {
+        cout << "testParallelForces failed: ";
+        e.print(cout);
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testParallelForces failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+//==============================================================================
+// Test Cases
+//==============================================================================
+void compareExactly(const SimTK::Vector& expected, const SimTK::Vector& found,
+                    const string& what)
+{
+    ASSERT(expected.size() == found.size());
+    for (int j = 0; j < expected.size(); ++j)
+        ASSERT(expected[j] == found[j], __FILE__, __LINE__,
+               what + " differs between parallel evaluations.");
+}
+
+void compareToSerial(const SimTK::Vector& expected, const SimTK::Vector& found)
+{
+    ASSERT(expected.size() == found.size());
+    for (int j = 0; j < expected.size(); ++j)
+        ASSERT_EQUAL(expected[j], found[j], 1e-9*(1 + std::abs(expected[j])),
+                     __FILE__, __LINE__,
+                     "Parallel evaluation differs from serial evaluation.");
+}
+
+void testParallelForcesMatch(const string& modelFile, int numStates)
+{
+    Model model(modelFile);
+    SimTK::State& s = model.initSystem();
+    ASSERT(model.getForceSet().getNumParallelChunks() == 0);
+
+    // Four threads, one thread (the chunks summed in turn) and four threads
+    // with batched muscles divide the forces into the same chunks.
+    Model parallelModel(modelFile);
+    parallelModel.updForceSet().setUseParallelEvaluation(true, 4);
+    SimTK::State& ps = parallelModel.initSystem();
+    const int numChunks = parallelModel.getForceSet().getNumParallelChunks();
+    ASSERT(numChunks > 1);
+
+    Model oneThreadModel(modelFile);
+    oneThreadModel.updForceSet().setUseParallelEvaluation(true, 1);
+    SimTK::State& os = oneThreadModel.initSystem();
+    ASSERT(oneThreadModel.getForceSet().getNumParallelChunks() == numChunks);
+
+    Model batchedModel(modelFile);
+    batchedModel.updForceSet().setUseBatchedMuscleEvaluation(true);
+    batchedModel.updForceSet().setUseParallelEvaluation(true, 4);
+    SimTK::State& bs = batchedModel.initSystem();
+    ASSERT(batchedModel.getForceSet().getNumParallelChunks() == numChunks);
+
+    // Random states within the ranges of the coordinates, with one muscle
+    // disabled in every other state.
+    SimTK::Random::Uniform random(0, 1);
+    random.setSeed(0);
+    const CoordinateSet& coordinates = model.getCoordinateSet();
+    const Set<Muscle>& muscles = model.getMuscles();
+    std::vector<SimTK::State> states;
+    for (int k = 0; k < numStates; ++k) {
+        for (int i = 0; i < coordinates.getSize(); ++i) {
+            const Coordinate& c = coordinates[i];
+            if (c.getLocked(s)) continue;
+            c.setValue(s, c.getRangeMin() + random.getValue()
+                       *(c.getRangeMax()-c.getRangeMin()), false);
+            c.setSpeedValue(s, 4*random.getValue()-2);
+        }
+        for (int i = 0; i < muscles.getSize(); ++i) {
+            const ActivationFiberLengthMuscle& m =
+                dynamic_cast<const ActivationFiberLengthMuscle&>(muscles[i]);
+            m.setActivation(s, random.getValue());
+            m.setFiberLength(s,
+                (0.5 + random.getValue())*m.getOptimalFiberLength());
+        }
+        states.push_back(s);
+    }
+
+    double time = 0, parallelTime = 0;
+    SimTK::Vector udot;
+    for (int k = 0; k < numStates; ++k) {
+        const int disabled = k % 2 ? k % muscles.getSize() : -1;
+        SimTK::State* all[] = { &s, &ps, &os, &bs };
+        const Model* models[] = { &model, &parallelModel, &oneThreadModel,
+                                  &batchedModel };
+        for (int m = 0; m < 4; ++m) {
+            all[m]->updY() = states[k].getY();
+            const Set<Muscle>& set = models[m]->getMuscles();
+            for (int i = 0; i < set.getSize(); ++i)
+                set[i].setDisabled(*all[m], i == disabled);
+        }
+
+        double start = SimTK::realTime();
+        model.getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+        time += SimTK::realTime() - start;
+
+        start = SimTK::realTime();
+        parallelModel.getMultibodySystem().realize(ps,
+                                                   SimTK::Stage::Acceleration);
+        parallelTime += SimTK::realTime() - start;
+        oneThreadModel.getMultibodySystem().realize(os,
+                                                    SimTK::Stage::Acceleration);
+        batchedModel.getMultibodySystem().realize(bs,
+                                                  SimTK::Stage::Acceleration);
+
+        compareToSerial(s.getUDot(), ps.getUDot());
+        compareExactly(ps.getUDot(), os.getUDot(), "One thread");
+        compareExactly(ps.getUDot(), bs.getUDot(), "Batched muscles");
+
+        // Evaluating the same state again gives the same bits.
+        udot = ps.getUDot();
+        ps.invalidateAllCacheAtOrAbove(SimTK::Stage::Dynamics);
+        parallelModel.getMultibodySystem().realize(ps,
+                                                   SimTK::Stage::Acceleration);
+        compareExactly(udot, ps.getUDot(), "Repeated evaluation");
+    }
+
+    // The contribution of one muscle is computed even though its adapter
+    // is deferred to the ForceSet.
+    SimTK::Vector_<SimTK::SpatialVec> bodyForces, parallelBodyForces;
+    SimTK::Vector mobilityForces, parallelMobilityForces;
+    model.getMuscles()[0].calcForceContribution(s, bodyForces, mobilityForces);
+    parallelModel.getMuscles()[0].calcForceContribution(ps,
+        parallelBodyForces, parallelMobilityForces);
+    ASSERT(bodyForces.size() == parallelBodyForces.size());
+    for (int b = 0; b < bodyForces.size(); ++b)
+        ASSERT(bodyForces[b] == parallelBodyForces[b]);
+    compareExactly(mobilityForces, parallelMobilityForces, "Contribution");
+
+    cout << modelFile << ": " << numChunks << " chunks, "
+         << 1e6*time/numStates << " us per realization of accelerations, "
+         << 1e6*parallelTime/numStates << " us with 4 threads." << endl;
+}
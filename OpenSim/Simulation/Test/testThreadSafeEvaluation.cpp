@@ -0,0 +1,162 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  testThreadSafeEvaluation.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/Muscle.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testThreadSafeEvaluation realizes many States of one Model to Acceleration
+// from several threads at once, with Model::setUseThreadSafeEvaluation(), and
+// checks that every result is identical to the one realized on this thread
+// alone. The muscles of arm26 wrap over cylinders, and those of gait2354 have
+// moving and conditional path points.
+//==============================================================================
+void testConcurrentRealization(const string& modelFile, int numStates,
+                               int numThreads, int numRounds);
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testConcurrentRealization("arm26.osim", 64, 8, 10);
+        testConcurrentRealization("gait2354_simbody.osim", 64, 8, 5);
+    }
+    catch (const Exception& e) {
+        cout << "testThreadSafeEvaluation failed: ";
+        e.print(cout);
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testThreadSafeEvaluation failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+//==============================================================================
+// Test Cases
+//==============================================================================
+// What is compared after realizing a State to Acceleration.
+struct Result {
+    SimTK::Vector udot;
+    std::vector<double> lengths;
+    std::vector<double> tensions;
+};
+
+Result realizeAndRecord(const Model& model, SimTK::State& s)
+{
+    model.getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+    Result result;
+    result.udot = s.getUDot();
+    const Set<Muscle>& muscles = model.getMuscles();
+    for (int i = 0; i < muscles.getSize(); ++i) {
+        result.lengths.push_back(muscles[i].getLength(s));
+        result.tensions.push_back(muscles[i].getTendonForce(s));
+    }
+    return result;
+}
+
+void testConcurrentRealization(const string& modelFile, int numStates,
+                               int numThreads, int numRounds)
+{
+    Model model(modelFile);
+    model.setUseThreadSafeEvaluation(true);
+    const SimTK::State& defaultState = model.initSystem();
+
+    // Spread the states over the ranges of the unlocked coordinates. The
+    // constraints need not be satisfied for the results to be repeatable.
+    SimTK::Random::Uniform random(0, 1);
+    random.setSeed(0);
+    const CoordinateSet& coordinates = model.getCoordinateSet();
+    std::vector<SimTK::State> states(numStates, defaultState);
+    for (int k = 0; k < numStates; ++k) {
+        for (int i = 0; i < coordinates.getSize(); ++i) {
+            const Coordinate& c = coordinates[i];
+            if (c.getLocked(states[k])) continue;
+            const double r = random.getValue();
+            c.setValue(states[k],
+                c.getRangeMin() + r*(c.getRangeMax()-c.getRangeMin()), false);
+            c.setSpeedValue(states[k], 2*random.getValue()-1);
+        }
+    }
+
+    std::vector<Result> expected;
+    for (int k = 0; k < numStates; ++k) {
+        SimTK::State s = states[k];
+        expected.push_back(realizeAndRecord(model, s));
+    }
+
+    // Each round realizes fresh copies of the states, so that what a wrap
+    // remembers from one realization to the next is the same as above.
+    double start = SimTK::realTime();
+    for (int round = 0; round < numRounds; ++round) {
+        std::vector<SimTK::State> copies(states);
+        std::vector<Result> results(numStates);
+        std::atomic<int> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        auto realize = [&]() {
+            for (int k = next++; k < numStates; k = next++) {
+                try {
+                    results[k] = realizeAndRecord(model, copies[k]);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) error = std::current_exception();
+                    next = numStates;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 1; t < numThreads; ++t)
+            threads.push_back(std::thread(realize));
+        realize();
+        for (unsigned t = 0; t < threads.size(); ++t)
+            threads[t].join();
+        if (error) std::rethrow_exception(error);
+
+        for (int k = 0; k < numStates; ++k) {
+            const Result& r = results[k];
+            const Result& e = expected[k];
+            ASSERT(r.udot.size() == e.udot.size());
+            for (int i = 0; i < e.udot.size(); ++i)
+                ASSERT(r.udot[i] == e.udot[i], __FILE__, __LINE__,
+                       modelFile + ": accelerations differ between threads.");
+            ASSERT(r.lengths == e.lengths, __FILE__, __LINE__,
+                   modelFile + ": muscle lengths differ between threads.");
+            ASSERT(r.tensions == e.tensions, __FILE__, __LINE__,
+                   modelFile + ": muscle tensions differ between threads.");
+        }
+    }
+    cout << modelFile << ": " << numRounds*numStates << " states realized on "
+         << numThreads << " threads in " << SimTK::realTime()-start << " s."
+         << endl;
+}
@@ -89,6 +89,8 @@ PathWrap::PathWrap(const PathWrap& aPathWrap) :
 void PathWrap::setNull()
 {
     _method = hybrid;
+    _wrapObject = NULL;
+    _path = NULL;
 
     resetPreviousWrap();
 }
@@ -165,6 +167,7 @@ void PathWrap::copyData(const PathWrap& aPathWrap)
     _method = aPathWrap._method;
     _range = aPathWrap._range;
     _wrapObject = aPathWrap._wrapObject;
+    _path = aPathWrap._path;
     _previousWrap = aPathWrap._previousWrap;
 
     _wrapPoints[0] = aPathWrap._wrapPoints[0];
@@ -26,6 +26,7 @@
 #include "Model/AnalysisSet.h"
 #include "Model/Bhargava2004MuscleMetabolicsProbe.h"
 #include "Model/Model.h"
+#include "Model/ModelCache.h"
 #include "Model/ModelDisplayHints.h"
 #include "Model/ModelVisualizer.h"
 #include "Model/ForceSet.h"
@@ -112,6 +113,7 @@
 #include "SimbodyEngine/SpatialTransform.h"
 
 #include "MomentArmSolver.h"
+#include "AccelerationSolver.h"
 
 #include "RegisterTypes_osimSimulation.h"   // to expose RegisterTypes_osimSimulation
 
@@ -0,0 +1,315 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testCoreWorkloads.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <memory>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/MarkersReference.h>
+#include <OpenSim/Simulation/CoordinateReference.h>
+#include <OpenSim/Simulation/InverseKinematicsSolver.h>
+#include <OpenSim/Simulation/Manager/Manager.h>
+#include <OpenSim/Common/SmoothSegmentedFunctionFactory.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Analyses/StaticOptimization.h>
+#include <OpenSim/Tools/AnalyzeTool.h>
+#include <OpenSim/Tools/InverseDynamicsTool.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <OpenSim/Auxiliary/benchmarkFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testCoreWorkloads times the workloads that dominate typical OpenSim runs,
+// so that their performance can be tracked between releases. Results are
+// written to testCoreWorkloads.json (see OpenSim/Auxiliary/benchmarkFunctions.h
+// for the options). Pass --benchmark_min_time=<seconds> for steadier numbers
+// than the short default used when running as a test.
+//==============================================================================
+void benchmarkModelLoading(BenchmarkSuite& suite, const string& modelFile);
+void benchmarkRealizeAcceleration(BenchmarkSuite& suite, const string& modelFile);
+void benchmarkPathLength(BenchmarkSuite& suite, const string& modelFile);
+void benchmarkSmoothSegmentedFunction(BenchmarkSuite& suite);
+void benchmarkStorage(BenchmarkSuite& suite);
+void benchmarkInverseKinematics(BenchmarkSuite& suite, const string& modelFile,
+                                const string& markerFile);
+void benchmarkInverseDynamics(BenchmarkSuite& suite, const string& modelFile,
+                              const string& motionFile);
+void benchmarkStaticOptimization(BenchmarkSuite& suite, const string& modelFile,
+                                 const string& motionFile);
+void benchmarkForwardSimulation(BenchmarkSuite& suite, const string& modelFile);
+
+int main(int argc, char** argv)
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        BenchmarkSuite suite("testCoreWorkloads", argc, argv, 0.2);
+
+        benchmarkModelLoading(suite, "gait2354_simbody.osim");
+        benchmarkModelLoading(suite, "arm26.osim");
+        benchmarkRealizeAcceleration(suite, "gait2354_simbody.osim");
+        benchmarkRealizeAcceleration(suite, "arm26.osim");
+        benchmarkPathLength(suite, "arm26.osim");
+        benchmarkSmoothSegmentedFunction(suite);
+        benchmarkStorage(suite);
+        benchmarkInverseKinematics(suite, "subject01_simbody.osim",
+                                   "subject01_synthetic_marker_data.trc");
+        benchmarkInverseDynamics(suite, "arm26.osim",
+                                 "arm26_InverseKinematics.mot");
+        benchmarkStaticOptimization(suite, "arm26.osim",
+                                    "arm26_InverseKinematics.mot");
+        benchmarkForwardSimulation(suite, "arm26.osim");
+
+        suite.writeResults();
+    }
+    catch (const Exception& e) {
+        cout << "testCoreWorkloads failed: ";
+        e.print(cout);
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testCoreWorkloads failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+// The name of a model file without its extension, to label results.
+string baseName(const string& fileName)
+{
+    return fileName.substr(0, fileName.find_last_of('.'));
+}
+
+// Number of rows of a Storage file between two times, inclusive.
+int countFrames(const string& fileName, double startTime, double endTime)
+{
+    Storage storage(fileName);
+    int numFrames = 0;
+    for (int i = 0; i < storage.getSize(); ++i) {
+        double time = storage.getStateVector(i)->getTime();
+        if (time >= startTime && time <= endTime) ++numFrames;
+    }
+    return numFrames;
+}
+
+void benchmarkModelLoading(BenchmarkSuite& suite, const string& modelFile)
+{
+    suite.run("LoadModel/" + baseName(modelFile), [&]() {
+        Model model(modelFile);
+        return 1.0;
+    });
+
+    // initSystem() rebuilds the System every time it is called.
+    Model model(modelFile);
+    suite.run("InitSystem/" + baseName(modelFile), [&]() {
+        model.initSystem();
+        return 1.0;
+    });
+}
+
+void benchmarkRealizeAcceleration(BenchmarkSuite& suite, const string& modelFile)
+{
+    Model model(modelFile);
+    SimTK::State& s = model.initSystem();
+    model.equilibrateMuscles(s);
+    const SimTK::Vector q0 = s.getQ();
+    const int numRealizations = 100;
+
+    // Changing a coordinate invalidates every stage from Position on.
+    suite.run("RealizeAcceleration/" + baseName(modelFile), [&]() {
+        for (int k = 0; k < numRealizations; ++k) {
+            s.updQ() = q0;
+            s.updQ()[0] += 1e-4*(k % 10);
+            model.getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+        }
+        return double(numRealizations);
+    });
+}
+
+void benchmarkPathLength(BenchmarkSuite& suite, const string& modelFile)
+{
+    Model model(modelFile);
+    SimTK::State& s = model.initSystem();
+    const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+    const Set<Muscle>& muscles = model.getMuscles();
+    const int numPoses = 50;
+
+    // The elbow moves the triceps paths across their wrap cylinders.
+    suite.run("GeometryPathLength/" + baseName(modelFile), [&]() {
+        double total = 0;
+        for (int k = 0; k < numPoses; ++k) {
+            elbow.setValue(s, 2.0*k/numPoses, false);
+            for (int i = 0; i < muscles.getSize(); ++i)
+                total += muscles[i].getGeometryPath().getLength(s);
+        }
+        ASSERT(total > 0);
+        return double(numPoses*muscles.getSize());
+    });
+}
+
+void benchmarkSmoothSegmentedFunction(BenchmarkSuite& suite)
+{
+    unique_ptr<SmoothSegmentedFunction> curve(
+        SmoothSegmentedFunctionFactory::createFiberForceLengthCurve(
+            0.0, 0.7, 0.2, 2.0/0.7, 0.75, false, "fiberForceLength"));
+    const int numEvaluations = 10000;
+
+    suite.run("SmoothSegmentedFunction/calcValueAndDerivative", [&]() {
+        double total = 0;
+        for (int k = 0; k < numEvaluations; ++k) {
+            double x = 0.9 + 0.8*k/numEvaluations;
+            total += curve->calcValue(x) + curve->calcDerivative(x, 1);
+        }
+        ASSERT(total > 0);
+        return double(numEvaluations);
+    });
+}
+
+void benchmarkStorage(BenchmarkSuite& suite)
+{
+    const int numRows = 5000, numColumns = 60;
+    Storage storage(numRows, "benchmark");
+    Array<string> labels("", numColumns+1);
+    labels[0] = "time";
+    for (int j = 0; j < numColumns; ++j)
+        labels[j+1] = "column" + to_string(j);
+    storage.setColumnLabels(labels);
+    SimTK::Vector row(numColumns);
+    for (int i = 0; i < numRows; ++i) {
+        for (int j = 0; j < numColumns; ++j)
+            row[j] = sin(0.01*i + j);
+        storage.append(0.005*i, row);
+    }
+
+    const string fileName = "testCoreWorkloads_storage.sto";
+    suite.run("Storage/write", [&]() {
+        storage.print(fileName);
+        return double(numRows);
+    });
+    suite.run("Storage/read", [&]() {
+        Storage copy(fileName);
+        ASSERT(copy.getSize() == numRows);
+        return double(numRows);
+    });
+
+    const int numSearches = 10000;
+    suite.run("Storage/findIndex", [&]() {
+        int total = 0;
+        for (int k = 0; k < numSearches; ++k)
+            total += storage.findIndex(0.005*((k*7919) % numRows) + 0.001);
+        ASSERT(total > 0);
+        return double(numSearches);
+    });
+}
+
+void benchmarkInverseKinematics(BenchmarkSuite& suite, const string& modelFile,
+                                const string& markerFile)
+{
+    Model model(modelFile);
+    model.initSystem();
+    MarkerData markerData(markerFile);
+    markerData.convertToUnits(model.getLengthUnits());
+
+    Set<MarkerWeight> weights;
+    for (int j = 0; j < markerData.getNumMarkers(); ++j) {
+        const string& name = markerData.getMarkerNames()[j];
+        if (model.getMarkerSet().contains(name))
+            weights.adoptAndAppend(new MarkerWeight(name, 1.0));
+    }
+    MarkersReference markersReference(markerData, &weights);
+    SimTK::Array_<CoordinateReference> coordinateReferences;
+    InverseKinematicsSolver ikSolver(model, markersReference,
+                                     coordinateReferences);
+    ikSolver.setAccuracy(1e-5);
+    const int numFrames = markerData.getNumFrames();
+    const double dt = 1.0/markerData.getDataRate();
+
+    suite.run("InverseKinematics/" + baseName(modelFile), [&]() {
+        SimTK::State s = model.getWorkingState();
+        s.updTime() = markerData.getStartFrameTime();
+        ikSolver.assemble(s);
+        for (int i = 1; i < numFrames; ++i) {
+            s.updTime() = markerData.getStartFrameTime() + i*dt;
+            ikSolver.track(s);
+        }
+        return double(numFrames);
+    });
+}
+
+void benchmarkInverseDynamics(BenchmarkSuite& suite, const string& modelFile,
+                              const string& motionFile)
+{
+    Model model(modelFile);
+    InverseDynamicsTool idTool;
+    idTool.setModel(model);
+    idTool.setCoordinatesFileName(motionFile);
+    idTool.setLowpassCutoffFrequency(6.0);
+    idTool.setStartTime(0.0);
+    idTool.setEndTime(1.0);
+    idTool.setResultsDir("testCoreWorkloads_results");
+    idTool.setOutputGenForceFileName("inverse_dynamics.sto");
+    const int numFrames = countFrames(motionFile, 0.0, 1.0);
+
+    suite.run("InverseDynamics/" + baseName(modelFile), [&]() {
+        ASSERT(idTool.run());
+        return double(numFrames);
+    });
+}
+
+void benchmarkStaticOptimization(BenchmarkSuite& suite, const string& modelFile,
+                                 const string& motionFile)
+{
+    Model model(modelFile);
+    AnalyzeTool analyzeTool(model);
+    analyzeTool.setCoordinatesFileName(motionFile);
+    analyzeTool.setLowpassCutoffFrequency(6.0);
+    analyzeTool.setLoadModelAndInput(true);
+    analyzeTool.setInitialTime(0.25);
+    analyzeTool.setFinalTime(0.75);
+    analyzeTool.setResultsDir("testCoreWorkloads_results");
+    analyzeTool.setPrintResultFiles(false);
+    model.addAnalysis(new StaticOptimization(&model));
+    const int numFrames = countFrames(motionFile, 0.25, 0.75);
+
+    suite.run("StaticOptimization/" + baseName(modelFile), [&]() {
+        ASSERT(analyzeTool.run());
+        return double(numFrames);
+    });
+}
+
+void benchmarkForwardSimulation(BenchmarkSuite& suite, const string& modelFile)
+{
+    Model model(modelFile);
+    SimTK::State& s0 = model.initSystem();
+    model.equilibrateMuscles(s0);
+    const SimTK::State initialState = s0;
+
+    suite.run("ForwardSimulation1s/" + baseName(modelFile), [&]() {
+        SimTK::State s = initialState;
+        SimTK::RungeKuttaMersonIntegrator integrator(model.getMultibodySystem());
+        integrator.setAccuracy(1e-5);
+        Manager manager(model, integrator);
+        manager.setInitialTime(0.0);
+        manager.setFinalTime(1.0);
+        manager.integrate(s);
+        return 1.0;
+    });
+}
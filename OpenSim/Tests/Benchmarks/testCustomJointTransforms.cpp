@@ -0,0 +1,218 @@
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  testCustomJointTransforms.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <iomanip>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/SimbodyEngine/CustomJoint.h>
+#include <OpenSim/Simulation/SimbodyEngine/SpatialTransform.h>
+#include <OpenSim/Common/FunctionAdapter.h>
+#include <OpenSim/Common/MultiplierFunction.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testCustomJointTransforms times the evaluation of the spatial transforms of
+// CustomJoints. It compares FunctionAdapter's single-argument path with the
+// Vector and std::vector arguments it used to pass on, for a knee spline, and
+// realize(Position) of gait2354 with its pin-like CustomJoints built as Pin
+// mobilizers and as FunctionBased mobilizers, as they were before.
+//==============================================================================
+void benchmarkSplineEvaluation(const string& modelFile, int numEvaluations);
+void benchmarkRealizePosition(const string& modelFile, int numStates,
+                              int numRepeats);
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        benchmarkSplineEvaluation("gait2354_simbody.osim", 1000000);
+        benchmarkRealizePosition("gait2354_simbody.osim", 1000, 20);
+    }
+    catch (const Exception& e) {
+        cout << "testCustomJointTransforms failed: ";
+        e.print(cout);
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testCustomJointTransforms failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+// Evaluate the spline of the knee's first translation and its derivatives,
+// as Simbody does through the FunctionAdapter.
+void benchmarkSplineEvaluation(const string& modelFile, int numEvaluations)
+{
+    Model model(modelFile);
+    const CustomJoint& knee =
+        dynamic_cast<const CustomJoint&>(model.getJointSet().get("knee_r"));
+    const OpenSim::Function& spline =
+        knee.getSpatialTransform()[3].getFunction();
+    const Coordinate& angle = knee.getCoordinateSet()[0];
+    FunctionAdapter adapter(spline);
+
+    const double dx = (angle.getRangeMax()-angle.getRangeMin())/numEvaluations;
+    SimTK::Array_<int> first(1, 0), second(2, 0);
+    SimTK::Vector x(1);
+
+    // What FunctionAdapter did before: copy the derivative components into a
+    // std::vector and pass on the Vector.
+    double sum = 0;
+    double start = SimTK::realTime();
+    for (int i = 0; i < numEvaluations; ++i) {
+        x[0] = angle.getRangeMin() + i*dx;
+        sum += spline.calcValue(x);
+        sum += spline.calcDerivative(
+            std::vector<int>(first.begin(), first.end()), x);
+        sum += spline.calcDerivative(
+            std::vector<int>(second.begin(), second.end()), x);
+    }
+    double vectorTime = SimTK::realTime() - start;
+
+    double adapterSum = 0;
+    start = SimTK::realTime();
+    for (int i = 0; i < numEvaluations; ++i) {
+        x[0] = angle.getRangeMin() + i*dx;
+        adapterSum += adapter.calcValue(x);
+        adapterSum += adapter.calcDerivative(first, x);
+        adapterSum += adapter.calcDerivative(second, x);
+    }
+    double adapterTime = SimTK::realTime() - start;
+
+    cout << setprecision(4) << "\n" << spline.getConcreteClassName()
+         << " value and 2 derivatives: " << 1e9*vectorTime/numEvaluations
+         << " ns through Vector arguments, " << 1e9*adapterTime/numEvaluations
+         << " ns through the single-argument path." << endl;
+
+    // Both paths run the same arithmetic.
+    ASSERT(sum == adapterSum);
+    for (int i = 0; i < 100; ++i) {
+        x[0] = angle.getRangeMin() + 1e4*i*dx;
+        ASSERT(adapter.calcValue(x) == spline.calcValue(x));
+        ASSERT(adapter.calcDerivative(first, x) ==
+               spline.calcDerivative(std::vector<int>(1, 0), x));
+        ASSERT(adapter.calcDerivative(second, x) ==
+               spline.calcDerivative(std::vector<int>(2, 0), x));
+    }
+}
+
+// Wrap the functions of the coordinates of CustomJoints in MultiplierFunctions
+// of scale 1, so that no joint is recognized as a pin or slider and each is
+// built as a FunctionBased mobilizer.
+void unfoldCustomJoints(Model& model)
+{
+    for (int j = 0; j < model.getJointSet().getSize(); ++j) {
+        CustomJoint* joint =
+            dynamic_cast<CustomJoint*>(&model.updJointSet().get(j));
+        if (!joint) continue;
+        for (int i = 0; i < 6; ++i) {
+            TransformAxis& axis = joint->updSpatialTransform()[i];
+            if (axis.hasFunction() && axis.getCoordinateNames().size() > 0)
+                axis.setFunction(
+                    new MultiplierFunction(axis.getFunction().clone(), 1.0));
+        }
+    }
+}
+
+// Realize each state to Position numRepeats times over.
+double timeRealizePosition(const Model& model, SimTK::State& s,
+                           const std::vector<SimTK::Vector>& qs,
+                           int numRepeats)
+{
+    double start = SimTK::realTime();
+    for (int r = 0; r < numRepeats; ++r) {
+        for (size_t k = 0; k < qs.size(); ++k) {
+            s.updQ() = qs[k];
+            model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+        }
+    }
+    return SimTK::realTime() - start;
+}
+
+void benchmarkRealizePosition(const string& modelFile, int numStates,
+                              int numRepeats)
+{
+    Model folded(modelFile);
+    Model unfolded(modelFile);
+    unfoldCustomJoints(unfolded);
+    SimTK::State& sFolded = folded.initSystem();
+    SimTK::State& sUnfolded = unfolded.initSystem();
+
+    int numPins = 0;
+    const SimTK::SimbodyMatterSubsystem& matter = folded.getMatterSubsystem();
+    for (SimTK::MobilizedBodyIndex mbx(1); mbx < matter.getNumBodies(); ++mbx)
+        if (SimTK::MobilizedBody::Pin::isInstanceOf(
+                matter.getMobilizedBody(mbx)))
+            ++numPins;
+
+    // The same random values of the coordinates in both models.
+    SimTK::Random::Uniform random(0, 1);
+    random.setSeed(0);
+    const CoordinateSet& coordinates = folded.getCoordinateSet();
+    std::vector<SimTK::Vector> qsFolded, qsUnfolded;
+    for (int k = 0; k < numStates; ++k) {
+        for (int i = 0; i < coordinates.getSize(); ++i) {
+            const Coordinate& c = coordinates[i];
+            const double value = c.getRangeMin() +
+                random.getValue()*(c.getRangeMax()-c.getRangeMin());
+            c.setValue(sFolded, value, false);
+            unfolded.getCoordinateSet().get(c.getName())
+                .setValue(sUnfolded, value, false);
+        }
+        qsFolded.push_back(sFolded.getQ());
+        qsUnfolded.push_back(sUnfolded.getQ());
+    }
+
+    double unfoldedTime =
+        timeRealizePosition(unfolded, sUnfolded, qsUnfolded, numRepeats);
+    double foldedTime =
+        timeRealizePosition(folded, sFolded, qsFolded, numRepeats);
+    const int n = numStates*numRepeats;
+
+    cout << setprecision(4) << modelFile << " realize(Position): "
+         << 1e6*unfoldedTime/n << " us with FunctionBased mobilizers, "
+         << 1e6*foldedTime/n << " us with " << numPins
+         << " CustomJoints built as Pins." << endl;
+
+    // The bodies are where they were.
+    ASSERT(numPins > 0);
+    for (int k = 0; k < numStates; k += 10) {
+        sFolded.updQ() = qsFolded[k];
+        sUnfolded.updQ() = qsUnfolded[k];
+        folded.realizePosition(sFolded);
+        unfolded.realizePosition(sUnfolded);
+        for (int b = 0; b < folded.getBodySet().getSize(); ++b) {
+            const OpenSim::Body& body = folded.getBodySet()[b];
+            const SimTK::Transform& X_GB = body.getGroundTransform(sFolded);
+            const SimTK::Transform& X_GBu = unfolded.getBodySet()
+                .get(body.getName()).getGroundTransform(sUnfolded);
+            ASSERT_EQUAL(X_GBu.p(), X_GB.p(), SimTK::Vec3(1e-12));
+            for (int i = 0; i < 3; ++i)
+                ASSERT_EQUAL(X_GBu.R().col(i).asVec3(),
+                             X_GB.R().col(i).asVec3(), SimTK::Vec3(1e-12));
+        }
+    }
+}
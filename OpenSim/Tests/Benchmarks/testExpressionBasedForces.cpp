@@ -0,0 +1,243 @@
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  testExpressionBasedForces.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <thread>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ExpressionBasedBushingForce.h>
+#include <OpenSim/Simulation/SimbodyEngine/WeldJoint.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testExpressionBasedForces compares an ExpressionBasedBushingForce with the
+// linear BushingForce of BushingForceModel_30000.osim, and times the
+// evaluation of its expressions with Lepton's ExpressionProgram (a map of
+// variable names per call) and with the compiled ExpressionEvaluator, as well
+// as the force computation and realizing the model to Acceleration. It also
+// checks the results of an evaluator used by several threads at once.
+//==============================================================================
+void benchmarkExpressionEvaluation();
+void testConcurrentEvaluation();
+void benchmarkBushingForce(const string& modelFile);
+
+static const int NUM_EVALUATIONS = 200000;
+static const char* DEFLECTIONS[6] =
+    {"theta_x", "theta_y", "theta_z", "delta_x", "delta_y", "delta_z"};
+static const char* EXPRESSIONS[6] =
+    {"0.5*theta_x+0.1*theta_x^3", "0.5*theta_y+0.1*theta_y^3",
+     "0.5*theta_z+0.1*theta_z^3", "10*delta_x", "10*delta_y", "10*delta_z"};
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        benchmarkExpressionEvaluation();
+        testConcurrentEvaluation();
+        benchmarkBushingForce("BushingForceModel_30000.osim");
+    }
+    catch (const Exception& e) {
+        cout << "testExpressionBasedForces failed: ";
+        e.print(cout);
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testExpressionBasedForces failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+void benchmarkExpressionEvaluation()
+{
+    vector<Lepton::ExpressionProgram> programs;
+    ExpressionEvaluator evaluator(
+        vector<string>(DEFLECTIONS, DEFLECTIONS+6), 6, true);
+    for (int i = 0; i < 6; ++i) {
+        programs.push_back(
+            Lepton::Parser::parse(EXPRESSIONS[i]).optimize().createProgram());
+        evaluator.setExpression(i, EXPRESSIONS[i]);
+    }
+
+    double sumPrograms = 0, sumEvaluator = 0;
+    double start = SimTK::realTime();
+    for (int n = 0; n < NUM_EVALUATIONS; ++n) {
+        map<string, double> vars;
+        for (int j = 0; j < 6; ++j)
+            vars[DEFLECTIONS[j]] = 1e-6*n + 0.01*j;
+        for (int i = 0; i < 6; ++i)
+            sumPrograms += programs[i].evaluate(vars);
+    }
+    double programTime = SimTK::realTime() - start;
+
+    start = SimTK::realTime();
+    double vars[6], results[6];
+    for (int n = 0; n < NUM_EVALUATIONS; ++n) {
+        for (int j = 0; j < 6; ++j)
+            vars[j] = 1e-6*n + 0.01*j;
+        evaluator.evaluate(vars, results);
+        for (int i = 0; i < 6; ++i)
+            sumEvaluator += results[i];
+    }
+    double evaluatorTime = SimTK::realTime() - start;
+
+    cout << setprecision(4) << "\nSix bushing expressions: "
+         << 1e9*programTime/NUM_EVALUATIONS << " ns with ExpressionProgram, "
+         << 1e9*evaluatorTime/NUM_EVALUATIONS
+         << " ns with ExpressionEvaluator per evaluation." << endl;
+    ASSERT_EQUAL(sumPrograms, sumEvaluator, 1e-9*fabs(sumPrograms));
+
+    // Analytic derivatives at the last deflections.
+    double derivatives[36];
+    evaluator.evaluateDerivatives(vars, derivatives);
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            double expected = (i != j) ? 0 :
+                (i < 3 ? 0.5 + 0.3*vars[j]*vars[j] : 10);
+            ASSERT_EQUAL(expected, derivatives[6*i+j], 1e-12);
+        }
+    }
+}
+
+// Threads that find the compiled expressions in use evaluate spare copies,
+// which must give the same results and follow changes of the expressions.
+void testConcurrentEvaluation()
+{
+    ExpressionEvaluator evaluator(
+        vector<string>(DEFLECTIONS, DEFLECTIONS+6), 6, true);
+    for (int round = 0; round < 2; ++round) {
+        // Replacing the expressions discards the spare copies.
+        const double scale = round + 1;
+        for (int i = 0; i < 6; ++i)
+            evaluator.setExpression(i, to_string(scale) + "*(" +
+                                       EXPRESSIONS[i] + ")");
+
+        vector<int> failures(4, 0);
+        vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.push_back(std::thread([&, t]() {
+                double vars[6], results[6], derivatives[36];
+                for (int n = 0; n < NUM_EVALUATIONS/10; ++n) {
+                    for (int j = 0; j < 6; ++j)
+                        vars[j] = 1e-5*n + 0.01*j + 0.1*t;
+                    evaluator.evaluate(vars, results);
+                    evaluator.evaluateDerivatives(vars, derivatives);
+                    for (int i = 0; i < 6; ++i) {
+                        double x = vars[i];
+                        double value = i < 3 ? 0.5*x + 0.1*x*x*x : 10*x;
+                        double slope = i < 3 ? 0.5 + 0.3*x*x : 10;
+                        if (fabs(scale*value - results[i]) > 1e-12 ||
+                            fabs(scale*slope - derivatives[7*i]) > 1e-12)
+                            ++failures[t];
+                    }
+                }
+            }));
+        }
+        for (int t = 0; t < 4; ++t) threads[t].join();
+        for (int t = 0; t < 4; ++t) ASSERT(failures[t] == 0);
+    }
+}
+
+void benchmarkBushingForce(const string& modelFile)
+{
+    using SimTK::Vec3;
+
+    // The model as is, with a linear BushingForce between ground and ball.
+    Model linear(modelFile);
+    SimTK::State& sLinear = linear.initSystem();
+
+    // The same model with the BushingForce replaced by an equivalent
+    // ExpressionBasedBushingForce. Its bodies must be in the BodySet, so it
+    // acts on a body welded to ground.
+    Model expression(modelFile);
+    const Force& bushing = expression.getForceSet().get(0);
+    expression.updForceSet().get(0).set_isDisabled(true);
+    Body* anchor = new Body("anchor", 1.0, Vec3(0), SimTK::Inertia(1.0));
+    expression.addBody(anchor);
+    expression.addJoint(new WeldJoint("anchor_weld", expression.getGround(),
+        Vec3(0), Vec3(0), *anchor, Vec3(0), Vec3(0)));
+    ExpressionBasedBushingForce* expressionBushing =
+        new ExpressionBasedBushingForce("anchor", Vec3(0), Vec3(0),
+            "ball", Vec3(0), Vec3(0), Vec3(10), Vec3(0), Vec3(0), Vec3(0));
+    expressionBushing->setName(bushing.getName() + "_expression");
+    expression.addForce(expressionBushing);
+    SimTK::State& sExpression = expression.initSystem();
+
+    const Coordinate& hLinear = linear.getCoordinateSet().get("ball_h");
+    const Coordinate& hExpression =
+        expression.getCoordinateSet().get("ball_h");
+
+    // Both models must have the same accelerations.
+    for (int i = 0; i <= 10; ++i) {
+        double h = -0.5 + 0.1*i;
+        hLinear.setValue(sLinear, h);
+        hExpression.setValue(sExpression, h);
+        linear.getMultibodySystem().realize(sLinear,
+                                            SimTK::Stage::Acceleration);
+        expression.getMultibodySystem().realize(sExpression,
+                                                SimTK::Stage::Acceleration);
+        ASSERT_EQUAL(hLinear.getAccelerationValue(sLinear),
+                     hExpression.getAccelerationValue(sExpression), 1e-10);
+
+        SimTK::Mat66 K = expressionBushing->computeStiffness(sExpression);
+        for (int j = 0; j < 6; ++j)
+            ASSERT_EQUAL(j < 3 ? 0.0 : 10.0, K(j, j), 1e-12);
+    }
+
+    // Force computation alone.
+    const SimTK::MultibodySystem& system = expression.getMultibodySystem();
+    SimTK::Vector_<SimTK::SpatialVec> bodyForces(
+        system.getMatterSubsystem().getNumBodies(), SimTK::SpatialVec(Vec3(0)));
+    SimTK::Vector generalizedForces(sExpression.getNU(), 0.0);
+    double start = SimTK::realTime();
+    for (int n = 0; n < NUM_EVALUATIONS; ++n)
+        expressionBushing->computeForce(sExpression, bodyForces,
+                                        generalizedForces);
+    double forceTime = SimTK::realTime() - start;
+
+    // Realizing to Acceleration, which invalidates the Position stage.
+    double realizeTime[2];
+    Model* models[2] = {&linear, &expression};
+    SimTK::State* states[2] = {&sLinear, &sExpression};
+    for (int m = 0; m < 2; ++m) {
+        const Coordinate& h = models[m]->getCoordinateSet().get("ball_h");
+        start = SimTK::realTime();
+        for (int n = 0; n < NUM_EVALUATIONS/10; ++n) {
+            h.setValue(*states[m], 1e-5*n, false);
+            models[m]->getMultibodySystem().realize(*states[m],
+                SimTK::Stage::Acceleration);
+        }
+        realizeTime[m] = (SimTK::realTime() - start)/(NUM_EVALUATIONS/10);
+    }
+
+    cout << setprecision(4) << "\n" << modelFile
+         << ": ExpressionBasedBushingForce::computeForce "
+         << 1e9*forceTime/NUM_EVALUATIONS << " ns; realize to Acceleration "
+         << 1e6*realizeTime[0] << " us with BushingForce, "
+         << 1e6*realizeTime[1] << " us with ExpressionBasedBushingForce."
+         << endl;
+}
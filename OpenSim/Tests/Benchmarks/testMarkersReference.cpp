@@ -0,0 +1,239 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  testMarkersReference.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <fstream>
+#include <iomanip>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/MarkersReference.h>
+#include <OpenSim/Simulation/CoordinateReference.h>
+#include <OpenSim/Simulation/InverseKinematicsSolver.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testMarkersReference compares MarkersReference::getValues(), which the IK
+// solver calls for every frame, with the linear search through MarkerData
+// that it used to do. It times both lookups and the IK frame throughput with
+// each, over the synthetic gait marker data repeated into a long trial.
+//==============================================================================
+void writeLongTrial(const string& trcFile, const string& longFile, int repeats);
+void benchmarkLookup(MarkerData& markerData);
+void benchmarkInverseKinematics(const string& modelFile, MarkerData& markerData,
+                                int numFrames);
+
+// The lookup MarkersReference did before: search the frames from the end of
+// the trial and copy the nearest one.
+class LinearSearchMarkersReference : public MarkersReference {
+OpenSim_DECLARE_CONCRETE_OBJECT(LinearSearchMarkersReference, MarkersReference);
+public:
+    LinearSearchMarkersReference(MarkerData& markerData,
+                                 const Set<MarkerWeight>* weights = NULL)
+    :   MarkersReference(markerData, weights), _data(&markerData) {}
+
+    void getValues(const SimTK::State& s,
+                   SimTK::Array_<SimTK::Vec3>& values) const override {
+        double time = s.getTime();
+        int before = 0, after = 0;
+        _data->findFrameRange(time, time, before, after);
+        if (after-before > 0) {
+            before = abs(_data->getFrame(before).getFrameTime()-time) <
+                     abs(_data->getFrame(after).getFrameTime()-time) ?
+                     before : after;
+        }
+        values = _data->getFrame(before).getMarkers();
+    }
+private:
+    MarkerData* _data;
+};
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        const string longFile = "testMarkersReference_long.trc";
+        writeLongTrial("subject01_synthetic_marker_data.trc", longFile, 100);
+        MarkerData markerData(longFile);
+        benchmarkLookup(markerData);
+        benchmarkInverseKinematics("subject01_simbody.osim", markerData, 600);
+    }
+    catch (const Exception& e) {
+        cout << "testMarkersReference failed: ";
+        e.print(cout);
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testMarkersReference failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+// Write the frames of trcFile repeats times over, one after the other.
+void writeLongTrial(const string& trcFile, const string& longFile, int repeats)
+{
+    MarkerData trial(trcFile);
+    const int nf = trial.getNumFrames(), nm = trial.getNumMarkers();
+    const double rate = trial.getDataRate();
+
+    ofstream out(longFile.c_str());
+    out << "PathFileType\t4\t(X/Y/Z)\t" << longFile << "\n"
+        << "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\t"
+           "OrigDataRate\tOrigDataStartFrame\tOrigNumFrames\n"
+        << rate << "\t" << rate << "\t" << nf*repeats << "\t" << nm << "\t"
+        << trial.getUnits().getAbbreviation() << "\t" << rate << "\t1\t"
+        << nf*repeats << "\nFrame#\tTime";
+    for (int j = 0; j < nm; ++j)
+        out << "\t" << trial.getMarkerNames()[j] << "\t\t";
+    out << "\n\t";
+    for (int j = 1; j <= nm; ++j)
+        out << "\tX" << j << "\tY" << j << "\tZ" << j;
+    out << "\n\n" << setprecision(10);
+
+    for (int i = 0; i < nf*repeats; ++i) {
+        out << i+1 << "\t" << i/rate;
+        for (int j = 0; j < nm; ++j) {
+            const SimTK::Vec3& m = trial.getMarkerPosition(i % nf, j);
+            out << "\t" << m[0] << "\t" << m[1] << "\t" << m[2];
+        }
+        out << "\n";
+    }
+}
+
+// Time getValues() at every frame and halfway between frames.
+void benchmarkLookup(MarkerData& markerData)
+{
+    MarkersReference reference(markerData);
+    LinearSearchMarkersReference linearSearch(markerData);
+    const int nf = markerData.getNumFrames(), nm = markerData.getNumMarkers();
+    const double dt = 1.0/markerData.getDataRate();
+    const double t0 = markerData.getStartFrameTime();
+
+    SimTK::State s;
+    SimTK::Array_<SimTK::Vec3> values, expected;
+    double start = SimTK::realTime();
+    for (int i = 0; i < 2*nf-1; ++i) {
+        s.updTime() = t0 + 0.5*i*dt;
+        linearSearch.getValues(s, expected);
+    }
+    double linearTime = SimTK::realTime() - start;
+
+    start = SimTK::realTime();
+    for (int i = 0; i < 2*nf-1; ++i) {
+        s.updTime() = t0 + 0.5*i*dt;
+        reference.getValues(s, values);
+    }
+    double lookupTime = SimTK::realTime() - start;
+
+    reference.setInterpolateFrames(true);
+    start = SimTK::realTime();
+    for (int i = 0; i < 2*nf-1; ++i) {
+        s.updTime() = t0 + 0.5*i*dt;
+        reference.getValues(s, values);
+    }
+    double interpolationTime = SimTK::realTime() - start;
+
+    cout << setprecision(4) << "\n" << nf << " frames of " << nm
+         << " markers: getValues " << 1e6*linearTime/(2*nf-1)
+         << " us with a linear search, " << 1e6*lookupTime/(2*nf-1)
+         << " us with the frame table, " << 1e6*interpolationTime/(2*nf-1)
+         << " us interpolated." << endl;
+
+    // The nearest frame is the same as before; interpolated values lie
+    // halfway between frames.
+    reference.setInterpolateFrames(false);
+    for (int i = 0; i < 2*nf-1; ++i) {
+        s.updTime() = t0 + 0.5*i*dt;
+        linearSearch.getValues(s, expected);
+        reference.getValues(s, values);
+        ASSERT(values.size() == expected.size());
+        for (int j = 0; j < nm; ++j)
+            ASSERT(values[j] == expected[j] ||
+                   (values[j].isNaN() && expected[j].isNaN()));
+    }
+    reference.setInterpolateFrames(true);
+    for (int i = 0; i < nf-1; ++i) {
+        s.updTime() = t0 + (i+0.5)*dt;
+        reference.getValues(s, values);
+        for (int j = 0; j < nm; ++j) {
+            const SimTK::Vec3& a = markerData.getMarkerPosition(i, j);
+            const SimTK::Vec3& b = markerData.getMarkerPosition(i+1, j);
+            if (!a.isNaN() && !b.isNaN())
+                ASSERT_EQUAL(0.5*(a+b), values[j], SimTK::Vec3(1e-9));
+        }
+    }
+}
+
+// Track numFrames frames of the trial with each MarkersReference.
+template <class T>
+double timeInverseKinematics(Model& model, MarkerData& markerData,
+                             const Set<MarkerWeight>& weights, int numFrames,
+                             SimTK::Vector& finalQ)
+{
+    T reference(markerData, &weights);
+    SimTK::Array_<CoordinateReference> coordinateReferences;
+    SimTK::State s = model.getWorkingState();
+    InverseKinematicsSolver ikSolver(model, reference, coordinateReferences);
+    ikSolver.setAccuracy(1e-5);
+
+    const double dt = 1.0/markerData.getDataRate();
+    s.updTime() = markerData.getStartFrameTime();
+    ikSolver.assemble(s);
+    double start = SimTK::realTime();
+    for (int i = 1; i < numFrames; ++i) {
+        s.updTime() = markerData.getStartFrameTime() + i*dt;
+        ikSolver.track(s);
+    }
+    finalQ = s.getQ();
+    return SimTK::realTime() - start;
+}
+
+void benchmarkInverseKinematics(const string& modelFile, MarkerData& markerData,
+                                int numFrames)
+{
+    Model model(modelFile);
+    model.initSystem();
+
+    Set<MarkerWeight> weights;
+    for (int j = 0; j < markerData.getNumMarkers(); ++j) {
+        const string& name = markerData.getMarkerNames()[j];
+        if (model.getMarkerSet().contains(name))
+            weights.adoptAndAppend(new MarkerWeight(name, 1.0));
+    }
+
+    SimTK::Vector linearQ, lookupQ;
+    double linearTime = timeInverseKinematics<LinearSearchMarkersReference>(
+        model, markerData, weights, numFrames, linearQ);
+    double lookupTime = timeInverseKinematics<MarkersReference>(
+        model, markerData, weights, numFrames, lookupQ);
+
+    cout << setprecision(4) << modelFile << " IK: "
+         << (numFrames-1)/linearTime << " frames/s with a linear search, "
+         << (numFrames-1)/lookupTime << " frames/s with the frame table."
+         << endl;
+
+    ASSERT(linearQ.size() == lookupQ.size());
+    for (int i = 0; i < linearQ.size(); ++i)
+        ASSERT_EQUAL(linearQ[i], lookupQ[i], 1e-10);
+}
@@ -0,0 +1,106 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  testModelCloning.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testModelCloning measures the cost of giving each of a number of workers
+// its own copy of a model: the time to clone the model and build the copy's
+// System, and the resident memory held by all of the copies. The copies must
+// have the same default state as the original.
+//==============================================================================
+void benchmarkModelCloning(const string& modelFile, int numWorkers);
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        benchmarkModelCloning("gait2354_simbody.osim", 32);
+        benchmarkModelCloning("gait10dof18musc_subject01.osim", 32);
+    }
+    catch (const Exception& e) {
+        cout << "testModelCloning failed: ";
+        e.print(cout);
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testModelCloning failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+// Resident memory of this process in bytes, or -1 if it is not known on this
+// platform.
+double residentMemory()
+{
+#if defined(__linux__)
+    ifstream statm("/proc/self/statm");
+    double size, resident;
+    if (statm >> size >> resident)
+        return resident*sysconf(_SC_PAGESIZE);
+#endif
+    return -1;
+}
+
+void benchmarkModelCloning(const string& modelFile, int numWorkers)
+{
+    Model model(modelFile);
+    const SimTK::State& s = model.initSystem();
+
+    double memoryBefore = residentMemory();
+    double cloneTime = 0, initTime = 0;
+    vector<unique_ptr<Model> > workers;
+    for (int i = 0; i < numWorkers; ++i) {
+        double start = SimTK::realTime();
+        workers.push_back(unique_ptr<Model>(model.clone()));
+        double cloned = SimTK::realTime();
+        const SimTK::State& sw = workers.back()->initSystem();
+        initTime += SimTK::realTime() - cloned;
+        cloneTime += cloned - start;
+
+        ASSERT(sw.getNY() == s.getNY());
+        for (int j = 0; j < s.getNY(); ++j)
+            ASSERT_EQUAL(s.getY()[j], sw.getY()[j], 1e-12);
+    }
+    double memoryAfter = residentMemory();
+
+    cout << setprecision(4) << "\n" << modelFile << " (" << numWorkers
+         << " workers): clone " << 1000*cloneTime/numWorkers
+         << " ms, initSystem " << 1000*initTime/numWorkers << " ms per worker";
+    if (memoryBefore >= 0)
+        cout << "; resident memory " << (memoryAfter-memoryBefore)/1048576.
+             << " MB in total";
+    cout << "." << endl;
+}
@@ -0,0 +1,110 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  testModelLoading.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testModelLoading times the deserialization of the bundled gait models with
+// the objects of each list property read serially and in parallel (see
+// Object::setNumDeserializationThreads()), and checks that both produce the
+// same model.
+//==============================================================================
+void benchmarkModelLoading(const string& modelFile, int numThreads);
+
+static const int NUM_LOADS = 5;
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        int numThreads = max(2, (int)std::thread::hardware_concurrency());
+        benchmarkModelLoading("arm26.osim", numThreads);
+        benchmarkModelLoading("gait10dof18musc_subject01.osim", numThreads);
+        benchmarkModelLoading("gait2354_simbody.osim", numThreads);
+        benchmarkModelLoading("gait2392_pelvisFixed.osim", numThreads);
+    }
+    catch (const Exception& e) {
+        cout << "testModelLoading failed: ";
+        e.print(cout);
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testModelLoading failed: " << e.what() << endl;
+        return 1;
+    }
+    Object::setNumDeserializationThreads(1);
+    cout << "Done" << endl;
+    return 0;
+}
+
+// Average wall-clock time of loading the model, and the model as written
+// back to XML by the last load.
+double timeLoading(const string& modelFile, string& serialized)
+{
+    double start = SimTK::realTime();
+    for (int i = 0; i < NUM_LOADS; ++i) {
+        Model model(modelFile);
+        if (i == NUM_LOADS-1) {
+            const string copyFile = "testModelLoading_copy.osim";
+            model.print(copyFile);
+            ifstream in(copyFile.c_str());
+            stringstream contents;
+            contents << in.rdbuf();
+            serialized = contents.str();
+        }
+    }
+    return (SimTK::realTime() - start)/NUM_LOADS;
+}
+
+void benchmarkModelLoading(const string& modelFile, int numThreads)
+{
+    string serial, parallel;
+
+    Object::setNumDeserializationThreads(1);
+    double serialTime = timeLoading(modelFile, serial);
+
+    Object::setNumDeserializationThreads(numThreads);
+    double parallelTime = timeLoading(modelFile, parallel);
+
+    // Building the System is not affected but is reported for reference.
+    double start = SimTK::realTime();
+    Model model(modelFile);
+    double loadTime = SimTK::realTime() - start;
+    model.initSystem();
+    double initTime = SimTK::realTime() - start - loadTime;
+
+    cout << setprecision(4) << "\n" << modelFile << ": load "
+         << 1000*serialTime << " ms serial, " << 1000*parallelTime
+         << " ms with " << numThreads << " threads; initSystem "
+         << 1000*initTime << " ms." << endl;
+
+    ASSERT(serial == parallel, __FILE__, __LINE__,
+        "Model " + modelFile + " differs when read in parallel.");
+}
@@ -0,0 +1,433 @@
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  ActuatorForceTargetLinear.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//==============================================================================
+// INCLUDES
+//==============================================================================
+#include <iostream>
+#include <OpenSim/Common/Exception.h>
+
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/Actuator.h>
+#include <OpenSim/Simulation/Model/Muscle.h>
+#include <OpenSim/Simulation/AccelerationSolver.h>
+
+#include "ActuatorForceTargetLinear.h"
+#include "CMC_TaskSet.h"
+#include "CMC_Joint.h"
+#include "CMC.h"
+#include "StateTrackingTask.h"
+
+using namespace std;
+using namespace OpenSim;
+using SimTK::Real;
+using SimTK::Vector;
+using SimTK::Matrix;
+
+//==============================================================================
+// DESTRUCTOR & CONSTRUCTIOR(S)
+//==============================================================================
+//______________________________________________________________________________
+/**
+ * Destructor.
+ */
+ActuatorForceTargetLinear::~ActuatorForceTargetLinear()
+{
+}
+//______________________________________________________________________________
+/**
+ * Constructor.
+ *
+ * @param aNX Number of controls.
+ * @param aController Parent controller.
+ */
+ActuatorForceTargetLinear::
+ActuatorForceTargetLinear(SimTK::State& s, int aNX, CMC *aController):
+    OptimizationTarget(aNX), _controller(aController),
+    _hasStateTrackingTasks(false)
+{
+    // NUMBER OF CONTROLS
+    if(getNumParameters()<=0) {
+        throw(Exception("ActuatorForceTargetLinear: ERROR- no controls.\n"));
+    }
+
+    const Model& model = _controller->getModel();
+    int na = _controller->getActuatorSet().getSize();
+    _recipOptForceSquared.setSize(na);
+
+    // MAP EACH ACTIVE TASK FUNCTION TO ITS GENERALIZED SPEED
+    // The rows of the constraint matrix are ordered as in
+    // CMC_TaskSet::computeAccelerations().
+    const CMC_TaskSet& taskSet = _controller->getTaskSet();
+    for(int i=0; i<taskSet.getSize(); i++) {
+        const TrackingTask& ttask = taskSet.get(i);
+        if(dynamic_cast<const StateTrackingTask*>(&ttask)) {
+            _hasStateTrackingTasks = true;
+            continue;
+        }
+        const CMC_Task* task = dynamic_cast<const CMC_Task*>(&ttask);
+        if(task==NULL) continue;
+
+        const CMC_Joint* joint = dynamic_cast<const CMC_Joint*>(task);
+        if(joint==NULL) {
+            throw Exception("ActuatorForceTargetLinear: ERROR- task '"
+                + task->getName() + "' is not a joint task. Only CMC_Joint "
+                "tasks are supported.", __FILE__, __LINE__);
+        }
+        if(!joint->getActive(0)) continue;
+
+        const Coordinate& coord =
+            model.getCoordinateSet().get(joint->getCoordinateName());
+        _taskBodies.push_back(coord.getBodyIndex());
+        _taskMobilizerQIndices.push_back(coord.getMobilizerQIndex());
+    }
+
+    int nConstraints = taskSet.getNumActiveTaskFunctions();
+    if(nConstraints != (int)_taskBodies.size()) {
+        throw Exception("ActuatorForceTargetLinear: ERROR- could not map "
+            "every active task function to a generalized coordinate.",
+            __FILE__, __LINE__);
+    }
+
+    // NUMBERS OF CONSTRAINTS
+    // There are only linear equality constraints.
+    setNumEqualityConstraints(nConstraints);
+    setNumLinearEqualityConstraints(nConstraints);
+
+    // DERIVATIVE PERTURBATION SIZES;
+    // Not used since the gradient and Jacobian are exact.
+    setDX(1.0e-6);
+}
+
+
+//==============================================================================
+// PREPARATION
+//==============================================================================
+//______________________________________________________________________________
+/**
+ * Build the linear constraints for the current control interval and, when
+ * possible, solve the problem directly.
+ *
+ * @return true if x holds the solution and the optimizer need not be run.
+ */
+bool ActuatorForceTargetLinear::
+prepareToOptimize(SimTK::State& s, double *x)
+{
+    // Keep around a "copy" of the state so we can use it in objective function
+    // in cases where we're tracking states
+    _saveState = s;
+
+    // COMPUTE MAX ISOMETRIC FORCE
+    // use tempory copy of state because computeIsokineticForceAssumingInfinitelyStiffTendon
+    // will change the muscle states. This is necessary ONLY in the case of deprecated muscles
+    SimTK::State tempState = s;
+    double activation = 1.0;
+    getController()->getModel().getMultibodySystem().realize(tempState, SimTK::Stage::Dynamics );
+
+    const Set<Actuator>& fSet = _controller->getActuatorSet();
+    double fOpt = SimTK::NaN;
+    for(int i=0 ; i<fSet.getSize(); ++i) {
+        ScalarActuator* act = dynamic_cast<ScalarActuator*>(&fSet[i]);
+        Muscle* mus = dynamic_cast<Muscle*>(act);
+        if(mus==NULL) {
+            fOpt = act->getOptimalForce();
+        }
+        else{
+            fOpt = mus->calcInextensibleTendonActiveFiberForce(tempState,
+                                                              activation);
+        }
+
+        if( std::fabs(fOpt) < SimTK::TinyReal )
+            fOpt = SimTK::TinyReal;
+
+        _recipOptForceSquared[i] = 1.0 / (fOpt*fOpt);
+    }
+
+    // BUILD THE AFFINE MAP FROM ACTUATOR FORCES TO TASK ACCELERATIONS
+    double start = SimTK::realTime();
+    computeForceDirections(s);
+    double afterForces = SimTK::realTime();
+    computeAccelerationMap(s);
+    double afterMap = SimTK::realTime();
+
+    // reset the actuator control
+    for(int i=0;i<fSet.getSize();i++) {
+        ScalarActuator* act = dynamic_cast<ScalarActuator*>(&fSet[i]);
+        act->overrideActuation(s, false);
+    }
+    _controller->getModel().getMultibodySystem().realizeModel(s);
+
+    // ATTEMPT A DIRECT SOLUTION
+    bool solved = false;
+    if(!_hasStateTrackingTasks) solved = solveDirectly(x);
+    double end = SimTK::realTime();
+
+    _timing.forceDirections += afterForces - start;
+    _timing.accelerationMap += afterMap - afterForces;
+    _timing.directSolve += end - afterMap;
+    _timing.numIntervals++;
+    if(solved) _timing.numDirectSolutions++;
+    if(_timingHook) _timingHook(_timing);
+
+    return solved;
+}
+//______________________________________________________________________________
+/**
+ * Compute the generalized force that each actuator applies at unit actuation.
+ *
+ * All actuators are switched to override mode, which invalidates the Model
+ * stage once. Afterwards only the override values are changed; these are
+ * consumed at Stage::Dynamics, so the positions, velocities and actuator paths
+ * computed at the Velocity stage are reused for every actuator.
+ */
+void ActuatorForceTargetLinear::
+computeForceDirections(SimTK::State& s)
+{
+    const Model& model = _controller->getModel();
+    const SimTK::MultibodySystem& system = model.getMultibodySystem();
+    const SimTK::SimbodyMatterSubsystem& matter = model.getMatterSubsystem();
+    const Set<Actuator>& fSet = _controller->getActuatorSet();
+    int nf = fSet.getSize();
+
+    for(int i=0;i<nf;i++) {
+        ScalarActuator* act = dynamic_cast<ScalarActuator*>(&fSet[i]);
+        act->overrideActuation(s, true);
+        act->setOverrideActuation(s, 0.0);
+    }
+    system.realizeModel(s);
+    system.realize(s, SimTK::Stage::Velocity);
+
+    _forceDirections.resize(s.getNU(), nf);
+    SimTK::Vector_<SimTK::SpatialVec> bodyForces;
+    Vector mobilityForces, tau;
+    for(int j=0;j<nf;j++) {
+        ScalarActuator* act = dynamic_cast<ScalarActuator*>(&fSet[j]);
+        act->setOverrideActuation(s, 1.0);
+        act->calcForceContribution(s, bodyForces, mobilityForces);
+        act->setOverrideActuation(s, 0.0);
+
+        matter.multiplyBySystemJacobianTranspose(s, bodyForces, tau);
+        _forceDirections(j) = tau + mobilityForces;
+    }
+}
+//______________________________________________________________________________
+/**
+ * Compute the constant part of the constraints with all actuations at zero
+ * and the acceleration produced by each actuator's unit generalized force.
+ * The state must be in override mode with zero actuations.
+ */
+void ActuatorForceTargetLinear::
+computeAccelerationMap(SimTK::State& s)
+{
+    const Model& model = _controller->getModel();
+    const SimTK::SimbodyMatterSubsystem& matter = model.getMatterSubsystem();
+    CMC_TaskSet& taskSet = _controller->updTaskSet();
+    int nf = _forceDirections.ncol();
+    int nc = getNumConstraints();
+
+    model.getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+
+    taskSet.computeAccelerations(s);
+    Array<double> &w = taskSet.getWeights();
+    Array<double> &aDes = taskSet.getDesiredAccelerations();
+    Array<double> &a = taskSet.getAccelerations();
+
+    _constraintVector.resize(nc);
+    for(int i=0; i<nc; i++)
+        _constraintVector[i] = w[i]*(aDes[i]-a[i]);
+
+    // The forward-dynamics operator is affine in the applied forces; factor
+    // it once and solve for the linear part for all actuators together.
+    AccelerationSolver solver(model);
+    solver.factor(s);
+    Matrix udot;
+    solver.solveLinear(_forceDirections, udot);
+
+    _constraintMatrix.resize(nc, nf);
+    for(int j=0; j<nf; j++) {
+        Vector udotj(udot(j));
+        for(int i=0; i<nc; i++) {
+            const SimTK::MobilizedBody& mobod =
+                matter.getMobilizedBody(_taskBodies[i]);
+            _constraintMatrix(i,j) = -w[i] *
+                mobod.getOneFromUPartition(s, _taskMobilizerQIndices[i], udotj);
+        }
+    }
+}
+//______________________________________________________________________________
+/**
+ * Solve the equality constrained problem ignoring the force bounds:
+ *
+ *     f = -W^-1 C^T (C W^-1 C^T)^-1 c0
+ *
+ * where W is the diagonal of the objective. The solution is accepted only if
+ * it satisfies the constraints and the bounds.
+ */
+bool ActuatorForceTargetLinear::
+solveDirectly(double *x) const
+{
+    int nf = getNumParameters();
+    int nc = getNumConstraints();
+    if(nc==0) return false;
+
+    Matrix CWinv(nc, nf);
+    for(int j=0; j<nf; j++)
+        CWinv(j) = _constraintMatrix(j) / _recipOptForceSquared[j];
+
+    Matrix S = CWinv * ~_constraintMatrix;
+    Vector y;
+    SimTK::FactorQTZ qtz(S);
+    qtz.solve(_constraintVector, y);
+    Vector f = -(~CWinv * y);
+
+    Vector residual = _constraintMatrix * f + _constraintVector;
+    if(residual.normInf() > SimTK::SqrtEps*(1.0+_constraintVector.normInf()))
+        return false;
+
+    if(getHasLimits()) {
+        double *lower, *upper;
+        getParameterLimits(&lower, &upper);
+        for(int j=0; j<nf; j++)
+            if(f[j] < lower[j] || f[j] > upper[j]) return false;
+    }
+
+    for(int j=0; j<nf; j++) x[j] = f[j];
+    return true;
+}
+
+//==============================================================================
+// PERFORMANCE AND CONSTRAINTS
+//==============================================================================
+//------------------------------------------------------------------------------
+// PERFORMANCE
+//------------------------------------------------------------------------------
+//______________________________________________________________________________
+/**
+ * Compute performance given x.
+ *
+ * @param aF Vector of controls.
+ * @param rP Value of the performance criterion.
+ * @return Status (normal termination = 0, error < 0).
+ */
+int ActuatorForceTargetLinear::
+objectiveFunc(const Vector &aF, const bool new_coefficients, Real& rP) const
+{
+    int nf = getNumParameters();
+    double p = 0.0;
+    for(int j=0; j<nf; j++)
+        p += aF[j] * aF[j] * _recipOptForceSquared[j];
+
+    // If tracking states, add in errors from them squared
+    if(_hasStateTrackingTasks) {
+        const CMC_TaskSet& tset=_controller->getTaskSet();
+        for(int t=0; t<tset.getSize(); t++){
+            TrackingTask& ttask = tset.get(t);
+            StateTrackingTask* stateTask=NULL;
+            if ((stateTask=dynamic_cast<StateTrackingTask*>(&ttask))!= NULL){
+                double err = stateTask->getTaskError(_saveState);
+                p+= (err * err * stateTask->getWeight(0));
+            }
+        }
+    }
+    rP = p;
+
+    return(0);
+}
+//______________________________________________________________________________
+/**
+ * Compute the gradient of performance given x.
+ *
+ * @param x Vector of controls.
+ * @param gradient Derivatives of performance with respect to the controls.
+ * @return Status (normal termination = 0, error < 0).
+ */
+int ActuatorForceTargetLinear::
+gradientFunc(const Vector &x, const bool new_coefficients, Vector &gradient) const
+{
+    int nf = getNumParameters();
+    for(int j=0; j<nf; j++)
+        gradient[j] = 2.0 * x[j] * _recipOptForceSquared[j];
+
+    // Add in the terms for the stateTracking
+    if(_hasStateTrackingTasks) {
+        const CMC_TaskSet& tset=_controller->getTaskSet();
+        for(int t=0; t<tset.getSize(); t++){
+            TrackingTask& ttask = tset.get(t);
+            StateTrackingTask* stateTask=NULL;
+            if ((stateTask=dynamic_cast<StateTrackingTask*>(&ttask))!= NULL){
+                gradient += stateTask->getTaskErrorGradient(_saveState);
+            }
+        }
+    }
+
+    return(0);
+}
+
+//------------------------------------------------------------------------------
+// CONSTRAINT
+//------------------------------------------------------------------------------
+//______________________________________________________________________________
+/**
+ * Compute the constraints given x.
+ *
+ * @param x Array of actuator forces.
+ * @return Status (normal termination = 0, error < 0).
+ */
+int ActuatorForceTargetLinear::
+constraintFunc(const SimTK::Vector &x, const bool new_coefficients, SimTK::Vector &constraints) const
+{
+    constraints = _constraintMatrix * x + _constraintVector;
+    return(0);
+}
+//______________________________________________________________________________
+/**
+ * Compute the Jacobian of the constraints given x. The constraints are
+ * linear, so this is the matrix built in prepareToOptimize().
+ *
+ * @param x Array of actuator forces.
+ * @param jac Jacobian of the constraints with respect to the forces.
+ * @return Status (normal termination = 0, error < 0).
+ */
+int ActuatorForceTargetLinear::
+constraintJacobian(const SimTK::Vector &x, const bool new_coefficients, SimTK::Matrix &jac) const
+{
+    jac = _constraintMatrix;
+    return 0;
+}
+
+//==============================================================================
+// TIMING
+//==============================================================================
+void ActuatorForceTargetLinear::
+printTiming(std::ostream& out) const
+{
+    double total = _timing.forceDirections + _timing.accelerationMap
+                 + _timing.directSolve;
+    out << "ActuatorForceTargetLinear: " << _timing.numIntervals
+        << " intervals, " << _timing.numDirectSolutions
+        << " solved without the optimizer.\n";
+    out << "  actuator force directions = " << _timing.forceDirections << " s\n";
+    out << "  acceleration map          = " << _timing.accelerationMap << " s\n";
+    out << "  direct solve              = " << _timing.directSolve << " s\n";
+    out << "  total                     = " << total << " s" << endl;
+}
@@ -0,0 +1,165 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  ActuatorForceTargetLinear.h                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#ifndef ActuatorForceTargetLinear_h__
+#define ActuatorForceTargetLinear_h__
+
+
+//==============================================================================
+// INCLUDES
+//==============================================================================
+#include "osimToolsDLL.h"
+#include <OpenSim/Common/OptimizationTarget.h>
+#include <SimTKcommon.h>
+#include "SimTKsimbody.h"
+#include <functional>
+#include <iosfwd>
+
+namespace OpenSim {
+
+class CMC;
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+/**
+ * A Computed Muscle Control (CMC) optimization target that exploits the fact
+ * that, within one CMC control interval, the coordinate accelerations are an
+ * affine function of the actuator forces.
+ *
+ * The performance criterion and the acceleration constraints are the same as
+ * those of ActuatorForceTargetFast. Rather than finite-differencing the
+ * constraints by realizing the model to Acceleration once per actuator, the
+ * affine map is built once per interval:
+ *  - every actuator is switched to override mode once, and its generalized
+ *    force for a unit actuation is obtained from its own force contribution
+ *    (no other forces are evaluated);
+ *  - the model is realized to Acceleration once with all actuations at zero,
+ *    which gives the constant part of the constraints;
+ *  - the acceleration produced by each unit generalized force is obtained
+ *    from the multibody forward-dynamics operator at that state, reusing the
+ *    articulated-body inertias computed for the zero-force realization and
+ *    accounting for any kinematic constraints.
+ *
+ * The constraint Jacobian and the objective gradient are therefore exact. If
+ * the minimum-norm solution of the equality constrained problem also satisfies
+ * the actuator force bounds, it is returned directly from prepareToOptimize()
+ * and the optimizer is not invoked.
+ *
+ * Only joint (CMC_Joint) tracking tasks are supported; the constructor throws
+ * an Exception if the task set contains point or orientation tasks so that the
+ * caller can fall back to ActuatorForceTargetFast.
+ *
+ * The cost of each phase of prepareToOptimize() is accumulated in a Timing
+ * structure, which is also passed to an optional timing hook after every
+ * control interval.
+ */
+class OSIMTOOLS_API ActuatorForceTargetLinear : public OptimizationTarget
+{
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+public:
+    /** Accumulated wall-clock cost (in seconds) of prepareToOptimize(). */
+    struct Timing {
+        /** Computing the generalized force of each actuator at unit
+        actuation. */
+        double forceDirections = 0.0;
+        /** Realizing the zero-actuation state and solving for the
+        acceleration produced by each actuator. */
+        double accelerationMap = 0.0;
+        /** Attempting the direct (bound-free) solution of the problem. */
+        double directSolve = 0.0;
+        /** Number of control intervals prepared. */
+        int numIntervals = 0;
+        /** Number of intervals solved directly, without the optimizer. */
+        int numDirectSolutions = 0;
+    };
+
+//==============================================================================
+// DATA
+//==============================================================================
+private:
+    /** Parent controller. */
+    CMC *_controller;
+    /** Reciprocal of optimal force squared accounting for force-length curve if actuator is a muscle. */
+    Array<double> _recipOptForceSquared;
+    /** Mobilized body and mobilizer coordinate of each active task. */
+    SimTK::Array_<SimTK::MobilizedBodyIndex> _taskBodies;
+    SimTK::Array_<int> _taskMobilizerQIndices;
+    /** True if the task set contains tasks that depend on the states. */
+    bool _hasStateTrackingTasks;
+
+    /** Generalized force of each actuator at unit actuation (nu x nf). */
+    SimTK::Matrix _forceDirections;
+    SimTK::Matrix _constraintMatrix;
+    SimTK::Vector _constraintVector;
+
+    // Save a (copy) of the state for state tracking purposes
+    SimTK::State    _saveState;
+
+    Timing _timing;
+    std::function<void(const Timing&)> _timingHook;
+
+//==============================================================================
+// METHODS
+//==============================================================================
+public:
+    //---------------------------------------------------------------------------
+    // CONSTRUCTION
+    //---------------------------------------------------------------------------
+    virtual ~ActuatorForceTargetLinear();
+    ActuatorForceTargetLinear(SimTK::State& s, int aNX, CMC *aController);
+
+    bool prepareToOptimize(SimTK::State& s, double *x) override;
+
+    //--------------------------------------------------------------------------
+    // REQUIRED OPTIMIZATION TARGET METHODS
+    //--------------------------------------------------------------------------
+    int objectiveFunc(const SimTK::Vector &aF, bool new_coefficients, SimTK::Real& rP) const override;
+    int gradientFunc(const SimTK::Vector &x, bool new_coefficients, SimTK::Vector &gradient) const override;
+    int constraintFunc( const SimTK::Vector &x, bool new_coefficients, SimTK::Vector &constraints) const override;
+    int constraintJacobian(const SimTK::Vector &x, bool new_coefficients, SimTK::Matrix &jac) const override;
+    CMC* getController() {return (_controller); }
+
+    //--------------------------------------------------------------------------
+    // TIMING
+    //--------------------------------------------------------------------------
+    const Timing& getTiming() const { return _timing; }
+    void resetTiming() { _timing = Timing(); }
+    /** Set a function that is called with the accumulated timing at the end
+    of every prepareToOptimize(). Pass an empty function to remove it. */
+    void setTimingHook(std::function<void(const Timing&)> hook)
+    {   _timingHook = hook; }
+    /** Print a summary of the accumulated timing. */
+    void printTiming(std::ostream& out) const;
+
+private:
+    void computeForceDirections(SimTK::State& s);
+    void computeAccelerationMap(SimTK::State& s);
+    bool solveDirectly(double *x) const;
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+};  // END class ActuatorForceTargetLinear
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+}; // end namespace
+
+#endif // ActuatorForceTargetLinear_h__
@@ -23,6 +23,7 @@
 #include "AnalyzeTool.h"
 #include <OpenSim/Common/IO.h>
 #include <OpenSim/Common/GCVSplineSet.h>
+#include <OpenSim/Common/ComponentProfiler.h>
 
 #include <OpenSim/Simulation/Control/ControlLinear.h>
 #include <OpenSim/Simulation/Control/ControlSet.h>
@@ -48,6 +49,7 @@ using namespace std;
  */
 AnalyzeTool::~AnalyzeTool()
 {
+    delete _motionStore;
 }
 //_____________________________________________________________________________
 /**
@@ -193,6 +195,7 @@ setNull()
     _lowpassCutoffFrequency = -1.0;
 
     _statesStore = NULL;
+    _motionStore = NULL;
 
     _printResultFiles = true;
     _replaceForceSet = false;
@@ -416,6 +419,10 @@ setStatesFromMotion(const SimTK::State& s, const Storage &aMotion, bool aInDegre
 {
     cout<<endl<<"Creating states from motion storage"<<endl;
 
+    // Keep the motion for the external loads
+    delete _motionStore;
+    _motionStore = new Storage(aMotion);
+
     // Make a copy in case we need to convert to degrees and/or filter
     Storage motionCopy(aMotion);
 
@@ -514,7 +521,9 @@ bool AnalyzeTool::run(bool plotting)
     }
 
     // Use the Dynamics Tool API to handle external loads instead of outdated AbstractTool
-    bool externalLoads = createExternalLoads(_externalLoadsFileName, *_model);
+    const Storage* loadKinematics =
+        _motionStore && _motionStore->getName() != "" ? _motionStore : NULL;
+    bool externalLoads = createExternalLoads(_externalLoadsFileName, *_model, loadKinematics);
 
 //printf("\nbefore AnalyzeTool.run() initSystem \n");
     // Call initSystem except when plotting
@@ -550,6 +559,7 @@ bool AnalyzeTool::run(bool plotting)
         string msg = "AnalysisTool.run: ERROR- no analyses have been set.";
         throw Exception(msg,__FILE__,__LINE__);
     }
+    analysisSet.setStreamBaseName(getName());
 
     // Call helper function to process analysis
     /*Array<double> bounds;
@@ -584,6 +594,7 @@ bool AnalyzeTool::run(bool plotting)
 
     IO::chDir(saveWorkingDirectory);
 
+    ComponentProfiler::report("AnalyzeTool::run");
     return completed;
 }
 
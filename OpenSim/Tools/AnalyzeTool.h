@@ -72,6 +72,11 @@ private:
     /** Storage for the model states. */
     Storage *_statesStore;
 
+    /** Copy of the motion passed to setStatesFromMotion(), if any. It takes
+    the place of the model kinematics file of the external loads when it has
+    that file's name. */
+    Storage *_motionStore;
+
     /** Whether to write result storages to files. */
     bool _printResultFiles;
 
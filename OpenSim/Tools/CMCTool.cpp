@@ -21,6 +21,7 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 #include <time.h>
+#include <algorithm>
 #include "CMCTool.h"
 #include "AnalyzeTool.h"
 #include <OpenSim/Common/IO.h>
@@ -36,10 +37,12 @@
 #include <OpenSim/Analyses/Actuation.h>
 #include "ForwardTool.h"
 #include <OpenSim/Common/DebugUtilities.h>
+#include <OpenSim/Common/ComponentProfiler.h>
 #include "CMC.h" 
 #include "CMC_TaskSet.h"
 #include "ActuatorForceTarget.h"
 #include "ActuatorForceTargetFast.h"
+#include "ActuatorForceTargetLinear.h"
 
 using namespace std;
 using namespace SimTK;
@@ -75,6 +78,7 @@ CMCTool::CMCTool() :
     _targetDT(_targetDTProp.getValueDbl()),          
     //_useCurvatureFilter(_useCurvatureFilterProp.getValueBool()),
     _useFastTarget(_useFastTargetProp.getValueBool()),
+    _useLinearizedTarget(_useLinearizedTargetProp.getValueBool()),
     _optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
     _numericalDerivativeStepSize(_numericalDerivativeStepSizeProp.getValueDbl()),
     _optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
@@ -105,6 +109,7 @@ CMCTool::CMCTool(const string &aFileName, bool aLoadModel) :
     _targetDT(_targetDTProp.getValueDbl()),          
     //_useCurvatureFilter(_useCurvatureFilterProp.getValueBool()),
     _useFastTarget(_useFastTargetProp.getValueBool()),
+    _useLinearizedTarget(_useLinearizedTargetProp.getValueBool()),
     _optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
     _numericalDerivativeStepSize(_numericalDerivativeStepSizeProp.getValueDbl()),
     _optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
@@ -175,6 +180,7 @@ CMCTool(const CMCTool &aTool) :
     _targetDT(_targetDTProp.getValueDbl()),          
     //_useCurvatureFilter(_useCurvatureFilterProp.getValueBool()),
     _useFastTarget(_useFastTargetProp.getValueBool()),
+    _useLinearizedTarget(_useLinearizedTargetProp.getValueBool()),
     _optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
     _numericalDerivativeStepSize(_numericalDerivativeStepSizeProp.getValueDbl()),
     _optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
@@ -207,6 +213,7 @@ setNull()
     _targetDT = 0.010;           
     //_useCurvatureFilter = false;       
     _useFastTarget = true;
+    _useLinearizedTarget = false;
     _optimizerAlgorithm = "ipopt";
     _numericalDerivativeStepSize = 1.0e-4;
     _optimizationConvergenceTolerance = 1.0e-4;
@@ -299,6 +306,13 @@ void CMCTool::setupProperties()
     _useFastTargetProp.setName("use_fast_optimization_target");          
     _propertySet.append( &_useFastTargetProp );
 
+    comment = "Flag (true or false) indicating whether the fast target should build the linear map ";
+    comment += "from actuator forces to accelerations once per time window instead of ";
+    comment += "finite-differencing it. Only joint tasks are supported.";
+    _useLinearizedTargetProp.setComment(comment);
+    _useLinearizedTargetProp.setName("use_linearized_optimization_target");
+    _propertySet.append( &_useLinearizedTargetProp );
+
     comment = "Preferred optimizer algorithm (currently support \"ipopt\" or \"cfsqp\", "
                  "the latter requiring the osimCFSQP library.";
     _optimizerAlgorithmProp.setComment(comment);
@@ -366,6 +380,7 @@ operator=(const CMCTool &aTool)
     _numericalDerivativeStepSize = aTool._numericalDerivativeStepSize;
     _optimizationConvergenceTolerance = aTool._optimizationConvergenceTolerance;
     _useFastTarget = aTool._useFastTarget;
+    _useLinearizedTarget = aTool._useLinearizedTarget;
     _optimizerAlgorithm = aTool._optimizerAlgorithm;
     _maxIterations = aTool._maxIterations;
     _printLevel = aTool._printLevel;
@@ -683,7 +698,17 @@ bool CMCTool::run()
 
     // Optimization target
     OptimizationTarget *target = NULL;
-    if(_useFastTarget) {
+    ActuatorForceTargetLinear *linearTarget = NULL;
+    if(_useFastTarget && _useLinearizedTarget) {
+        try {
+            target = linearTarget = new ActuatorForceTargetLinear(s, na, controller);
+        }
+        catch(const Exception& x) {
+            cout << x.getMessage() << endl;
+            cout << "Using the fast optimization target instead." << endl;
+            target = new ActuatorForceTargetFast(s, na,controller);
+        }
+    } else if(_useFastTarget) {
         target = new ActuatorForceTargetFast(s, na,controller);
     } else {
         target = new ActuatorForceTarget(na,controller);
@@ -750,11 +775,28 @@ bool CMCTool::run()
     // Initialize integrand controls using controls read in from file (which specify min/max control values)
     initializeControlSetUsingConstraints(rraControlSet,controlConstraints, controller->updControlSet());
 
+    // CHECKPOINTING
+    // A checkpoint holds the states and the controls computed so far, so
+    // the initial states and controls need not be computed when resuming.
+    IO::makeDir(getResultsDir());
+    manager.setCheckpointFileName(getCheckpointFileName());
+    manager.setCheckpointInterval(_checkpointInterval);
+    manager.setCheckpointControlSet(&controller->updControlSet());
+    bool resumed = _resumeFromCheckpoint && manager.resumeFromCheckpoint(s);
+    double tStart = resumed ? s.getTime() : _ti;
+    // The controls were last computed up to the next target time.
+    double tTarget = tStart;
+    if(resumed && controller->updControlSet().getSize()>0)
+        tTarget = std::max(tStart,
+            controller->updControlSet().get(0).getLastTime());
+
     // Initial auxilliary states
     time_t startTime,finishTime;
     struct tm *localTime;
     double elapsedTime;
-    if( s.getNZ() > 0) { // If there are actuator states (i.e. muscles dynamics)
+    if(resumed) {
+        cmcActSubsystem.setCompleteState( s );
+    } else if( s.getNZ() > 0) { // If there are actuator states (i.e. muscles dynamics)
         cout<<"\n\n\n";
         cout<<"================================================================\n";
         cout<<"================================================================\n";
@@ -802,16 +844,16 @@ bool CMCTool::run()
         controller->computeControls( s, controller->updControlSet() );
         controller->setTargetDT(_targetDT);
     }
-    manager.setInitialTime(_ti);
+    manager.setInitialTime(tStart);
 
     // ---- INTEGRATE ----
     cout<<"\n\n\n";
     cout<<"================================================================\n";
     cout<<"================================================================\n";
     cout<<"Using CMC to track the specified kinematics\n";
-    cout<<"Integrating from "<<_ti<<" to "<<_tf<<endl;
-    s.updTime() = _ti;
-    controller->setTargetTime( _ti );
+    cout<<"Integrating from "<<tStart<<" to "<<_tf<<endl;
+    s.updTime() = tStart;
+    controller->setTargetTime( tTarget );
     time(&startTime);
     localTime = localtime(&startTime);
     cout<<"Start time = "<<asctime(localTime);
@@ -858,6 +900,7 @@ bool CMCTool::run()
     elapsedTime = difftime(finishTime,startTime);
     cout<<"Elapsed time = "<<elapsedTime<<" seconds.\n";
     cout<<"================================================================\n\n\n";
+    if(linearTarget) linearTarget->printTiming(cout);
 
     // ---- RESULTS -----
     printResults(getName(),getResultsDir()); // this will create results directory if necessary
@@ -885,6 +928,7 @@ bool CMCTool::run()
 
     IO::chDir(saveWorkingDirectory);
 
+    ComponentProfiler::report("CMCTool::run");
     return true;
 }
 
@@ -108,6 +108,13 @@ private:
     PropertyBool _useFastTargetProp;         
     bool &_useFastTarget;
 
+    /** Flag indicating whether the fast target should build the linear
+    map from actuator forces to accelerations once per control interval
+    (ActuatorForceTargetLinear) instead of finite-differencing it. Only
+    joint tasks are supported; otherwise the fast target is used. */
+    PropertyBool _useLinearizedTargetProp;
+    bool &_useLinearizedTarget;
+
     /** Preferred optimizer algorithm. */
     PropertyStr _optimizerAlgorithmProp;
     std::string &_optimizerAlgorithm;
@@ -196,6 +203,8 @@ public:
     // Target selection
     bool getUseFastTarget() const { return _useFastTarget;};         
     void setUseFastTarget(bool useFastTarget) const {  _useFastTarget=useFastTarget; };
+    bool getUseLinearizedTarget() const { return _useLinearizedTarget; }
+    void setUseLinearizedTarget(bool useLinearizedTarget) { _useLinearizedTarget = useLinearizedTarget; }
 
 
     //--------------------------------------------------------------------------
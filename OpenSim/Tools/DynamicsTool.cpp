@@ -107,6 +107,7 @@ void DynamicsTool::setNull()
 {
     setupProperties();
     _model = NULL;
+    _externalLoadsReadMutex = NULL;
 }
 //_____________________________________________________________________________
 /**
@@ -234,6 +235,9 @@ bool DynamicsTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
     IO::chDir(IO::getParentDirectory(aExternalLoadsFileName));
     // Create external forces
     try {
+        std::unique_lock<std::mutex> lock;
+        if(_externalLoadsReadMutex)
+            lock = std::unique_lock<std::mutex>(*_externalLoadsReadMutex);
         _externalLoads = ExternalLoads(aModel, aExternalLoadsFileName);
     }
      catch (const Exception& ex) {
@@ -245,6 +249,17 @@ bool DynamicsTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
         throw(ex);
     }
     _externalLoads.setMemoryOwner(false);
+
+    // The files the ExternalLoads names are relative to its directory. When
+    // that is known, name them by their full path, so they are found even if
+    // another thread changes the working directory meanwhile.
+    const string loadsDirectory = IO::getParentDirectory(aExternalLoadsFileName);
+    const bool resolveFileNames = IO::isAbsolutePath(loadsDirectory);
+    string dataFileName = _externalLoads.getDataFileName();
+    IO::TrimLeadingWhitespace(dataFileName);
+    if(resolveFileNames && dataFileName != "" && !IO::isAbsolutePath(dataFileName))
+        _externalLoads.setDataFileName(loadsDirectory + dataFileName);
+
     _externalLoads.invokeConnectToModel(aModel);
 
     string loadKinematicsFileName = _externalLoads.getExternalLoadsModelKinematicsFileName();
@@ -260,6 +275,8 @@ bool DynamicsTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
         Storage *temp = NULL;
         // fine if there are no kinematics as long as it was not assigned
         if(!(loadKinematicsFileName == "") && !(loadKinematicsFileName == "Unassigned")){
+            if(resolveFileNames && !IO::isAbsolutePath(loadKinematicsFileName))
+                loadKinematicsFileName = loadsDirectory + loadKinematicsFileName;
             temp = new Storage(loadKinematicsFileName);
             if(!temp){
                 IO::chDir(savedCwd);
@@ -32,6 +32,7 @@
 #include  <OpenSim/Simulation/Model/ForceSet.h>
 #include  <OpenSim/Simulation/Model/ExternalLoads.h>
 #include "Tool.h"
+#include <mutex>
 
 #ifdef SWIG
     #ifdef OSIMTOOLS_API
@@ -84,6 +85,8 @@ protected:
     /** External loads object that manages loading and applying external forces
         to the model, including transformations required by the Tool */
     ExternalLoads   _externalLoads;
+    /** Held while reading the external loads, if not NULL. */
+    std::mutex* _externalLoadsReadMutex;
 
 
 //=============================================================================
@@ -103,6 +106,14 @@ public:
     
     const ExternalLoads& getExternalLoads() const { return _externalLoads; }
     ExternalLoads& updExternalLoads() { return _externalLoads; }
+#ifndef SWIG
+    /** Hold aMutex, if not NULL, while reading the external loads file in
+    run(), so that it is not read while another thread holding aMutex reads
+    other XML files (reading XML can update the registered default objects).
+    The tool does not own the mutex. */
+    void setExternalLoadsReadMutex(std::mutex* aMutex)
+    {   _externalLoadsReadMutex = aMutex; }
+#endif
 
     // External loads get/set
     const std::string &getExternalLoadsFileName() const { return _externalLoadsFileName; }
@@ -26,6 +26,7 @@
 #include <OpenSim/Common/XMLDocument.h>
 #include "ForwardTool.h"
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/ComponentProfiler.h>
 
 #include <OpenSim/Simulation/Control/Controller.h>
 #include <OpenSim/Simulation/Control/ControlSet.h>
@@ -308,6 +309,25 @@ bool ForwardTool::run()
         _model->equilibrateMuscles(s);  
     }
 
+    // CHECKPOINTING
+    // Checkpoints are written to the results directory even when the results
+    // are not printed.
+    if(_checkpointInterval > 0 || _resumeFromCheckpoint)
+        IO::makeDir(getResultsDir());
+    manager.setCheckpointFileName(getCheckpointFileName());
+    manager.setCheckpointInterval(_checkpointInterval);
+    bool resumed = _resumeFromCheckpoint && manager.resumeFromCheckpoint(s);
+    double tStart = resumed ? s.getTime() : _ti;
+
+    // Write the states to their file as they are computed, in the background;
+    // printResults() finishes the file. A resumed run restores the earlier
+    // states only once it starts, so printResults() writes them all instead.
+    if(_printResultFiles && !resumed) {
+        IO::makeDir(getResultsDir());
+        manager.getStateStorage().setOutputFileName(
+            getResultsDir() + "/" + getName() + "_states.sto", true);
+    }
+
 
     bool completed = true;
 
@@ -315,7 +335,7 @@ bool ForwardTool::run()
         // INTEGRATE
         _model->printDetailedInfo(s, std::cout );
 
-        cout<<"\n\nIntegrating from "<<_ti<<" to "<<_tf<<endl;
+        cout<<"\n\nIntegrating from "<<tStart<<" to "<<_tf<<endl;
         manager.integrate(s);
     } catch(const std::exception& x) {
         cout << "ForwardTool::run() caught exception \n";
@@ -335,6 +355,7 @@ bool ForwardTool::run()
     IO::chDir(saveWorkingDirectory);
 
     removeAnalysisSetFromModel();
+    ComponentProfiler::report("ForwardTool::run");
     return completed;
 }
 //=============================================================================
@@ -353,7 +374,8 @@ void ForwardTool::printResults()
     AbstractTool::printResults(getName(),getResultsDir()); // this will create results directory if necessary
     if(_model) {
         _model->printControlStorage(getResultsDir() + "/" + getName() + "_controls.sto");
-        getManager().getStateStorage().print(getResultsDir() + "/" + getName() + "_states.sto");
+        if(!getManager().getStateStorage().closeOutputFile())
+            getManager().getStateStorage().print(getResultsDir() + "/" + getName() + "_states.sto");
 
         Storage statesDegrees(getManager().getStateStorage());
         _model->getSimbodyEngine().convertRadiansToDegrees(statesDegrees);
@@ -38,6 +38,7 @@
 #include <OpenSim/Common/FunctionSet.h> 
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/ComponentProfiler.h>
 #include "AnalyzeTool.h"
 
 using namespace OpenSim;
@@ -422,6 +423,7 @@ bool InverseDynamicsTool::run()
         throw (Exception("InverseDynamicsTool Failed, please see messages window for details..."));
     }
 
+    ComponentProfiler::report("InverseDynamicsTool::run");
     if (modelFromFile) delete _model;
     return success;
 }
@@ -38,6 +38,7 @@
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/XMLDocument.h>
+#include <OpenSim/Common/ComponentProfiler.h>
 
 #include <OpenSim/Analyses/Kinematics.h>
 
@@ -61,6 +62,7 @@ using namespace SimTK;
  */
 InverseKinematicsTool::~InverseKinematicsTool()
 {
+    delete _outputStorage;
 }
 //_____________________________________________________________________________
 /**
@@ -144,6 +146,7 @@ void InverseKinematicsTool::setNull()
 {
     setupProperties();
     _model = NULL;
+    _outputStorage = NULL;
 }
 //_____________________________________________________________________________
 /**
@@ -246,6 +249,17 @@ operator=(const InverseKinematicsTool &aTool)
 //=============================================================================
 // GET AND SET
 //=============================================================================
+//_____________________________________________________________________________
+/**
+ * Get the motion computed by the last run().
+ */
+const Storage& InverseKinematicsTool::getOutputStorage() const
+{
+    if (!_outputStorage)
+        throw Exception("InverseKinematicsTool::getOutputStorage: the tool has not been run.",
+                        __FILE__, __LINE__);
+    return *_outputStorage;
+}
 
 
 //=============================================================================
@@ -259,6 +273,7 @@ bool InverseKinematicsTool::run()
 {
     bool success = false;
     bool modelFromFile=true;
+    Kinematics kinematicsReporter;
     try{
         //Load and create the indicated model
         if (!_model) 
@@ -276,7 +291,6 @@ bool InverseKinematicsTool::run()
         IO::chDir(directoryOfSetupFile);
 
         // Define reporter for output
-        Kinematics kinematicsReporter;
         kinematicsReporter.setRecordAccelerations(false);
         kinematicsReporter.setInDegrees(true);
         _model->addAnalysis(&kinematicsReporter);
@@ -365,6 +379,7 @@ bool InverseKinematicsTool::run()
         double dt = 1.0/markersReference.getSamplingFrequency();
         int Nframes = int((final_time-start_time)/dt)+1;
         AnalysisSet& analysisSet = _model->updAnalysisSet();
+        analysisSet.setStreamBaseName(getName());
         analysisSet.begin(s);
         // number of markers
         int nm = markerWeights.getSize();
@@ -412,6 +427,12 @@ bool InverseKinematicsTool::run()
             analysisSet.step(s, i);
         }
 
+        // The reporter is about to go out of scope; the model may outlive
+        // this run, so it must not keep it.
+        _model->removeAnalysis(&kinematicsReporter, false);
+        delete _outputStorage;
+        _outputStorage = new Storage(*kinematicsReporter.getPositionStorage());
+
         // Do the maneuver to change then restore working directory 
         // so that output files are saved to same folder as setup file.
         if (_outputMotionFileName!= "" && _outputMotionFileName!="Unassigned"){
@@ -444,11 +465,13 @@ bool InverseKinematicsTool::run()
         cout << "InverseKinematicsTool completed " << Nframes-1 << " frames in " <<(double)(clock()-start)/CLOCKS_PER_SEC << "s\n" <<endl;
     }
     catch (const std::exception& ex) {
+        if (_model) _model->removeAnalysis(&kinematicsReporter, false);
         std::cout << "InverseKinematicsTool Failed: " << ex.what() << std::endl;
         throw (Exception("InverseKinematicsTool Failed, please see messages window for details..."));
     }
 
-    if (modelFromFile) delete _model;
+    ComponentProfiler::report("InverseKinematicsTool::run");
+    if (modelFromFile) { delete _model; _model = NULL; }
 
     return success;
 }
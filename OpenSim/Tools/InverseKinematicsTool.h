@@ -108,6 +108,9 @@ private:
     PropertyBool _reportMarkerLocationsProp;
     bool &_reportMarkerLocations;
 
+    // motion computed by the last run, with the coordinates in degrees
+    Storage *_outputStorage;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -139,7 +142,9 @@ public:
     void setCoordinateFileName(const std::string& coordDataFileName) { _coordinateFileName=coordDataFileName;};
     const std::string& getCoordinateFileName() const { return  _coordinateFileName;};
     
-    //const OpenSim::Storage& getOutputStorage() const;
+    /** The motion computed by the last run(), with the coordinates in
+    degrees, whether or not it was also written to the output motion file. */
+    const Storage& getOutputStorage() const;
 private:
     void setNull();
     void setupProperties();
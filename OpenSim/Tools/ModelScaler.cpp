@@ -322,21 +322,24 @@ bool ModelScaler::processModel(Model* aModel, const string& aPathToSubject, doub
 
 
         if(_printResultFiles) {
-            std::string savedCwd = IO::getCwd();
-            IO::chDir(aPathToSubject);
-
+            // The output files are relative to the subject's directory. Name
+            // them by their path rather than changing the working directory,
+            // which other threads may be using.
             if (!_outputModelFileNameProp.getValueIsDefault())
             {
-                if (aModel->print(_outputModelFileName))
+                const string fileName = IO::isAbsolutePath(_outputModelFileName) ?
+                    _outputModelFileName : aPathToSubject + _outputModelFileName;
+                if (aModel->print(fileName))
                     cout << "Wrote model file " << _outputModelFileName << " from model " << aModel->getName() << endl;
             }
 
             if (!_outputScaleFileNameProp.getValueIsDefault())
             {
-                if (theScaleSet.print(_outputScaleFileName))
+                const string fileName = IO::isAbsolutePath(_outputScaleFileName) ?
+                    _outputScaleFileName : aPathToSubject + _outputScaleFileName;
+                if (theScaleSet.print(fileName))
                     cout << "Wrote scale file " << _outputScaleFileName << " for model " << aModel->getName() << endl;
             }
-            IO::chDir(savedCwd);
         }
     }
     catch (const Exception& x)
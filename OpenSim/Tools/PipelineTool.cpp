@@ -0,0 +1,116 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  PipelineTool.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "PipelineTool.h"
+#include <OpenSim/Common/IO.h>
+#include <atomic>
+#include <thread>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+PipelineTool::PipelineTool()
+{
+    constructProperties();
+}
+
+PipelineTool::PipelineTool(const string& aFileName) : Super(aFileName, false)
+{
+    constructProperties();
+    updateFromXMLDocument();
+}
+
+void PipelineTool::constructProperties()
+{
+    constructProperty_subjects();
+    constructProperty_max_threads(0);
+}
+
+const string& PipelineTool::getFailure(int index) const
+{
+    return _failures.at(index);
+}
+
+//=============================================================================
+// RUN
+//=============================================================================
+bool PipelineTool::run()
+{
+    // The tools of the subjects change the working directory as they run,
+    // so file names are made absolute before any of them starts and the
+    // working directory is restored once all of them are done.
+    const string savedCwd = IO::getCwd();
+    string directory = getDocument() ?
+        IO::getParentDirectory(getDocumentFileName()) : "";
+    if (!IO::isAbsolutePath(directory))
+        directory = savedCwd + "/" + directory;
+
+    const int numSubjects = getProperty_subjects().size();
+    vector<SubjectPipeline*> subjects;
+    for (int i = 0; i < numSubjects; ++i)
+        subjects.push_back(&upd_subjects(i));
+    _failures.assign(numSubjects, "");
+
+    int numThreads = get_max_threads();
+    if (numThreads <= 0)
+        numThreads = max(1, (int)thread::hardware_concurrency());
+    numThreads = min(numThreads, numSubjects);
+
+    // Each thread takes the next subject that has not been started.
+    atomic<int> next(0);
+    auto work = [&]() {
+        for (int i = next++; i < numSubjects; i = next++) {
+            try {
+                subjects[i]->run(directory);
+            }
+            catch (const std::exception& x) {
+                _failures[i] = x.what();
+            }
+            subjects[i]->clearResults();
+        }
+    };
+
+    cout << "PipelineTool " << getName() << ": processing " << numSubjects
+         << " subjects on " << numThreads << " threads." << endl;
+    vector<thread> threads;
+    for (int t = 1; t < numThreads; ++t)
+        threads.push_back(thread(work));
+    work();
+    for (size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+    IO::chDir(savedCwd);
+
+    bool succeeded = true;
+    for (int i = 0; i < numSubjects; ++i) {
+        if (_failures[i] == "") continue;
+        cout << "PipelineTool: subject " << subjects[i]->getName()
+             << " failed: " << _failures[i] << endl;
+        succeeded = false;
+    }
+    return succeeded;
+}
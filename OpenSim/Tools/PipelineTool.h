@@ -0,0 +1,103 @@
+#ifndef OPENSIM_PIPELINE_TOOL_H_
+#define OPENSIM_PIPELINE_TOOL_H_
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  PipelineTool.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimToolsDLL.h"
+#include "SubjectPipeline.h"
+
+#ifdef SWIG
+    #ifdef OSIMTOOLS_API
+        #undef OSIMTOOLS_API
+        #define OSIMTOOLS_API
+    #endif
+#endif
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Runs the SubjectPipeline of each of a number of subjects, several at a
+ * time on a bounded pool of threads. Each subject's stages (scale, inverse
+ * kinematics, inverse dynamics, analyze) run one after the other in memory;
+ * the subjects run concurrently with each other.
+ *
+ * Setup and model file names of the subjects are relative to the directory
+ * of the PipelineTool's setup file. A subject that fails does not stop the
+ * others; run() reports the failures once all subjects are done. The models
+ * and motions of the subjects are released as each finishes, so the memory
+ * in use is bounded by the number of threads rather than of subjects.
+ *
+ * @code
+ * <PipelineTool name="study">
+ *   <max_threads>4</max_threads>
+ *   <subjects>
+ *     <SubjectPipeline name="subject01">
+ *       <scale_setup_file>subject01/Setup_Scale.xml</scale_setup_file>
+ *       <inverse_kinematics_setup_file>subject01/Setup_IK.xml</inverse_kinematics_setup_file>
+ *       <inverse_dynamics_setup_file>subject01/Setup_ID.xml</inverse_dynamics_setup_file>
+ *       <analyze_setup_file>subject01/Setup_SO.xml</analyze_setup_file>
+ *     </SubjectPipeline>
+ *     ...
+ *   </subjects>
+ * </PipelineTool>
+ * @endcode
+ */
+class OSIMTOOLS_API PipelineTool : public Object {
+OpenSim_DECLARE_CONCRETE_OBJECT(PipelineTool, Object);
+
+public:
+//==============================================================================
+// PROPERTIES
+//==============================================================================
+    OpenSim_DECLARE_LIST_PROPERTY(subjects, SubjectPipeline,
+        "The subjects to process.");
+    OpenSim_DECLARE_PROPERTY(max_threads, int,
+        "Number of subjects processed at a time. 0, the default, for one "
+        "per processor core.");
+
+//=============================================================================
+// METHODS
+//=============================================================================
+    PipelineTool();
+    PipelineTool(const std::string& aFileName) SWIG_DECLARE_EXCEPTION;
+    virtual ~PipelineTool() {}
+
+    /** Process all subjects. Returns true if all of them succeeded. */
+    bool run() SWIG_DECLARE_EXCEPTION;
+
+    /** Why the subject at index failed in the last run(), or an empty
+    string if it succeeded. */
+    const std::string& getFailure(int index) const;
+
+private:
+    void constructProperties();
+
+    std::vector<std::string> _failures;
+
+//=============================================================================
+};  // END of class PipelineTool
+//=============================================================================
+} // namespace OpenSim
+
+#endif // OPENSIM_PIPELINE_TOOL_H_
@@ -38,6 +38,7 @@
 #include <OpenSim/Simulation/SimbodyEngine/Joint.h>
 #include "ForwardTool.h"
 #include <OpenSim/Common/DebugUtilities.h>
+#include <OpenSim/Common/ComponentProfiler.h>
 #include "CMC.h" 
 #include "CMC_TaskSet.h"
 #include "ActuatorForceTarget.h"
@@ -904,6 +905,7 @@ bool RRATool::run()
 
     IO::chDir(saveWorkingDirectory);
 
+    ComponentProfiler::report("RRATool::run");
     return true;
 }
 
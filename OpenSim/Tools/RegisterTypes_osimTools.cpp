@@ -35,6 +35,8 @@
 #include "AnalyzeTool.h"
 #include "InverseKinematicsTool.h"
 #include "InverseDynamicsTool.h"
+#include "SubjectPipeline.h"
+#include "PipelineTool.h"
 
 #include "GenericModelMaker.h"
 #include "IKCoordinateTask.h"
@@ -78,6 +80,8 @@ OSIMTOOLS_API void RegisterTypes_osimTools()
     Object::registerType( RRATool() );
     Object::registerType( ForwardTool() );
     Object::registerType( AnalyzeTool() );
+    Object::registerType( SubjectPipeline() );
+    Object::registerType( PipelineTool() );
 
     Object::registerType( GenericModelMaker() );
     Object::registerType( IKCoordinateTask() );
@@ -0,0 +1,252 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  SubjectPipeline.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SubjectPipeline.h"
+#include "ScaleTool.h"
+#include "InverseKinematicsTool.h"
+#include "InverseDynamicsTool.h"
+#include "AnalyzeTool.h"
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <mutex>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace {
+    // Reading an XML file can update the default objects that all files are
+    // read with, so subjects read their setup files, and their tools read
+    // the external loads files, one at a time.
+    std::mutex readMutex;
+
+    // fileName, if relative, as a path in directory. Empty and unassigned
+    // file names are returned as they are.
+    string resolve(const string& directory, string fileName)
+    {
+        IO::TrimWhitespace(fileName);
+        if (fileName == "" || fileName == "Unassigned" ||
+            IO::isAbsolutePath(fileName))
+            return fileName;
+        return directory + fileName;
+    }
+}
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+SubjectPipeline::SubjectPipeline()
+{
+    constructProperties();
+}
+
+void SubjectPipeline::constructProperties()
+{
+    constructProperty_model_file("");
+    constructProperty_scale_setup_file("");
+    constructProperty_inverse_kinematics_setup_file("");
+    constructProperty_inverse_dynamics_setup_file("");
+    constructProperty_analyze_setup_file("");
+    constructProperty_write_intermediate_files(false);
+}
+
+//=============================================================================
+// RESULTS
+//=============================================================================
+const Model& SubjectPipeline::getModel() const
+{
+    if (!_model)
+        throw Exception("SubjectPipeline::getModel: subject " + getName() +
+                        " has not been run.", __FILE__, __LINE__);
+    return *_model;
+}
+
+const Storage& SubjectPipeline::getMotion() const
+{
+    if (!_motion)
+        throw Exception("SubjectPipeline::getMotion: subject " + getName() +
+                        " has no inverse kinematics results.",
+                        __FILE__, __LINE__);
+    return *_motion;
+}
+
+void SubjectPipeline::clearResults()
+{
+    _model.reset();
+    _motion.reset();
+}
+
+//=============================================================================
+// RUN
+//=============================================================================
+void SubjectPipeline::run(const string& directory)
+{
+    clearResults();
+
+    // Relative file names are resolved against an absolute directory.
+    string base = directory;
+    if (base != "" && base[base.size()-1] != '/' && base[base.size()-1] != '\\')
+        base += "/";
+    if (!IO::isAbsolutePath(base))
+        base = IO::getCwd() + "/" + base;
+
+    const bool writeIntermediateFiles = get_write_intermediate_files();
+    const string ikSetupFile =
+        resolve(base, get_inverse_kinematics_setup_file());
+    const string idSetupFile = resolve(base, get_inverse_dynamics_setup_file());
+    const string analyzeSetupFile = resolve(base, get_analyze_setup_file());
+
+    // Declared first so that they outlive the tools that refer to them.
+    shared_ptr<Model> model;
+    unique_ptr<Model> idModel, analyzeModel;
+
+    unique_ptr<ScaleTool> scaleTool;
+    unique_ptr<InverseKinematicsTool> ikTool;
+    unique_ptr<InverseDynamicsTool> idTool;
+    unique_ptr<AnalyzeTool> analyzeTool;
+    {
+        lock_guard<mutex> lock(readMutex);
+        const string scaleSetupFile = resolve(base, get_scale_setup_file());
+        if (scaleSetupFile != "") {
+            // The ScaleTool finds its files relative to the directory of
+            // its setup file, which is absolute here.
+            scaleTool.reset(new ScaleTool(scaleSetupFile));
+            scaleTool->setPrintResultFiles(writeIntermediateFiles);
+            model.reset(scaleTool->createModel());
+            if (!model)
+                throw Exception("SubjectPipeline: the ScaleTool of subject " +
+                    getName() + " did not make a model.", __FILE__, __LINE__);
+        }
+        else if (get_model_file() != "")
+            model.reset(new Model(resolve(base, get_model_file())));
+        else
+            throw Exception("SubjectPipeline: subject " + getName() +
+                " has neither a scale_setup_file nor a model_file.",
+                __FILE__, __LINE__);
+
+        if (ikSetupFile != "")
+            ikTool.reset(new InverseKinematicsTool(ikSetupFile, false));
+        if (idSetupFile != "")
+            idTool.reset(new InverseDynamicsTool(idSetupFile, false));
+        if (analyzeSetupFile != "")
+            analyzeTool.reset(new AnalyzeTool(analyzeSetupFile, false));
+    }
+
+    // SCALE
+    if (scaleTool) {
+        if (!scaleTool->isDefaultModelScaler() &&
+            scaleTool->getModelScaler().getApply()) {
+            if (!scaleTool->getModelScaler().processModel(model.get(),
+                    scaleTool->getPathToSubject(), scaleTool->getSubjectMass()))
+                throw Exception("SubjectPipeline: scaling subject " +
+                                getName() + " failed.", __FILE__, __LINE__);
+        }
+        if (!scaleTool->isDefaultMarkerPlacer() &&
+            scaleTool->getMarkerPlacer().getApply()) {
+            if (!scaleTool->getMarkerPlacer().processModel(model.get(),
+                    scaleTool->getPathToSubject()))
+                throw Exception("SubjectPipeline: placing the markers of "
+                    "subject " + getName() + " failed.", __FILE__, __LINE__);
+        }
+    }
+
+    // INVERSE KINEMATICS
+    shared_ptr<Storage> motion;
+    if (ikTool) {
+        const string directory = IO::getParentDirectory(ikSetupFile);
+        ikTool->setMarkerDataFileName(
+            resolve(directory, ikTool->getMarkerDataFileName()));
+        ikTool->setCoordinateFileName(
+            resolve(directory, ikTool->getCoordinateFileName()));
+        ikTool->setResultsDir(resolve(directory, ikTool->getResultsDir()));
+        string motionFileName = ikTool->getOutputMotionFileName();
+        IO::TrimWhitespace(motionFileName);
+        ikTool->setOutputMotionFileName(writeIntermediateFiles ?
+            resolve(directory, motionFileName) : "");
+
+        ikTool->setModel(*model);
+        ikTool->run();
+
+        // Named after the file it stands for, so that the external loads
+        // use it in place of that file.
+        motion.reset(new Storage(ikTool->getOutputStorage()));
+        if (motionFileName != "" && motionFileName != "Unassigned")
+            motion->setName(motionFileName);
+    }
+
+    // INVERSE DYNAMICS
+    if (idTool) {
+        const string directory = IO::getParentDirectory(idSetupFile);
+        idTool->setExternalLoadsFileName(
+            resolve(directory, idTool->getExternalLoadsFileName()));
+        idTool->setResultsDir(resolve(directory, idTool->getResultsDir()));
+        if (motion)
+            idTool->setCoordinateValues(*motion);
+        else
+            idTool->setCoordinatesFileName(
+                resolve(directory, idTool->getCoordinatesFileName()));
+
+        // The tool adds the external loads to the model, so it gets a copy.
+        idModel.reset(model->clone());
+        idTool->setModel(*idModel);
+        idTool->setExternalLoadsReadMutex(&readMutex);
+        idTool->run();
+    }
+
+    // ANALYZE
+    if (analyzeTool) {
+        const string directory = IO::getParentDirectory(analyzeSetupFile);
+        analyzeTool->setExternalLoadsFileName(
+            resolve(directory, analyzeTool->getExternalLoadsFileName()));
+        analyzeTool->setResultsDir(
+            resolve(directory, analyzeTool->getResultsDir()));
+        Array<string> forceSetFiles = analyzeTool->getForceSetFiles();
+        for (int i = 0; i < forceSetFiles.getSize(); ++i)
+            forceSetFiles[i] = resolve(directory, forceSetFiles[i]);
+        analyzeTool->setForceSetFiles(forceSetFiles);
+
+        analyzeModel.reset(model->clone());
+        {
+            lock_guard<mutex> lock(readMutex);
+            analyzeTool->updateModelForces(*analyzeModel, analyzeSetupFile);
+        }
+        analyzeTool->setModel(*analyzeModel);
+        analyzeTool->setExternalLoadsReadMutex(&readMutex);
+        if (motion) {
+            SimTK::State& s = analyzeModel->initSystem();
+            analyzeTool->setStatesFromMotion(s, *motion, true);
+        }
+        else {
+            analyzeTool->setStatesFileName(
+                resolve(directory, analyzeTool->getStatesFileName()));
+            analyzeTool->setCoordinatesFileName(
+                resolve(directory, analyzeTool->getCoordinatesFileName()));
+            analyzeTool->setSpeedsFileName(
+                resolve(directory, analyzeTool->getSpeedsFileName()));
+            analyzeTool->setLoadModelAndInput(true);
+        }
+        analyzeTool->run();
+    }
+
+    _model = model;
+    _motion = motion;
+}
@@ -0,0 +1,122 @@
+#ifndef OPENSIM_SUBJECT_PIPELINE_H_
+#define OPENSIM_SUBJECT_PIPELINE_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  SubjectPipeline.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2015 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimToolsDLL.h"
+#include <OpenSim/Common/Object.h>
+#include <memory>
+
+#ifdef SWIG
+    #ifdef OSIMTOOLS_API
+        #undef OSIMTOOLS_API
+        #define OSIMTOOLS_API
+    #endif
+#endif
+
+namespace OpenSim {
+
+class Model;
+class Storage;
+
+//=============================================================================
+//=============================================================================
+/**
+ * The processing of one subject: scaling (ScaleTool), inverse kinematics
+ * (InverseKinematicsTool), inverse dynamics (InverseDynamicsTool) and an
+ * AnalyzeTool, typically with a StaticOptimization analysis, each described
+ * by its usual setup file and each optional.
+ *
+ * The stages run in one process and pass their results to each other in
+ * memory: the scaled model goes to the later stages, which each get their
+ * own copy of it, and the motion from inverse kinematics is used in place
+ * of the coordinates files of the inverse dynamics and analyze stages. If
+ * the external loads name that motion's output file as their model
+ * kinematics file, they use the motion too. Unless write_intermediate_files
+ * is set, the scaled model and the motion are not written to the files the
+ * setup files name; the results of the inverse dynamics and analyze stages
+ * are always written.
+ *
+ * Relative file names in the setup files are relative to the directory of
+ * the setup file, as when the tools are run on their own, but they are
+ * resolved up front so that the stages do not depend on the working
+ * directory; this allows a PipelineTool to run several subjects at once.
+ *
+ * @see PipelineTool
+ */
+class OSIMTOOLS_API SubjectPipeline : public Object {
+OpenSim_DECLARE_CONCRETE_OBJECT(SubjectPipeline, Object);
+
+public:
+//==============================================================================
+// PROPERTIES
+//==============================================================================
+    OpenSim_DECLARE_PROPERTY(model_file, std::string,
+        "Model of the subject, used if there is no scale_setup_file.");
+    OpenSim_DECLARE_PROPERTY(scale_setup_file, std::string,
+        "Setup file of the ScaleTool that makes the model of the subject "
+        "(optional).");
+    OpenSim_DECLARE_PROPERTY(inverse_kinematics_setup_file, std::string,
+        "Setup file of the InverseKinematicsTool (optional).");
+    OpenSim_DECLARE_PROPERTY(inverse_dynamics_setup_file, std::string,
+        "Setup file of the InverseDynamicsTool (optional).");
+    OpenSim_DECLARE_PROPERTY(analyze_setup_file, std::string,
+        "Setup file of the AnalyzeTool, e.g., with a StaticOptimization "
+        "analysis (optional).");
+    OpenSim_DECLARE_PROPERTY(write_intermediate_files, bool,
+        "Also write the scaled model and the inverse kinematics motion to "
+        "the files named in the setup files (default false).");
+
+//=============================================================================
+// METHODS
+//=============================================================================
+    SubjectPipeline();
+    virtual ~SubjectPipeline() {}
+
+    /** Run the stages. Relative names of the setup and model files are
+    relative to directory, by default the working directory. Throws an
+    Exception if a stage fails. */
+    void run(const std::string& directory = "");
+
+    /** The model made by the last run(). */
+    const Model& getModel() const;
+    /** The motion computed by the last run(), if it had an inverse
+    kinematics stage, with the coordinates in degrees. */
+    const Storage& getMotion() const;
+    bool hasMotion() const { return _motion != nullptr; }
+
+    /** Release the model and motion of the last run(). */
+    void clearResults();
+
+private:
+    void constructProperties();
+
+    // Results of the last run; copies of the object share them.
+    std::shared_ptr<Model> _model;
+    std::shared_ptr<Storage> _motion;
+
+//=============================================================================
+};  // END of class SubjectPipeline
+//=============================================================================
+} // namespace OpenSim
+
+#endif // OPENSIM_SUBJECT_PIPELINE_H_
@@ -28,22 +28,45 @@
 //  Tests Include:
 //      1. Test a control set controller on a block with an ideal actuator
 //      2. Test a corrective controller on a block with an ideal actuator
+//      3. Test that computing the controls of a model does not allocate
 //      
 //     Add tests here as new controller types are added to OpenSim
 //
 //==========================================================================================================
 #include <OpenSim/OpenSim.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
 
 using namespace OpenSim;
 using namespace std;
 
+// Count the allocations of this process, to check that computing controls
+// does not allocate. (On Windows, allocations inside the OpenSim DLLs do not
+// go through these, so nothing is checked there.)
+static std::atomic<long long> numAllocations(0);
+
+void* operator new(std::size_t size)
+{
+    ++numAllocations;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) throw()
+{
+    std::free(p);
+}
+
 void testControlSetControllerOnBlock();
 void testPrescribedControllerOnBlock(bool disabled);
 void testCorrectionControllerOnBlock();
 void testPrescribedControllerFromFile(const std::string& modelFile,
                                       const std::string& actuatorsFile,
                                       const std::string& controlsFile);
+void testComputeControlsDoesNotAllocate();
 
 int main()
 {
@@ -58,6 +81,8 @@ int main()
         cout << "Testing PrescribedController from File" << endl;
         testPrescribedControllerFromFile("arm26.osim", "arm26_Reserve_Actuators.xml",
                                          "arm26_controls.xml");
+        cout << "Testing that computing controls does not allocate" << endl;
+        testComputeControlsDoesNotAllocate();
     }   
     catch (const Exception& e) {
         e.print(cerr);
@@ -416,3 +441,46 @@ void testPrescribedControllerFromFile(const std::string& modelFile,
      
     osimModel.disownAllComponents();
 }
+
+//==========================================================================================================
+void testComputeControlsDoesNotAllocate()
+{
+    Model osimModel("arm26.osim");
+    const Set<Actuator>& actuators = osimModel.getActuators();
+
+    PrescribedController* prescribed = new PrescribedController();
+    prescribed->setActuators(actuators);
+    for (int i = 0; i < actuators.getSize(); ++i)
+        prescribed->prescribeControlForActuator(i, new Constant(0.01*(i+1)));
+    osimModel.addController(prescribed);
+
+    osimModel.addController(new ToyReflexController(0.5));
+    osimModel.updControllerSet().get(1).setActuators(actuators);
+
+    ControlSetController* controlSetController = new ControlSetController();
+    controlSetController->setControlSet(new ControlSet("arm26_controls.xml"));
+    osimModel.addController(controlSetController);
+
+    SimTK::State& s = osimModel.initSystem();
+    s.updTime() = 0.1;
+    osimModel.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+
+    SimTK::Vector controls(osimModel.getNumControls(), 0.0);
+    // The first evaluation may fill caches, e.g. of the muscle paths.
+    osimModel.computeControls(s, controls);
+    SimTK::Vector expected = controls;
+
+    long long before = numAllocations;
+    for (int i = 0; i < 100; ++i) {
+        controls = 0;
+        osimModel.computeControls(s, controls);
+    }
+    long long allocations = numAllocations - before;
+    cout << "Allocations in 100 calls of computeControls: " << allocations
+         << endl;
+    ASSERT(allocations == 0, __FILE__, __LINE__,
+           "Model::computeControls() allocated memory.");
+
+    for (int i = 0; i < controls.size(); ++i)
+        ASSERT_EQUAL(expected[i], controls[i], 1e-15);
+}
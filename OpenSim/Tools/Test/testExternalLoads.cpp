@@ -29,11 +29,13 @@ using namespace OpenSim;
 using namespace std;
 
 void testExternalLoad();
+void testResampledExternalForce();
 
 int main()
 {
     try {
         testExternalLoad();
+        testResampledExternalForce();
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -268,4 +270,61 @@ void testExternalLoad()
 
     // kinematics should match to within integ accuracy
     ASSERT_EQUAL(0.0, norm_err, integ_accuracy);
-}
\ No newline at end of file
+}
+
+// Loads evaluated from a resampled table must match those evaluated from the
+// splines through the data.
+void testResampledExternalForce()
+{
+    using namespace SimTK;
+
+    Model model("Pendulum.osim");
+    const string bodyName = model.getBodySet().get(model.getNumBodies()-1).getName();
+
+    // Smooth loads sampled at 100 Hz.
+    Storage forceStore;
+    Array<string> labels;
+    labels.append("time");
+    const char* names[9] = {"forceX", "forceY", "forceZ", "pointX", "pointY",
+                            "pointZ", "torqueX", "torqueY", "torqueZ"};
+    for (int i = 0; i < 9; ++i)
+        labels.append(names[i]);
+    forceStore.setColumnLabels(labels);
+    for (int k = 0; k <= 100; ++k) {
+        double t = 0.01*k;
+        double data[9];
+        for (int i = 0; i < 9; ++i)
+            data[i] = (i+1)*sin(2*Pi*t + 0.3*i);
+        StateVector row;
+        row.setStates(t, 9, data);
+        forceStore.append(row);
+    }
+    forceStore.setName("test_resampled_external_loads.sto");
+
+    ExternalForce* exact = new ExternalForce(forceStore, "force", "point",
+        "torque", bodyName, "ground", "ground");
+    exact->setName("exact");
+    ExternalForce* resampled = exact->clone();
+    resampled->setName("resampled");
+    resampled->setResampleInterval(0.001);
+    ASSERT_EQUAL(0.001, resampled->getResampleInterval(), 0.0);
+    model.addForce(exact);
+    model.addForce(resampled);
+    model.initSystem();
+
+    for (int k = 0; k <= 1000; ++k) {
+        // Include times outside the data, which are not resampled.
+        double t = -0.05 + 0.0011*k;
+        Vec3 fe, pe, te, fr, pr, tr;
+        exact->calcLoadsAtTime(t, fe, pe, te);
+        resampled->calcLoadsAtTime(t, fr, pr, tr);
+        ASSERT_EQUAL(fe, fr, Vec3(1e-6));
+        ASSERT_EQUAL(pe, pr, Vec3(1e-6));
+        ASSERT_EQUAL(te, tr, Vec3(1e-6));
+
+        // The separate accessors give the same values.
+        ASSERT_EQUAL(fe, exact->getForceAtTime(t), Vec3(0));
+        ASSERT_EQUAL(pr, resampled->getPointAtTime(t), Vec3(0));
+        ASSERT_EQUAL(tr, resampled->getTorqueAtTime(t), Vec3(0));
+    }
+}
@@ -407,6 +407,166 @@ JOINT_ADOPT_HELPER(PlanarJoint);
 		    self->set(i, dValues[i]);
 };
 };
+// NumPy views
+// ===========
+/*
+Views share memory with the C++ object instead of copying it element by
+element through the proxies. A view holds a reference to the proxy it was
+taken from, so an object owned by that proxy cannot be deleted while the view
+is alive. Objects owned by other C++ objects (e.g., the working State of a
+Model) live only as long as their owner. A view is invalidated by resizing the object it was taken from
+(e.g., appending to a Storage or an Array), so take a new view afterwards.
+NumPy is imported only when a view is requested.
+*/
+%pythoncode %{
+def _numpy_view(owner, address, shape, writeable=True, order='C'):
+    """Return a NumPy array of doubles sharing the memory at address, which
+    is owned by (the C++ object behind) owner."""
+    import ctypes
+    import numpy
+    size = 1
+    for dim in shape:
+        size *= dim
+    if size == 0:
+        return numpy.zeros(shape)
+    buf = (ctypes.c_double * size).from_address(address)
+    # Keep the owner alive as long as the buffer (and so the view) is.
+    buf._opensim_owner = owner
+    view = numpy.frombuffer(buf, dtype=numpy.float64).reshape(shape,
+                                                              order=order)
+    view.flags.writeable = writeable
+    return view
+%}
+
+%define SIMTK_VECTOR_NUMPY_HELPER(CLASS, NSCALARS)
+%extend CLASS {
+    size_t _contiguousDataAddress() {
+        return self->hasContiguousData()
+            ? (size_t)self->updContiguousScalarData() : 0;
+    }
+%pythoncode %{
+    def asNumPy(self, writeable=True):
+        """A NumPy view of this vector, with a row for each element that is
+        not a scalar, sharing its memory."""
+        address = self._contiguousDataAddress()
+        if self.size() and not address:
+            raise ValueError("Vector does not have contiguous data.")
+        shape = (self.size(),) if NSCALARS == 1 else (self.size(), NSCALARS)
+        return _numpy_view(self, address, shape, writeable)
+%}
+};
+%enddef
+
+SIMTK_VECTOR_NUMPY_HELPER(SimTK::Vector_<double>, 1);
+SIMTK_VECTOR_NUMPY_HELPER(SimTK::Vector_<SimTK::Vec3>, 3);
+SIMTK_VECTOR_NUMPY_HELPER(SimTK::Vector_<SimTK::SpatialVec>, 6);
+
+%extend SimTK::Matrix_<double> {
+    size_t _contiguousDataAddress() {
+        return self->hasContiguousData()
+            ? (size_t)self->updContiguousScalarData() : 0;
+    }
+%pythoncode %{
+    def asNumPy(self, writeable=True):
+        """A NumPy view of this matrix, sharing its (column-major) memory."""
+        address = self._contiguousDataAddress()
+        if self.nrow()*self.ncol() and not address:
+            raise ValueError("Matrix does not have contiguous data.")
+        return _numpy_view(self, address, (self.nrow(), self.ncol()),
+                           writeable, order='F')
+%}
+};
+
+%extend OpenSim::Array<double> {
+    size_t _dataAddress() {
+        return (size_t)self->get();
+    }
+%pythoncode %{
+    def asNumPy(self, writeable=True):
+        """A NumPy view of this Array, sharing its memory."""
+        return _numpy_view(self, self._dataAddress(), (self.getSize(),),
+                           writeable)
+%}
+};
+
+/*
+The rows of a Storage are separate StateVectors, so its table of data is not
+contiguous and is copied into NumPy in one call. A single row can be viewed.
+*/
+%extend OpenSim::Storage {
+    int _getNumDataColumns() const {
+        int n = self->getColumnLabels().getSize() - 1;
+        return n > 0 ? n : self->getSmallestNumberOfStates();
+    }
+    void _copyDataTo(size_t address, int nRows, int nColumns) const {
+        double* out = reinterpret_cast<double*>(address);
+        for(int i = 0; i < nRows; ++i) {
+            const OpenSim::Array<double>& data =
+                self->getStateVector(i)->getData();
+            int n = std::min(nColumns, data.getSize());
+            std::copy(data.get(), data.get() + n, out + i*nColumns);
+            std::fill(out + i*nColumns + n, out + (i+1)*nColumns, SimTK::NaN);
+        }
+    }
+    void _copyTimeTo(size_t address, int nRows) const {
+        double* out = reinterpret_cast<double*>(address);
+        for(int i = 0; i < nRows; ++i)
+            out[i] = self->getStateVector(i)->getTime();
+    }
+    size_t _rowDataAddress(int aTimeIndex) {
+        return (size_t)self->getStateVector(aTimeIndex)->getData().get();
+    }
+%pythoncode %{
+    def getDataAsNumPy(self):
+        """A copy of the data (without time) as a rows x columns NumPy
+        array. Missing values in short rows are NaN."""
+        import numpy
+        nrows = self.getSize()
+        data = numpy.empty((nrows, self._getNumDataColumns()))
+        if data.size:
+            self._copyDataTo(data.ctypes.data, nrows, data.shape[1])
+        return data
+
+    def getTimeAsNumPy(self):
+        """A copy of the time column as a NumPy array."""
+        import numpy
+        time = numpy.empty(self.getSize())
+        if time.size:
+            self._copyTimeTo(time.ctypes.data, time.size)
+        return time
+
+    def getRowAsNumPy(self, timeIndex, writeable=True):
+        """A NumPy view of the data of one row, sharing its memory."""
+        if timeIndex < 0 or timeIndex >= self.getSize():
+            raise IndexError("Storage row index out of range.")
+        n = self.getStateVector(timeIndex).getSize()
+        return _numpy_view(self, self._rowDataAddress(timeIndex), (n,),
+                           writeable)
+%}
+};
+
+/*
+The vectors returned by a State refer to its memory; keep the State alive as
+long as they (and views of them) are.
+*/
+%define STATE_VECTOR_PIN_HELPER(NAME)
+%pythonappend SimTK::State:: ## NAME %{
+    val._opensim_state = self
+%}
+%enddef
+
+STATE_VECTOR_PIN_HELPER(getY);
+STATE_VECTOR_PIN_HELPER(getQ);
+STATE_VECTOR_PIN_HELPER(getU);
+STATE_VECTOR_PIN_HELPER(getZ);
+STATE_VECTOR_PIN_HELPER(updY);
+STATE_VECTOR_PIN_HELPER(updQ);
+STATE_VECTOR_PIN_HELPER(updU);
+STATE_VECTOR_PIN_HELPER(updZ);
+STATE_VECTOR_PIN_HELPER(getYDot);
+STATE_VECTOR_PIN_HELPER(getQDot);
+STATE_VECTOR_PIN_HELPER(getUDot);
+
 /*
 %extend OpenSim::Model {
 	static void LoadOpenSimLibrary(std::string libraryName){
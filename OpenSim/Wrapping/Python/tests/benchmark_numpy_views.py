@@ -0,0 +1,70 @@
+"""Times getting simulation-sized results into NumPy element by element
+through the SWIG proxies and through the NumPy views and copies added to the
+bindings (asNumPy(), Storage.getDataAsNumPy()).
+
+Usage: python benchmark_numpy_views.py [num_rows] [num_columns]
+
+"""
+from __future__ import print_function
+
+import sys
+import time
+
+import numpy as np
+
+import opensim as osim
+
+num_rows = int(sys.argv[1]) if len(sys.argv) > 1 else 50000
+num_columns = int(sys.argv[2]) if len(sys.argv) > 2 else 100
+
+def timed(label, function):
+    start = time.time()
+    result = function()
+    print('%-45s %10.4f s' % (label, time.time() - start))
+    return result
+
+# Build the Storage, filling each row through a view of a Vector.
+sto = osim.Storage(num_rows)
+labels = osim.ArrayStr()
+labels.append('time')
+for j in range(num_columns):
+    labels.append('column%i' % j)
+sto.setColumnLabels(labels)
+row = osim.Vector(num_columns, 0.0)
+row_view = row.asNumPy()
+values = np.random.rand(num_rows, num_columns)
+def fill():
+    for i in range(num_rows):
+        row_view[:] = values[i]
+        sto.append(0.01 * i, row)
+timed('Storage: append %i rows' % num_rows, fill)
+
+# Storage, element by element.
+def element_by_element():
+    data = np.empty((num_rows, num_columns))
+    for i in range(num_rows):
+        state_vector = sto.getStateVector(i).getData()
+        for j in range(num_columns):
+            data[i, j] = state_vector.get(j)
+    return data
+slow = timed('Storage -> NumPy, element by element', element_by_element)
+fast = timed('Storage -> NumPy, getDataAsNumPy()', sto.getDataAsNumPy)
+assert np.array_equal(slow, fast)
+assert np.array_equal(fast, values)
+
+# Vector.
+n = num_rows * num_columns // 10
+vector = osim.Vector(n, 1.0)
+slow = timed('Vector(%i) -> NumPy, element by element' % n,
+             lambda: np.array([vector.get(i) for i in range(n)]))
+fast = timed('Vector(%i) -> NumPy, asNumPy()' % n, vector.asNumPy)
+assert np.array_equal(slow, fast)
+
+# Matrix.
+nr, nc = num_rows // 10, num_columns
+matrix = osim.Matrix(nr, nc, 2.0)
+slow = timed('Matrix(%i, %i) -> NumPy, element by element' % (nr, nc),
+             lambda: np.array([[matrix.get(i, j) for j in range(nc)]
+                               for i in range(nr)]))
+fast = timed('Matrix(%i, %i) -> NumPy, asNumPy()' % (nr, nc), matrix.asNumPy)
+assert np.array_equal(slow, fast)
@@ -253,3 +253,44 @@ def test_markAdoptedSets():
     constr.setConstantDistance(1)
     a.addConstraint(constr)
 
+
+def test_numpyViews():
+    import gc
+    import numpy as np
+
+    # Vector: writes through the view reach the Vector.
+    v = osim.Vector(5, 1.5)
+    view = v.asNumPy()
+    assert view.shape == (5,)
+    view[2] = 7
+    assert v.get(2) == 7
+    assert not v.asNumPy(writeable=False).flags.writeable
+
+    # The view keeps the Vector alive.
+    del v
+    gc.collect()
+    assert view[2] == 7
+
+    m = osim.Matrix(2, 3, 0.0)
+    m.set(1, 2, 4.0)
+    assert m.asNumPy()[1, 2] == 4.0
+
+    a = osim.ArrayDouble(0.0, 4)
+    a.asNumPy()[3] = 2.5
+    assert a.get(3) == 2.5
+
+    model = osim.Model(os.path.join(this_file_dir, "arm26.osim"))
+    state = model.initSystem()
+    q = state.getQ().asNumPy(writeable=False)
+    assert q.shape == (model.getNumCoordinates(),)
+    coord = model.getCoordinateSet().get(0)
+    assert q[0] == coord.getValue(state)
+
+    sto = osim.Storage(os.path.join(this_file_dir, 'storage.sto'))
+    data = sto.getDataAsNumPy()
+    assert data.shape == (5, 2)
+    assert data[1, 0] == 9.21
+    assert np.allclose(sto.getTimeAsNumPy(), [0, 0.01, 0.02, 0.03, 0.04])
+    row = sto.getRowAsNumPy(4)
+    row[1] = 3.0
+    assert sto.getDataAsNumPy()[4, 1] == 3.0
@@ -68,6 +68,13 @@ CompiledExpression::CompiledExpression(const CompiledExpression& expression) : j
 }
 
 CompiledExpression& CompiledExpression::operator=(const CompiledExpression& expression) {
+    if (&expression == this)
+        return *this;
+    // Delete the operations being replaced.
+    for (int i = 0; i < (int) operation.size(); i++)
+        if (operation[i] != NULL)
+            delete operation[i];
+    operation.clear();
     arguments = expression.arguments;
     target = expression.target;
     variableIndices = expression.variableIndices;